@@ -0,0 +1,33 @@
+#!/bin/bash
+# Copyright 2021 The Verible Authors.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Runs all *_benchmark targets, and writes the results of each as JSON
+# into the given directory (default: benchmark-results).
+# Additional arguments are passed to every benchmark, for example
+# --benchmark_filter=... or --benchmark_repetitions=...
+
+set -e
+
+OUT_DIR="${1:-benchmark-results}"
+shift || true
+mkdir -p "${OUT_DIR}"
+OUT_DIR="$(cd "${OUT_DIR}" && pwd)"
+
+for target in $(bazel query 'attr(name, "_benchmark$", kind(cc_binary, //...))'); do
+  name="$(echo "${target#//}" | tr '/:' '__')"
+  bazel run -c opt "${target}" -- \
+    --benchmark_out="${OUT_DIR}/${name}.json" \
+    --benchmark_out_format=json "$@"
+done
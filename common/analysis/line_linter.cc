@@ -14,6 +14,7 @@
 
 #include "common/analysis/line_linter.h"
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -27,12 +28,14 @@ namespace verible {
 void LineLinter::Lint(const std::vector<absl::string_view>& lines) {
   VLOG(1) << "LineLinter analyzing lines with " << rules_.size() << " rules.";
   for (const auto& line : lines) {
-    for (const auto& rule : rules_) {
-      ABSL_DIE_IF_NULL(rule)->HandleLine(line);
+    for (size_t i = 0; i < rules_.size(); ++i) {
+      const ScopedLintRuleCost cost(rule_costs_[i]);
+      ABSL_DIE_IF_NULL(rules_[i])->HandleLine(line);
     }
   }
-  for (const auto& rule : rules_) {
-    rule->Finalize();
+  for (size_t i = 0; i < rules_.size(); ++i) {
+    const ScopedLintRuleCost cost(rule_costs_[i]);
+    rules_[i]->Finalize();
   }
 }
 
@@ -137,5 +137,16 @@ TEST(LineLinterTest, FinalizeRejects) {
   EXPECT_THAT(statuses[0].violations, SizeIs(1));
 }
 
+TEST(LineLinterTest, ProfilingCountsLinesAndFinalize) {
+  std::vector<absl::string_view> lines{{"abc", "", "def"}};
+  LineLinter linter;
+  linter.AddRule(MakeBlankLineRule());
+  EXPECT_TRUE(linter.RuleCosts().empty());
+  linter.EnableProfiling();
+  linter.Lint(lines);
+  ASSERT_THAT(linter.RuleCosts(), SizeIs(1));
+  EXPECT_EQ(linter.RuleCosts()[0].callbacks, 4);
+}
+
 }  // namespace
 }  // namespace verible
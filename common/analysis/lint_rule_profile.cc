@@ -0,0 +1,106 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/analysis/lint_rule_profile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+
+#include "json/json.h"
+
+namespace verible {
+
+namespace {
+ABSL_CONST_INIT std::atomic<LintRuleProfile*> global_profile{nullptr};
+
+// Average time per callback, in nanoseconds.
+double NanosecondsPerCallback(const LintRuleCost& cost) {
+  if (cost.callbacks == 0) return 0.0;
+  return absl::ToDoubleNanoseconds(cost.time) / cost.callbacks;
+}
+}  // namespace
+
+void LintRuleProfile::Add(absl::string_view rule, const LintRuleCost& cost) {
+  absl::MutexLock lock(&mutex_);
+  auto found = costs_.find(rule);
+  if (found == costs_.end()) {
+    found = costs_.emplace(std::string(rule), LintRuleCost()).first;
+  }
+  found->second += cost;
+}
+
+LintRuleProfile::RankedCosts LintRuleProfile::Ranked() const {
+  RankedCosts ranked;
+  {
+    absl::MutexLock lock(&mutex_);
+    ranked.assign(costs_.begin(), costs_.end());
+  }
+  // Stable, so that ties remain ordered by name.
+  std::stable_sort(ranked.begin(), ranked.end(),
+                   [](const RankedCosts::value_type& left,
+                      const RankedCosts::value_type& right) {
+                     return left.second.time > right.second.time;
+                   });
+  return ranked;
+}
+
+void LintRuleProfile::PrintTable(std::ostream& stream) const {
+  const RankedCosts ranked(Ranked());
+  absl::Duration total;
+  for (const auto& rule : ranked) total += rule.second.time;
+
+  constexpr int kRuleWidth = 40;
+  stream << std::left << std::setw(kRuleWidth) << "rule" << std::right
+         << std::setw(12) << "callbacks" << std::setw(12) << "time ms"
+         << std::setw(8) << "%" << std::setw(12) << "ns/call" << std::endl;
+  const auto old_flags = stream.flags();
+  const auto old_precision = stream.precision();
+  stream << std::fixed << std::setprecision(2);
+  for (const auto& rule : ranked) {
+    const LintRuleCost& cost = rule.second;
+    const double share = total == absl::ZeroDuration()
+                             ? 0.0
+                             : 100.0 * absl::FDivDuration(cost.time, total);
+    stream << std::left << std::setw(kRuleWidth) << rule.first << std::right
+           << std::setw(12) << cost.callbacks << std::setw(12)
+           << absl::ToDoubleMilliseconds(cost.time) << std::setw(8) << share
+           << std::setw(12) << NanosecondsPerCallback(cost) << std::endl;
+  }
+  stream.flags(old_flags);
+  stream.precision(old_precision);
+}
+
+void LintRuleProfile::PrintJson(std::ostream& stream) const {
+  Json::Value json(Json::arrayValue);
+  for (const auto& rule : Ranked()) {
+    Json::Value entry(Json::objectValue);
+    entry["rule"] = rule.first;
+    entry["callbacks"] = Json::Int64(rule.second.callbacks);
+    entry["time_ms"] = absl::ToDoubleMilliseconds(rule.second.time);
+    json.append(entry);
+  }
+  stream << json;
+}
+
+LintRuleProfile* GlobalLintRuleProfile() {
+  return global_profile.load(std::memory_order_acquire);
+}
+
+void SetGlobalLintRuleProfile(LintRuleProfile* profile) {
+  global_profile.store(profile, std::memory_order_release);
+}
+
+}  // namespace verible
@@ -0,0 +1,142 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_COMMON_ANALYSIS_LINT_RULE_PROFILE_H_
+#define VERIBLE_COMMON_ANALYSIS_LINT_RULE_PROFILE_H_
+
+#include <chrono>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace verible {
+
+// Time spent in one lint rule, and the number of times it was called.
+struct LintRuleCost {
+  int64_t callbacks = 0;
+  absl::Duration time;
+
+  LintRuleCost& operator+=(const LintRuleCost& other) {
+    callbacks += other.callbacks;
+    time += other.time;
+    return *this;
+  }
+};
+
+// Adds the duration of its lifetime as one callback to 'cost', unless 'cost'
+// is nullptr, in which case it does nothing.
+// Linters wrap every call into a rule with this, when profiling.
+class ScopedLintRuleCost {
+ public:
+  explicit ScopedLintRuleCost(LintRuleCost* cost) : cost_(cost) {
+    if (cost_ != nullptr) start_ = std::chrono::steady_clock::now();
+  }
+
+  ~ScopedLintRuleCost() {
+    if (cost_ == nullptr) return;
+    ++cost_->callbacks;
+    cost_->time += absl::FromChrono(std::chrono::steady_clock::now() - start_);
+  }
+
+  ScopedLintRuleCost(const ScopedLintRuleCost&) = delete;
+  ScopedLintRuleCost& operator=(const ScopedLintRuleCost&) = delete;
+
+ private:
+  LintRuleCost* const cost_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Costs of the rules of one linter, indexed like its rules.
+// Disabled by default, in which case no costs are measured.
+class LintRuleCosts {
+ public:
+  // Starts measuring the costs of 'num_rules' rules.
+  void Enable(size_t num_rules) {
+    enabled_ = true;
+    costs_.resize(num_rules);
+  }
+
+  bool Enabled() const { return enabled_; }
+
+  // Makes room for the cost of a newly added rule.
+  void AddRule() {
+    if (enabled_) costs_.emplace_back();
+  }
+
+  // Returns where to accumulate the cost of the rule at 'index', for
+  // ScopedLintRuleCost, or nullptr if disabled.
+  LintRuleCost* operator[](size_t index) {
+    return enabled_ ? &costs_[index] : nullptr;
+  }
+
+  // Returns the costs of all rules, or nothing if disabled.
+  const std::vector<LintRuleCost>& Costs() const { return costs_; }
+
+ private:
+  bool enabled_ = false;
+  std::vector<LintRuleCost> costs_;
+};
+
+// Thread-safe accumulator of LintRuleCosts by rule name, e.g. over all files
+// of a lint run.
+class LintRuleProfile {
+ public:
+  // Rules with their costs, most expensive first.
+  using RankedCosts = std::vector<std::pair<std::string, LintRuleCost>>;
+
+  LintRuleProfile() = default;
+
+  LintRuleProfile(const LintRuleProfile&) = delete;
+  LintRuleProfile& operator=(const LintRuleProfile&) = delete;
+
+  // Adds 'cost' to the totals of 'rule'.
+  void Add(absl::string_view rule, const LintRuleCost& cost);
+
+  // Returns all rules by descending time (then by name).
+  RankedCosts Ranked() const;
+
+  // Prints Ranked() as a human-readable table, including each rule's share
+  // of the total time of all rules.
+  void PrintTable(std::ostream& stream) const;
+
+  // Prints Ranked() as a JSON array.
+  void PrintJson(std::ostream& stream) const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  std::map<std::string, LintRuleCost, std::less<>> costs_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+// Returns the profile into which linters record rule costs, or nullptr if
+// rule profiling is disabled (the default).
+LintRuleProfile* GlobalLintRuleProfile();
+
+// Sets the profile into which linters record rule costs.  Pass nullptr to
+// disable profiling.  Linters created afterwards are affected.
+void SetGlobalLintRuleProfile(LintRuleProfile* profile);
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_ANALYSIS_LINT_RULE_PROFILE_H_
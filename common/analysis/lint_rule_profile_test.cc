@@ -0,0 +1,120 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/analysis/lint_rule_profile.h"
+
+#include <sstream>
+#include <string>
+
+#include "absl/strings/match.h"
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "json/json.h"
+
+namespace verible {
+namespace {
+
+LintRuleCost Cost(int64_t callbacks, absl::Duration time) {
+  LintRuleCost cost;
+  cost.callbacks = callbacks;
+  cost.time = time;
+  return cost;
+}
+
+TEST(ScopedLintRuleCostTest, NullCostIsIgnored) {
+  const ScopedLintRuleCost cost(nullptr);
+}
+
+TEST(ScopedLintRuleCostTest, CountsCallbacksAndTime) {
+  LintRuleCost cost;
+  for (int i = 0; i < 3; ++i) {
+    const ScopedLintRuleCost scoped(&cost);
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  EXPECT_EQ(cost.callbacks, 3);
+  EXPECT_GE(cost.time, absl::Milliseconds(3));
+}
+
+TEST(LintRuleCostsTest, DisabledByDefault) {
+  LintRuleCosts costs;
+  costs.AddRule();
+  EXPECT_FALSE(costs.Enabled());
+  EXPECT_EQ(costs[0], nullptr);
+  EXPECT_TRUE(costs.Costs().empty());
+}
+
+TEST(LintRuleCostsTest, EnabledCostsFollowRules) {
+  LintRuleCosts costs;
+  costs.Enable(2);
+  costs.AddRule();
+  ASSERT_EQ(costs.Costs().size(), 3);
+  ASSERT_NE(costs[2], nullptr);
+  costs[2]->callbacks = 5;
+  EXPECT_EQ(costs.Costs()[2].callbacks, 5);
+}
+
+TEST(LintRuleProfileTest, RanksByTime) {
+  LintRuleProfile profile;
+  profile.Add("cheap", Cost(10, absl::Microseconds(1)));
+  profile.Add("pricey", Cost(1, absl::Milliseconds(1)));
+  profile.Add("cheap", Cost(5, absl::Microseconds(2)));
+  profile.Add("a-tie", Cost(1, absl::Microseconds(3)));
+
+  const auto ranked = profile.Ranked();
+  ASSERT_EQ(ranked.size(), 3);
+  EXPECT_EQ(ranked[0].first, "pricey");
+  // Ties are ordered by name.
+  EXPECT_EQ(ranked[1].first, "a-tie");
+  EXPECT_EQ(ranked[2].first, "cheap");
+  EXPECT_EQ(ranked[2].second.callbacks, 15);
+  EXPECT_EQ(ranked[2].second.time, absl::Microseconds(3));
+}
+
+TEST(LintRuleProfileTest, PrintTable) {
+  LintRuleProfile profile;
+  profile.Add("rule-a", Cost(4, absl::Milliseconds(3)));
+  profile.Add("rule-b", Cost(2, absl::Milliseconds(1)));
+  std::ostringstream stream;
+  profile.PrintTable(stream);
+  const std::string table(stream.str());
+  EXPECT_TRUE(absl::StrContains(table, "rule-a"));
+  EXPECT_TRUE(absl::StrContains(table, "75.00"));  // share of rule-a
+  EXPECT_LT(table.find("rule-a"), table.find("rule-b"));
+}
+
+TEST(LintRuleProfileTest, PrintJson) {
+  LintRuleProfile profile;
+  profile.Add("rule-a", Cost(4, absl::Milliseconds(3)));
+  std::ostringstream output;
+  profile.PrintJson(output);
+  std::istringstream input(output.str());
+  Json::Value json;
+  input >> json;
+  ASSERT_EQ(json.size(), 1);
+  EXPECT_EQ(json[0]["rule"].asString(), "rule-a");
+  EXPECT_EQ(json[0]["callbacks"].asInt64(), 4);
+  EXPECT_DOUBLE_EQ(json[0]["time_ms"].asDouble(), 3.0);
+}
+
+TEST(GlobalLintRuleProfileTest, SetAndReset) {
+  EXPECT_EQ(GlobalLintRuleProfile(), nullptr);
+  LintRuleProfile profile;
+  SetGlobalLintRuleProfile(&profile);
+  EXPECT_EQ(GlobalLintRuleProfile(), &profile);
+  SetGlobalLintRuleProfile(nullptr);
+  EXPECT_EQ(GlobalLintRuleProfile(), nullptr);
+}
+
+}  // namespace
+}  // namespace verible
@@ -61,6 +61,14 @@ class Matcher {
           const SymbolTransformer& t)
       : predicate_(p), inner_match_handler_(handler), transformer_(t) {}
 
+  // Matcher whose predicate only accepts symbols with the given tag.
+  // Unlike an equivalent opaque predicate, this lets users like
+  // SyntaxTreeMatchEngine skip this matcher on all other symbols.
+  Matcher(SymbolTag tag, const InnerMatchHandler& handler)
+      : predicate_([tag](const Symbol& symbol) { return symbol.Tag() == tag; }),
+        inner_match_handler_(handler),
+        required_tag_(tag) {}
+
   // Returns true if this and all submatchers match on symbol.
   // Returns false otherwise.
   // If this and all submatchers match, adds their bound symbols to manager
@@ -78,6 +86,9 @@ class Matcher {
     AddMatchers(std::forward<Args>(args)...);
   }
 
+  // If set, this matcher can only match symbols with this tag.
+  const absl::optional<SymbolTag>& RequiredTag() const { return required_tag_; }
+
  private:
   // Contains all inner matchers.
   std::vector<Matcher> inner_matchers_;
@@ -100,6 +111,9 @@ class Matcher {
   // If present when Matches is called, symbol will be bound to its value
   // If null_opt, then symbol will not be
   absl::optional<std::string> bind_id_ = absl::nullopt;
+
+  // If present, predicate_ only accepts symbols with this tag.
+  absl::optional<SymbolTag> required_tag_ = absl::nullopt;
 };
 
 // BindableMatcher is a subclass of matcher that enables setting
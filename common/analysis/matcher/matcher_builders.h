@@ -137,7 +137,7 @@ class TagMatchBuilder {
 
   template <typename... Args>
   BindableMatcher operator()(Args... args) const {
-    BindableMatcher matcher(EqualTagPredicate<Kind, EnumType, Tag>,
+    BindableMatcher matcher(SymbolTag{Kind, static_cast<int>(Tag)},
                             InnerMatchAll);
     matcher.AddMatchers(std::forward<Args>(args)...);
     return matcher;
@@ -169,8 +169,7 @@ class DynamicTagMatchBuilder {
 
   template <typename... Args>
   BindableMatcher operator()(Args... args) const {
-    BindableMatcher matcher([this](const Symbol& s) { return s.Tag() == tag_; },
-                            InnerMatchAll);
+    BindableMatcher matcher(tag_, InnerMatchAll);
     matcher.AddMatchers(std::forward<Args>(args)...);
     return matcher;
   }
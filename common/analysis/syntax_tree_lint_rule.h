@@ -15,7 +15,12 @@
 #ifndef VERIBLE_COMMON_ANALYSIS_SYNTAX_TREE_LINT_RULE_H_
 #define VERIBLE_COMMON_ANALYSIS_SYNTAX_TREE_LINT_RULE_H_
 
+#include <cstddef>
+#include <vector>
+
 #include "common/analysis/lint_rule.h"
+#include "common/analysis/matcher/bound_symbol_manager.h"
+#include "common/analysis/matcher/matcher.h"
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/symbol.h"
@@ -33,6 +38,12 @@ namespace verible {
 // See verible/doc/style_lint.md
 // for a guide to implementing new syntax tree rules.
 //
+// Rules that only look for symbols that match a fixed set of matchers should
+// return those matchers from Matchers(), and handle their matches in
+// HandleMatch(), instead of running their matchers on every symbol in
+// HandleSymbol().  The linter evaluates the matchers of all rules together,
+// testing each symbol only against matchers that can match its tag.
+//
 // Note that context is a stack nodes representing the ancestors of the
 // Symbol currented being operated on. Most recent ancestors are at the
 // top of the stack/back of vector.
@@ -46,6 +57,16 @@ class SyntaxTreeLintRule : public LintRule {
                           const SyntaxTreeContext& context) {}
   virtual void HandleSymbol(const Symbol& node,
                             const SyntaxTreeContext& context) {}
+
+  // Returns the matchers whose matches are passed to HandleMatch().
+  // This is called once, when the rule is added to a linter.
+  virtual std::vector<matcher::Matcher> Matchers() const { return {}; }
+
+  // Called on every symbol that is matched by Matchers()[matcher_index],
+  // with the symbols bound by that match.
+  virtual void HandleMatch(size_t matcher_index, const Symbol& symbol,
+                           const matcher::BoundSymbolManager& manager,
+                           const SyntaxTreeContext& context) {}
 };
 
 }  // namespace verible
@@ -14,10 +14,13 @@
 
 #include "common/analysis/syntax_tree_linter.h"
 
+#include <cstddef>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "common/analysis/lint_rule_status.h"
+#include "common/analysis/matcher/bound_symbol_manager.h"
 #include "common/analysis/syntax_tree_lint_rule.h"
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/concrete_syntax_tree.h"
@@ -27,10 +30,32 @@
 
 namespace verible {
 
+void SyntaxTreeLinter::AddRule(std::unique_ptr<SyntaxTreeLintRule> rule) {
+  SyntaxTreeLintRule* const handler = ABSL_DIE_IF_NULL(rule.get());
+  const auto matchers = handler->Matchers();
+  for (size_t i = 0; i < matchers.size(); ++i) {
+    match_engine_.AddMatcher(
+        matchers[i],
+        [handler, i](const Symbol& symbol,
+                     const matcher::BoundSymbolManager& manager,
+                     const SyntaxTreeContext& context) {
+          handler->HandleMatch(i, symbol, manager, context);
+        },
+        rules_.size());
+  }
+  rules_.emplace_back(std::move(rule));
+  rule_costs_.AddRule();
+}
+
+void SyntaxTreeLinter::EnableProfiling() {
+  rule_costs_.Enable(rules_.size());
+  match_engine_.ProfileOwners(&rule_costs_);
+}
+
 void SyntaxTreeLinter::Lint(const Symbol& root) {
   VLOG(1) << "SyntaxTreeLinter analyzing syntax tree with " << rules_.size()
           << " rules.";
-  root.Accept(this);
+  Traverse(root);
 }
 
 std::vector<LintRuleStatus> SyntaxTreeLinter::ReportStatus() const {
@@ -42,26 +67,27 @@ std::vector<LintRuleStatus> SyntaxTreeLinter::ReportStatus() const {
 }
 
 // Visits a leaf. Every held rule handles that leaf.
-void SyntaxTreeLinter::Visit(const SyntaxTreeLeaf& leaf) {
-  for (const auto& rule : rules_) {
+void SyntaxTreeLinter::VisitLeaf(const SyntaxTreeLeaf& leaf) {
+  for (size_t i = 0; i < rules_.size(); ++i) {
+    const ScopedLintRuleCost cost(rule_costs_[i]);
     // Have rule handle the leaf as both a leaf and a symbol.
-    ABSL_DIE_IF_NULL(rule)->HandleLeaf(leaf, Context());
-    rule->HandleSymbol(leaf, Context());
+    ABSL_DIE_IF_NULL(rules_[i])->HandleLeaf(leaf, Context());
+    rules_[i]->HandleSymbol(leaf, Context());
   }
+  match_engine_.MatchSymbol(leaf, Context());
 }
 
-// Visits a node. First, linter has every rule handle that node
-// Second, linter recurses on every non-null child of that node in order
-// to visit the entire tree
-void SyntaxTreeLinter::Visit(const SyntaxTreeNode& node) {
-  for (const auto& rule : rules_) {
+// Visits a node. Every held rule handles that node, before the traversal
+// continues on every non-null child of that node, in order to visit the
+// entire tree.
+void SyntaxTreeLinter::VisitNode(const SyntaxTreeNode& node) {
+  for (size_t i = 0; i < rules_.size(); ++i) {
+    const ScopedLintRuleCost cost(rule_costs_[i]);
     // Have rule handle the node as both a node and a symbol.
-    ABSL_DIE_IF_NULL(rule)->HandleNode(node, Context());
-    rule->HandleSymbol(node, Context());
+    ABSL_DIE_IF_NULL(rules_[i])->HandleNode(node, Context());
+    rules_[i]->HandleSymbol(node, Context());
   }
-
-  // Visit subtree children.
-  TreeContextVisitor::Visit(node);
+  match_engine_.MatchSymbol(node, Context());
 }
 
 }  // namespace verible
@@ -23,8 +23,10 @@
 #include <utility>
 #include <vector>
 
+#include "common/analysis/lint_rule_profile.h"
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/syntax_tree_lint_rule.h"
+#include "common/analysis/syntax_tree_match_engine.h"
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/symbol.h"
@@ -47,17 +49,12 @@ namespace verible {
 //
 // Note that the tree is traversed in a preorder traversal.
 //
-class SyntaxTreeLinter : public TreeContextVisitor {
+class SyntaxTreeLinter : public IterativeTreeContextVisitor {
  public:
   SyntaxTreeLinter() : rules_() {}
 
-  void Visit(const SyntaxTreeLeaf& leaf) override;
-  void Visit(const SyntaxTreeNode& node) override;
-
   // Transfers ownership of rule into Linter
-  void AddRule(std::unique_ptr<SyntaxTreeLintRule> rule) {
-    rules_.emplace_back(std::move(rule));
-  }
+  void AddRule(std::unique_ptr<SyntaxTreeLintRule> rule);
 
   // Aggregates results of each held LintRule
   std::vector<LintRuleStatus> ReportStatus() const;
@@ -65,10 +62,28 @@ class SyntaxTreeLinter : public TreeContextVisitor {
   // Performs lint analysis on root
   void Lint(const Symbol& root);
 
+  // Starts measuring the time spent in each rule, see RuleCosts().
+  void EnableProfiling();
+
+  // Returns the costs of the rules, in the same order as ReportStatus(), or
+  // nothing if profiling is not enabled.
+  const std::vector<LintRuleCost>& RuleCosts() const {
+    return rule_costs_.Costs();
+  }
+
  private:
+  void VisitLeaf(const SyntaxTreeLeaf& leaf) override;
+  void VisitNode(const SyntaxTreeNode& node) override;
+
   // List of rules that the linter is using. Rules are responsible for tracking
   // their own internal state.
   std::vector<std::unique_ptr<SyntaxTreeLintRule>> rules_;
+
+  // Evaluates the Matchers() of all rules in the same traversal.
+  SyntaxTreeMatchEngine match_engine_;
+
+  // Time spent in each rule (handlers and matchers), when profiling.
+  LintRuleCosts rule_costs_;
 };
 
 }  // namespace verible
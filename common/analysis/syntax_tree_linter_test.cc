@@ -18,6 +18,9 @@
 #include <vector>
 
 #include "common/analysis/lint_rule_status.h"
+#include "common/analysis/matcher/bound_symbol_manager.h"
+#include "common/analysis/matcher/matcher.h"
+#include "common/analysis/matcher/matcher_builders.h"
 #include "common/analysis/syntax_tree_lint_rule.h"
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/concrete_syntax_tree.h"
@@ -25,6 +28,7 @@
 #include "common/text/syntax_tree_context.h"
 #include "common/text/token_info.h"
 #include "common/text/tree_builder_test_util.h"
+#include "common/text/tree_utils.h"
 #include "gtest/gtest.h"
 
 namespace verible {
@@ -275,5 +279,79 @@ TEST(SyntaxTreeLinterTest, DepthSuccess) {
   EXPECT_EQ(statuses[0].violations.size(), 0);
 }
 
+// Simple testing rule that uses matchers: leaves tagged 3 are forbidden,
+// and so are leaves tagged 4 directly under nodes tagged 5.
+class ForbiddenLeavesByMatcher : public SyntaxTreeLintRule {
+ public:
+  std::vector<matcher::Matcher> Matchers() const override {
+    return {
+        matcher::TagMatchBuilder<SymbolKind::kLeaf, int, 3>()(),
+        matcher::TagMatchBuilder<SymbolKind::kNode, int, 5>()(
+            matcher::MakePathMatcher({LeafTag(4)})().Bind("leaf")),
+    };
+  }
+
+  void HandleMatch(size_t matcher_index, const Symbol& symbol,
+                   const matcher::BoundSymbolManager& manager,
+                   const SyntaxTreeContext& context) override {
+    const Symbol* leaf =
+        matcher_index == 0 ? &symbol : manager.FindSymbol("leaf");
+    ASSERT_NE(leaf, nullptr);
+    violations_.insert(
+        LintViolation(SymbolCastToLeaf(*leaf).get(), "", context));
+  }
+
+  LintRuleStatus Report() const override { return LintRuleStatus(violations_); }
+
+ private:
+  std::set<LintViolation> violations_;
+};
+
+TEST(SyntaxTreeLinterTest, MatcherRule) {
+  constexpr absl::string_view text("abcde");
+  SymbolPtr root = TNode(0, Leaf(3, text.substr(0, 1)),
+                         TNode(5, Leaf(4, text.substr(1, 1))),
+                         TNode(6, Leaf(4, text.substr(2, 1))),
+                         Leaf(3, text.substr(3, 1)), Leaf(1, text.substr(4)));
+  SyntaxTreeLinter linter;
+  linter.AddRule(std::unique_ptr<SyntaxTreeLintRule>(
+      new ForbiddenLeavesByMatcher()));
+  linter.AddRule(MakeRuleN(1));
+  linter.Lint(*root);
+
+  std::vector<LintRuleStatus> statuses = linter.ReportStatus();
+  ASSERT_EQ(statuses.size(), 2);
+  EXPECT_EQ(statuses[0].violations.size(), 3);
+  EXPECT_EQ(statuses[1].violations.size(), 4);
+}
+
+TEST(SyntaxTreeLinterTest, NoProfilingByDefault) {
+  SymbolPtr root = Node(XLeaf(2));
+  SyntaxTreeLinter linter;
+  linter.AddRule(MakeRuleN(2));
+  linter.Lint(*root);
+  EXPECT_TRUE(linter.RuleCosts().empty());
+}
+
+TEST(SyntaxTreeLinterTest, ProfilingCountsHandlersAndMatchers) {
+  constexpr absl::string_view text("abcde");
+  SymbolPtr root = TNode(0, Leaf(3, text.substr(0, 1)),
+                         TNode(5, Leaf(4, text.substr(1, 1))),
+                         TNode(6, Leaf(4, text.substr(2, 1))),
+                         Leaf(3, text.substr(3, 1)), Leaf(1, text.substr(4)));
+  SyntaxTreeLinter linter;
+  linter.AddRule(std::unique_ptr<SyntaxTreeLintRule>(
+      new ForbiddenLeavesByMatcher()));
+  linter.EnableProfiling();
+  linter.AddRule(MakeRuleN(1));  // added after enabling
+  linter.Lint(*root);
+
+  const std::vector<LintRuleCost>& costs = linter.RuleCosts();
+  ASSERT_EQ(costs.size(), 2);
+  // 8 symbols, plus 2 leaves tagged 3 and 1 node tagged 5 for the matchers.
+  EXPECT_EQ(costs[0].callbacks, 8 + 3);
+  EXPECT_EQ(costs[1].callbacks, 8);
+}
+
 }  // namespace
 }  // namespace verible
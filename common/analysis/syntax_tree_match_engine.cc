@@ -0,0 +1,85 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/analysis/syntax_tree_match_engine.h"
+
+#include <utility>
+#include <vector>
+
+namespace verible {
+
+void SyntaxTreeMatchEngine::AddMatcher(const matcher::Matcher& matcher,
+                                       SyntaxTreeMatchHandler handler,
+                                       size_t owner) {
+  const size_t index = entries_.size();
+  entries_.push_back(Entry{matcher, std::move(handler), owner});
+  const auto& tag = matcher.RequiredTag();
+  if (!tag.has_value() || tag->tag < 0) {
+    untagged_matchers_.push_back(index);
+    return;
+  }
+  auto& table =
+      tag->kind == SymbolKind::kNode ? node_matchers_ : leaf_matchers_;
+  if (static_cast<size_t>(tag->tag) >= table.size()) {
+    table.resize(tag->tag + 1);
+  }
+  table[tag->tag].push_back(index);
+}
+
+const std::vector<size_t>& SyntaxTreeMatchEngine::TaggedCandidates(
+    const SymbolTag& tag) const {
+  static const std::vector<size_t> kNone;
+  const auto& table =
+      tag.kind == SymbolKind::kNode ? node_matchers_ : leaf_matchers_;
+  if (tag.tag < 0 || static_cast<size_t>(tag.tag) >= table.size()) {
+    return kNone;
+  }
+  return table[tag.tag];
+}
+
+void SyntaxTreeMatchEngine::MatchSymbol(const Symbol& symbol,
+                                        const SyntaxTreeContext& context) {
+  const std::vector<size_t>& tagged(TaggedCandidates(symbol.Tag()));
+  // Merge both (sorted) candidate lists, to deliver matches in order of
+  // registration.
+  auto tagged_iter = tagged.begin();
+  auto untagged_iter = untagged_matchers_.begin();
+  while (tagged_iter != tagged.end() ||
+         untagged_iter != untagged_matchers_.end()) {
+    size_t index;
+    if (untagged_iter == untagged_matchers_.end() ||
+        (tagged_iter != tagged.end() && *tagged_iter < *untagged_iter)) {
+      index = *tagged_iter++;
+    } else {
+      index = *untagged_iter++;
+    }
+    const Entry& entry(entries_[index]);
+    const ScopedLintRuleCost cost(
+        owner_costs_ == nullptr ? nullptr : (*owner_costs_)[entry.owner]);
+    manager_.Clear();
+    if (entry.matcher.Matches(symbol, &manager_)) {
+      entry.handler(symbol, manager_, context);
+    }
+  }
+}
+
+void SyntaxTreeMatchEngine::VisitLeaf(const SyntaxTreeLeaf& leaf) {
+  MatchSymbol(leaf, Context());
+}
+
+void SyntaxTreeMatchEngine::VisitNode(const SyntaxTreeNode& node) {
+  MatchSymbol(node, Context());
+}
+
+}  // namespace verible
@@ -0,0 +1,119 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_COMMON_ANALYSIS_SYNTAX_TREE_MATCH_ENGINE_H_
+#define VERIBLE_COMMON_ANALYSIS_SYNTAX_TREE_MATCH_ENGINE_H_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "common/analysis/lint_rule_profile.h"
+#include "common/analysis/matcher/bound_symbol_manager.h"
+#include "common/analysis/matcher/matcher.h"
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
+#include "common/text/syntax_tree_context.h"
+#include "common/text/tree_context_visitor.h"
+
+namespace verible {
+
+// Called for every symbol matched by a matcher, with the symbols bound by the
+// match, and the ancestors of the matched symbol.
+using SyntaxTreeMatchHandler =
+    std::function<void(const Symbol&, const matcher::BoundSymbolManager&,
+                       const SyntaxTreeContext&)>;
+
+// SyntaxTreeMatchEngine evaluates any number of matchers over a syntax tree
+// in a single traversal.
+//
+// Matchers are indexed by the tag of the symbols that they can match
+// (Matcher::RequiredTag()), so that each symbol is only tested against the
+// matchers that can possibly match it, instead of against every matcher.
+// Matchers without a required tag are tested against every symbol.
+// On each symbol, matches are delivered in the order in which the matchers
+// were added.
+//
+// Usage:
+//   SyntaxTreeMatchEngine engine;
+//   engine.AddMatcher(NodekModuleDeclaration(), [](const Symbol& symbol,
+//       const BoundSymbolManager& manager, const SyntaxTreeContext& context) {
+//     ...
+//   });
+//   ... add more matchers ...
+//   engine.Match(root);
+//
+class SyntaxTreeMatchEngine : public IterativeTreeContextVisitor {
+ public:
+  SyntaxTreeMatchEngine() = default;
+
+  SyntaxTreeMatchEngine(const SyntaxTreeMatchEngine&) = delete;
+  SyntaxTreeMatchEngine& operator=(const SyntaxTreeMatchEngine&) = delete;
+
+  // Registers a matcher (which is copied), whose matches are passed to
+  // 'handler'.  'owner' identifies the client that registered the matcher,
+  // for ProfileOwners().
+  void AddMatcher(const matcher::Matcher& matcher,
+                  SyntaxTreeMatchHandler handler, size_t owner = 0);
+
+  // Accumulates the time spent evaluating each matcher, including its
+  // handler, into the cost of its owner in 'costs'.  Pass nullptr to stop.
+  void ProfileOwners(LintRuleCosts* costs) { owner_costs_ = costs; }
+
+  // Number of registered matchers.
+  size_t NumMatchers() const { return entries_.size(); }
+
+  // Evaluates all matchers on every symbol under (and including) 'root',
+  // in pre-order.
+  void Match(const Symbol& root) { Traverse(root); }
+
+  // Evaluates all matchers on a single 'symbol', whose ancestors are
+  // 'context'.  This is for clients that already traverse the tree.
+  void MatchSymbol(const Symbol& symbol, const SyntaxTreeContext& context);
+
+ private:
+  void VisitLeaf(const SyntaxTreeLeaf& leaf) override;
+  void VisitNode(const SyntaxTreeNode& node) override;
+
+  struct Entry {
+    matcher::Matcher matcher;
+    SyntaxTreeMatchHandler handler;
+    size_t owner;
+  };
+
+  // Returns the (ordered) indices of matchers that require 'tag'.
+  const std::vector<size_t>& TaggedCandidates(const SymbolTag& tag) const;
+
+  // All registered matchers, in order of registration.
+  std::vector<Entry> entries_;
+
+  // Indices into entries_ of matchers that require a specific node tag
+  // (or leaf tag), indexed by that tag.
+  std::vector<std::vector<size_t>> node_matchers_;
+  std::vector<std::vector<size_t>> leaf_matchers_;
+
+  // Indices into entries_ of matchers without a required tag.
+  std::vector<size_t> untagged_matchers_;
+
+  // Re-used for every match attempt.
+  matcher::BoundSymbolManager manager_;
+
+  // Costs by owner, when profiling (not owned).
+  LintRuleCosts* owner_costs_ = nullptr;
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_ANALYSIS_SYNTAX_TREE_MATCH_ENGINE_H_
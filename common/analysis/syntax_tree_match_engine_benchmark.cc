@@ -0,0 +1,129 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares SyntaxTreeMatchEngine against testing every matcher on every
+// symbol, on a synthetic tree, for increasing numbers of matchers.
+
+#include <cstddef>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/analysis/matcher/bound_symbol_manager.h"
+#include "common/analysis/matcher/matcher.h"
+#include "common/analysis/matcher/matcher_builders.h"
+#include "common/analysis/syntax_tree_match_engine.h"
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
+#include "common/text/syntax_tree_context.h"
+#include "common/text/tree_builder_test_util.h"
+#include "common/text/tree_context_visitor.h"
+#include "common/text/tree_utils.h"
+
+namespace verible {
+namespace {
+
+constexpr int kNumNodeTags = 64;
+constexpr int kNumLeafTags = 32;
+
+// Builds a tree with (fanout^depth) leaves, with tags that cycle through
+// kNumNodeTags and kNumLeafTags.
+SymbolPtr MakeTree(int depth, int fanout, int* counter) {
+  const int id = (*counter)++;
+  if (depth == 0) return XLeaf(id % kNumLeafTags);
+  SymbolPtr node = TNode(id % kNumNodeTags);
+  for (int i = 0; i < fanout; ++i) {
+    SymbolCastToNode(*node).AppendChild(MakeTree(depth - 1, fanout, counter));
+  }
+  return node;
+}
+
+const Symbol& BenchmarkTree() {
+  static const Symbol* const tree = [] {
+    int counter = 0;
+    return MakeTree(7, 6, &counter).release();  // ~336k symbols
+  }();
+  return *tree;
+}
+
+// Alternates node and leaf matchers over different tags.
+std::vector<matcher::Matcher> MakeMatchers(int count) {
+  std::vector<matcher::Matcher> matchers;
+  for (int i = 0; i < count; ++i) {
+    const SymbolTag tag = (i % 2 == 0) ? NodeTag(i / 2 % kNumNodeTags)
+                                       : LeafTag(i / 2 % kNumLeafTags);
+    matchers.push_back(matcher::DynamicTagMatchBuilder(tag)());
+  }
+  return matchers;
+}
+
+// Tests every matcher on every symbol, which is what rules do when each
+// runs its own matcher from HandleSymbol().
+class EveryMatcherVisitor : public IterativeTreeContextVisitor {
+ public:
+  explicit EveryMatcherVisitor(const std::vector<matcher::Matcher>& matchers)
+      : matchers_(matchers) {}
+
+  size_t NumMatches() const { return num_matches_; }
+
+ private:
+  void VisitLeaf(const SyntaxTreeLeaf& leaf) override { MatchAll(leaf); }
+
+  void VisitNode(const SyntaxTreeNode& node) override { MatchAll(node); }
+
+  void MatchAll(const Symbol& symbol) {
+    for (const auto& matcher : matchers_) {
+      matcher::BoundSymbolManager manager;
+      if (matcher.Matches(symbol, &manager)) ++num_matches_;
+    }
+  }
+
+  const std::vector<matcher::Matcher>& matchers_;
+  size_t num_matches_ = 0;
+};
+
+void BM_EveryMatcherOnEverySymbol(benchmark::State& state) {
+  const Symbol& tree = BenchmarkTree();
+  const auto matchers = MakeMatchers(state.range(0));
+  for (auto _ : state) {
+    EveryMatcherVisitor visitor(matchers);
+    visitor.Traverse(tree);
+    benchmark::DoNotOptimize(visitor.NumMatches());
+  }
+}
+BENCHMARK(BM_EveryMatcherOnEverySymbol)->RangeMultiplier(4)->Range(1, 64);
+
+void BM_SyntaxTreeMatchEngine(benchmark::State& state) {
+  const Symbol& tree = BenchmarkTree();
+  size_t num_matches = 0;
+  SyntaxTreeMatchEngine engine;
+  for (const auto& matcher : MakeMatchers(state.range(0))) {
+    engine.AddMatcher(matcher,
+                      [&num_matches](const Symbol&,
+                                     const matcher::BoundSymbolManager&,
+                                     const SyntaxTreeContext&) {
+                        ++num_matches;
+                      });
+  }
+  for (auto _ : state) {
+    engine.Match(tree);
+    benchmark::DoNotOptimize(num_matches);
+  }
+}
+BENCHMARK(BM_SyntaxTreeMatchEngine)->RangeMultiplier(4)->Range(1, 64);
+
+}  // namespace
+}  // namespace verible
+
+BENCHMARK_MAIN();
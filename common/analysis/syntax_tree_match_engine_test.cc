@@ -0,0 +1,169 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/analysis/syntax_tree_match_engine.h"
+
+#include <utility>
+#include <vector>
+
+#include "common/analysis/matcher/bound_symbol_manager.h"
+#include "common/analysis/matcher/matcher.h"
+#include "common/analysis/matcher/matcher_builders.h"
+#include "common/analysis/syntax_tree_search.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
+#include "common/text/syntax_tree_context.h"
+#include "common/text/tree_builder_test_util.h"
+#include "common/text/tree_utils.h"
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace {
+
+using matcher::BoundSymbolManager;
+using matcher::Matcher;
+
+template <int NodeTag>
+using NodeMatcher = matcher::TagMatchBuilder<SymbolKind::kNode, int, NodeTag>;
+
+template <int LeafTag>
+using LeafMatcher = matcher::TagMatchBuilder<SymbolKind::kLeaf, int, LeafTag>;
+
+// Records (matcher id, matched symbol) pairs, in order of delivery.
+using MatchLog = std::vector<std::pair<int, const Symbol*>>;
+
+SyntaxTreeMatchHandler Record(int id, MatchLog* log) {
+  return [=](const Symbol& symbol, const BoundSymbolManager&,
+             const SyntaxTreeContext&) { log->emplace_back(id, &symbol); };
+}
+
+TEST(SyntaxTreeMatchEngineTest, NoMatchers) {
+  auto tree = TNode(0, XLeaf(1));
+  SyntaxTreeMatchEngine engine;
+  EXPECT_EQ(engine.NumMatchers(), 0);
+  engine.Match(*tree);  // does nothing
+}
+
+TEST(SyntaxTreeMatchEngineTest, TaggedMatchersAreIndexed) {
+  EXPECT_TRUE(NodeMatcher<3>()().RequiredTag().has_value());
+  EXPECT_TRUE(LeafMatcher<3>()().RequiredTag().has_value());
+  const Matcher untagged([](const Symbol&) { return true; },
+                         matcher::InnerMatchAll);
+  EXPECT_FALSE(untagged.RequiredTag().has_value());
+}
+
+TEST(SyntaxTreeMatchEngineTest, NodeAndLeafTagsAreDistinct) {
+  auto tree = TNode(1, XLeaf(1), TNode(2, XLeaf(2)));
+  const Symbol* leaf1 = SymbolCastToNode(*tree).children()[0].get();
+  const Symbol* node2 = SymbolCastToNode(*tree).children()[1].get();
+  const Symbol* leaf2 = SymbolCastToNode(*node2).children()[0].get();
+
+  MatchLog log;
+  SyntaxTreeMatchEngine engine;
+  engine.AddMatcher(NodeMatcher<1>()(), Record(0, &log));
+  engine.AddMatcher(LeafMatcher<2>()(), Record(1, &log));
+  engine.AddMatcher(NodeMatcher<2>()(), Record(2, &log));
+  engine.AddMatcher(LeafMatcher<1>()(), Record(3, &log));
+  engine.AddMatcher(LeafMatcher<7>()(), Record(4, &log));
+  EXPECT_EQ(engine.NumMatchers(), 5);
+  engine.Match(*tree);
+
+  const MatchLog expected{
+      {0, tree.get()}, {3, leaf1}, {2, node2}, {1, leaf2}};
+  EXPECT_EQ(log, expected);
+}
+
+TEST(SyntaxTreeMatchEngineTest, MatchesAreDeliveredInRegistrationOrder) {
+  auto tree = TNode(4);
+  MatchLog log;
+  SyntaxTreeMatchEngine engine;
+  const Matcher any([](const Symbol&) { return true; },
+                    matcher::InnerMatchAll);
+  engine.AddMatcher(NodeMatcher<4>()(), Record(0, &log));
+  engine.AddMatcher(any, Record(1, &log));
+  engine.AddMatcher(NodeMatcher<4>()(), Record(2, &log));
+  engine.AddMatcher(any, Record(3, &log));
+  engine.AddMatcher(NodeMatcher<5>()(), Record(4, &log));
+  engine.Match(*tree);
+
+  const MatchLog expected{
+      {0, tree.get()}, {1, tree.get()}, {2, tree.get()}, {3, tree.get()}};
+  EXPECT_EQ(log, expected);
+}
+
+TEST(SyntaxTreeMatchEngineTest, InnerMatchersAndBindings) {
+  auto tree = TNode(0, TNode(1, XLeaf(5)), TNode(1, XLeaf(6)));
+  const Symbol* inner =
+      SymbolCastToNode(*SymbolCastToNode(*tree).children()[1]).children()[0]
+          .get();
+
+  std::vector<const Symbol*> bound;
+  SyntaxTreeMatchEngine engine;
+  // Binds leaf 6 under node 1.
+  engine.AddMatcher(
+      NodeMatcher<1>()(matcher::MakePathMatcher({LeafTag(6)})().Bind("leaf")),
+      [&](const Symbol&, const BoundSymbolManager& manager,
+          const SyntaxTreeContext&) {
+        bound.push_back(manager.FindSymbol("leaf"));
+      });
+  engine.Match(*tree);
+  ASSERT_EQ(bound.size(), 1);
+  EXPECT_EQ(bound.front(), inner);
+}
+
+TEST(SyntaxTreeMatchEngineTest, ContextIsPassed) {
+  auto tree = TNode(0, TNode(1, TNode(2)));
+  std::vector<size_t> depths;
+  SyntaxTreeMatchEngine engine;
+  engine.AddMatcher(NodeMatcher<2>()(),
+                    [&](const Symbol&, const BoundSymbolManager&,
+                        const SyntaxTreeContext& context) {
+                      depths.push_back(context.size());
+                      EXPECT_TRUE(context.DirectParentIs(1));
+                    });
+  engine.Match(*tree);
+  EXPECT_EQ(depths, std::vector<size_t>{2});
+}
+
+// Tests that the engine finds the same matches as a search per matcher.
+TEST(SyntaxTreeMatchEngineTest, AgreesWithSearchSyntaxTree) {
+  auto tree = Node(TNode(1, XLeaf(2), TNode(2, XLeaf(1), XLeaf(3))),
+                   TNode(3, TNode(1, TNode(1)), XLeaf(2)), XLeaf(1));
+  const std::vector<Matcher> matchers{
+      NodeMatcher<1>()(), NodeMatcher<2>()(), NodeMatcher<3>()(),
+      LeafMatcher<1>()(), LeafMatcher<2>()(), LeafMatcher<3>()(),
+  };
+
+  SyntaxTreeMatchEngine engine;
+  std::vector<std::vector<const Symbol*>> found(matchers.size());
+  for (size_t i = 0; i < matchers.size(); ++i) {
+    engine.AddMatcher(matchers[i], [&found, i](const Symbol& symbol,
+                                               const BoundSymbolManager&,
+                                               const SyntaxTreeContext&) {
+      found[i].push_back(&symbol);
+    });
+  }
+  engine.Match(*tree);
+
+  for (size_t i = 0; i < matchers.size(); ++i) {
+    std::vector<const Symbol*> expected;
+    for (const auto& match : SearchSyntaxTree(*tree, matchers[i])) {
+      expected.push_back(match.match);
+    }
+    EXPECT_EQ(found[i], expected) << "matcher " << i;
+  }
+}
+
+}  // namespace
+}  // namespace verible
@@ -34,21 +34,21 @@ using matcher::BoundSymbolManager;
 // SyntaxTreeSearcher collects node that match specified criteria
 // from a syntax tree.  Prefer to use the SearchSyntaxTree() function
 // over this class.
-class SyntaxTreeSearcher : public TreeContextVisitor {
+class SyntaxTreeSearcher : public IterativeTreeContextVisitor {
  public:
   SyntaxTreeSearcher(
       const matcher::Matcher& m,
       std::function<bool(const SyntaxTreeContext&)> context_predicate)
       : matcher_(m), context_predicate_(context_predicate) {}
 
-  void Search(const Symbol& root) { root.Accept(this); }
+  void Search(const Symbol& root) { Traverse(root); }
 
   const std::vector<TreeSearchMatch> Matches() const { return matches_; }
 
  private:
   void CheckSymbol(const Symbol&);
-  void Visit(const SyntaxTreeLeaf& leaf) override;
-  void Visit(const SyntaxTreeNode& node) override;
+  void VisitLeaf(const SyntaxTreeLeaf& leaf) override;
+  void VisitNode(const SyntaxTreeNode& node) override;
 
   // Main matcher that finds a particular type of tree node.
   const verible::matcher::Matcher matcher_;
@@ -71,15 +71,14 @@ void SyntaxTreeSearcher::CheckSymbol(const Symbol& symbol) {
 }
 //
 // Checks if leaf matches critera.
-void SyntaxTreeSearcher::Visit(const SyntaxTreeLeaf& leaf) {
+void SyntaxTreeSearcher::VisitLeaf(const SyntaxTreeLeaf& leaf) {
   CheckSymbol(leaf);
 }
 
 // Checks if node matches criteria.
-// Then recursively search subtree.
-void SyntaxTreeSearcher::Visit(const SyntaxTreeNode& node) {
+// The traversal continues into its subtree.
+void SyntaxTreeSearcher::VisitNode(const SyntaxTreeNode& node) {
   CheckSymbol(node);
-  TreeContextVisitor::Visit(node);
 }
 
 }  // namespace
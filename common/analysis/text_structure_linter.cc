@@ -14,6 +14,7 @@
 
 #include "common/analysis/text_structure_linter.h"
 
+#include <cstddef>
 #include <vector>
 
 #include "absl/strings/string_view.h"
@@ -28,8 +29,9 @@ void TextStructureLinter::Lint(const TextStructureView& text_structure,
                                absl::string_view filename) {
   VLOG(1) << "TextStructureLinter analyzing text with " << rules_.size()
           << " rules.";
-  for (const auto& rule : rules_) {
-    ABSL_DIE_IF_NULL(rule)->Lint(text_structure, filename);
+  for (size_t i = 0; i < rules_.size(); ++i) {
+    const ScopedLintRuleCost cost(rule_costs_[i]);
+    ABSL_DIE_IF_NULL(rules_[i])->Lint(text_structure, filename);
   }
 }
 
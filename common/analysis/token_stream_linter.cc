@@ -14,6 +14,7 @@
 
 #include "common/analysis/token_stream_linter.h"
 
+#include <cstddef>
 #include <vector>
 
 #include "common/analysis/lint_rule_status.h"
@@ -27,8 +28,9 @@ void TokenStreamLinter::Lint(const TokenSequence& tokens) {
   VLOG(1) << "TokenStreamLinter analyzing tokens with " << rules_.size()
           << " rules.";
   for (const auto& token : tokens) {
-    for (const auto& rule : rules_) {
-      ABSL_DIE_IF_NULL(rule)->HandleToken(token);
+    for (size_t i = 0; i < rules_.size(); ++i) {
+      const ScopedLintRuleCost cost(rule_costs_[i]);
+      ABSL_DIE_IF_NULL(rules_[i])->HandleToken(token);
     }
   }
 }
@@ -23,6 +23,7 @@
 #include <utility>
 #include <vector>
 
+#include "common/analysis/lint_rule_profile.h"
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/token_stream_lint_rule.h"
 #include "common/text/token_stream_view.h"
@@ -37,6 +38,16 @@ class TokenStreamLinter {
   // Transfers ownership of rule into this Linter
   void AddRule(std::unique_ptr<TokenStreamLintRule> rule) {
     rules_.emplace_back(std::move(rule));
+    rule_costs_.AddRule();
+  }
+
+  // Starts measuring the time spent in each rule, see RuleCosts().
+  void EnableProfiling() { rule_costs_.Enable(rules_.size()); }
+
+  // Returns the costs of the rules, in the same order as ReportStatus(), or
+  // nothing if profiling is not enabled.
+  const std::vector<LintRuleCost>& RuleCosts() const {
+    return rule_costs_.Costs();
   }
 
   // Aggregates results of each held LintRule
@@ -46,6 +57,9 @@ class TokenStreamLinter {
   // List of rules that the linter is using. Rules are responsible for tracking
   // their own internal state.
   std::vector<std::unique_ptr<TokenStreamLintRule>> rules_;
+
+  // Time spent in each rule, when profiling.
+  LintRuleCosts rule_costs_;
 };
 
 }  // namespace verible
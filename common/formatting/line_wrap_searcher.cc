@@ -14,10 +14,16 @@
 
 #include "common/formatting/line_wrap_searcher.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <queue>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "common/formatting/basic_format_style.h"
 #include "common/formatting/format_token.h"
@@ -30,6 +36,31 @@
 namespace verible {
 namespace {
 
+// Returns true if the decisions that lead to 'left' come before the ones that
+// lead to 'right', comparing from the first token of their UnwrappedLine, in
+// the order of SpacingDecision (appending before wrapping).
+bool PrecedesByDecisions(const StateNode& left, const StateNode& right) {
+  // Bring both to the same depth (deeper states have fewer undecided tokens).
+  const StateNode* l = &left;
+  const StateNode* r = &right;
+  while (l->undecided_path.size() < r->undecided_path.size()) {
+    l = l->prev_state.get();
+  }
+  while (r->undecided_path.size() < l->undecided_path.size()) {
+    r = r->prev_state.get();
+  }
+  if (l == r) {
+    // One path is a prefix of the other.
+    return left.undecided_path.size() > right.undecided_path.size();
+  }
+  // Compare the decisions right after the paths diverge.
+  while (l->prev_state != r->prev_state) {
+    l = l->prev_state.get();
+    r = r->prev_state.get();
+  }
+  return l->spacing_choice < r->spacing_choice;
+}
+
 // Wrapped class around StateNode for the sake of adapting to a
 // std::priority_queue interface.
 // TODO(fangism): if performance of memory allocations is an issue,
@@ -40,15 +71,172 @@ struct SearchState {
   explicit SearchState(const std::shared_ptr<const StateNode>& s) : state(s) {}
 
   // Inverted to min-heap: *lowest* penalty has the highest search priority.
-  bool operator<(const SearchState& r) const { return *r.state < *state; }
+  // Ties between equally good states are broken by their decisions, so that
+  // the search order depends only on the states themselves, and not on which
+  // other states were pruned.
+  bool operator<(const SearchState& r) const {
+    if (*r.state < *state) return true;
+    if (*state < *r.state) return false;
+    return PrecedesByDecisions(*r.state, *state);
+  }
 };
-}  // namespace
 
-std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
-                                              const BasicFormatStyle& style,
-                                              int max_search_states) {
-  // Dijkstra's algorithm for now: prioritize searching minimum penalty path
-  // until destination is reached.
+// Admissible estimate of the penalty that remains to be paid after a state:
+// it never exceeds the penalty of any way of finishing the line.
+class RemainingCostBound {
+ public:
+  RemainingCostBound(const UnwrappedLine& uwline, const BasicFormatStyle& style)
+      : tokens_begin_(uwline.TokensRange().begin()), style_(style) {
+    // suffix_bounds_[i] bounds the break penalties of tokens [i, end).
+    const auto tokens = uwline.TokensRange();
+    suffix_bounds_.resize(tokens.size() + 1, 0);
+    for (size_t i = tokens.size(); i > 0; --i) {
+      const InterTokenInfo& before = tokens[i - 1].before;
+      int bound = 0;
+      switch (before.break_decision) {
+        case SpacingOptions::MustWrap:
+          bound = before.break_penalty;
+          break;
+        case SpacingOptions::MustAppend:
+        case SpacingOptions::Preserve:
+          // Appending never costs less than 0, and preserving costs nothing.
+          break;
+        default:
+          // Either wrapped or appended.
+          bound = std::min(0, before.break_penalty);
+          break;
+      }
+      suffix_bounds_[i - 1] = suffix_bounds_[i] + bound;
+    }
+  }
+
+  int operator()(const StateNode& state) const {
+    // Tokens that must be appended right after this state land on known
+    // columns, so their overflow penalty is certain.
+    auto iter = state.undecided_path.begin();
+    const auto end = state.undecided_path.end();
+    int column = state.current_column;
+    int overflow_cost = 0;
+    for (; iter != end && iter->before.break_decision ==
+                              SpacingOptions::MustAppend;
+         ++iter) {
+      // The column after a multi-line token is not a simple sum.
+      if (absl::StrContains(iter->Text(), '\n')) break;
+      column += iter->before.spaces_required + iter->Length();
+      if (column > style_.column_limit) {
+        overflow_cost +=
+            style_.over_column_limit_penalty + column - style_.column_limit;
+      }
+    }
+    return overflow_cost + suffix_bounds_[std::distance(tokens_begin_, iter)];
+  }
+
+ private:
+  const FormatTokenRange::const_iterator tokens_begin_;
+
+  const BasicFormatStyle& style_;
+
+  std::vector<int> suffix_bounds_;
+};
+
+// States at the same token, with the same column, last decision, and wrap
+// column positions, have exactly the same ways of finishing the line, so a
+// state is dominated by an equivalent one with lower cost.
+// Equivalent states with equal cost are all kept, as they can lead to equally
+// optimal results.
+class DominanceTable {
+ public:
+  // Returns true if an equivalent of 'state' with lower cost was recorded.
+  // Otherwise records 'state', in place of any costlier equivalent.
+  bool IsDominated(const std::shared_ptr<const StateNode>& state) {
+    auto& recorded = states_[KeyOf(*state)];
+    for (auto& other : recorded) {
+      if (other->wrap_column_positions != state->wrap_column_positions) {
+        continue;
+      }
+      if (other->cumulative_cost < state->cumulative_cost) return true;
+      if (state->cumulative_cost < other->cumulative_cost) other = state;
+      return false;
+    }
+    recorded.push_back(state);
+    return false;
+  }
+
+  // Returns true if an equivalent of 'state' with lower cost was recorded
+  // after 'state', which no longer needs to be explored.
+  bool WasSuperseded(const StateNode& state) const {
+    const auto found = states_.find(KeyOf(state));
+    if (found == states_.end()) return false;
+    for (const auto& other : found->second) {
+      if (other->wrap_column_positions == state.wrap_column_positions) {
+        return other->cumulative_cost < state.cumulative_cost;
+      }
+    }
+    return false;
+  }
+
+ private:
+  using Key = std::tuple<const PreFormatToken*, int, SpacingDecision>;
+
+  static Key KeyOf(const StateNode& state) {
+    return Key(&state.GetCurrentToken(), state.current_column,
+               state.spacing_choice);
+  }
+
+  absl::flat_hash_map<Key, std::vector<std::shared_ptr<const StateNode>>>
+      states_;
+};
+
+// Returns a complete formatting that follows 'state', with the same decisions
+// that the search could make: tokens are appended while they fit, unless they
+// must be wrapped, or their spacing preserved.
+std::shared_ptr<const StateNode> GreedyFinish(
+    const std::shared_ptr<const StateNode>& state,
+    const BasicFormatStyle& style) {
+  std::shared_ptr<const StateNode> latest(state);
+  while (!latest->Done()) {
+    switch (latest->GetNextToken().before.break_decision) {
+      case SpacingOptions::Preserve:
+        latest = std::make_shared<StateNode>(latest, style,
+                                             SpacingDecision::Preserve);
+        break;
+      case SpacingOptions::MustWrap:
+        latest =
+            std::make_shared<StateNode>(latest, style, SpacingDecision::Wrap);
+        break;
+      case SpacingOptions::MustAppend:
+        latest =
+            std::make_shared<StateNode>(latest, style, SpacingDecision::Append);
+        break;
+      default: {
+        auto appended =
+            std::make_shared<StateNode>(latest, style, SpacingDecision::Append);
+        if (appended->current_column <= style.column_limit) {
+          latest = std::move(appended);
+        } else {
+          latest =
+              std::make_shared<StateNode>(latest, style, SpacingDecision::Wrap);
+        }
+        break;
+      }
+    }
+  }
+  return latest;
+}
+
+// Implements SearchLineWraps, and optionally prunes the search.
+std::vector<FormattedExcerpt> SearchLineWrapsImpl(const UnwrappedLine& uwline,
+                                                  const BasicFormatStyle& style,
+                                                  int max_search_states,
+                                                  bool prune,
+                                                  LineWrapSearchStats* stats) {
+  // Dijkstra's algorithm: prioritize searching minimum penalty path until
+  // destination is reached.  States that cannot lead to an optimal result are
+  // pruned, using an admissible estimate of their remaining penalty (like A*),
+  // and dominance by equivalent states with lower penalty.
+  // The search order is kept by cumulative penalty (rather than estimated
+  // total penalty), and only depends on the states themselves, so that
+  // pruning finds the same equally optimal results in the same order.
 
   VLOG(2) << "SearchLineWraps on: " << uwline;
   if (uwline.TokensRange().empty()) {
@@ -56,25 +244,56 @@ std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
     return result;
   }
 
-  // Worklist for decision searching, ordered by cumulative penalty.
-  // Note: a heap-based priority-queue will not guarantee stable ordering
-  // among equal-valued keys.  If first-come-first-serve tie-breaking is
-  // important, consider switching to a std::map.
+  // Worklist for decision searching, ordered by cumulative penalty, then
+  // by decisions (see SearchState).
   std::priority_queue<SearchState> worklist;
 
   // Seed worklist with a NodeState that should have 0 penalty.
   SearchState seed(std::make_shared<StateNode>(uwline, style));
   worklist.push(seed);
 
+  // Any complete formatting bounds the optimal penalty from above.
+  int cost_upper_bound = GreedyFinish(seed.state, style)->cumulative_cost;
+  const RemainingCostBound remaining_cost_bound(uwline, style);
+  DominanceTable dominance_table;
+  int pruned_count = 0;
+
+  // Pushes a new state into the worklist, unless it cannot lead to an optimal
+  // result.
+  const auto push_state = [&](const SearchState& state) {
+    if (!prune) {
+      worklist.push(state);
+      return;
+    }
+    const int cost_lower_bound =
+        state.state->cumulative_cost + remaining_cost_bound(*state.state);
+    if (cost_lower_bound > cost_upper_bound) {
+      ++pruned_count;
+      return;
+    }
+    if (state.state->Done()) {
+      cost_upper_bound = state.state->cumulative_cost;
+    } else if (dominance_table.IsDominated(state.state)) {
+      ++pruned_count;
+      return;
+    }
+    worklist.push(state);
+  };
+
   bool aborted_search = false;
   std::vector<std::shared_ptr<const StateNode>> winning_paths;
   int state_count = 0;
   while (!worklist.empty()) {
-    ++state_count;
-
     SearchState next(worklist.top());
     worklist.pop();
 
+    if (prune && !next.state->Done() &&
+        dominance_table.WasSuperseded(*next.state)) {
+      ++pruned_count;
+      continue;
+    }
+    ++state_count;
+
     VLOG(4) << "\n---- line wrapping search state " << state_count << " ----"
             << "\ncurrent cost: " << next.state->cumulative_cost
             << "\ncurrent column: " << next.state->current_column;
@@ -117,7 +336,7 @@ std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
       VLOG(4) << "preserving spaces before \'" << token.token->text() << '\'';
       SearchState preserved(std::make_shared<StateNode>(
           next.state, style, SpacingDecision::Preserve));
-      worklist.push(preserved);
+      push_state(preserved);
     } else {
       // Remaining options are: Undecided, MustWrap, MustAppend
       // Explore one or both: SpacingDecision::Wrap/Append
@@ -126,7 +345,7 @@ std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
         // Consider cost of appending token to current line.
         SearchState appended(std::make_shared<StateNode>(
             next.state, style, SpacingDecision::Append));
-        worklist.push(appended);
+        push_state(appended);
         VLOG(4) << "  cost: " << appended.state->cumulative_cost;
         VLOG(4) << "  column: " << appended.state->current_column;
       }
@@ -135,19 +354,19 @@ std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
         // Consider cost of line wrapping here.
         SearchState wrapped(std::make_shared<StateNode>(next.state, style,
                                                         SpacingDecision::Wrap));
-        worklist.push(wrapped);
+        push_state(wrapped);
         VLOG(4) << "  cost: " << wrapped.state->cumulative_cost;
         VLOG(4) << "  column: " << wrapped.state->current_column;
       }
     }
-
-    // TODO(fangism): Use an admissibility heuristic to prune search space from
-    // paths whose best-case outcome is worse than a conservatively achievable
-    // goal.  Without a heuristic, this is just Dijkstra.
-    // With heuristic pruning, this is A* (A-star).
   }  // while (!worklist.empty())
 
   CHECK_GE(winning_paths.size(), 1);
+  VLOG(2) << "explored " << state_count << " states, pruned " << pruned_count;
+  if (stats != nullptr) {
+    stats->explored_states = state_count;
+    stats->pruned_states = pruned_count;
+  }
 
   // Reconstruct the unwrapped_line to reflect the decisions made to reach the
   // winning_paths.  Return a modified copy of the original UnwrappedLine.
@@ -165,6 +384,24 @@ std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
   return results;
 }
 
+}  // namespace
+
+std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
+                                              const BasicFormatStyle& style,
+                                              int max_search_states,
+                                              LineWrapSearchStats* stats) {
+  return SearchLineWrapsImpl(uwline, style, max_search_states, true, stats);
+}
+
+namespace internal {
+std::vector<FormattedExcerpt> SearchLineWrapsWithoutPruning(
+    const UnwrappedLine& uwline, const BasicFormatStyle& style,
+    int max_search_states) {
+  return SearchLineWrapsImpl(uwline, style, max_search_states, false,
+                             nullptr);
+}
+}  // namespace internal
+
 void DisplayEquallyOptimalWrappings(
     std::ostream& stream, const UnwrappedLine& uwline,
     const std::vector<FormattedExcerpt>& solutions) {
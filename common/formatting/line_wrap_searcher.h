@@ -23,6 +23,17 @@
 
 namespace verible {
 
+// Counts of the work done by SearchLineWraps, for comparing search strategies.
+struct LineWrapSearchStats {
+  // Number of states taken from the worklist (this is what max_search_states
+  // limits).
+  int explored_states = 0;
+
+  // Number of states that were discarded without being explored, because
+  // they could not lead to an optimal result.
+  int pruned_states = 0;
+};
+
 // SearchLineWraps takes an UnwrappedLine with formatting annotations,
 // and a style structure, and returns equally-good FormattedExcerpts with
 // formatting decisions (wraps, spaces) committed.
@@ -33,9 +44,19 @@ namespace verible {
 // returning a greedily formatted result (which can still be rendered)
 // that will be marked as !CompletedFormatting().
 // This is guaranteed to return at least one result.
-std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
-                                              const BasicFormatStyle& style,
-                                              int max_search_states);
+// If 'stats' is not null, it is set to the counts of states of this search.
+std::vector<FormattedExcerpt> SearchLineWraps(
+    const UnwrappedLine& uwline, const BasicFormatStyle& style,
+    int max_search_states, LineWrapSearchStats* stats = nullptr);
+
+namespace internal {
+// Same as SearchLineWraps, but explores every state that is cheaper than the
+// optimal result, like SearchLineWraps did before it pruned the search.
+// Only meant for testing that pruning does not change the results.
+std::vector<FormattedExcerpt> SearchLineWrapsWithoutPruning(
+    const UnwrappedLine& uwline, const BasicFormatStyle& style,
+    int max_search_states);
+}  // namespace internal
 
 // Diagnostic helper for displaying when multiple optimal wrappings are found
 // by SearchLineWraps.  This aids in development around wrap penalty tuning.
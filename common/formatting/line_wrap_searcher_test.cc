@@ -14,6 +14,9 @@
 
 #include "common/formatting/line_wrap_searcher.h"
 
+#include <algorithm>
+#include <random>
+#include <string>
 #include <vector>
 
 #include "absl/strings/match.h"
@@ -398,6 +401,113 @@ TEST_F(SearchLineWrapsTestFixture, FitsOnLine) {
   EXPECT_EQ(FitsOnLine(uwline_in, style_).final_column, 14);
 }
 
+// Test that the search prunes states that cannot lead to optimal results, but
+// still finds all of the equally optimal results.
+TEST_F(SearchLineWrapsTestFixture, PrunesNonOptimalStates) {
+  const std::vector<TokenInfo> tokens = {
+      {0, "aaaa"}, {0, "bbb"}, {0, "cc"}, {0, "ddddd"},  //
+      {0, "aaaa"}, {0, "bbb"}, {0, "cc"}, {0, "ddddd"},  //
+      {0, "aaaa"}, {0, "bbb"}, {0, "cc"}, {0, "ddddd"},  //
+      {0, "aaaa"}, {0, "bbb"}, {0, "cc"}, {0, "ddddd"},
+  };
+  CreateTokenInfos(tokens);
+  UnwrappedLine uwline_in(LevelsToSpaces(1), pre_format_tokens_.begin());
+  AddFormatTokens(&uwline_in);
+  EXPECT_EQ(uwline_in.Size(), tokens.size());
+  for (auto& ftoken : pre_format_tokens_) {
+    ftoken.before.break_penalty = 2;
+    ftoken.before.spaces_required = 1;
+  }
+  // Without pruning, this search explores over 600 states.
+  LineWrapSearchStats stats;
+  const auto formatted_lines =
+      verible::SearchLineWraps(uwline_in, style_, 200, &stats);
+  ASSERT_FALSE(formatted_lines.empty());
+  EXPECT_TRUE(formatted_lines.front().CompletedFormatting());
+  EXPECT_LT(stats.explored_states, 200);
+  EXPECT_GT(stats.pruned_states, 0);
+  // The 6 line breaks can be placed in several equally good ways.
+  EXPECT_EQ(formatted_lines.size(), 9);
+  for (const auto& formatted_line : formatted_lines) {
+    EXPECT_TRUE(formatted_line.CompletedFormatting());
+    const std::string text = formatted_line.Render();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 6) << text;
+  }
+}
+
+// Test that pruning finds the same results, in the same order, as searching
+// every state that is cheaper than the optimal result.
+TEST(SearchLineWrapsTest, RandomLinesMatchUnprunedSearch) {
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<int> num_tokens(2, 24);
+  std::uniform_int_distribution<int> token_kind(0, 9);
+  std::uniform_int_distribution<int> text_length(1, 12);
+  std::uniform_int_distribution<int> spaces(0, 1);
+  std::uniform_int_distribution<int> penalty(0, 4);
+  std::uniform_int_distribution<int> decision(0, 11);
+  std::uniform_int_distribution<int> column_limit(20, 39);
+  std::uniform_int_distribution<int> over_column_limit_penalty(50, 149);
+  for (int test = 0; test < 300; ++test) {
+    std::vector<std::string> texts(num_tokens(generator));
+    for (size_t i = 0; i < texts.size(); ++i) {
+      switch (token_kind(generator)) {
+        case 0:
+          texts[i] = "(";
+          break;
+        case 1:
+          texts[i] = ")";
+          break;
+        case 2:
+          texts[i] = "a\nbb";
+          break;
+        default:
+          texts[i].assign(text_length(generator), 'a' + i);
+          break;
+      }
+    }
+    std::vector<TokenInfo> tokens;
+    for (const auto& text : texts) tokens.emplace_back(0, text);
+    UnwrappedLineMemoryHandler handler;
+    handler.CreateTokenInfos(tokens);
+    UnwrappedLine uwline_in(0, handler.GetPreFormatTokensBegin());
+    handler.AddFormatTokens(&uwline_in);
+    for (auto& ftoken : handler.pre_format_tokens_) {
+      ftoken.before.spaces_required = spaces(generator);
+      ftoken.before.break_penalty = penalty(generator);
+      switch (decision(generator)) {
+        case 0:
+          ftoken.before.break_decision = SpacingOptions::MustWrap;
+          break;
+        case 1:
+          ftoken.before.break_decision = SpacingOptions::MustAppend;
+          break;
+        case 2:
+          ftoken.before.break_decision = SpacingOptions::Preserve;
+          break;
+        default:
+          break;
+      }
+      if (ftoken.token->text() == "(") ftoken.balancing = GroupBalancing::Open;
+      if (ftoken.token->text() == ")") ftoken.balancing = GroupBalancing::Close;
+    }
+    BasicFormatStyle style;
+    style.column_limit = column_limit(generator);
+    style.wrap_spaces = 4;
+    style.over_column_limit_penalty = over_column_limit_penalty(generator);
+
+    const auto expected =
+        internal::SearchLineWrapsWithoutPruning(uwline_in, style, 100000);
+    if (!expected.front().CompletedFormatting()) continue;
+    const auto formatted_lines = SearchLineWraps(uwline_in, style, 100000);
+    ASSERT_EQ(formatted_lines.size(), expected.size()) << uwline_in;
+    for (size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_TRUE(formatted_lines[i].CompletedFormatting());
+      EXPECT_EQ(formatted_lines[i].Render(), expected[i].Render())
+          << "result " << i << " of " << uwline_in;
+    }
+  }
+}
+
 // Test that aborted wrap search works returns a result marked as incomplete.
 TEST_F(SearchLineWrapsTestFixture, AbortedSearch) {
   const std::vector<TokenInfo> tokens = {
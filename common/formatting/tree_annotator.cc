@@ -29,7 +29,7 @@ namespace {  // implementation detail
 // TODO(fangism): The class bears some semblance to TreeUnwrapper in its
 // simultaneous traversal of a token stream and syntax tree, and may be worth
 // refactoring as a common pattern.
-class TreeAnnotator : public TreeContextVisitor {
+class TreeAnnotator : public IterativeTreeContextVisitor {
  public:
   TreeAnnotator(const Symbol* syntax_tree_root, const TokenInfo& eof_token,
                 std::vector<PreFormatToken>::iterator tokens_begin,
@@ -43,9 +43,8 @@ class TreeAnnotator : public TreeContextVisitor {
 
   void Annotate();
 
- private:                           // methods
-  using TreeContextVisitor::Visit;  // for SyntaxTreeNode
-  void Visit(const SyntaxTreeLeaf& leaf) override {
+ private:  // methods
+  void VisitLeaf(const SyntaxTreeLeaf& leaf) override {
     CatchUpToCurrentLeaf(leaf.get());
   }
 
@@ -86,7 +85,7 @@ void TreeAnnotator::Annotate() {
   // Visit the tokens from the beginning of the token stream through
   // the last syntax tree node.
   if (syntax_tree_root_ != nullptr) {
-    syntax_tree_root_->Accept(this);
+    Traverse(*syntax_tree_root_);
   }
   // Else without a syntax tree, the following code will still annotate
   // over the sequence of format tokens with an empty context, which is
@@ -15,13 +15,17 @@
 #ifndef VERIBLE_COMMON_FORMATTING_TREE_ANNOTATOR_H_
 #define VERIBLE_COMMON_FORMATTING_TREE_ANNOTATOR_H_
 
+#include <algorithm>
 #include <functional>
 #include <vector>
 
 #include "common/formatting/format_token.h"
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
 #include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
 #include "common/text/token_info.h"
+#include "common/text/tree_context_visitor.h"
 
 namespace verible {
 
@@ -40,6 +44,133 @@ void AnnotateFormatTokensUsingSyntaxContext(
     std::vector<PreFormatToken>::iterator tokens_end,
     const ContextTokenAnnotatorFunction& annotator);
 
+// Compact summaries of the syntax tree contexts of a sequence of format
+// tokens, as computed by SummarizeTokenContexts().
+// The contexts are those that AnnotateFormatTokensUsingSyntaxContext() would
+// pass to its annotator function: a pair of adjacent tokens is annotated with
+// the contexts of the last syntax tree leaf visited before the pair, and of
+// the next leaf at or after the right token.
+template <typename Summary>
+struct TokenContextSummaries {
+  // Summaries of the contexts of the syntax tree leaves, in order, preceded by
+  // that of the empty context before the first leaf, and followed by that of
+  // the empty context after the last leaf.
+  std::vector<Summary> contexts;
+
+  // For each element of 'contexts', the number of ancestors that it shares
+  // with the previous context.
+  std::vector<int> common_ancestors;
+
+  // For each format token, the index into 'contexts' of its right context.
+  // The left context of the same pair is the one right before it.
+  // The first token, which is never annotated, has index 0.
+  std::vector<int> context_index;
+};
+
+namespace internal {
+
+template <typename Summary, typename Extend>
+class TokenContextSummarizer : public IterativeTreeContextVisitor {
+ public:
+  TokenContextSummarizer(const TokenInfo& eof_token,
+                         std::vector<PreFormatToken>::const_iterator begin,
+                         std::vector<PreFormatToken>::const_iterator end,
+                         const Extend& extend,
+                         TokenContextSummaries<Summary>* summaries)
+      : eof_token_(eof_token),
+        next_token_(begin),
+        end_token_(end),
+        extend_(extend),
+        summaries_(summaries) {
+    ancestors_.push_back(Summary());
+  }
+
+  void Summarize(const Symbol* syntax_tree_root) {
+    if (next_token_ == end_token_) return;
+    summaries_->context_index.reserve(std::distance(next_token_, end_token_));
+    summaries_->context_index.push_back(0);
+    RecordContext();
+    if (syntax_tree_root != nullptr) Traverse(*syntax_tree_root);
+    CatchUpToCurrentLeaf(eof_token_);
+  }
+
+ private:
+  void VisitLeaf(const SyntaxTreeLeaf& leaf) final {
+    CatchUpToCurrentLeaf(leaf.get());
+  }
+
+  void VisitNode(const SyntaxTreeNode& node) final {
+    ancestors_.push_back(extend_(ancestors_.back(), node));
+  }
+
+  void LeaveNode(const SyntaxTreeNode& node) final {
+    ancestors_.pop_back();
+    min_depth_ = std::min(min_depth_, Depth());
+  }
+
+  // Number of ancestors of the current position in the syntax tree.
+  int Depth() const { return ancestors_.size() - 1; }
+
+  // Assigns the current context to the tokens up to 'leaf_token', in the same
+  // way as AnnotateFormatTokensUsingSyntaxContext().
+  void CatchUpToCurrentLeaf(const TokenInfo& leaf_token) {
+    const int index = summaries_->contexts.size();
+    while (std::distance(next_token_, end_token_) > 1 &&
+           next_token_->token->text().begin() != leaf_token.text().begin()) {
+      ++next_token_;
+      summaries_->context_index.push_back(index);
+    }
+    RecordContext();
+  }
+
+  void RecordContext() {
+    summaries_->contexts.push_back(ancestors_.back());
+    // Since the previous context, the traversal left all ancestors deeper
+    // than min_depth_, and only entered new ones.
+    summaries_->common_ancestors.push_back(min_depth_);
+    min_depth_ = Depth();
+  }
+
+  const TokenInfo& eof_token_;
+
+  std::vector<PreFormatToken>::const_iterator next_token_;
+  const std::vector<PreFormatToken>::const_iterator end_token_;
+
+  const Extend& extend_;
+
+  TokenContextSummaries<Summary>* const summaries_;
+
+  // Summaries of the contexts of the current node and its ancestors, starting
+  // with the empty context at the root.
+  std::vector<Summary> ancestors_;
+
+  // Smallest Depth() since the last recorded context.
+  int min_depth_ = 0;
+};
+
+}  // namespace internal
+
+// Summarizes the syntax tree contexts of the tokens in [tokens_begin,
+// tokens_end) in a single traversal of 'syntax_tree_root', so that they can be
+// annotated in a linear pass over the tokens, without copying or searching
+// context stacks.
+// 'extend' computes the summary of the context of a node's children from the
+// summary of the context of the node, and the node itself:
+//   Summary extend(const Summary& context, const SyntaxTreeNode& node);
+// The empty context is summarized by a default-constructed Summary.
+template <typename Summary, typename Extend>
+TokenContextSummaries<Summary> SummarizeTokenContexts(
+    const Symbol* syntax_tree_root, const TokenInfo& eof_token,
+    std::vector<PreFormatToken>::const_iterator tokens_begin,
+    std::vector<PreFormatToken>::const_iterator tokens_end,
+    const Extend& extend) {
+  TokenContextSummaries<Summary> summaries;
+  internal::TokenContextSummarizer<Summary, Extend> summarizer(
+      eof_token, tokens_begin, tokens_end, extend, &summaries);
+  summarizer.Summarize(syntax_tree_root);
+  return summaries;
+}
+
 }  // namespace verible
 
 #endif  // VERIBLE_COMMON_FORMATTING_TREE_ANNOTATOR_H_
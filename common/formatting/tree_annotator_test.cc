@@ -15,6 +15,7 @@
 #include "common/formatting/tree_annotator.h"
 
 #include "common/formatting/format_token.h"
+#include "common/text/concrete_syntax_tree.h"
 #include "common/text/constants.h"
 #include "common/text/token_info.h"
 #include "common/text/tree_builder_test_util.h"
@@ -224,5 +225,81 @@ TEST(AnnotateFormatTokensUsingSyntaxContextTest, VerifySlidingContexts) {
                   V({6, 8}), V({6, 8}), V({6, 9}), V()));
 }
 
+// Summarizes a context by the tags of its nodes.
+std::vector<int> AppendTag(const std::vector<int>& context,
+                           const SyntaxTreeNode& node) {
+  std::vector<int> result(context);
+  result.push_back(node.Tag().tag);
+  return result;
+}
+
+TEST(SummarizeTokenContextsTest, EmptyFormatTokens) {
+  std::vector<PreFormatToken> ftokens;
+  const auto summaries = SummarizeTokenContexts<std::vector<int>>(
+      nullptr, TokenInfo::EOFToken(), ftokens.begin(), ftokens.end(),
+      AppendTag);
+  EXPECT_TRUE(summaries.contexts.empty());
+  EXPECT_TRUE(summaries.context_index.empty());
+}
+
+TEST(SummarizeTokenContextsTest, NoSyntaxTree) {
+  const absl::string_view text("abc");
+  const TokenInfo tokens[] = {
+      {4, text.substr(0, 1)},
+      {5, text.substr(1, 1)},
+      {verible::TK_EOF, text.substr(3, 0)},  // EOF
+  };
+  std::vector<PreFormatToken> ftokens;
+  for (const auto& t : tokens) {
+    ftokens.emplace_back(&t);
+  }
+  const auto summaries = SummarizeTokenContexts<std::vector<int>>(
+      nullptr, tokens[2], ftokens.begin(), ftokens.end(), AppendTag);
+  using V = std::vector<int>;
+  EXPECT_THAT(summaries.contexts, ElementsAre(V(), V()));
+  EXPECT_THAT(summaries.common_ancestors, ElementsAre(0, 0));
+  EXPECT_THAT(summaries.context_index, ElementsAre(0, 1, 1));
+}
+
+// Same tree as VerifySlidingContexts, which must see the same contexts.
+TEST(SummarizeTokenContextsTest, MatchesSlidingContexts) {
+  const absl::string_view text("abcdefgh");
+  const TokenInfo tokens[] = {
+      {4, text.substr(0, 1)}, {5, text.substr(1, 1)},
+      {6, text.substr(2, 1)}, {4, text.substr(3, 1)},
+      {5, text.substr(4, 1)}, {6, text.substr(5, 1)},
+      {4, text.substr(6, 1)}, {verible::TK_EOF, text.substr(7, 0)},  // EOF
+  };
+  const auto tree = TNode(6,                      // synthesized syntax tree
+                          TNode(7,                //
+                                Leaf(tokens[0]),  //
+                                TNode(10,         //
+                                      Leaf(tokens[1]),  //
+                                      TNode(12)),       //
+                                TNode(11,               //
+                                      Leaf(tokens[2]),  //
+                                      Leaf(tokens[3]))  //
+                                ),                      //
+                          TNode(8,                      //
+                                Leaf(tokens[4]),        //
+                                Leaf(tokens[5])),       //
+                          TNode(9, Leaf(tokens[6]))     //
+  );
+  std::vector<PreFormatToken> ftokens;
+  for (const auto& t : tokens) {
+    ftokens.emplace_back(&t);
+  }
+  const auto summaries = SummarizeTokenContexts<std::vector<int>>(
+      &*tree, tokens[7], ftokens.begin(), ftokens.end(), AppendTag);
+  using V = std::vector<int>;
+  EXPECT_THAT(summaries.contexts,
+              ElementsAre(V(), V({6, 7}), V({6, 7, 10}), V({6, 7, 11}),
+                          V({6, 7, 11}), V({6, 8}), V({6, 8}), V({6, 9}),
+                          V()));
+  EXPECT_THAT(summaries.common_ancestors,
+              ElementsAre(0, 0, 2, 2, 3, 1, 2, 1, 0));
+  EXPECT_THAT(summaries.context_index, ElementsAre(0, 2, 3, 4, 5, 6, 7, 8));
+}
+
 }  // namespace
 }  // namespace verible
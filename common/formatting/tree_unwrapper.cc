@@ -28,8 +28,8 @@
 #include "common/text/text_structure.h"
 #include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
+#include "common/util/casts.h"
 #include "common/util/logging.h"
-#include "common/util/value_saver.h"
 #include "common/util/vector_tree.h"
 
 namespace verible {
@@ -66,7 +66,7 @@ const TokenPartitionTree* TreeUnwrapper::Unwrap() {
   CollectLeadingFilteredTokens();
 
   // Traverse the concrete syntax tree to build up token partitions.
-  ABSL_DIE_IF_NULL(text_structure_view_.SyntaxTree())->Accept(this);
+  TraverseTree(*ABSL_DIE_IF_NULL(text_structure_view_.SyntaxTree()));
 
   // After traversing the ConcreteSyntaxTree, collect possible tokens filtered
   // after the right-most leaf until the end-of-file.
@@ -275,66 +275,122 @@ void TreeUnwrapper::AdvanceNextUnfilteredToken() {
   }
 }
 
-void TreeUnwrapper::TraverseChildren(const verible::SyntaxTreeNode& node) {
-  // Can't just use TreeContextVisitor::Visit(node) because we need to
-  // call a visit hook between children.
-  const verible::SyntaxTreeContext::AutoPop p(&current_context_, &node);
-  InterChildNodeHook(node);
-  for (const auto& child : node.children()) {
-    if (child) {
-      child->Accept(this);
-      InterChildNodeHook(node);
+void TreeUnwrapper::TraverseTree(const Symbol& root) {
+  VisitSymbol(root);
+  while (!traversal_stack_.empty()) {
+    TraversalFrame& frame = traversal_stack_.back();
+    if (!frame.started) {
+      StartTraversal();
+      continue;
+    }
+    const auto& children = frame.node->children();
+    if (frame.next_child == children.size()) {
+      LeaveTraversedNode();
+      // The hook follows a child node only once all of the traversals that
+      // its Visit() requested are done.
+      if (!traversal_stack_.empty() && traversal_stack_.back().started) {
+        InterChildNodeHook(*traversal_stack_.back().node);
+      }
+      continue;
+    }
+    const Symbol* child = children[frame.next_child++].get();
+    if (child != nullptr && !VisitSymbol(*child)) {
+      InterChildNodeHook(*traversal_stack_.back().node);
     }
   }
 }
 
-TreeUnwrapper::preformatted_tokens_type::const_iterator
-TreeUnwrapper::VisitIndentedChildren(const SyntaxTreeNode& node,
-                                     int indentation_delta,
-                                     PartitionPolicyEnum partitioning) {
-  // Visit subtree with increased indentation level.
-  const ValueSaver<int> depth_saver(
-      &current_indentation_spaces_,
-      current_indentation_spaces_ + indentation_delta);
-
-  // Mark a new sibling at the new indentation level, apply partition policy.
-  StartNewUnwrappedLine(partitioning, &node);
-
-  // Start first child right away.
-  const ValueSaver<TokenPartitionTree*> tree_saver(
-      &active_unwrapped_lines_,
-      active_unwrapped_lines_->NewChild(UnwrappedLine(
-          current_indentation_spaces_, CurrentFormatTokenIterator(),
-          PartitionPolicyEnum::kFitOnLineElseExpand /* default */)));
-  VLOG(3) << __FUNCTION__ << ", new child node "
-          << NodePath(*active_unwrapped_lines_) << ": "
-          << CurrentUnwrappedLine();
-  TraverseChildren(node);
-
-  return CurrentFormatTokenIterator();
-
-  // To maintain the invariant that a parent range's upper-bound is equal
-  // to the upper-bound of its last child, we may have to add one more
-  // child whose range spans up to the parent's upper-bound.
-  // The right time to do this is when an UnwrappedLine is finalized,
-  // which is the same time that a new UnwrappedLine is added.
-  // See StartNewUnwrappedLine().
+bool TreeUnwrapper::VisitSymbol(const Symbol& symbol) {
+  symbol.Accept(this);
+  const SyntaxTreeNode* node =
+      symbol.Kind() == SymbolKind::kNode
+          ? &down_cast<const SyntaxTreeNode&>(symbol)
+          : nullptr;
+  if (requested_traversals_.empty()) {
+    // Visit(node) did not traverse any children.
+    if (node != nullptr) LeaveNode(*node);
+    return false;
+  }
+  requested_traversals_.back().leave_node = node;
+  // The first requested traversal goes on top, so that it runs first.
+  traversal_stack_.insert(traversal_stack_.end(),
+                          requested_traversals_.rbegin(),
+                          requested_traversals_.rend());
+  requested_traversals_.clear();
+  return true;
+}
+
+void TreeUnwrapper::TraverseChildren(const verible::SyntaxTreeNode& node) {
+  requested_traversals_.push_back({&node});
 }
 
 void TreeUnwrapper::VisitIndentedSection(const SyntaxTreeNode& node,
                                          int indentation_delta,
                                          PartitionPolicyEnum partitioning) {
-  const auto last_ftoken_iter =
-      VisitIndentedChildren(node, indentation_delta, partitioning);
+  TraversalFrame frame{&node};
+  frame.indented_section = true;
+  frame.indentation_delta = indentation_delta;
+  frame.partitioning = partitioning;
+  requested_traversals_.push_back(frame);
+}
 
-  // TODO(fangism): do we ever need to remove trailing empty partitions here?
+void TreeUnwrapper::StartTraversal() {
+  TraversalFrame& frame = traversal_stack_.back();
+  frame.started = true;
+
+  if (frame.indented_section) {
+    // Visit subtree with increased indentation level.
+    frame.saved_indentation_spaces = current_indentation_spaces_;
+    current_indentation_spaces_ += frame.indentation_delta;
+
+    // Mark a new sibling at the new indentation level, apply partition policy.
+    StartNewUnwrappedLine(frame.partitioning, frame.node);
+
+    // Start first child right away.
+    frame.saved_unwrapped_lines = active_unwrapped_lines_;
+    active_unwrapped_lines_ = active_unwrapped_lines_->NewChild(UnwrappedLine(
+        current_indentation_spaces_, CurrentFormatTokenIterator(),
+        PartitionPolicyEnum::kFitOnLineElseExpand /* default */));
+    VLOG(3) << __FUNCTION__ << ", new child node "
+            << NodePath(*active_unwrapped_lines_) << ": "
+            << CurrentUnwrappedLine();
+  }
 
-  // Update parent's end() format token iterator to match that of
-  // its last child.  It can still be advanced later.
-  active_unwrapped_lines_->Value().SpanUpToToken(last_ftoken_iter);
+  // Can't just use TreeContextVisitor::Visit(node) because we need to
+  // call a visit hook between children.
+  current_context_.Push(frame.node);
+  InterChildNodeHook(*frame.node);
+}
+
+void TreeUnwrapper::LeaveTraversedNode() {
+  const TraversalFrame frame = traversal_stack_.back();
+  traversal_stack_.pop_back();
+  current_context_.Pop();
+
+  if (frame.indented_section) {
+    // Finish the section started by StartTraversal().
+    const auto last_ftoken_iter = CurrentFormatTokenIterator();
+    active_unwrapped_lines_ = frame.saved_unwrapped_lines;
+    current_indentation_spaces_ = frame.saved_indentation_spaces;
+
+    // To maintain the invariant that a parent range's upper-bound is equal
+    // to the upper-bound of its last child, we may have to add one more
+    // child whose range spans up to the parent's upper-bound.
+    // The right time to do this is when an UnwrappedLine is finalized,
+    // which is the same time that a new UnwrappedLine is added.
+    // See StartNewUnwrappedLine().
+
+    // TODO(fangism): do we ever need to remove trailing empty partitions here?
+
+    // Update parent's end() format token iterator to match that of
+    // its last child.  It can still be advanced later.
+    active_unwrapped_lines_->Value().SpanUpToToken(last_ftoken_iter);
+
+    // Start new empty UnwrappedLine at the previous indentation level.
+    StartNewUnwrappedLine(PartitionPolicyEnum::kUninitialized, nullptr);
+  }
 
-  // Start new empty UnwrappedLine at the previous indentation level.
-  StartNewUnwrappedLine(PartitionPolicyEnum::kUninitialized, nullptr);
+  if (frame.leave_node != nullptr) LeaveNode(*frame.leave_node);
 }
 
 std::ostream& operator<<(std::ostream& stream, const TreeUnwrapper& unwrapper) {
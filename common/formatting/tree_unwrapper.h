@@ -15,6 +15,7 @@
 #ifndef VERIBLE_COMMON_FORMATTING_TREE_UNWRAPPER_H_
 #define VERIBLE_COMMON_FORMATTING_TREE_UNWRAPPER_H_
 
+#include <cstddef>
 #include <functional>
 #include <iosfwd>
 #include <vector>
@@ -23,6 +24,7 @@
 #include "common/formatting/token_partition_tree.h"
 #include "common/formatting/unwrapped_line.h"
 #include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
 #include "common/text/text_structure.h"
 #include "common/text/token_info.h"
@@ -58,6 +60,10 @@ class TreeUnwrapper : public TreeContextVisitor {
   // TODO(fangism): rename this Partition.
   const TokenPartitionTree* Unwrap();
 
+  // Returns the tree of unwrapped lines, for passes that reshape it or
+  // release parts of it once they are formatted.
+  TokenPartitionTree* MutableTokenPartitions() { return &unwrapped_lines_; }
+
   // Returns a flattened copy of all of the deepest nodes in the tree of
   // unwrapped lines, which represents maximal partitioning into the smallest
   // partitions of format token ranges one might work with.
@@ -100,15 +106,24 @@ class TreeUnwrapper : public TreeContextVisitor {
   void StartNewUnwrappedLine(PartitionPolicyEnum partitioning,
                              const Symbol* origin);
 
-  // Traverses the children of a node in postorder, recursively accepting this
-  // visitor.
+  // Traverses the children of a node, accepting this visitor on each.
+  // The tree is traversed with an explicit stack instead of recursion, so
+  // the children are only visited after the calling Visit() returns.
+  // Traversals requested by one Visit() run in the order of the calls.
   void TraverseChildren(const verible::SyntaxTreeNode& node);
 
   // Override-able hook for actions that should be taken while in the
   // context of traversing children.
   virtual void InterChildNodeHook(const verible::SyntaxTreeNode&) {}
 
+  // Override-able hook for actions that should be taken after all of the
+  // descendants of a node have been visited, that would otherwise follow
+  // TraverseChildren() or VisitIndentedSection() in Visit(node).
+  // This runs once per Visit(node), after all of the traversals it requested.
+  virtual void LeaveNode(const verible::SyntaxTreeNode&) {}
+
   // Visits a subtree with (possibly) additional indentation.
+  // Like TraverseChildren(), this takes effect after Visit() returns.
   // TODO(fangism): NOW: rename this to VisitSubPartition.
   void VisitIndentedSection(const verible::SyntaxTreeNode& node,
                             int indentation_delta, PartitionPolicyEnum);
@@ -171,11 +186,19 @@ class TreeUnwrapper : public TreeContextVisitor {
   // Finalizes an UnwrappedLine, prior to starting the next one.
   void FinishUnwrappedLine();
 
-  // Returns the last iterator position from visiting a set of children.
-  // This automatically restores active_unwrapped_lines_ on return.
-  preformatted_tokens_type::const_iterator VisitIndentedChildren(
-      const verible::SyntaxTreeNode& node, int indentation_delta,
-      PartitionPolicyEnum);
+  // Visits 'root' and all of its descendants, without recursion.
+  void TraverseTree(const Symbol& root);
+
+  // Accepts this visitor on 'symbol', and returns true if it requested
+  // traversals, which are now pending on traversal_stack_.
+  bool VisitSymbol(const Symbol& symbol);
+
+  // Begins the traversal on top of traversal_stack_.
+  void StartTraversal();
+
+  // Finishes the traversal on top of traversal_stack_, once all of its
+  // children have been visited.
+  void LeaveTraversedNode();
 
   // Verifies parent-child token range equivalence in the entire tree of
   // unwrapped_lines_.
@@ -226,6 +249,38 @@ class TreeUnwrapper : public TreeContextVisitor {
   // No container is actually needed because popping the stack is a matter
   // of replacing this pointer with its Parent().
   TokenPartitionTree* active_unwrapped_lines_ = nullptr;
+
+  // A node whose children are to be, or are being, traversed.
+  struct TraversalFrame {
+    const verible::SyntaxTreeNode* node;
+
+    // Set once the traversal has begun, see StartTraversal().
+    bool started = false;
+
+    // Position of the next child to visit.
+    size_t next_child = 0;
+
+    // Set by VisitIndentedSection(), to open a section at the given
+    // indentation before the children, and to restore the enclosing
+    // indentation and partition after them.
+    bool indented_section = false;
+    int indentation_delta = 0;
+    PartitionPolicyEnum partitioning = PartitionPolicyEnum::kUninitialized;
+    int saved_indentation_spaces = 0;
+    TokenPartitionTree* saved_unwrapped_lines = nullptr;
+
+    // Node to pass to LeaveNode() once this traversal is finished, set on
+    // the last traversal requested by a Visit(node).
+    const verible::SyntaxTreeNode* leave_node = nullptr;
+  };
+
+  // Traversals in progress, innermost last, followed by those that have not
+  // begun yet, next one last.  The started ones parallel the context of
+  // TreeContextVisitor.
+  std::vector<TraversalFrame> traversal_stack_;
+
+  // Traversals requested by the Visit() in progress, in order.
+  std::vector<TraversalFrame> requested_traversals_;
 };
 
 // Prints all of the unwrapped_lines_.  Used for diagnostics only.
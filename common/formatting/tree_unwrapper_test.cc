@@ -15,11 +15,15 @@
 #include "common/formatting/tree_unwrapper.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "common/formatting/format_token.h"
 #include "common/formatting/unwrapped_line.h"
@@ -29,6 +33,7 @@
 #include "common/text/text_structure_test_utils.h"
 #include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
+#include "common/text/tree_builder_test_util.h"
 #include "common/util/container_iterator_range.h"
 #include "common/util/range.h"
 #include "gtest/gtest.h"
@@ -162,4 +167,78 @@ TEST(TreeUnwrapperTest, StreamPrinting) {
             "[world], policy: always-expand, (origin: \"world\")\n");
 }
 
+// Records the order of visits and hooks, identifying nodes by their number
+// of children, and traverses the children of the root node twice.
+class TraversalRecordingTreeUnwrapper : public FakeTreeUnwrapper {
+ public:
+  explicit TraversalRecordingTreeUnwrapper(const TextStructureView& view)
+      : FakeTreeUnwrapper(view) {}
+
+  void Visit(const SyntaxTreeNode& node) override {
+    events_.push_back(absl::StrCat("visit", node.children().size()));
+    const bool is_root = !root_visited_;
+    root_visited_ = true;
+    TraverseChildren(node);
+    if (is_root) TraverseChildren(node);
+  }
+
+  void InterChildNodeHook(const SyntaxTreeNode& node) override {
+    events_.push_back(absl::StrCat("hook", node.children().size()));
+  }
+
+  void LeaveNode(const SyntaxTreeNode& node) override {
+    events_.push_back(absl::StrCat("leave", node.children().size()));
+  }
+
+  const std::vector<std::string>& Events() const { return events_; }
+
+ private:
+  bool root_visited_ = false;
+  std::vector<std::string> events_;
+};
+
+// Test that traversals requested by one Visit() run in order, followed by
+// a single LeaveNode().
+TEST(TreeUnwrapperTest, RepeatedTraversal) {
+  // Node(Node(), Node(), Node(Node(), Node()))
+  std::unique_ptr<TextStructureView> view = MakeTextStructureViewWithNoLeaves();
+  TraversalRecordingTreeUnwrapper tree_unwrapper(*view);
+  tree_unwrapper.Unwrap();
+
+  const std::vector<std::string> root_children = {
+      "hook3",                                         //
+      "visit0", "hook0", "leave0", "hook3",            //
+      "visit0", "hook0", "leave0", "hook3",            //
+      "visit2", "hook2",                               //
+      "visit0", "hook0", "leave0", "hook2",            //
+      "visit0", "hook0", "leave0", "hook2", "leave2",  //
+      "hook3",                                         //
+  };
+  std::vector<std::string> expected = {"visit3"};
+  expected.insert(expected.end(), root_children.begin(), root_children.end());
+  expected.insert(expected.end(), root_children.begin(), root_children.end());
+  expected.push_back("leave3");
+  EXPECT_EQ(tree_unwrapper.Events(), expected);
+}
+
+// Test that trees deeper than the call stack would allow are unwrapped.
+TEST(TreeUnwrapperTest, UnwrapVeryDeepTree) {
+  TextStructureView view("hello");
+  TokenSequence& tokens = view.MutableTokenStream();
+  tokens.push_back(TokenInfo(0, view.Contents()));
+  view.MutableTokenStreamView().push_back(tokens.begin());
+  constexpr size_t kDepth = 1000000;
+  SymbolPtr tree = Leaf(tokens[0]);
+  for (size_t i = 0; i < kDepth; ++i) {
+    tree = Node(std::move(tree));
+  }
+  view.MutableSyntaxTree() = std::move(tree);
+
+  FakeTreeUnwrapper tree_unwrapper(view);
+  tree_unwrapper.Unwrap();
+  const auto unwrapped_lines = tree_unwrapper.FullyPartitionedUnwrappedLines();
+  ASSERT_EQ(unwrapped_lines.size(), 1);
+  EXPECT_EQ(unwrapped_lines.front().Size(), 1);
+}
+
 }  // namespace verible
@@ -14,9 +14,13 @@
 
 #include "common/strings/diff.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <thread>  // NOLINT
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_split.h"
 #include "common/strings/split.h"
 #include "common/util/iterator_range.h"
@@ -41,13 +45,42 @@ static char EditOperationToLineMarker(Operation op) {
   }
 }
 
+// Replaces every line with an id that is shared by all equal lines (of both
+// texts), and only by those.
+static std::vector<uint32_t> LineIds(
+    const std::vector<absl::string_view>& lines,
+    absl::flat_hash_map<absl::string_view, uint32_t>* ids) {
+  std::vector<uint32_t> line_ids;
+  line_ids.reserve(lines.size());
+  for (const auto& line : lines) {
+    line_ids.push_back(ids->emplace(line, ids->size()).first->second);
+  }
+  return line_ids;
+}
+
+// Diffs lines by their ids, which gives the same edits as diffing the lines
+// themselves, but every line is only hashed once, instead of being compared
+// again and again while searching for common affixes and bisection points.
+static Edits DiffLines(const std::vector<absl::string_view>& before_lines,
+                       const std::vector<absl::string_view>& after_lines) {
+  absl::flat_hash_map<absl::string_view, uint32_t> ids;
+  ids.reserve(before_lines.size());
+  const std::vector<uint32_t> before_ids(LineIds(before_lines, &ids));
+  const std::vector<uint32_t> after_ids(LineIds(after_lines, &ids));
+  // Only diffs of large and different texts bisect spans big enough to use
+  // more than one thread.
+  const int max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+  return diff::GetTokenDiffsInParallel(before_ids.begin(), before_ids.end(),
+                                       after_ids.begin(), after_ids.end(),
+                                       max_threads);
+}
+
 LineDiffs::LineDiffs(absl::string_view before, absl::string_view after)
     : before_text(before),
       after_text(after),
       before_lines(SplitLinesKeepLineTerminator(before_text)),
       after_lines(SplitLinesKeepLineTerminator(after_text)),
-      edits(diff::GetTokenDiffs(before_lines.begin(), before_lines.end(),
-                                after_lines.begin(), after_lines.end())) {}
+      edits(DiffLines(before_lines, after_lines)) {}
 
 template <typename Iter>
 static std::ostream& PrintLineRange(std::ostream& stream, char op, Iter start,
@@ -16,7 +16,9 @@
 
 #include <initializer_list>
 #include <sstream>
+#include <string>
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -124,6 +126,21 @@ TEST(LineDiffsTest, Various) {
   }
 }
 
+TEST(LineDiffsTest, SameEditsAsDiffOfLines) {
+  // Many repeated lines, and enough of them to bisect in parallel.
+  std::string before, after;
+  for (int i = 0; i < 20000; ++i) {
+    absl::StrAppend(&before, "line ", i % 97, "\n");
+    if (i % 13 == 0) absl::StrAppend(&after, "new ", i % 7, "\n");
+    if (i % 17 != 0) absl::StrAppend(&after, "line ", i % 97, "\n");
+  }
+  const LineDiffs line_diffs(before, after);
+  const Edits expected = diff::GetTokenDiffs(
+      line_diffs.before_lines.begin(), line_diffs.before_lines.end(),
+      line_diffs.after_lines.begin(), line_diffs.after_lines.end());
+  EXPECT_THAT(line_diffs.edits, ElementsAreArray(expected));
+}
+
 struct AddedLineNumbersTestCase {
   Edits edits;
   LineNumberSet expected_line_numbers;
@@ -28,23 +28,36 @@
 namespace verible {
 
 bool Obfuscator::encode(absl::string_view key, absl::string_view value) {
+  absl::MutexLock lock(&mutex_);
   return translator_.insert(std::string(key), std::string(value));
 }
 
 absl::string_view Obfuscator::operator()(absl::string_view input) {
-  if (decode_mode) {
-    const auto* p = translator_.find_reverse(input);
-    return (p != nullptr) ? *p : input;
-  } else {
-    const std::string* str = translator_.insert_using_value_generator(
-        std::string(input), [=]() { return generator_(input); });
-    return *str;
+  if (decode_mode) return decode(input);
+  {
+    // Most identifiers are seen many times, so first look for an existing
+    // translation, which other threads can do at the same time.
+    absl::ReaderMutexLock lock(&mutex_);
+    const std::string* str = translator_.find_forward(input);
+    if (str != nullptr) return *str;
   }
+  absl::MutexLock lock(&mutex_);
+  // Re-generates on collisions with existing replacements.
+  const std::string* str = translator_.insert_using_value_generator(
+      std::string(input), [=]() { return generator_(input); });
+  return *str;
+}
+
+absl::string_view Obfuscator::decode(absl::string_view input) const {
+  absl::ReaderMutexLock lock(&mutex_);
+  const auto* p = translator_.find_reverse(input);
+  return (p != nullptr) ? *p : input;
 }
 
 constexpr char kPairSeparator = ' ';
 
 std::string Obfuscator::save() const {
+  absl::ReaderMutexLock lock(&mutex_);
   std::ostringstream stream;
   for (const auto& pair : translator_.forward_view()) {
     stream << pair.first << kPairSeparator << *pair.second << "\n";
@@ -18,8 +18,10 @@
 #include <functional>
 #include <string>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "common/strings/compare.h"
 #include "common/strings/random.h"
 #include "common/util/bijective_map.h"
@@ -39,6 +41,10 @@ namespace verible {
 //
 // The save() and load() functions can be used to re-apply previously used
 // substitutions written/read from a text file.
+//
+// All methods other than GetTranslator() are thread-safe, so that one
+// Obfuscator can consistently translate many files concurrently.  The
+// generator is only ever called by one thread at a time.
 class Obfuscator {
  public:
   typedef std::function<std::string(absl::string_view)> generator_type;
@@ -48,6 +54,9 @@ class Obfuscator {
 
   explicit Obfuscator(generator_type g) : generator_(g), translator_() {}
 
+  Obfuscator(const Obfuscator&) = delete;
+  Obfuscator& operator=(const Obfuscator&) = delete;
+
   // Declares a mapping from key-string to value-string that will be
   // used in obfuscation.  This is useful for applying previously used
   // translations.  Returns true if key-value pair was successfully inserted,
@@ -62,7 +71,13 @@ class Obfuscator {
   // for later re-use.  Returns the replacement string.
   absl::string_view operator()(absl::string_view input);
 
+  // Returns the original string that was translated into 'input', or 'input'
+  // itself if it is not a known replacement.  This is what operator() does in
+  // decoding mode, but works in either mode.
+  absl::string_view decode(absl::string_view input) const;
+
   // Read-only view of string translation map.
+  // Not synchronized: only use this while no other thread modifies the map.
   const translator_type& GetTranslator() const { return translator_; }
 
   // Parses a mapping dictionary, and pre-loads the translator map with it.
@@ -78,8 +93,12 @@ class Obfuscator {
   // Generates a random substitution string, for obfuscation.
   generator_type generator_;
 
+  // Guards the translator_, and calls of the generator_ that extend it.
+  mutable absl::Mutex mutex_;
+
   // Keeps track of transformations done on seen strings.
-  translator_type translator_;
+  // Entries are never removed, so references to them remain valid.
+  translator_type translator_ ABSL_GUARDED_BY(mutex_);
 
   // If true, apply reverse translation of identifiers, and do not generate any
   // new obfuscation mappings.
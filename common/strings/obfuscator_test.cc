@@ -14,6 +14,11 @@
 
 #include "common/strings/obfuscator.h"
 
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/strings/str_cat.h"
 #include "common/util/bijective_map.h"
 #include "common/util/logging.h"
 #include "gmock/gmock.h"
@@ -117,6 +122,14 @@ TEST(ObfuscatorTest, DecodeModeDoesNotAddEntries) {
   EXPECT_EQ(ob.GetTranslator().size(), 1);
 }
 
+TEST(ObfuscatorTest, DecodeInEncodingMode) {
+  Obfuscator ob(RotateGenerator);
+  EXPECT_EQ(ob("cat"), "png");
+  EXPECT_EQ(ob.decode("png"), "cat");
+  EXPECT_EQ(ob.decode("dog"), "dog");  // unrecognized id, unchanged
+  EXPECT_EQ(ob.GetTranslator().size(), 1);
+}
+
 TEST(ObfuscatorTest, SaveMap) {
   Obfuscator ob(RotateGenerator);
   EXPECT_EQ(ob.save(), "");
@@ -182,6 +195,40 @@ TEST(IdentifierObfuscatorTest, Transform) {
   }
 }
 
+TEST(IdentifierObfuscatorTest, ConcurrentTranslationsAreConsistent) {
+  constexpr int kNumWords = 512;
+  constexpr int kNumThreads = 8;
+  std::vector<std::string> words;
+  for (int i = 0; i < kNumWords; ++i) words.push_back(absl::StrCat("w", i));
+
+  IdentifierObfuscator ob;
+  // Translations, as seen by each thread, indexed by word.
+  std::vector<std::vector<std::string>> results(
+      kNumThreads, std::vector<std::string>(kNumWords));
+  {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&, t] {
+        // Every thread sees the words in a different order.
+        for (int i = 0; i < kNumWords; ++i) {
+          const int w = (i * (2 * t + 1)) % kNumWords;
+          results[t][w] = std::string(ob(words[w]));
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
+
+  const auto& tran = ob.GetTranslator();
+  EXPECT_EQ(tran.size(), kNumWords);
+  for (const auto& result : results) {
+    for (int w = 0; w < kNumWords; ++w) {
+      EXPECT_EQ(*ABSL_DIE_IF_NULL(tran.find_forward(words[w])), result[w]);
+      EXPECT_EQ(*ABSL_DIE_IF_NULL(tran.find_reverse(result[w])), words[w]);
+    }
+  }
+}
+
 TEST(IdentifierObfuscatorTest, EncodeInvalid) {
   IdentifierObfuscator ob;
   EXPECT_DEATH(ob.encode("cat", "sheep"), "");  // mismatch length
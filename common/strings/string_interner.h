@@ -0,0 +1,81 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_COMMON_STRINGS_STRING_INTERNER_H_
+#define VERIBLE_COMMON_STRINGS_STRING_INTERNER_H_
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace verible {
+
+// StringInterner maps distinct string contents to small dense integer ids.
+// Equal strings (by contents, not by address) always map to the same id, so
+// once strings are interned, equality tests and hashing reduce to integer
+// operations.
+//
+// Each distinct string is copied once into memory owned by the interner,
+// so interned ids (and the string_views returned by Value()) remain valid even
+// after the originally interned text is released.
+class StringInterner {
+ public:
+  using id_type = uint32_t;
+
+  // Sentinel value returned by Find() for strings that were never interned.
+  static constexpr id_type kNotFound = ~id_type(0);
+
+  StringInterner() = default;
+
+  StringInterner(const StringInterner&) = delete;
+  StringInterner(StringInterner&&) = default;
+  StringInterner& operator=(const StringInterner&) = delete;
+  StringInterner& operator=(StringInterner&&) = default;
+
+  // Returns the id for 'text', assigning a new one if it has not been seen.
+  id_type Intern(absl::string_view text);
+
+  // Returns the id for 'text', or kNotFound if it was never interned.
+  // This never modifies the interner, and is safe to call concurrently with
+  // other const methods.
+  id_type Find(absl::string_view text) const;
+
+  // Returns the (owned) string for 'id'.
+  // 'id' must be a value previously returned by Intern().
+  absl::string_view Value(id_type id) const { return strings_[id]; }
+
+  // Returns the number of distinct strings interned.
+  size_t size() const { return strings_.size(); }
+
+  bool empty() const { return strings_.empty(); }
+
+  void clear();
+
+ private:
+  // Maps string contents to id.
+  // Keys point into strings_.
+  absl::flat_hash_map<absl::string_view, id_type> ids_;
+
+  // Owned copies of interned strings, indexed by id.
+  // std::deque never relocates existing elements when growing at the end,
+  // which keeps the keys of ids_ valid.
+  std::deque<std::string> strings_;
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_STRINGS_STRING_INTERNER_H_
@@ -0,0 +1,80 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/strings/string_interner.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace {
+
+TEST(StringInternerTest, Empty) {
+  const StringInterner interner;
+  EXPECT_TRUE(interner.empty());
+  EXPECT_EQ(interner.size(), 0);
+  EXPECT_EQ(interner.Find("foo"), StringInterner::kNotFound);
+}
+
+TEST(StringInternerTest, DistinctStringsGetDistinctIds) {
+  StringInterner interner;
+  const auto foo = interner.Intern("foo");
+  const auto bar = interner.Intern("bar");
+  EXPECT_NE(foo, bar);
+  EXPECT_EQ(interner.size(), 2);
+  EXPECT_EQ(interner.Find("foo"), foo);
+  EXPECT_EQ(interner.Find("bar"), bar);
+  EXPECT_EQ(interner.Find("baz"), StringInterner::kNotFound);
+  EXPECT_EQ(interner.Value(foo), "foo");
+  EXPECT_EQ(interner.Value(bar), "bar");
+}
+
+TEST(StringInternerTest, EqualContentsDifferentAddresses) {
+  const std::string text("xyzxyz");
+  const absl::string_view first(text.data(), 3);
+  const absl::string_view second(text.data() + 3, 3);
+  StringInterner interner;
+  const auto id1 = interner.Intern(first);
+  const auto id2 = interner.Intern(second);
+  EXPECT_EQ(id1, id2);
+  EXPECT_EQ(interner.size(), 1);
+}
+
+TEST(StringInternerTest, OwnsStringMemory) {
+  StringInterner interner;
+  StringInterner::id_type id;
+  {
+    const std::string temp("transient");
+    id = interner.Intern(temp);
+    EXPECT_NE(interner.Value(id).begin(), temp.data());
+  }
+  // Many more strings, to force internal growth.
+  for (int i = 0; i < 1000; ++i) interner.Intern(std::to_string(i));
+  EXPECT_EQ(interner.Value(id), "transient");
+  EXPECT_EQ(interner.Find("transient"), id);
+  EXPECT_EQ(interner.Find("999"), interner.Intern("999"));
+}
+
+TEST(StringInternerTest, Clear) {
+  StringInterner interner;
+  interner.Intern("foo");
+  interner.clear();
+  EXPECT_TRUE(interner.empty());
+  EXPECT_EQ(interner.Find("foo"), StringInterner::kNotFound);
+  EXPECT_EQ(interner.Intern("bar"), 0);
+}
+
+}  // namespace
+}  // namespace verible
@@ -81,6 +81,17 @@ class StringViewSuperRangeMap {
     return string_map_.must_emplace(superstring.begin(), superstring.end());
   }
 
+  // Removes a superstring range that was previously inserted, e.g. before its
+  // memory is released.  'superstring' must exactly match an inserted range.
+  void must_erase(absl::string_view superstring) {
+    const const_iterator found(find(superstring));
+    CHECK(found != string_map_.end());
+    CHECK(found->first == superstring.begin() &&
+          found->second == superstring.end())
+        << "Can only erase whole superstring ranges.";
+    string_map_.erase(found);
+  }
+
  private:
   // Internal representation of string range map.
   impl_type string_map_;
@@ -105,6 +105,30 @@ TEST(StringViewSuperRangeMapTest, TwoStrings) {
   });
 }
 
+TEST(StringViewSuperRangeMapTest, EraseAndReinsert) {
+  StringViewSuperRangeMap svmap;
+  constexpr absl::string_view text1("hello"), text2("world");
+  svmap.must_emplace(text1);
+  svmap.must_emplace(text2);
+  svmap.must_erase(text1);
+  EXPECT_EQ(svmap.find(text1), svmap.end());
+  EXPECT_TRUE(BoundsEqual(svmap.must_find(text2), text2));
+  svmap.must_emplace(text1);
+  EXPECT_TRUE(BoundsEqual(svmap.must_find(text1), text1));
+}
+
+TEST(StringViewSuperRangeMapTest, EraseSubstringFails) {
+  StringViewSuperRangeMap svmap;
+  constexpr absl::string_view text("text");
+  svmap.must_emplace(text);
+  EXPECT_DEATH(svmap.must_erase(text.substr(1)), "");
+}
+
+TEST(StringViewSuperRangeMapTest, EraseNotInSetFails) {
+  StringViewSuperRangeMap svmap;
+  EXPECT_DEATH(svmap.must_erase(absl::string_view("never-there")), "");
+}
+
 // Function to get the owned address range of the underlying string.
 static absl::string_view StringViewKey(
     const std::unique_ptr<const std::string>& owned) {
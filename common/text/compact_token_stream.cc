@@ -0,0 +1,124 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/text/compact_token_stream.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "common/util/logging.h"
+
+namespace verible {
+
+CompactTokenSequence::CompactTokenSequence(absl::string_view contents)
+    : contents_(contents) {
+  CHECK(CanHoldContents(contents))
+      << "Text is too large for compact token storage.";
+}
+
+bool CompactTokenSequence::CanHoldContents(absl::string_view contents) {
+  return contents.size() <= std::numeric_limits<uint32_t>::max();
+}
+
+bool CompactTokenSequence::CanHold(const TokenInfo& token) const {
+  const absl::string_view text = token.text();
+  return text.begin() >= contents_.begin() && text.end() <= contents_.end() &&
+         token.token_enum() >= 0 &&
+         token.token_enum() <= std::numeric_limits<uint16_t>::max();
+}
+
+CompactTokenSequence::CompactTokenSequence(absl::string_view contents,
+                                           const TokenSequence& tokens)
+    : CompactTokenSequence(contents) {
+  reserve(tokens.size());
+  for (const auto& token : tokens) push_back(token);
+}
+
+void CompactTokenSequence::reserve(size_t n) {
+  offsets_.reserve(n);
+  lengths_.reserve(n);
+  enums_.reserve(n);
+}
+
+void CompactTokenSequence::push_back(const TokenInfo& token) {
+  CHECK(CanHold(token)) << "Token does not fit compact token storage: "
+                        << token;
+  offsets_.push_back(token.left(contents_));
+  lengths_.push_back(token.text().length());
+  enums_.push_back(token.token_enum());
+}
+
+size_t CompactTokenSequence::LowerBound(size_t offset) const {
+  return std::lower_bound(offsets_.begin(), offsets_.end(), offset) -
+         offsets_.begin();
+}
+
+TokenSequence CompactTokenSequence::ToTokenSequence() const {
+  TokenSequence tokens;
+  tokens.reserve(size());
+  for (size_t i = 0; i < size(); ++i) tokens.push_back((*this)[i]);
+  return tokens;
+}
+
+size_t CompactTokenSequence::MemoryUsage() const {
+  return offsets_.capacity() * sizeof(uint32_t) +
+         lengths_.capacity() * sizeof(uint32_t) +
+         enums_.capacity() * sizeof(uint16_t);
+}
+
+CompactTokenStreamView::CompactTokenStreamView(
+    const CompactTokenSequence* tokens, const TokenSequence& origin,
+    const TokenStreamView& view)
+    : tokens_(tokens) {
+  CHECK_EQ(tokens->size(), origin.size());
+  indices_.reserve(view.size());
+  for (const auto iter : view) {
+    indices_.push_back(std::distance(origin.begin(), iter));
+  }
+}
+
+void CompactTokenStreamView::FilterInPlace(const TokenFilterPredicate& keep) {
+  indices_.erase(std::remove_if(indices_.begin(), indices_.end(),
+                                [&](uint32_t index) {
+                                  return !keep((*tokens_)[index]);
+                                }),
+                 indices_.end());
+}
+
+std::vector<uint32_t> CompactLineTokenMap(
+    const CompactTokenSequence& tokens, const std::vector<int>& line_offsets) {
+  std::vector<uint32_t> line_token_map;
+  line_token_map.reserve(line_offsets.size() + 1);
+  size_t index = 0;
+  for (const int offset : line_offsets) {
+    // Lines are in increasing order, so search only the remaining tokens.
+    while (index < tokens.size() &&
+           tokens.left(index) < static_cast<size_t>(offset)) {
+      ++index;
+    }
+    line_token_map.push_back(index);
+  }
+  // Like TextStructureView::CalculateFirstTokensPerLine(), end with an
+  // end() entry.
+  line_token_map.push_back(tokens.size());
+  return line_token_map;
+}
+
+}  // namespace verible
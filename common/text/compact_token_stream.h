@@ -0,0 +1,247 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compact, structure-of-arrays storage for the tokens of one text buffer.
+//
+// A TokenSequence stores a TokenInfo (an int and a string_view) per token,
+// and a TokenStreamView an 8-byte iterator per token.  For the same tokens,
+// CompactTokenSequence stores a 32-bit offset, a 32-bit length and a 16-bit
+// enum in three separate arrays (10 bytes per token), and
+// CompactTokenStreamView a 32-bit index per token.  Passes that only look at
+// token enums scan a dense array of them.
+//
+// Consumers of TokenInfo can still iterate over either container: elements
+// are materialized as TokenInfo values on access.
+//
+// TextStructureView::CompactTokens() moves a structure's tokens into this
+// form, for structures that are kept after analysis.
+
+#ifndef VERIBLE_COMMON_TEXT_COMPACT_TOKEN_STREAM_H_
+#define VERIBLE_COMMON_TEXT_COMPACT_TOKEN_STREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+
+namespace verible {
+
+// Random-access iterator over a container that materializes TokenInfo values,
+// like CompactTokenSequence and CompactTokenStreamView.
+// Dereferencing yields a TokenInfo by value, so there is no operator->.
+template <class Container>
+class CompactTokenIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = TokenInfo;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = TokenInfo;
+
+  CompactTokenIterator(const Container* container, size_t index)
+      : container_(container), index_(index) {}
+
+  // Position of this iterator in its container.
+  size_t index() const { return index_; }
+
+  TokenInfo operator*() const { return (*container_)[index_]; }
+  TokenInfo operator[](difference_type n) const {
+    return (*container_)[index_ + n];
+  }
+
+  CompactTokenIterator& operator++() {
+    ++index_;
+    return *this;
+  }
+  CompactTokenIterator operator++(int) {
+    CompactTokenIterator result(*this);
+    ++index_;
+    return result;
+  }
+  CompactTokenIterator& operator--() {
+    --index_;
+    return *this;
+  }
+  CompactTokenIterator operator--(int) {
+    CompactTokenIterator result(*this);
+    --index_;
+    return result;
+  }
+  CompactTokenIterator& operator+=(difference_type n) {
+    index_ += n;
+    return *this;
+  }
+  CompactTokenIterator& operator-=(difference_type n) {
+    index_ -= n;
+    return *this;
+  }
+  CompactTokenIterator operator+(difference_type n) const {
+    return CompactTokenIterator(container_, index_ + n);
+  }
+  CompactTokenIterator operator-(difference_type n) const {
+    return CompactTokenIterator(container_, index_ - n);
+  }
+  difference_type operator-(const CompactTokenIterator& other) const {
+    return static_cast<difference_type>(index_) -
+           static_cast<difference_type>(other.index_);
+  }
+
+  bool operator==(const CompactTokenIterator& other) const {
+    return index_ == other.index_;
+  }
+  bool operator!=(const CompactTokenIterator& other) const {
+    return index_ != other.index_;
+  }
+  bool operator<(const CompactTokenIterator& other) const {
+    return index_ < other.index_;
+  }
+  bool operator>(const CompactTokenIterator& other) const {
+    return index_ > other.index_;
+  }
+  bool operator<=(const CompactTokenIterator& other) const {
+    return index_ <= other.index_;
+  }
+  bool operator>=(const CompactTokenIterator& other) const {
+    return index_ >= other.index_;
+  }
+
+ private:
+  const Container* container_;
+  size_t index_;
+};
+
+// CompactTokenSequence holds the tokens of a single text buffer, which must
+// outlive it.  Every token's text must lie within that buffer (like the
+// tokens of a TextStructureView, including its EOF token), which may be at
+// most 4 GiB large, and token enums must fit in 16 bits.
+class CompactTokenSequence {
+ public:
+  using const_iterator = CompactTokenIterator<CompactTokenSequence>;
+
+  explicit CompactTokenSequence(absl::string_view contents);
+
+  // Copies 'tokens', which must all point into 'contents'.
+  CompactTokenSequence(absl::string_view contents,
+                       const TokenSequence& tokens);
+
+  absl::string_view Contents() const { return contents_; }
+
+  // Returns true if 'token' can be stored: its text lies within Contents(),
+  // and its enum fits in 16 bits.
+  bool CanHold(const TokenInfo& token) const;
+
+  // Returns true if the tokens of 'contents' can be stored compactly, as long
+  // as each of them CanHold().
+  static bool CanHoldContents(absl::string_view contents);
+
+  void reserve(size_t n);
+  void push_back(const TokenInfo& token);
+
+  size_t size() const { return enums_.size(); }
+  bool empty() const { return enums_.empty(); }
+
+  int token_enum(size_t i) const { return enums_[i]; }
+  // Byte offsets of the token's text relative to Contents(), like
+  // TokenInfo::left() and TokenInfo::right().
+  size_t left(size_t i) const { return offsets_[i]; }
+  size_t right(size_t i) const { return offsets_[i] + lengths_[i]; }
+  absl::string_view text(size_t i) const {
+    return contents_.substr(offsets_[i], lengths_[i]);
+  }
+
+  // Materializes the i'th token.
+  TokenInfo operator[](size_t i) const {
+    return TokenInfo(enums_[i], text(i));
+  }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+
+  // The enums of all tokens, in order, for passes that only need those.
+  const std::vector<uint16_t>& TokenEnums() const { return enums_; }
+
+  // Returns the index of the first token that starts at or after 'offset',
+  // or size() if there is none.  Tokens must be in text order.
+  size_t LowerBound(size_t offset) const;
+
+  // Returns a full copy of the tokens.
+  TokenSequence ToTokenSequence() const;
+
+  // Returns the number of bytes allocated for the tokens.
+  size_t MemoryUsage() const;
+
+ private:
+  absl::string_view contents_;
+  std::vector<uint32_t> offsets_;
+  std::vector<uint32_t> lengths_;
+  std::vector<uint16_t> enums_;
+};
+
+// CompactTokenStreamView is the counterpart of TokenStreamView: a (filtered)
+// subsequence of a CompactTokenSequence, which must outlive it.
+class CompactTokenStreamView {
+ public:
+  using const_iterator = CompactTokenIterator<CompactTokenStreamView>;
+
+  explicit CompactTokenStreamView(const CompactTokenSequence* tokens)
+      : tokens_(tokens) {}
+
+  // Translates 'view' over 'origin' to the same tokens of 'tokens', which
+  // must be a copy of 'origin'.
+  CompactTokenStreamView(const CompactTokenSequence* tokens,
+                         const TokenSequence& origin,
+                         const TokenStreamView& view);
+
+  const CompactTokenSequence& Tokens() const { return *tokens_; }
+
+  // Indices into Tokens() of the tokens in this view.
+  const std::vector<uint32_t>& Indices() const { return indices_; }
+
+  void push_back(size_t index) { indices_.push_back(index); }
+
+  // Removes the tokens that evaluate to false with 'keep'.
+  void FilterInPlace(const TokenFilterPredicate& keep);
+
+  size_t size() const { return indices_.size(); }
+  bool empty() const { return indices_.empty(); }
+
+  int token_enum(size_t i) const { return tokens_->token_enum(indices_[i]); }
+
+  // Materializes the i'th token of this view.
+  TokenInfo operator[](size_t i) const { return (*tokens_)[indices_[i]]; }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+
+  // Returns the number of bytes allocated for the view (not the tokens).
+  size_t MemoryUsage() const { return indices_.capacity() * sizeof(uint32_t); }
+
+ private:
+  const CompactTokenSequence* tokens_;
+  std::vector<uint32_t> indices_;
+};
+
+// Returns the indices of the first token on each line of 'contents' (given
+// as 'line_offsets', the offsets of the beginnings of lines), followed by
+// tokens.size(), like TextStructureView::GetLineTokenMap().
+std::vector<uint32_t> CompactLineTokenMap(
+    const CompactTokenSequence& tokens, const std::vector<int>& line_offsets);
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_TEXT_COMPACT_TOKEN_STREAM_H_
@@ -0,0 +1,94 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares a token pass (counting tokens of one enum in the filtered view)
+// over TokenSequence/TokenStreamView and their compact counterparts, and
+// reports the memory used by each.
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "common/text/compact_token_stream.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+
+namespace verible {
+namespace {
+
+// Random tokens of 1 to 8 characters, one in four of which is filtered out
+// (like whitespace and comments).
+struct TokenData {
+  explicit TokenData(int count) {
+    std::mt19937 generator(count);
+    std::uniform_int_distribution<int> length(1, 8);
+    std::uniform_int_distribution<int> token_enum(1, 400);
+    std::vector<int> lengths(count);
+    for (auto& l : lengths) l = length(generator);
+    for (const int l : lengths) text.append(l, 'x');
+    const absl::string_view text_view(text);
+    size_t offset = 0;
+    for (const int l : lengths) {
+      tokens.push_back(
+          TokenInfo(token_enum(generator), text_view.substr(offset, l)));
+      offset += l;
+    }
+    for (auto iter = tokens.cbegin(); iter != tokens.cend(); ++iter) {
+      if (iter->token_enum() % 4 != 0) view.push_back(iter);
+    }
+  }
+
+  std::string text;
+  TokenSequence tokens;
+  TokenStreamView view;
+};
+
+void BM_TokenStreamViewCountEnum(benchmark::State& state) {
+  const TokenData data(state.range(0));
+  for (auto _ : state) {
+    int count = 0;
+    for (const auto& iter : data.view) count += iter->token_enum() == 42;
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * data.view.size());
+  state.counters["bytes"] = data.tokens.capacity() * sizeof(TokenInfo) +
+                            data.view.capacity() * sizeof(data.view[0]);
+}
+BENCHMARK(BM_TokenStreamViewCountEnum)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22);
+
+void BM_CompactTokenStreamViewCountEnum(benchmark::State& state) {
+  const TokenData data(state.range(0));
+  const CompactTokenSequence tokens(data.text, data.tokens);
+  const CompactTokenStreamView view(&tokens, data.tokens, data.view);
+  for (auto _ : state) {
+    int count = 0;
+    for (size_t i = 0; i < view.size(); ++i) count += view.token_enum(i) == 42;
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * view.size());
+  state.counters["bytes"] = tokens.MemoryUsage() + view.MemoryUsage();
+}
+BENCHMARK(BM_CompactTokenStreamViewCountEnum)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22);
+
+}  // namespace
+}  // namespace verible
+
+BENCHMARK_MAIN();
@@ -0,0 +1,167 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/text/compact_token_stream.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "common/text/text_structure.h"
+#include "common/text/text_structure_test_utils.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace {
+
+using testing::ElementsAre;
+
+TEST(CompactTokenSequenceTest, Empty) {
+  const CompactTokenSequence tokens("");
+  EXPECT_TRUE(tokens.empty());
+  EXPECT_EQ(tokens.begin(), tokens.end());
+  EXPECT_TRUE(tokens.ToTokenSequence().empty());
+}
+
+TEST(CompactTokenSequenceTest, MaterializesSameTokens) {
+  const auto view = MakeTextStructureViewHelloWorld();
+  const CompactTokenSequence tokens(view->Contents(), view->TokenStream());
+  ASSERT_EQ(tokens.size(), view->TokenStream().size());
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    const TokenInfo& expected = view->TokenStream()[i];
+    // Same text range, not only equal text.
+    EXPECT_EQ(tokens[i], expected);
+    EXPECT_EQ(tokens.token_enum(i), expected.token_enum());
+    EXPECT_EQ(tokens.text(i), expected.text());
+    EXPECT_EQ(tokens.left(i), expected.left(view->Contents()));
+    EXPECT_EQ(tokens.right(i), expected.right(view->Contents()));
+  }
+  EXPECT_EQ(tokens.ToTokenSequence(), view->TokenStream());
+  EXPECT_THAT(tokens.TokenEnums(), ElementsAre(0, 1, 2, 3));
+}
+
+TEST(CompactTokenSequenceTest, Iteration) {
+  const auto view = MakeTextStructureViewHelloWorld();
+  const CompactTokenSequence tokens(view->Contents(), view->TokenStream());
+  std::vector<absl::string_view> texts;
+  for (const TokenInfo token : tokens) texts.push_back(token.text());
+  EXPECT_THAT(texts, ElementsAre("hello", ",", " ", "world"));
+
+  EXPECT_EQ(std::distance(tokens.begin(), tokens.end()), 4);
+  auto iter = tokens.begin() + 3;
+  EXPECT_EQ((*iter).text(), "world");
+  EXPECT_EQ(iter.index(), 3);
+  --iter;
+  EXPECT_EQ((*iter).text(), " ");
+  EXPECT_EQ(tokens.begin()[1].text(), ",");
+  EXPECT_LT(tokens.begin(), iter);
+
+  // Standard algorithms work on materialized tokens.
+  const auto found =
+      std::find_if(tokens.begin(), tokens.end(), [](const TokenInfo& token) {
+        return token.text() == "world";
+      });
+  EXPECT_EQ(found.index(), 3);
+}
+
+TEST(CompactTokenSequenceTest, LowerBound) {
+  const auto view = MakeTextStructureViewHelloWorld();
+  const CompactTokenSequence tokens(view->Contents(), view->TokenStream());
+  EXPECT_EQ(tokens.LowerBound(0), 0);
+  EXPECT_EQ(tokens.LowerBound(1), 1);  // inside "hello"
+  EXPECT_EQ(tokens.LowerBound(5), 1);
+  EXPECT_EQ(tokens.LowerBound(7), 3);
+  EXPECT_EQ(tokens.LowerBound(12), 4);
+}
+
+TEST(CompactTokenSequenceTest, EOFTokenAtEndOfContents) {
+  const absl::string_view text("abc");
+  CompactTokenSequence tokens(text);
+  tokens.push_back(TokenInfo(7, text.substr(0, 3)));
+  tokens.push_back(TokenInfo::EOFToken(text));
+  ASSERT_EQ(tokens.size(), 2);
+  EXPECT_TRUE(tokens[1].isEOF());
+  EXPECT_EQ(tokens.left(1), 3);
+  EXPECT_EQ(tokens[1], TokenInfo::EOFToken(text));
+}
+
+TEST(CompactTokenSequenceTest, SmallerThanTokenSequence) {
+  const absl::string_view text("a b c d e f g h");
+  TokenSequence full;
+  for (size_t i = 0; i < text.length(); ++i) {
+    full.push_back(TokenInfo(i % 3, text.substr(i, 1)));
+  }
+  TokenStreamView full_view;
+  InitTokenStreamView(full, &full_view);
+
+  const CompactTokenSequence tokens(text, full);
+  const CompactTokenStreamView view(&tokens, full, full_view);
+  const size_t full_size = full.size() * sizeof(TokenInfo) +
+                           full_view.size() * sizeof(full_view[0]);
+  EXPECT_LE((tokens.MemoryUsage() + view.MemoryUsage()) * 2, full_size);
+}
+
+TEST(CompactTokenStreamViewTest, TranslatesView) {
+  const auto view = MakeTextStructureViewHelloWorld();
+  const CompactTokenSequence tokens(view->Contents(), view->TokenStream());
+  const CompactTokenStreamView compact_view(&tokens, view->TokenStream(),
+                                            view->GetTokenStreamView());
+  EXPECT_THAT(compact_view.Indices(), ElementsAre(0, 1, 3));
+  ASSERT_EQ(compact_view.size(), view->GetTokenStreamView().size());
+  for (size_t i = 0; i < compact_view.size(); ++i) {
+    EXPECT_EQ(compact_view[i], *view->GetTokenStreamView()[i]);
+    EXPECT_EQ(compact_view.token_enum(i),
+              view->GetTokenStreamView()[i]->token_enum());
+  }
+  std::vector<absl::string_view> texts;
+  for (const TokenInfo token : compact_view) texts.push_back(token.text());
+  EXPECT_THAT(texts, ElementsAre("hello", ",", "world"));
+}
+
+TEST(CompactTokenStreamViewTest, FilterInPlace) {
+  const auto view = MakeTextStructureViewHelloWorld();
+  const CompactTokenSequence tokens(view->Contents(), view->TokenStream());
+  CompactTokenStreamView compact_view(&tokens);
+  for (size_t i = 0; i < tokens.size(); ++i) compact_view.push_back(i);
+  compact_view.FilterInPlace(
+      [](const TokenInfo& token) { return token.text().length() > 1; });
+  EXPECT_THAT(compact_view.Indices(), ElementsAre(0, 3));
+}
+
+TEST(CompactLineTokenMapTest, SameAsLineTokenMap) {
+  const TextStructureTokenized text_structure({
+      {TokenInfo(1, "foo"), TokenInfo(2, " "), TokenInfo(3, "\n")},
+      {TokenInfo(3, "\n")},
+      {TokenInfo(4, "bar"), TokenInfo(3, "\n")},
+  });
+  const TextStructureView& data = text_structure.Data();
+  const CompactTokenSequence tokens(data.Contents(), data.TokenStream());
+  const std::vector<uint32_t> line_token_map = CompactLineTokenMap(
+      tokens, data.GetLineColumnMap().GetBeginningOfLineOffsets());
+
+  std::vector<uint32_t> expected;
+  for (const auto iter : data.GetLineTokenMap()) {
+    expected.push_back(std::distance(data.TokenStream().begin(), iter));
+  }
+  EXPECT_EQ(line_token_map, expected);
+  EXPECT_THAT(line_token_map, ElementsAre(0, 3, 4, 6, 6));
+}
+
+}  // namespace
+}  // namespace verible
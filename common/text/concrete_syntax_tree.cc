@@ -25,6 +25,27 @@
 
 namespace verible {
 
+SyntaxTreeNode::~SyntaxTreeNode() {
+  // Move the descendant nodes onto an explicit stack, taking every node's
+  // children before destroying it, so that no destructor recurses deeper than
+  // one level.  Leaves are destroyed along with their parents.
+  std::vector<SymbolPtr> pending;
+  for (auto& child : children_) {
+    if (child != nullptr && child->Kind() == SymbolKind::kNode) {
+      pending.push_back(std::move(child));
+    }
+  }
+  while (!pending.empty()) {
+    SymbolPtr symbol = std::move(pending.back());
+    pending.pop_back();
+    for (auto& child : down_cast<SyntaxTreeNode&>(*symbol).children_) {
+      if (child != nullptr && child->Kind() == SymbolKind::kNode) {
+        pending.push_back(std::move(child));
+      }
+    }
+  }
+}
+
 // Checks if this is equal to SymbolPtr node under compare_token function
 bool SyntaxTreeNode::equals(const Symbol* symbol,
                             const TokenComparator& compare_tokens) const {
@@ -64,11 +85,29 @@ const SymbolPtr& SyntaxTreeNode::operator[](const size_t i) const {
   return children_[i];
 }
 
-// visits self, then forwards visitor to every child
+// Visits self, then forwards visitor to every descendant, in pre-order.
+// Nodes whose children are being visited are kept on an explicit stack, along
+// with the position of their next child, instead of recursing.
 void SyntaxTreeNode::Accept(TreeVisitorRecursive* visitor) const {
   visitor->Visit(*this);
-  for (auto& child : children_) {
-    if (child != nullptr) child->Accept(visitor);
+  std::vector<std::pair<const SyntaxTreeNode*, size_t>> stack;
+  stack.emplace_back(this, 0);
+  while (!stack.empty()) {
+    const SyntaxTreeNode& node = *stack.back().first;
+    const size_t index = stack.back().second++;
+    if (index == node.children_.size()) {
+      stack.pop_back();
+      continue;
+    }
+    const Symbol* child = node.children_[index].get();
+    if (child == nullptr) continue;
+    if (child->Kind() == SymbolKind::kNode) {
+      const auto* child_node = down_cast<const SyntaxTreeNode*>(child);
+      visitor->Visit(*child_node);
+      stack.emplace_back(child_node, 0);
+    } else {
+      child->Accept(visitor);
+    }
   }
 }
 
@@ -76,8 +115,24 @@ void SyntaxTreeNode::Accept(MutableTreeVisitorRecursive* visitor,
                             SymbolPtr* this_owned) {
   CHECK_EQ(ABSL_DIE_IF_NULL(this_owned)->get(), this);
   visitor->Visit(*this, this_owned);
-  for (auto& child : children_) {
-    if (child != nullptr) child->Accept(visitor, &child);
+  std::vector<std::pair<SyntaxTreeNode*, size_t>> stack;
+  stack.emplace_back(this, 0);
+  while (!stack.empty()) {
+    SyntaxTreeNode& node = *stack.back().first;
+    const size_t index = stack.back().second++;
+    if (index == node.children_.size()) {
+      stack.pop_back();
+      continue;
+    }
+    SymbolPtr& child = node.children_[index];
+    if (child == nullptr) continue;
+    if (child->Kind() == SymbolKind::kNode) {
+      auto* child_node = down_cast<SyntaxTreeNode*>(child.get());
+      visitor->Visit(*child_node, &child);
+      stack.emplace_back(child_node, 0);
+    } else {
+      child->Accept(visitor, &child);
+    }
   }
 }
 
@@ -74,6 +74,9 @@ class SyntaxTreeNode : public Symbol {
  public:
   explicit SyntaxTreeNode(const int tag = kUntagged) : tag_(tag), children_() {}
 
+  // Destroys the subtree without recursion, so that it works at any depth.
+  ~SyntaxTreeNode() override;
+
   const std::vector<SymbolPtr>& children() const { return children_; }
   std::vector<SymbolPtr>& mutable_children() { return children_; }
 
@@ -128,8 +131,8 @@ class SyntaxTreeNode : public Symbol {
   bool equals(const SyntaxTreeNode* node,
               const TokenComparator& compare_tokens) const;
 
-  // Uses passed TreeVisitorRecursive to visit all children recursively,
-  // then visit itself.
+  // Uses passed TreeVisitorRecursive to visit itself, then all descendants
+  // in pre-order.  This does not recurse, so it handles trees of any depth.
   void Accept(TreeVisitorRecursive* visitor) const override;
   void Accept(MutableTreeVisitorRecursive* visitor,
               SymbolPtr* this_owned) override;
@@ -18,11 +18,13 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/symbol.h"
 #include "common/text/tree_builder_test_util.h"
 #include "common/text/tree_compare.h"
+#include "common/text/visitors.h"
 #include "common/util/logging.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -390,5 +392,61 @@ TEST(NodeSubscriptTest, ConstReference) {
   EXPECT_EQ(example_node[1]->Tag().tag, 9);
 }
 
+// Records the tags of visited symbols, and marks leaves by negating them.
+class TagRecorder : public TreeVisitorRecursive,
+                    public MutableTreeVisitorRecursive {
+ public:
+  void Visit(const SyntaxTreeLeaf& leaf) override {
+    tags_.push_back(-leaf.Tag().tag);
+  }
+  void Visit(const SyntaxTreeNode& node) override {
+    tags_.push_back(node.Tag().tag);
+  }
+  void Visit(const SyntaxTreeLeaf& leaf, SymbolPtr*) override { Visit(leaf); }
+  void Visit(const SyntaxTreeNode& node, SymbolPtr*) override { Visit(node); }
+
+  std::vector<int> tags_;
+};
+
+// Tests that visitors see every symbol in pre-order.
+TEST(SyntaxTreeNodeAcceptTest, PreOrder) {
+  SymbolPtr tree = TNode(1, TNode(2, XLeaf(3), nullptr, XLeaf(4)), XLeaf(5),
+                         TNode(6, TNode(7)), XLeaf(8));
+  const std::vector<int> expected = {1, 2, -3, -4, -5, 6, 7, -8};
+  {
+    TagRecorder recorder;
+    static_cast<const Symbol&>(*tree).Accept(
+        static_cast<TreeVisitorRecursive*>(&recorder));
+    EXPECT_EQ(recorder.tags_, expected);
+  }
+  {
+    TagRecorder recorder;
+    tree->Accept(static_cast<MutableTreeVisitorRecursive*>(&recorder), &tree);
+    EXPECT_EQ(recorder.tags_, expected);
+  }
+}
+
+// Tests that trees deeper than the call stack would allow are visited.
+TEST(SyntaxTreeNodeAcceptTest, VeryDeepTree) {
+  constexpr int kDepth = 1000000;
+  SymbolPtr tree = XLeaf(0);
+  for (int i = 0; i < kDepth; ++i) {
+    tree = TNode(1, std::move(tree));
+  }
+  {
+    TagRecorder recorder;
+    static_cast<const Symbol&>(*tree).Accept(
+        static_cast<TreeVisitorRecursive*>(&recorder));
+    EXPECT_EQ(recorder.tags_.size(), kDepth + 1);
+    EXPECT_EQ(recorder.tags_.back(), 0);
+  }
+  {
+    TagRecorder recorder;
+    tree->Accept(static_cast<MutableTreeVisitorRecursive*>(&recorder), &tree);
+    EXPECT_EQ(recorder.tags_.size(), kDepth + 1);
+    EXPECT_EQ(recorder.tags_.back(), 0);
+  }
+}
+
 }  // namespace
 }  // namespace verible
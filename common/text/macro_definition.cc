@@ -14,6 +14,7 @@
 
 #include "common/text/macro_definition.h"
 
+#include <algorithm>
 #include <iterator>
 #include <map>
 #include <string>
@@ -31,13 +32,13 @@ using container::FindOrNull;
 
 bool MacroDefinition::AppendParameter(const MacroParameterInfo& param_info) {
   is_callable_ = true;
-  // Record position of this parameter.
-  const bool inserted = parameter_positions_
-                            .insert({std::string(param_info.name.text()),
-                                     parameter_info_array_.size()})
-                            .second;
+  const bool duplicate = std::any_of(
+      parameter_info_array_.begin(), parameter_info_array_.end(),
+      [&param_info](const MacroParameterInfo& param) {
+        return param.name.text() == param_info.name.text();
+      });
   parameter_info_array_.push_back(param_info);
-  return inserted;
+  return !duplicate;
 }
 
 absl::Status MacroDefinition::PopulateSubstitutionMap(
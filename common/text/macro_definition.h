@@ -79,8 +79,7 @@ class MacroDefinition {
       : header_(header),
         name_(name),
         is_callable_(false),
-        parameter_info_array_(),
-        parameter_positions_() {}
+        parameter_info_array_() {}
 
   absl::string_view Name() const { return name_.text(); }
 
@@ -124,9 +123,9 @@ class MacroDefinition {
   // Distinguish between a definition without () vs. with empty ().
   bool is_callable_;
 
-  // These form an ordered dictionary on macro parameters.
+  // Formal parameters, in order.  Macros have few parameters, so these are
+  // searched linearly rather than indexed by name.
   std::vector<MacroParameterInfo> parameter_info_array_;
-  std::map<std::string, size_t> parameter_positions_;
 
   // un-tokenized text
   DefaultTokenInfo definition_text_;
@@ -25,11 +25,13 @@
 #include <utility>
 #include <vector>
 
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "common/strings/line_column_map.h"
+#include "common/text/compact_token_stream.h"
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/symbol.h"
@@ -69,6 +71,7 @@ void TextStructureView::Clear() {
   line_token_map_.clear();
   tokens_view_.clear();
   tokens_.clear();
+  compact_tokens_.reset();
   contents_ = contents_.substr(0, 0);  // clear
   lines_.clear();
 }
@@ -114,6 +117,29 @@ void TextStructureView::CalculateFirstTokensPerLine() {
   line_token_map_.push_back(tokens_.cend());
 }
 
+bool TextStructureView::CompactTokens() {
+  if (!CompactTokenSequence::CanHoldContents(contents_)) return false;
+  auto compact = absl::make_unique<CompactTokenData>(contents_);
+  for (const auto& token : tokens_) {
+    if (!compact->tokens.CanHold(token)) return false;
+  }
+  compact->tokens.reserve(tokens_.size());
+  for (const auto& token : tokens_) compact->tokens.push_back(token);
+  compact->tokens_view =
+      CompactTokenStreamView(&compact->tokens, tokens_, tokens_view_);
+  compact->line_token_map.reserve(line_token_map_.size());
+  for (const auto iter : line_token_map_) {
+    compact->line_token_map.push_back(std::distance(tokens_.cbegin(), iter));
+  }
+  compact_tokens_ = std::move(compact);
+
+  // Release the memory, not only the elements.
+  TokenSequence().swap(tokens_);
+  TokenStreamView().swap(tokens_view_);
+  std::vector<TokenSequence::const_iterator>().swap(line_token_map_);
+  return true;
+}
+
 TokenRange TextStructureView::TokenRangeSpanningOffsets(size_t lower,
                                                         size_t upper) const {
   const auto text_base = Contents().begin();
@@ -27,6 +27,7 @@
 #define VERIBLE_COMMON_TEXT_TEXT_STRUCTURE_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -35,6 +36,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "common/strings/line_column_map.h"
+#include "common/text/compact_token_stream.h"
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/symbol.h"
 #include "common/text/token_stream_view.h"
@@ -65,6 +67,25 @@ class TextStructureView {
   // expansion is encountered.
   using NodeExpansionMap = std::map<int, DeferredExpansion>;
 
+  // Tokens moved into compact storage by CompactTokens().
+  struct CompactTokenData {
+    explicit CompactTokenData(absl::string_view contents)
+        : tokens(contents), tokens_view(&tokens) {}
+
+    // tokens_view points into tokens.
+    CompactTokenData(const CompactTokenData&) = delete;
+    CompactTokenData& operator=(const CompactTokenData&) = delete;
+
+    // Counterpart of TokenStream().
+    CompactTokenSequence tokens;
+
+    // Counterpart of GetTokenStreamView().
+    CompactTokenStreamView tokens_view;
+
+    // Counterpart of GetLineTokenMap(), with indices into tokens.
+    std::vector<uint32_t> line_token_map;
+  };
+
   explicit TextStructureView(absl::string_view contents);
 
   ~TextStructureView();
@@ -106,6 +127,21 @@ class TextStructureView {
   // Create the EOF token given the contents.
   TokenInfo EOFToken() const;
 
+  // Moves the tokens into compact storage, for structures that are kept
+  // around once they have been analyzed: TokenStream(), GetTokenStreamView()
+  // and GetLineTokenMap() become empty, and GetCompactTokens() holds the same
+  // tokens in about a third of the memory.  The syntax tree has its own copies
+  // of tokens, and is unaffected.
+  // Tokens can no longer be filtered, mutated or expanded afterwards.
+  // Returns false, and changes nothing, if any token cannot be stored
+  // compactly (see CompactTokenSequence::CanHold()).
+  bool CompactTokens();
+
+  // Returns the tokens moved by CompactTokens(), or nullptr.
+  const CompactTokenData* GetCompactTokens() const {
+    return compact_tokens_.get();
+  }
+
   // Resets all fields.
   void Clear();
 
@@ -179,6 +215,10 @@ class TextStructureView {
   // Tree representation of file contents.
   ConcreteSyntaxTree syntax_tree_;
 
+  // Set by CompactTokens(), which empties tokens_, tokens_view_ and
+  // line_token_map_.
+  std::unique_ptr<CompactTokenData> compact_tokens_;
+
   void TrimSyntaxTree(int first_token_offset, int last_token_offset);
 
   void TrimTokensToSubstring(int left_offset, int right_offset);
@@ -270,6 +270,44 @@ TEST_F(TokenRangeTest, TokenRangeOnLine) {
   }
 }
 
+// Checks that compacted tokens are the same as the original ones.
+TEST_F(TokenRangeTest, CompactTokens) {
+  const TokenSequence tokens(data_.TokenStream());
+  std::vector<size_t> view_indices;
+  for (const auto iter : data_.GetTokenStreamView()) {
+    view_indices.push_back(std::distance(data_.TokenStream().cbegin(), iter));
+  }
+  EXPECT_THAT(data_.GetCompactTokens(), IsNull());
+
+  ASSERT_TRUE(data_.CompactTokens());
+  EXPECT_THAT(data_.TokenStream(), IsEmpty());
+  EXPECT_THAT(data_.GetTokenStreamView(), IsEmpty());
+  EXPECT_THAT(data_.GetLineTokenMap(), IsEmpty());
+  EXPECT_OK(data_.InternalConsistencyCheck());
+
+  const auto* compact = data_.GetCompactTokens();
+  ASSERT_NE(compact, nullptr);
+  EXPECT_EQ(compact->tokens.ToTokenSequence(), tokens);
+  EXPECT_THAT(compact->tokens_view.Indices(),
+              testing::ElementsAreArray(view_indices));
+  EXPECT_THAT(compact->line_token_map, testing::ElementsAre(0, 5, 6, 11, 11));
+}
+
+// Checks that tokens outside of the contents are not compacted.
+TEST(CompactTokensTest, TokenOutsideContents) {
+  const absl::string_view other_text("other");
+  TextStructureTokenized text_structure(
+      {{TokenInfo(3, "hello"), TokenInfo(4, "\n")}});
+  TextStructureView& data = text_structure.MutableData();
+  TokenInfo& token = data.MutableTokenStream().front();
+  const TokenInfo original(token);
+  token = TokenInfo(3, other_text);
+  EXPECT_FALSE(data.CompactTokens());
+  EXPECT_THAT(data.GetCompactTokens(), IsNull());
+  EXPECT_THAT(data.TokenStream(), SizeIs(2));
+  token = original;  // for the consistency checks on destruction
+}
+
 // Testing select public methods of TextStructureView.
 class TextStructureViewPublicTest : public ::testing::Test,
                                     public TextStructureView {
@@ -14,17 +14,84 @@
 
 #include "common/text/tree_context_visitor.h"
 
+#include <functional>
+#include <utility>
 #include <vector>
 
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
+#include "common/util/casts.h"
 #include "common/util/logging.h"
 
 namespace verible {
 
 void TreeContextVisitor::Visit(const SyntaxTreeNode& node) {
-  const SyntaxTreeContext::AutoPop p(&current_context_, &node);
-  for (const auto& child : node.children()) {
-    if (child) child->Accept(this);
+  // Frames below 'base' belong to enclosing calls.
+  const size_t base = visit_stack_.size();
+  current_context_.Push(&node);
+  visit_stack_.push_back({&node, 0, nullptr});
+  while (visit_stack_.size() > base) {
+    TraversalFrame& frame = visit_stack_.back();
+    const auto& children = frame.node->children();
+    if (frame.next_child == children.size()) {
+      const std::function<void()> leave = std::move(frame.leave);
+      current_context_.Pop();
+      visit_stack_.pop_back();
+      if (leave) leave();
+      continue;
+    }
+    const Symbol* child = children[frame.next_child++].get();
+    if (child == nullptr) continue;
+    accepted_child_ = child;
+    child->Accept(this);
+    accepted_child_ = nullptr;
+  }
+}
+
+void TreeContextVisitor::VisitChildrenLater(const SyntaxTreeNode& node,
+                                            std::function<void()> leave) {
+  if (accepted_child_ != &node) {
+    TreeContextVisitor::Visit(node);
+    if (leave) leave();
+    return;
+  }
+  accepted_child_ = nullptr;
+  current_context_.Push(&node);
+  visit_stack_.push_back({&node, 0, std::move(leave)});
+}
+
+void IterativeTreeContextVisitor::Traverse(const Symbol& root) {
+  if (root.Kind() == SymbolKind::kLeaf) {
+    VisitLeaf(down_cast<const SyntaxTreeLeaf&>(root));
+    return;
+  }
+  const auto& root_node = down_cast<const SyntaxTreeNode&>(root);
+  VisitNode(root_node);
+  current_context_.Push(&root_node);
+  next_child_.push_back(0);
+  while (!next_child_.empty()) {
+    const SyntaxTreeNode& node = Context().top();
+    const auto& children = node.children();
+    const size_t index = next_child_.back();
+    if (index == children.size()) {
+      current_context_.Pop();
+      next_child_.pop_back();
+      LeaveNode(node);
+      continue;
+    }
+    ++next_child_.back();
+    const Symbol* child = children[index].get();
+    if (child == nullptr) continue;
+    if (child->Kind() == SymbolKind::kLeaf) {
+      VisitLeaf(down_cast<const SyntaxTreeLeaf&>(*child));
+    } else {
+      const auto& child_node = down_cast<const SyntaxTreeNode&>(*child);
+      VisitNode(child_node);
+      current_context_.Push(&child_node);
+      next_child_.push_back(0);
+    }
   }
 }
 
@@ -15,14 +15,33 @@
 #ifndef VERIBLE_COMMON_TEXT_TREE_CONTEXT_VISITOR_H_
 #define VERIBLE_COMMON_TEXT_TREE_CONTEXT_VISITOR_H_
 
+#include <cstddef>
+#include <functional>
+#include <vector>
+
 #include "common/strings/display_utils.h"
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
 #include "common/text/visitors.h"
 
 namespace verible {
 
+// Context for visitors that enter and leave nodes in different iterations of
+// a traversal loop, where pushing and popping cannot be scoped with AutoPop.
+class SyntaxTreeContextStack : public SyntaxTreeContext {
+ public:
+  using SyntaxTreeContext::Pop;
+  using SyntaxTreeContext::Push;
+};
+
 // This visitor traverses a tree and maintains a stack of context
 // that points to all ancestors at any given node.
+// Visit(node) walks the children of 'node' in a loop; subclasses that need no
+// special handling for a node can let that loop take over its children with
+// VisitChildrenLater(), so that long chains of such nodes, like deeply nested
+// expressions, do not recurse.
 class TreeContextVisitor : public SymbolVisitor {
  public:
   TreeContextVisitor() = default;
@@ -31,10 +50,77 @@ class TreeContextVisitor : public SymbolVisitor {
   void Visit(const SyntaxTreeLeaf& leaf) override {}
   void Visit(const SyntaxTreeNode& node) override;
 
+  // Equivalent to TreeContextVisitor::Visit(node) followed by 'leave' (if
+  // any), as the last action of a subclass' Visit(node): no state that is
+  // restored when Visit(node) returns may be relied upon by the children, and
+  // state that they need can be restored by 'leave' instead.
+  // When Visit(node) was called by the traversal loop of an enclosing
+  // TreeContextVisitor::Visit(), the children are visited by that loop after
+  // Visit(node) returns, instead of by a new loop, one level deeper in the
+  // call stack.  Otherwise, they are visited right away.
+  void VisitChildrenLater(const SyntaxTreeNode& node,
+                          std::function<void()> leave = nullptr);
+
   const SyntaxTreeContext& Context() const { return current_context_; }
 
   // Keeps track of ancestors as the visitor traverses tree.
-  SyntaxTreeContext current_context_;
+  SyntaxTreeContextStack current_context_;
+
+ private:
+  // A node whose children are being visited.
+  struct TraversalFrame {
+    const SyntaxTreeNode* node;
+
+    // Position of the next child to visit.
+    size_t next_child;
+
+    // Action to take after the children, see VisitChildrenLater().
+    std::function<void()> leave;
+  };
+
+  // Nodes whose children are being visited by the loops of all calls to
+  // TreeContextVisitor::Visit() in progress, innermost last.
+  std::vector<TraversalFrame> visit_stack_;
+
+  // The child just accepted by the innermost loop, while it can still hand
+  // over its children with VisitChildrenLater().
+  const Symbol* accepted_child_ = nullptr;
+};
+
+// This visitor traverses a tree in the same order as TreeContextVisitor and
+// maintains the same context, but it walks the tree with an explicit stack
+// instead of recursive Accept() calls.  The depth of the trees it can handle
+// is limited only by memory, not by the native call stack.
+// Subclasses handle each symbol in pre-order by overriding VisitNode() and
+// VisitLeaf(), and can act after all of a node's descendants in LeaveNode().
+// This suits visitors that do not direct the recursion themselves.
+class IterativeTreeContextVisitor {
+ public:
+  IterativeTreeContextVisitor() = default;
+  virtual ~IterativeTreeContextVisitor() = default;
+
+  // Visits 'root' and all of its descendants.
+  void Traverse(const Symbol& root);
+
+ protected:
+  // Called before visiting the descendants of 'node'.
+  virtual void VisitNode(const SyntaxTreeNode& node) {}
+
+  // Called after visiting all of the descendants of 'node'.
+  virtual void LeaveNode(const SyntaxTreeNode& node) {}
+
+  virtual void VisitLeaf(const SyntaxTreeLeaf& leaf) {}
+
+  // Ancestors of the symbol being visited (excluding itself).
+  const SyntaxTreeContext& Context() const { return current_context_; }
+
+ private:
+  // Keeps track of ancestors as the visitor traverses tree.
+  SyntaxTreeContextStack current_context_;
+
+  // For every node in current_context_, the position of its next child to
+  // visit.
+  std::vector<size_t> next_child_;
 };
 
 // Type that is used to keep track of positions descended from a root
@@ -14,9 +14,16 @@
 
 #include "common/text/tree_context_visitor.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <utility>
 #include <vector>
 
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
 #include "common/text/tree_builder_test_util.h"
+#include "common/util/casts.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -58,6 +65,53 @@ class ContextRecorder : public BaseVisitor {
   std::vector<SyntaxTreeContext> context_history_;
 };
 
+// Same as ContextRecorder, for the iterative visitor.
+class IterativeContextRecorder : public IterativeTreeContextVisitor {
+ public:
+  void VisitLeaf(const SyntaxTreeLeaf& leaf) override {
+    context_history_.push_back(Context());
+  }
+
+  void VisitNode(const SyntaxTreeNode& node) override {
+    context_history_.push_back(Context());
+  }
+
+  std::vector<std::vector<int>> ContextTagHistory() const {
+    std::vector<std::vector<int>> result;
+    for (const auto& context : context_history_) {
+      result.emplace_back(ContextToTags(context));
+    }
+    return result;
+  }
+
+ private:
+  std::vector<SyntaxTreeContext> context_history_;
+};
+
+// Same as ContextRecorder, with children visited by VisitChildrenLater().
+class LaterContextRecorder : public TreeContextVisitor {
+ public:
+  void Visit(const SyntaxTreeLeaf& leaf) override {
+    context_history_.push_back(Context());
+  }
+
+  void Visit(const SyntaxTreeNode& node) override {
+    context_history_.push_back(Context());
+    VisitChildrenLater(node);
+  }
+
+  std::vector<std::vector<int>> ContextTagHistory() const {
+    std::vector<std::vector<int>> result;
+    for (const auto& context : context_history_) {
+      result.emplace_back(ContextToTags(context));
+    }
+    return result;
+  }
+
+ private:
+  std::vector<SyntaxTreeContext> context_history_;
+};
+
 template <class T>
 static void TestContextRecorder(const SymbolPtr& tree,
                                 const std::vector<std::vector<int>>& expect) {
@@ -75,6 +129,14 @@ static void TestContextRecorders(const SymbolPtr& tree,
                                  const std::vector<std::vector<int>>& expect) {
   TestContextRecorder<TreeContextVisitor>(tree, expect);
   TestContextRecorder<TreeContextPathVisitor>(tree, expect);
+
+  LaterContextRecorder later;
+  tree->Accept(&later);
+  EXPECT_THAT(later.ContextTagHistory(), ElementsAreArray(expect));
+
+  IterativeContextRecorder r;
+  r.Traverse(*tree);
+  EXPECT_THAT(r.ContextTagHistory(), ElementsAreArray(expect));
 }
 
 TEST(TreeContextVisitorTest, LoneNode) {
@@ -137,6 +199,172 @@ TEST(TreeContextVisitorTest, FullTree) {
   TestContextRecorders(tree, expect);
 }
 
+TEST(TreeContextVisitorTest, LoneLeaf) {
+  auto tree = XLeaf(1);
+  const std::vector<std::vector<int>> expect = {
+      {},
+  };
+  TestContextRecorders(tree, expect);
+}
+
+TEST(TreeContextVisitorTest, NodeWithSomeNullptrs) {
+  auto tree = TNode(1, nullptr, TNode(2), nullptr, XLeaf(3));
+  const std::vector<std::vector<int>> expect = {
+      {},
+      {1},
+      {1},
+  };
+  TestContextRecorders(tree, expect);
+}
+
+// Records the order of entering and leaving nodes, by tag.
+// Left nodes are recorded as negative tags.
+class EnterLeaveRecorder : public IterativeTreeContextVisitor {
+ public:
+  void VisitLeaf(const SyntaxTreeLeaf& leaf) override {
+    events_.push_back(leaf.Tag().tag);
+  }
+
+  void VisitNode(const SyntaxTreeNode& node) override {
+    events_.push_back(node.Tag().tag);
+  }
+
+  void LeaveNode(const SyntaxTreeNode& node) override {
+    // The context no longer includes 'node'.
+    EXPECT_TRUE(Context().empty() || &Context().top() != &node);
+    events_.push_back(-node.Tag().tag);
+  }
+
+  const std::vector<int>& Events() const { return events_; }
+
+ private:
+  std::vector<int> events_;
+};
+
+TEST(IterativeTreeContextVisitorTest, EnterAndLeaveOrder) {
+  auto tree = TNode(3,                    //
+                    TNode(4,              //
+                          XLeaf(99),      //
+                          TNode(1)),      //
+                    XLeaf(5),             //
+                    TNode(6, TNode(2)));  //
+  EnterLeaveRecorder r;
+  r.Traverse(*tree);
+  EXPECT_THAT(r.Events(), ElementsAreArray({3, 4, 99, 1, -1, -4, 5, 6, 2, -2,
+                                            -6, -3}));
+}
+
+// Records entering and leaving nodes, leaving them with actions passed to
+// VisitChildrenLater(), except for nodes tagged 0, whose children it visits
+// right away, between calls to TreeContextVisitor::Visit().
+class LaterEnterLeaveRecorder : public TreeContextVisitor {
+ public:
+  void Visit(const SyntaxTreeLeaf& leaf) override {
+    events_.push_back(leaf.Tag().tag);
+  }
+
+  void Visit(const SyntaxTreeNode& node) override {
+    const int tag = node.Tag().tag;
+    events_.push_back(tag);
+    if (tag == 0) {
+      for (const auto& child : node.children()) {
+        TreeContextVisitor::Visit(down_cast<const SyntaxTreeNode&>(*child));
+      }
+      events_.push_back(-100);
+      return;
+    }
+    VisitChildrenLater(node, [this, &node, tag] {
+      // The context no longer includes 'node'.
+      EXPECT_TRUE(Context().empty() || &Context().top() != &node);
+      events_.push_back(-tag);
+    });
+  }
+
+  const std::vector<int>& Events() const { return events_; }
+
+ private:
+  std::vector<int> events_;
+};
+
+TEST(TreeContextVisitorTest, VisitChildrenLaterOrder) {
+  auto tree = TNode(3,                                   //
+                    TNode(4,                             //
+                          XLeaf(99),                     //
+                          TNode(1)),                     //
+                    XLeaf(5),                            //
+                    TNode(0, TNode(6, TNode(2)), TNode(7, XLeaf(8))));
+  LaterEnterLeaveRecorder r;
+  tree->Accept(&r);
+  // Children of the nodes tagged 0 are not themselves visited.
+  EXPECT_THAT(r.Events(),
+              ElementsAreArray({3, 4, 99, 1, -1, -4, 5, 0, 2, -2, 8, -100, -3}));
+}
+
+// Counts the nodes and leaves, and the maximum depth.
+class DepthCounter : public IterativeTreeContextVisitor {
+ public:
+  void VisitLeaf(const SyntaxTreeLeaf& leaf) override {
+    ++leaves_;
+    max_depth_ = std::max(max_depth_, Context().size());
+  }
+
+  void VisitNode(const SyntaxTreeNode& node) override { ++nodes_; }
+
+  size_t nodes_ = 0;
+  size_t leaves_ = 0;
+  size_t max_depth_ = 0;
+};
+
+TEST(IterativeTreeContextVisitorTest, VeryDeepTree) {
+  // Deep enough that recursive traversal would overflow the call stack.
+  constexpr size_t kDepth = 1000000;
+  SymbolPtr tree = XLeaf(0);
+  for (size_t i = 0; i < kDepth; ++i) {
+    tree = TNode(1, std::move(tree));
+  }
+
+  DepthCounter counter;
+  counter.Traverse(*tree);
+  EXPECT_EQ(counter.nodes_, kDepth);
+  EXPECT_EQ(counter.leaves_, 1);
+  EXPECT_EQ(counter.max_depth_, kDepth);
+}
+
+// Same as DepthCounter, with children visited by VisitChildrenLater().
+class LaterDepthCounter : public TreeContextVisitor {
+ public:
+  void Visit(const SyntaxTreeLeaf& leaf) override {
+    ++leaves_;
+    max_depth_ = std::max(max_depth_, Context().size());
+  }
+
+  void Visit(const SyntaxTreeNode& node) override {
+    ++nodes_;
+    VisitChildrenLater(node, [this] { ++left_; });
+  }
+
+  size_t nodes_ = 0;
+  size_t left_ = 0;
+  size_t leaves_ = 0;
+  size_t max_depth_ = 0;
+};
+
+TEST(TreeContextVisitorTest, VeryDeepTree) {
+  // Deep enough that recursive traversal would overflow the call stack.
+  constexpr size_t kDepth = 1000000;
+  SymbolPtr tree = XLeaf(0);
+  for (size_t i = 0; i < kDepth; ++i) {
+    tree = TNode(1, std::move(tree));
+  }
+
+  LaterDepthCounter counter;
+  tree->Accept(&counter);
+  EXPECT_EQ(counter.nodes_, kDepth);
+  EXPECT_EQ(counter.left_, kDepth);
+  EXPECT_EQ(counter.leaves_, 1);
+  EXPECT_EQ(counter.max_depth_, kDepth);
+}
+
 // Test class demonstrating visitation and path tracking
 class PathRecorder : public TreeContextPathVisitor {
  public:
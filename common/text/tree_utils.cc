@@ -37,55 +37,50 @@
 namespace verible {
 
 const Symbol* DescendThroughSingletons(const Symbol& symbol) {
-  if (symbol.Kind() == SymbolKind::kLeaf) {
-    return &symbol;
-  }
-  // else is a kNode
-  const auto& node = SymbolCastToNode(symbol);
-  const auto& children = node.children();
-  if (children.size() == 1 && children.front() != nullptr) {
+  const Symbol* current = &symbol;
+  while (current->Kind() == SymbolKind::kNode) {
+    const auto& children = SymbolCastToNode(*current).children();
     // If only child is non-null, descend.
-    return DescendThroughSingletons(*children.front());
-    // TODO(fangism): rewrite non-recursively.
+    if (children.size() != 1 || children.front() == nullptr) break;
+    current = children.front().get();
   }
-  return &symbol;
+  return current;
 }
 
-const SyntaxTreeLeaf* GetRightmostLeaf(const Symbol& symbol) {
-  if (symbol.Kind() == SymbolKind::kLeaf) {
-    return &SymbolCastToLeaf(symbol);
-  }
-
-  const auto& node = SymbolCastToNode(symbol);
+// The leftmost and rightmost leaves are searched depth-first with an explicit
+// stack, so that trees of any depth can be searched.
 
-  for (const auto& child : reversed_view(node.children())) {
-    if (child != nullptr) {
-      const auto* leaf = GetRightmostLeaf(*child);
-      if (leaf != nullptr) {
-        return leaf;
-      }
+const SyntaxTreeLeaf* GetRightmostLeaf(const Symbol& symbol) {
+  std::vector<const Symbol*> pending = {&symbol};
+  while (!pending.empty()) {
+    const Symbol* next = pending.back();
+    pending.pop_back();
+    if (next->Kind() == SymbolKind::kLeaf) {
+      return &SymbolCastToLeaf(*next);
+    }
+    // The last child is on top, to be searched first.
+    const auto& children = SymbolCastToNode(*next).children();
+    for (const auto& child : children) {
+      if (child != nullptr) pending.push_back(child.get());
     }
   }
-
   return nullptr;
 }
 
 const SyntaxTreeLeaf* GetLeftmostLeaf(const Symbol& symbol) {
-  if (symbol.Kind() == SymbolKind::kLeaf) {
-    return &SymbolCastToLeaf(symbol);
-  }
-
-  const auto& node = SymbolCastToNode(symbol);
-
-  for (const auto& child : node.children()) {
-    if (child != nullptr) {
-      const auto* leaf = GetLeftmostLeaf(*child);
-      if (leaf != nullptr) {
-        return leaf;
-      }
+  std::vector<const Symbol*> pending = {&symbol};
+  while (!pending.empty()) {
+    const Symbol* next = pending.back();
+    pending.pop_back();
+    if (next->Kind() == SymbolKind::kLeaf) {
+      return &SymbolCastToLeaf(*next);
+    }
+    // The first child is on top, to be searched first.
+    const auto& children = SymbolCastToNode(*next).children();
+    for (const auto& child : reversed_view(children)) {
+      if (child != nullptr) pending.push_back(child.get());
     }
   }
-
   return nullptr;
 }
 
@@ -35,8 +35,8 @@ namespace verible {
 // Returns the leftmost/rightmost leaf contained in Symbol.
 // null_opt is returned if no leaves are found.
 // If symbol is a leaf node, then it is its own rightmost/leftmost leaf
-// Otherwise, recursively try to find leftmost/rightmost leaf by searching
-//   through node's children.
+// Otherwise, search depth-first through node's children for the
+//   leftmost/rightmost leaf.
 const SyntaxTreeLeaf* GetLeftmostLeaf(const Symbol& symbol);
 const SyntaxTreeLeaf* GetRightmostLeaf(const Symbol& symbol);
 
@@ -0,0 +1,41 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Replaces the global operator new to count the bytes allocated per thread,
+// for ThreadAllocatedBytes().  Only link this into binaries (alwayslink).
+//
+// The array and nothrow forms of the standard library forward to this one,
+// and the default operator delete releases memory with free().
+
+#include <cstdlib>
+#include <new>
+
+#include "absl/base/attributes.h"
+#include "common/util/phase_stats.h"
+
+namespace {
+ABSL_ATTRIBUTE_UNUSED const bool kRegistered =
+    (verible::internal::allocation_counting_enabled = true);
+}  // namespace
+
+void* operator new(std::size_t size) {
+  verible::internal::thread_allocated_bytes += size;
+  if (size == 0) size = 1;
+  while (true) {
+    if (void* ptr = std::malloc(size)) return ptr;
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) throw std::bad_alloc();
+    handler();
+  }
+}
@@ -0,0 +1,49 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/util/phase_stats.h"
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace {
+
+TEST(AllocationCounterTest, Enabled) {
+  EXPECT_TRUE(AllocationCountingEnabled());
+}
+
+TEST(AllocationCounterTest, CountsAllocatedBytes) {
+  const int64_t start = ThreadAllocatedBytes();
+  const auto buffer = std::make_unique<char[]>(1000);
+  EXPECT_GE(ThreadAllocatedBytes() - start, 1000);
+}
+
+TEST(AllocationCounterTest, CountsIntoScopedPhase) {
+  PhaseStatsCollector collector;
+  SetGlobalPhaseStats(&collector);
+  {
+    const ScopedPhase phase("alloc");
+    const std::string text(5000, 'x');
+  }
+  SetGlobalPhaseStats(nullptr);
+  const auto totals = collector.RunTotals();
+  ASSERT_EQ(totals.size(), 1);
+  EXPECT_GE(totals[0].second.allocated_bytes, 5000);
+}
+
+}  // namespace
+}  // namespace verible
@@ -33,6 +33,7 @@
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "common/util/logging.h"
+#include "common/util/phase_stats.h"
 
 namespace fs = std::filesystem;
 
@@ -134,6 +135,7 @@ absl::Status FileExists(const std::string &filename) {
 }
 
 absl::Status GetContents(absl::string_view filename, std::string *content) {
+  const ScopedPhase phase("file-read");
   std::ifstream fs;
   std::istream *stream = nullptr;
   const bool use_stdin = filename == "-";  // convention: honor "-" as stdin
@@ -184,6 +186,15 @@ absl::Status CreateDir(absl::string_view dir) {
   return CreateErrorStatusFromErr("can't create directory", err);
 }
 
+absl::Status CreateDirs(absl::string_view dir) {
+  const std::string path(dir);
+  std::error_code err;
+  if (fs::create_directories(path, err) || err.value() == 0)
+    return absl::OkStatus();
+
+  return CreateErrorStatusFromErr("can't create directories", err);
+}
+
 absl::StatusOr<Directory> ListDir(absl::string_view dir) {
   std::error_code err;
   Directory d;
@@ -74,6 +74,9 @@ std::string JoinPath(absl::string_view base, absl::string_view name);
 // Create directory with given name, return success.
 absl::Status CreateDir(absl::string_view dir);
 
+// Create directory with given name and any missing parent directories.
+absl::Status CreateDirs(absl::string_view dir);
+
 // Returns the content of the directory. POSIX only. Ignores symlinks and
 // unknown nodes which it fails to resolve to a file or a directory. Returns an
 // error status on any read error (doesn't allow partial results) except
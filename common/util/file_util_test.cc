@@ -112,6 +112,18 @@ TEST(FileUtil, CreateDir) {
   EXPECT_EQ(test_content, read_back_content);
 }
 
+TEST(FileUtil, CreateDirs) {
+  const std::string test_dir =
+      file::JoinPath(testing::TempDir(), "test_dirs/a/b");
+  const std::string test_file = file::JoinPath(test_dir, "foo");
+
+  EXPECT_OK(file::CreateDirs(test_dir));
+  EXPECT_OK(file::CreateDirs(test_dir));  // Creating twice should succeed
+
+  EXPECT_OK(file::SetContents(test_file, "nested"));
+  EXPECT_FALSE(file::CreateDirs(file::JoinPath(test_file, "c")).ok());
+}
+
 TEST(FileUtil, StatusErrorReporting) {
   std::string content;
   absl::Status status = file::GetContents("does-not-exist", &content);
@@ -0,0 +1,238 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_COMMON_UTIL_FLAT_TREE_H_
+#define VERIBLE_COMMON_UTIL_FLAT_TREE_H_
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "common/util/logging.h"
+#include "common/util/vector_tree.h"
+
+namespace verible {
+
+// FlatTree stores a tree of values contiguously, in pre-order, with every
+// node linked to its parent, first child and next sibling by position.
+// Every subtree occupies a contiguous range of positions, so a pre-order
+// traversal is a linear scan, and a post-order traversal is a linear scan of
+// the parent links, instead of visiting every node's separately allocated
+// children like VectorTree does.  None of them recurse.
+//
+// Nodes can only be appended, in pre-order, or copied in bulk from a
+// VectorTree.  FlatTree suits trees that are built once and then traversed
+// many times, whereas VectorTree suits trees that are restructured in place.
+//
+// Traversal functions are template parameters, so that they can be inlined.
+template <typename T>
+class FlatTree {
+ public:
+  typedef T value_type;
+
+  // Position of a node, in pre-order.  The root (if any) is at 0.
+  typedef size_t index_type;
+
+  // Position that refers to no node, like a null pointer.
+  static constexpr index_type kNone = std::numeric_limits<index_type>::max();
+
+  FlatTree() = default;
+
+  FlatTree(const FlatTree&) = default;
+  FlatTree(FlatTree&&) = default;
+  FlatTree& operator=(const FlatTree&) = default;
+  FlatTree& operator=(FlatTree&&) = default;
+
+  // Copies the values and shape of 'tree'.
+  explicit FlatTree(const VectorTree<T>& tree)
+      : FlatTree(tree, [](const VectorTree<T>& node) { return node.Value(); }) {
+  }
+
+  // Builds a tree with the shape of 'tree', in which every value is computed
+  // by 'f' from the corresponding node of 'tree'.
+  template <typename S, typename F>
+  FlatTree(const VectorTree<S>& tree, F&& f) {
+    size_t num_nodes = 0;
+    tree.ApplyPreOrder([&num_nodes](const VectorTree<S>&) { ++num_nodes; });
+    reserve(num_nodes);
+    // Nodes still to be appended, with their parents' positions, last one
+    // first, so that they are appended in pre-order without recursion.
+    std::vector<std::pair<const VectorTree<S>*, index_type>> pending;
+    pending.emplace_back(&tree, kNone);
+    while (!pending.empty()) {
+      const VectorTree<S>& node = *pending.back().first;
+      const index_type parent = pending.back().second;
+      pending.pop_back();
+      const index_type index = Append(parent, f(node));
+      const auto& children = node.Children();
+      for (auto iter = children.rbegin(); iter != children.rend(); ++iter) {
+        pending.emplace_back(&*iter, index);
+      }
+    }
+  }
+
+  // Reserves space for 'n' nodes.
+  void reserve(size_t n) {
+    values_.reserve(n);
+    parents_.reserve(n);
+    first_children_.reserve(n);
+    next_siblings_.reserve(n);
+  }
+
+  size_t size() const { return values_.size(); }
+
+  bool empty() const { return values_.empty(); }
+
+  // Appends a node with 'value' as the last child of 'parent', and returns
+  // its position.  To keep the nodes in pre-order, 'parent' must be the last
+  // node or one of its ancestors.  Pass kNone to append the root of an empty
+  // tree.
+  // This is amortized constant time, because every node is passed over at
+  // most once when finding the previous sibling of new nodes.
+  index_type Append(index_type parent, T value) {
+    const index_type index = size();
+    if (parent == kNone) {
+      CHECK(empty()) << "A tree can only have one root.";
+    } else {
+      CHECK_LT(parent, index);
+      if (parent == index - 1) {
+        first_children_[parent] = index;
+      } else {
+        // Find the previous sibling: the ancestor of the last node that is a
+        // child of 'parent'.
+        index_type sibling = index - 1;
+        while (parents_[sibling] != parent) {
+          sibling = parents_[sibling];
+          CHECK_NE(sibling, kNone)
+              << "Parent must be the last node or one of its ancestors.";
+        }
+        next_siblings_[sibling] = index;
+      }
+    }
+    values_.push_back(std::move(value));
+    parents_.push_back(parent);
+    first_children_.push_back(kNone);
+    next_siblings_.push_back(kNone);
+    return index;
+  }
+
+  // Accessors and navigation, all in constant time:
+
+  const T& Value(index_type index) const { return values_[index]; }
+
+  T& Value(index_type index) { return values_[index]; }
+
+  // Returns the parent of the node at 'index', or kNone for the root.
+  index_type Parent(index_type index) const { return parents_[index]; }
+
+  // Returns the first child of the node at 'index', or kNone.
+  // In pre-order, this is always index + 1, if it exists.
+  index_type FirstChild(index_type index) const {
+    return first_children_[index];
+  }
+
+  // Returns the next sibling of the node at 'index', or kNone.
+  index_type NextSibling(index_type index) const {
+    return next_siblings_[index];
+  }
+
+  bool is_leaf(index_type index) const { return FirstChild(index) == kNone; }
+
+  // Returns the position after the last descendant of the node at 'index'.
+  // The node and its descendants occupy [index, SubtreeEnd(index)).
+  // This takes time proportional to the number of ancestors.
+  index_type SubtreeEnd(index_type index) const {
+    for (; index != kNone; index = Parent(index)) {
+      const index_type next = NextSibling(index);
+      if (next != kNone) return next;
+    }
+    return size();
+  }
+
+  // Applies 'f' to the position of every child of the node at 'index', in
+  // order.
+  template <typename F>
+  void ForEachChild(index_type index, F&& f) const {
+    for (index_type child = FirstChild(index); child != kNone;
+         child = NextSibling(child)) {
+      f(child);
+    }
+  }
+
+  // Applies 'f' to every value, in pre-order traversal (non-modifying).
+  template <typename F>
+  void ApplyPreOrder(F&& f) const {
+    for (const auto& value : values_) f(value);
+  }
+
+  // Applies 'f' to every value, in pre-order traversal (modifying).
+  template <typename F>
+  void ApplyPreOrder(F&& f) {
+    for (auto& value : values_) f(value);
+  }
+
+  // Applies 'f' to every value, in post-order traversal (non-modifying).
+  template <typename F>
+  void ApplyPostOrder(F&& f) const {
+    ApplyPostOrderIndices([this, &f](index_type index) { f(Value(index)); });
+  }
+
+  // Applies 'f' to every value, in post-order traversal (modifying).
+  template <typename F>
+  void ApplyPostOrder(F&& f) {
+    ApplyPostOrderIndices([this, &f](index_type index) { f(Value(index)); });
+  }
+
+  // Applies 'f' to every position, in pre-order: 0, 1, 2, ...
+  template <typename F>
+  void ApplyPreOrderIndices(F&& f) const {
+    for (index_type index = 0; index < size(); ++index) f(index);
+  }
+
+  // Applies 'f' to every position, in post-order.
+  // This scans the parent links in pre-order, and keeps the ancestors of the
+  // current node on a stack, so it does not recurse.
+  template <typename F>
+  void ApplyPostOrderIndices(F&& f) const {
+    std::vector<index_type> ancestors;
+    for (index_type index = 0; index < size(); ++index) {
+      // Every subtree that 'index' is not in is complete.
+      const index_type parent = Parent(index);
+      while (!ancestors.empty() && ancestors.back() != parent) {
+        f(ancestors.back());
+        ancestors.pop_back();
+      }
+      ancestors.push_back(index);
+    }
+    while (!ancestors.empty()) {
+      f(ancestors.back());
+      ancestors.pop_back();
+    }
+  }
+
+ private:
+  // Node values, in pre-order.
+  std::vector<T> values_;
+
+  // Links between nodes, parallel to values_.  These are separate arrays
+  // so that traversals that need only one kind of link scan it densely.
+  std::vector<index_type> parents_;
+  std::vector<index_type> first_children_;
+  std::vector<index_type> next_siblings_;
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_FLAT_TREE_H_
@@ -0,0 +1,130 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares whole-tree traversals of VectorTree, through std::function and
+// through inlined functions, with those of FlatTree.  The tree is shaped like
+// the token partitions of a large file: many top-level items, each a few
+// levels deep.
+
+#include <cstddef>
+#include <functional>
+
+#include "benchmark/benchmark.h"
+#include "common/util/flat_tree.h"
+#include "common/util/vector_tree.h"
+
+namespace verible {
+namespace {
+
+// Appends a subtree with (fanout^depth) leaves under 'node'.
+void AddChildren(VectorTree<int>* node, int depth, int fanout, int* counter) {
+  if (depth == 0) return;
+  for (int i = 0; i < fanout; ++i) {
+    AddChildren(node->NewChild((*counter)++), depth - 1, fanout, counter);
+  }
+}
+
+const VectorTree<int>& BenchmarkVectorTree() {
+  static const VectorTree<int>* const tree = [] {
+    int counter = 0;
+    auto* root = new VectorTree<int>(counter++);
+    for (int i = 0; i < 2000; ++i) {
+      AddChildren(root->NewChild(counter++), 3, 5, &counter);  // 156 nodes
+    }
+    return root;
+  }();
+  return *tree;
+}
+
+const FlatTree<int>& BenchmarkFlatTree() {
+  static const FlatTree<int>* const tree =
+      new FlatTree<int>(BenchmarkVectorTree());
+  return *tree;
+}
+
+void BM_VectorTreePreOrderStdFunction(benchmark::State& state) {
+  const auto& tree = BenchmarkVectorTree();
+  for (auto _ : state) {
+    size_t sum = 0;
+    const std::function<void(const int&)> f = [&sum](int v) { sum += v; };
+    tree.ApplyPreOrder(f);
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_VectorTreePreOrderStdFunction);
+
+void BM_VectorTreePreOrder(benchmark::State& state) {
+  const auto& tree = BenchmarkVectorTree();
+  for (auto _ : state) {
+    size_t sum = 0;
+    tree.ApplyPreOrder([&sum](int v) { sum += v; });
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_VectorTreePreOrder);
+
+void BM_FlatTreePreOrder(benchmark::State& state) {
+  const auto& tree = BenchmarkFlatTree();
+  for (auto _ : state) {
+    size_t sum = 0;
+    tree.ApplyPreOrder([&sum](int v) { sum += v; });
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_FlatTreePreOrder);
+
+void BM_VectorTreePostOrderStdFunction(benchmark::State& state) {
+  const auto& tree = BenchmarkVectorTree();
+  for (auto _ : state) {
+    size_t sum = 0;
+    const std::function<void(const int&)> f = [&sum](int v) { sum += v; };
+    tree.ApplyPostOrder(f);
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_VectorTreePostOrderStdFunction);
+
+void BM_VectorTreePostOrder(benchmark::State& state) {
+  const auto& tree = BenchmarkVectorTree();
+  for (auto _ : state) {
+    size_t sum = 0;
+    tree.ApplyPostOrder([&sum](int v) { sum += v; });
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_VectorTreePostOrder);
+
+void BM_FlatTreePostOrder(benchmark::State& state) {
+  const auto& tree = BenchmarkFlatTree();
+  for (auto _ : state) {
+    size_t sum = 0;
+    tree.ApplyPostOrder([&sum](int v) { sum += v; });
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_FlatTreePostOrder);
+
+void BM_FlatTreeFromVectorTree(benchmark::State& state) {
+  const auto& tree = BenchmarkVectorTree();
+  for (auto _ : state) {
+    FlatTree<int> flat(tree);
+    benchmark::DoNotOptimize(flat.size());
+  }
+}
+BENCHMARK(BM_FlatTreeFromVectorTree);
+
+}  // namespace
+}  // namespace verible
+
+BENCHMARK_MAIN();
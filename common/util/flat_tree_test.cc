@@ -0,0 +1,179 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/flat_tree.h"
+
+#include <cstddef>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "common/util/vector_tree.h"
+#include "common/util/vector_tree_test_util.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using verible::testing::MakeExampleFamilyTree;
+using verible::testing::NamedInterval;
+using verible::testing::VectorTreeTestType;
+
+using FlatTreeTestType = FlatTree<NamedInterval>;
+
+constexpr size_t kNone = FlatTreeTestType::kNone;
+
+std::vector<absl::string_view> PreOrderNames(const FlatTreeTestType& tree) {
+  std::vector<absl::string_view> names;
+  tree.ApplyPreOrder(
+      [&names](const NamedInterval& value) { names.push_back(value.name); });
+  return names;
+}
+
+std::vector<absl::string_view> PostOrderNames(const FlatTreeTestType& tree) {
+  std::vector<absl::string_view> names;
+  tree.ApplyPostOrder(
+      [&names](const NamedInterval& value) { names.push_back(value.name); });
+  return names;
+}
+
+TEST(FlatTreeTest, Empty) {
+  const FlatTreeTestType tree;
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.size(), 0);
+  EXPECT_THAT(PreOrderNames(tree), ElementsAre());
+  EXPECT_THAT(PostOrderNames(tree), ElementsAre());
+}
+
+TEST(FlatTreeTest, RootOnly) {
+  const FlatTreeTestType tree(verible::testing::MakeRootOnlyExampleTree());
+  ASSERT_EQ(tree.size(), 1);
+  EXPECT_EQ(tree.Parent(0), kNone);
+  EXPECT_EQ(tree.FirstChild(0), kNone);
+  EXPECT_EQ(tree.NextSibling(0), kNone);
+  EXPECT_TRUE(tree.is_leaf(0));
+  EXPECT_EQ(tree.SubtreeEnd(0), 1);
+  EXPECT_THAT(PreOrderNames(tree), ElementsAre("root"));
+  EXPECT_THAT(PostOrderNames(tree), ElementsAre("root"));
+}
+
+TEST(FlatTreeTest, FamilyTreeLinks) {
+  const FlatTreeTestType tree(MakeExampleFamilyTree());
+  ASSERT_EQ(tree.size(), 7);
+  // Pre-order positions:
+  // 0: grandparent, 1: parent1, 2: child1, 3: child2,
+  // 4: parent2, 5: child3, 6: child4
+  const std::vector<size_t> parents = {kNone, 0, 1, 1, 0, 4, 4};
+  const std::vector<size_t> first_children = {1,     2,     kNone, kNone,
+                                              5,     kNone, kNone};
+  const std::vector<size_t> next_siblings = {kNone, 4, 3,    kNone,
+                                             kNone, 6, kNone};
+  const std::vector<size_t> subtree_ends = {7, 4, 3, 4, 7, 6, 7};
+  for (size_t i = 0; i < tree.size(); ++i) {
+    EXPECT_EQ(tree.Parent(i), parents[i]) << i;
+    EXPECT_EQ(tree.FirstChild(i), first_children[i]) << i;
+    EXPECT_EQ(tree.NextSibling(i), next_siblings[i]) << i;
+    EXPECT_EQ(tree.SubtreeEnd(i), subtree_ends[i]) << i;
+  }
+
+  std::vector<size_t> children;
+  tree.ForEachChild(0,
+                    [&children](size_t child) { children.push_back(child); });
+  EXPECT_THAT(children, ElementsAre(1, 4));
+}
+
+TEST(FlatTreeTest, FamilyTreeTraversalsMatchVectorTree) {
+  const VectorTreeTestType vector_tree(MakeExampleFamilyTree());
+  const FlatTreeTestType tree(vector_tree);
+
+  std::vector<NamedInterval> expect_pre_order;
+  vector_tree.ApplyPreOrder([&expect_pre_order](const NamedInterval& value) {
+    expect_pre_order.push_back(value);
+  });
+  std::vector<NamedInterval> pre_order;
+  tree.ApplyPreOrder(
+      [&pre_order](const NamedInterval& value) { pre_order.push_back(value); });
+  EXPECT_THAT(pre_order, ElementsAreArray(expect_pre_order));
+
+  std::vector<NamedInterval> expect_post_order;
+  vector_tree.ApplyPostOrder([&expect_post_order](const NamedInterval& value) {
+    expect_post_order.push_back(value);
+  });
+  std::vector<NamedInterval> post_order;
+  tree.ApplyPostOrder([&post_order](const NamedInterval& value) {
+    post_order.push_back(value);
+  });
+  EXPECT_THAT(post_order, ElementsAreArray(expect_post_order));
+}
+
+TEST(FlatTreeTest, TransformValues) {
+  const FlatTree<int> tree(MakeExampleFamilyTree(),
+                           [](const VectorTreeTestType& node) {
+                             return int(node.Children().size());
+                           });
+  std::vector<int> values;
+  tree.ApplyPreOrder([&values](int value) { values.push_back(value); });
+  EXPECT_THAT(values, ElementsAre(2, 2, 0, 0, 2, 0, 0));
+}
+
+TEST(FlatTreeTest, MutateValues) {
+  FlatTreeTestType tree(MakeExampleFamilyTree());
+  tree.ApplyPreOrder([](NamedInterval& value) { ++value.left; });
+  int order = 0;
+  tree.ApplyPostOrder(
+      [&order](NamedInterval& value) { value.right = order++; });
+  EXPECT_EQ(tree.Value(0).left, 1);
+  EXPECT_EQ(tree.Value(0).right, 6);
+  EXPECT_EQ(tree.Value(2).left, 1);
+  EXPECT_EQ(tree.Value(2).right, 0);
+}
+
+TEST(FlatTreeTest, AppendInPreOrder) {
+  FlatTree<int> tree;
+  EXPECT_EQ(tree.Append(kNone, 10), 0);
+  EXPECT_EQ(tree.Append(0, 11), 1);
+  EXPECT_EQ(tree.Append(1, 12), 2);
+  EXPECT_EQ(tree.Append(0, 13), 3);  // closes the subtree of 1
+  EXPECT_EQ(tree.Append(0, 14), 4);
+  EXPECT_EQ(tree.Append(4, 15), 5);
+
+  EXPECT_EQ(tree.NextSibling(1), 3);
+  EXPECT_EQ(tree.NextSibling(3), 4);
+  EXPECT_EQ(tree.NextSibling(4), kNone);
+  EXPECT_EQ(tree.FirstChild(4), 5);
+  std::vector<int> post_order;
+  tree.ApplyPostOrder(
+      [&post_order](int value) { post_order.push_back(value); });
+  EXPECT_THAT(post_order, ElementsAre(12, 11, 13, 15, 14, 10));
+}
+
+TEST(FlatTreeTest, AppendSecondRoot) {
+  FlatTree<int> tree;
+  tree.Append(kNone, 1);
+  EXPECT_DEATH(tree.Append(kNone, 2), "one root");
+}
+
+TEST(FlatTreeTest, AppendToClosedSubtree) {
+  FlatTree<int> tree;
+  tree.Append(kNone, 1);
+  tree.Append(0, 2);
+  tree.Append(0, 3);
+  // Node 1 is not the last node, nor one of its ancestors.
+  EXPECT_DEATH(tree.Append(1, 4), "ancestors");
+}
+
+}  // namespace
+}  // namespace verible
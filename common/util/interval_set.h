@@ -15,11 +15,15 @@
 #ifndef VERIBLE_COMMON_UTIL_INTERVAL_SET_H_
 #define VERIBLE_COMMON_UTIL_INTERVAL_SET_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <map>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 #include "absl/random/random.h"
 #include "absl/strings/numbers.h"
@@ -47,7 +51,7 @@ std::ostream& FormatIntervals(std::ostream& stream, Iter begin, Iter end) {
              });
 }
 
-// Non-template private implementation class of IntervalSet.
+// Non-template private implementation class of DisjointIntervalSet.
 class _IntervalSetImpl {
  protected:
   // Returns the first (interval) iterator that spans or follows 'value'.
@@ -135,10 +139,16 @@ class _IntervalSetImpl {
 // non-overlapping [min, max) intervals.
 // Mutating operations will automatically merge abutting intervals.
 // Type T must be std::less-comparable for binary-search-ability.
+//
+// Intervals are stored in a sorted vector, which makes queries (the most
+// frequent operation, e.g. per token while formatting) cheap binary searches
+// over contiguous memory.  Adding or removing an interval in the middle of the
+// set is O(N) in the number of intervals, so prefer AddIntervals() (or the
+// initializer-list constructor) to build sets from many unordered intervals.
 template <typename T>
-class IntervalSet : private _IntervalSetImpl {
+class IntervalSet {
  private:
-  typedef std::map<T, T> impl_type;
+  typedef std::vector<std::pair<T, T>> impl_type;
 
  protected:
   typedef typename impl_type::iterator iterator;
@@ -153,11 +163,8 @@ class IntervalSet : private _IntervalSetImpl {
  public:
   IntervalSet() = default;
   IntervalSet(std::initializer_list<Interval<T>> ranges) {
-    // Add-ing will properly fuse overlapping intervals and maintain intervals_'
-    // invariants.
-    for (const auto& range : ranges) {
-      Add(range);
-    }
+    // Fuses overlapping intervals and maintains intervals_' invariants.
+    AddIntervals(ranges.begin(), ranges.end());
   }
 
   IntervalSet(const IntervalSet<T>&) = default;
@@ -196,7 +203,8 @@ class IntervalSet : private _IntervalSetImpl {
 
   // Returns true if value is a member of an interval in the set.
   bool Contains(const T& value) const {
-    return Find(value) != intervals_.end();
+    const auto index = LastIndexStartingAtOrBefore(value);
+    return index >= 0 && value < intervals_[index].second;
   }
 
   // Returns true if interval is entirely contained by an interval in the set.
@@ -209,146 +217,108 @@ class IntervalSet : private _IntervalSetImpl {
 
   // Returns the first (interval) iterator that spans or follows 'value'.
   const_iterator LowerBound(const T& value) const {
-    return _IntervalSetImpl::FindLowerBound(intervals_, value);
+    return intervals_.begin() + LowerBoundIndex(value);
   }
 
   // Returns the first (interval) iterator that follows 'value'.
   const_iterator UpperBound(const T& value) const {
-    return intervals_.upper_bound(value);
+    return intervals_.begin() + (LastIndexStartingAtOrBefore(value) + 1);
   }
 
   // Returns an iterator to the interval that entirely contains [min,max),
   // or the end iterator if no such interval exists, or the input is empty.
   const_iterator Find(const Interval<T>& interval) const {
-    return _IntervalSetImpl::FindSpanningInterval(intervals_, interval);
+    return intervals_.begin() + FindIndex(interval);
   }
 
   // Returns an iterator to the interval that contains 'value',
   // or the end iterator if no such interval exists.
   const_iterator Find(const T& value) const {
-    return _IntervalSetImpl::FindSpanningInterval(intervals_, value);
+    return intervals_.begin() + FindIndex(value);
   }
 
   // Adds an interval to the interval set.
   // Also fuses any intervals that may result from the addition.
+  // Run-time: O(lg N) to add after the last interval, else O(N), where N is
+  // the number of existing intervals.
   void Add(const Interval<T>& interval) {
     CHECK(interval.valid());
     if (interval.empty()) return;  // adding empty interval changes nothing
     const auto& min = interval.min;
     const auto& max = interval.max;
 
-    T new_max = max;
-    iterator erase_end;
-    const auto max_lb = LowerBound(max);
-    if (max_lb == intervals_.end()) {
-      // erase all the way to the end
-      erase_end = max_lb;
-    } else if (AsInterval(*max_lb).contains(max)) {
-      // erase this interval, but use its max (.second)
-      erase_end = std::next(max_lb);
-      new_max = max_lb->second;
+    // Find the range of intervals that overlap or abut the new one.
+    const auto fuse_begin = std::partition_point(
+        intervals_.begin(), intervals_.end(),
+        [&min](const value_type& i) { return i.second < min; });
+    const auto fuse_end = std::partition_point(
+        fuse_begin, intervals_.end(),
+        [&max](const value_type& i) { return !(max < i.first); });
+    if (fuse_begin == fuse_end) {
+      intervals_.emplace(fuse_begin, min, max);
     } else {
-      // erase up to the interval before this one
-      erase_end = max_lb;
+      // Re-use the first of the fused intervals, and erase the others.
+      fuse_begin->first = std::min(fuse_begin->first, min);
+      fuse_begin->second = std::max(std::prev(fuse_end)->second, max);
+      intervals_.erase(std::next(fuse_begin), fuse_end);
     }
 
-    iterator erase_begin;
-    const auto p = intervals_.insert({min, new_max});  // (bool, iterator)
-    if (p.second) {
-      // new interval was successfully inserted at p.first
-      // If this abuts or overlaps with the previous interval, update that
-      // one with new_max, and discard this one.
-      if (p.first == intervals_.begin()) {
-        erase_begin = std::next(p.first);
-      } else {
-        const auto prev = std::prev(p.first);
-        if (prev->second >= min) {
-          prev->second = new_max;
-          erase_begin = p.first;
-        } else {
-          erase_begin = std::next(p.first);
-        }
-      }
-    } else {
-      // new interval was not inserted because there already exist key=min.
-      // Re-use that interval, but update its max.
-      p.first->second = new_max;
-      // Erase intervals starting after that one.
-      erase_begin = std::next(p.first);
-    }
-
-    // Finally erase range of obsolete intervals to maintain invariants.
-    intervals_.erase(erase_begin, erase_end);
-
     CheckIntegrity();
   }
 
   // Adds a single value to the interval set.
   void Add(const T& value) { Add({value, value + 1}); }
 
+  // Adds all intervals in [begin, end), in any order, at once.
+  // Iter can point to any Interval<> or any type constructible to Interval<>
+  // (like std::pair).
+  // Run-time: O((N + M) lg (N + M)), where N is the number of existing
+  // intervals, and M is the number of added intervals.
+  template <class Iter>
+  void AddIntervals(Iter begin, Iter end) {
+    for (const auto& range : make_range(begin, end)) {
+      const Interval<T> interval(AsInterval(range));
+      CHECK(interval.valid());
+      if (interval.empty()) continue;
+      intervals_.emplace_back(interval.min, interval.max);
+    }
+    SortAndFuse();
+  }
+
   // Removes an interval from the set.
-  // Run-time: O(lg N), where N is the number of existing intervals.
+  // Run-time: O(N), where N is the number of existing intervals.
   void Difference(const Interval<T>& interval) {
     CHECK(interval.valid());
     if (interval.empty()) return;  // removing an empty interval changes nothing
     const auto& min = interval.min;
     const auto& max = interval.max;
 
-    iterator erase_end;
-    bool replace_upper = false;
-    Interval<T> replaced_upper_interval;
-    const auto max_ub = UpperBound(max);
-    if (max_ub == intervals_.begin()) {
-      return;  // interval is out of range of this set
-    }
-    {
-      const auto prev = std::prev(max_ub);
-      if (AsInterval(*prev).contains(max)) {
-        if (prev->first == max) {
-          erase_end = prev;  // erase up to this interval
-        } else {
-          // max falls in the middle of this prev interval
-          erase_end = max_ub;  // erase including this interval
-          // Add new interval with higher min, which will be ordered after prev.
-          replaced_upper_interval = {max, prev->second};
-          replace_upper = replaced_upper_interval.valid() &&
-                          !replaced_upper_interval.empty();
-        }
-      } else {
-        erase_end = max_ub;
-      }
-    }
-
-    iterator erase_begin;
-    bool replace_lower = false;
-    Interval<T> replaced_lower_interval;
-    const auto min_lb = LowerBound(min);
-    if (min_lb == intervals_.end()) {
-      return;  // interval is out of range of this set
-    } else if (AsInterval(*min_lb).contains(min)) {
-      if (min_lb->first == min) {
-        erase_begin = min_lb;  // erase starting at this interval
-        replaced_lower_interval = {max, min_lb->second};
-        replace_lower =
-            replaced_lower_interval.valid() && !replaced_lower_interval.empty();
-      } else {
-        // FIXME
-        min_lb->second = min;  // reduce the upper bound of matching interval
-        erase_begin = std::next(min_lb);  // erase starting past this interval
+    // Find the range of intervals that overlap the removed one.
+    const auto erase_begin = std::partition_point(
+        intervals_.begin(), intervals_.end(),
+        [&min](const value_type& i) { return !(min < i.second); });
+    const auto erase_end = std::partition_point(
+        erase_begin, intervals_.end(),
+        [&max](const value_type& i) { return i.first < max; });
+    if (erase_begin == erase_end) return;  // nothing overlaps
+
+    // Keep the parts of the first and last intervals outside of [min, max).
+    const value_type lower{erase_begin->first, min};
+    const value_type upper{max, std::prev(erase_end)->second};
+    const bool keep_lower = lower.first < lower.second;
+    const bool keep_upper = upper.first < upper.second;
+    auto kept = erase_begin;
+    if (keep_lower) *kept++ = lower;
+    if (keep_upper) {
+      if (kept == erase_end) {
+        // [min, max) splits the only overlapping interval in two.
+        intervals_.insert(kept, upper);
+        CheckIntegrity();
+        return;
       }
-    } else {  // min is to the left of the first interval we might erase
-      erase_begin = min_lb;
-    }
-
-    // Erase range of obsolete intervals.
-    intervals_.erase(erase_begin, erase_end);
-
-    // Add new interval as necessary.
-    if (replace_lower) {
-      AddUnsafe(replaced_lower_interval);
-    } else if (replace_upper) {
-      AddUnsafe(replaced_upper_interval);
+      *kept++ = upper;
     }
+    intervals_.erase(kept, erase_end);
 
     CheckIntegrity();
   }
@@ -357,20 +327,43 @@ class IntervalSet : private _IntervalSetImpl {
   void Difference(const T& value) { Difference({value, value + 1}); }
 
   // Subtracts all intervals in the other set from this one.
+  // Run-time: O(N + M), where N and M are the number of intervals in each set.
   void Difference(const IntervalSet<T>& iset) {
-    // TODO(fangism): optimize by implementing with two advancing iterators,
-    // like linear-time sorted-sequence set operations.
-    for (const auto& interval : iset) {
-      Difference(AsInterval(interval));
+    impl_type result;
+    auto subtrahend = iset.intervals_.begin();
+    const auto subtrahends_end = iset.intervals_.end();
+    for (const auto& interval : intervals_) {
+      T min = interval.first;
+      const T& max = interval.second;
+      // Skip over subtracted intervals that end before this one starts.
+      while (subtrahend != subtrahends_end && !(min < subtrahend->second)) {
+        ++subtrahend;
+      }
+      // Cut out every overlapping subtracted interval.
+      for (auto cut = subtrahend; cut != subtrahends_end && cut->first < max;
+           ++cut) {
+        if (min < cut->first) result.emplace_back(min, cut->first);
+        if (!(cut->second < max)) {
+          min = max;
+          break;
+        }
+        min = cut->second;
+      }
+      if (min < max) result.emplace_back(min, max);
     }
+    intervals_.swap(result);
+    CheckIntegrity();
   }
 
   // Adds all intervals in the other set from this one.
+  // Run-time: O(N + M), where N and M are the number of intervals in each set.
   void Union(const IntervalSet<T>& iset) {
-    // Could be optimized with a hand-written linear-merge.
-    for (const auto& interval : iset) {
-      Add(AsInterval(interval));
-    }
+    if (&iset == this) return;
+    const auto middle = intervals_.insert(
+        intervals_.end(), iset.intervals_.begin(), iset.intervals_.end());
+    std::inplace_merge(intervals_.begin(), middle, intervals_.end());
+    Fuse();
+    CheckIntegrity();
   }
 
   // Inverts the set of integers with respect to the given interval bound.
@@ -393,8 +386,10 @@ class IntervalSet : private _IntervalSetImpl {
       // ignore empty intervals that may result from range compression
       if (left == right) continue;
       if (left > right) std::swap(left, right);  // inverting
-      result.AddUnsafe({left, right});
+      result.intervals_.emplace_back(left, right);
     }
+    // An inverting function reverses the order of intervals.
+    std::sort(result.intervals_.begin(), result.intervals_.end());
     result.CheckIntegrity();
     return result;
   }
@@ -455,11 +450,20 @@ class IntervalSet : private _IntervalSetImpl {
 
  protected:
   // This operation is only intended for constructing test expect values.
-  // It does not guarantee any invariants among intervals_.
+  // It does not guarantee any invariants among intervals_, other than their
+  // order by min: an interval with the same min as an existing one replaces
+  // it.
   void AddUnsafe(const Interval<T>& interval) {
     CHECK(interval.valid());
     CHECK(!interval.empty());
-    intervals_[interval.min] = interval.max;
+    const auto iter = std::partition_point(
+        intervals_.begin(), intervals_.end(),
+        [&interval](const value_type& i) { return i.first < interval.min; });
+    if (iter != intervals_.end() && !(interval.min < iter->first)) {
+      iter->second = interval.max;
+    } else {
+      intervals_.emplace(iter, interval.min, interval.max);
+    }
   }
 
   // Checks invariant properties described in class description.
@@ -491,17 +495,92 @@ class IntervalSet : private _IntervalSetImpl {
   // Mutable variants of Find(), LowerBound() are protected to preserve
   // invariants.
   iterator Find(const Interval<T>& interval) {
-    return _IntervalSetImpl::FindSpanningInterval(intervals_, interval);
+    return intervals_.begin() + FindIndex(interval);
   }
   iterator Find(const T& value) {
-    return _IntervalSetImpl::FindSpanningInterval(intervals_, value);
+    return intervals_.begin() + FindIndex(value);
   }
   iterator LowerBound(const T& value) {
-    return _IntervalSetImpl::FindLowerBound(intervals_, value);
+    return intervals_.begin() + LowerBoundIndex(value);
+  }
+  iterator UpperBound(const T& value) {
+    return intervals_.begin() + (LastIndexStartingAtOrBefore(value) + 1);
   }
-  iterator UpperBound(const T& value) { return intervals_.upper_bound(value); }
 
  private:
+  template <typename S>
+  friend class IntervalSet;
+
+  // Returns the index of the last interval whose min is not greater than
+  // 'value', or -1 if there is none.
+  // Each step of this binary search only selects between two pointers, which
+  // compilers turn into a conditional move instead of a hard to predict
+  // branch.
+  std::ptrdiff_t LastIndexStartingAtOrBefore(const T& value) const {
+    if (intervals_.empty()) return -1;
+    const value_type* base = intervals_.data();
+    size_type length = intervals_.size();
+    while (length > 1) {
+      const size_type half = length / 2;
+      base = (value < base[half].first) ? base : base + half;
+      length -= half;
+    }
+    // base can only be after value if it is the first interval.
+    return (base - intervals_.data()) - (value < base->first ? 1 : 0);
+  }
+
+  // Returns the index of the interval that contains 'value', or size().
+  std::ptrdiff_t FindIndex(const T& value) const {
+    const auto index = LastIndexStartingAtOrBefore(value);
+    if (index >= 0 && value < intervals_[index].second) return index;
+    return intervals_.size();
+  }
+
+  // Returns the index of the interval that entirely contains 'interval', or
+  // size().
+  std::ptrdiff_t FindIndex(const Interval<T>& interval) const {
+    CHECK(interval.valid());
+    // Nothing 'contains' an empty interval.
+    if (!interval.empty()) {
+      // Find an interval that contains the lower bound.
+      const auto index = FindIndex(interval.min);
+      // Check if the same interval covers the upper bound.
+      if (index != static_cast<std::ptrdiff_t>(intervals_.size()) &&
+          !(intervals_[index].second < interval.max)) {
+        return index;
+      }
+    }
+    return intervals_.size();
+  }
+
+  // Returns the index of the first interval that spans or follows 'value'.
+  std::ptrdiff_t LowerBoundIndex(const T& value) const {
+    const auto index = LastIndexStartingAtOrBefore(value);
+    if (index >= 0 && value < intervals_[index].second) return index;
+    return index + 1;
+  }
+
+  // Sorts intervals_ by min, and fuses the ones that overlap or abut.
+  void SortAndFuse() {
+    std::sort(intervals_.begin(), intervals_.end());
+    Fuse();
+    CheckIntegrity();
+  }
+
+  // Fuses overlapping and abutting intervals, which must be sorted by min.
+  void Fuse() {
+    if (intervals_.empty()) return;
+    auto last = intervals_.begin();
+    for (auto iter = std::next(last); iter != intervals_.end(); ++iter) {
+      if (!(last->second < iter->first)) {
+        last->second = std::max(last->second, iter->second);
+      } else {
+        *++last = *iter;
+      }
+    }
+    intervals_.erase(std::next(last), intervals_.end());
+  }
+
   // Internal storage of intervals.
   // Invariants: all intervals are
   //   * non-overlapping
@@ -629,6 +708,9 @@ class DisjointIntervalSet : private _IntervalSetImpl {
     return p.first;
   }
 
+  // Removes the interval at 'pos', and returns an iterator to the next one.
+  const_iterator erase(const_iterator pos) { return intervals_.erase(pos); }
+
  private:
   impl_type intervals_;
 };
@@ -0,0 +1,128 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares membership queries and construction of IntervalSet against the
+// std::map based representation that it used to have, for increasing numbers
+// of intervals.
+
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/util/interval.h"
+#include "common/util/interval_set.h"
+
+namespace verible {
+namespace {
+
+// The previous representation of IntervalSet<int>: a map from interval min to
+// interval max.
+class MapIntervalSet {
+ public:
+  void Add(const Interval<int>& interval) {
+    intervals_[interval.min] = interval.max;
+  }
+
+  bool Contains(int value) const {
+    const auto upper_bound = intervals_.upper_bound(value);
+    if (upper_bound == intervals_.begin()) return false;
+    return value < std::prev(upper_bound)->second;
+  }
+
+ private:
+  std::map<int, int> intervals_;
+};
+
+// Returns 'count' disjoint intervals of random lengths and gaps, in order,
+// like the disabled byte ranges of a file.
+std::vector<Interval<int>> MakeIntervals(int count) {
+  std::mt19937 generator(count);
+  std::uniform_int_distribution<int> length(1, 64);
+  std::vector<Interval<int>> intervals;
+  int position = 0;
+  for (int i = 0; i < count; ++i) {
+    position += length(generator);  // gap
+    const int min = position;
+    position += length(generator);
+    intervals.push_back({min, position});
+  }
+  return intervals;
+}
+
+// Random values to query, spanning all intervals.
+std::vector<int> MakeQueries(const std::vector<Interval<int>>& intervals) {
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<int> value(
+      0, intervals.empty() ? 0 : intervals.back().max);
+  std::vector<int> queries(4096);
+  for (auto& query : queries) query = value(generator);
+  return queries;
+}
+
+void BM_IntervalSetContains(benchmark::State& state) {
+  const std::vector<Interval<int>> intervals(MakeIntervals(state.range(0)));
+  IntervalSet<int> set;
+  set.AddIntervals(intervals.begin(), intervals.end());
+  const std::vector<int> queries(MakeQueries(intervals));
+  for (auto _ : state) {
+    for (const int query : queries) {
+      benchmark::DoNotOptimize(set.Contains(query));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_IntervalSetContains)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+void BM_MapIntervalSetContains(benchmark::State& state) {
+  const std::vector<Interval<int>> intervals(MakeIntervals(state.range(0)));
+  MapIntervalSet set;
+  for (const auto& interval : intervals) set.Add(interval);
+  const std::vector<int> queries(MakeQueries(intervals));
+  for (auto _ : state) {
+    for (const int query : queries) {
+      benchmark::DoNotOptimize(set.Contains(query));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_MapIntervalSetContains)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+void BM_IntervalSetAddIntervals(benchmark::State& state) {
+  const std::vector<Interval<int>> intervals(MakeIntervals(state.range(0)));
+  for (auto _ : state) {
+    IntervalSet<int> set;
+    set.AddIntervals(intervals.begin(), intervals.end());
+    benchmark::DoNotOptimize(set.size());
+  }
+  state.SetItemsProcessed(state.iterations() * intervals.size());
+}
+BENCHMARK(BM_IntervalSetAddIntervals)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+void BM_MapIntervalSetAdd(benchmark::State& state) {
+  const std::vector<Interval<int>> intervals(MakeIntervals(state.range(0)));
+  for (auto _ : state) {
+    MapIntervalSet set;
+    for (const auto& interval : intervals) set.Add(interval);
+    benchmark::DoNotOptimize(set.Contains(0));
+  }
+  state.SetItemsProcessed(state.iterations() * intervals.size());
+}
+BENCHMARK(BM_MapIntervalSetAdd)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+}  // namespace
+}  // namespace verible
+
+BENCHMARK_MAIN();
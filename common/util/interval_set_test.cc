@@ -15,7 +15,10 @@
 #include "common/util/interval_set.h"
 
 #include <initializer_list>
+#include <random>
+#include <set>
 #include <sstream>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -673,6 +676,84 @@ TEST(IntervalSetTest, SetUnions) {
   }
 }
 
+TEST(IntervalSetTest, AddIntervalsUnordered) {
+  interval_set_type set{{20, 22}};
+  const std::vector<interval_type> intervals{
+      {10, 12}, {30, 31}, {0, 0}, {11, 14}, {22, 25}, {1, 2}, {2, 3}};
+  set.AddIntervals(intervals.begin(), intervals.end());
+  const UnsafeIntervalSet expected{{1, 3}, {10, 14}, {20, 25}, {30, 31}};
+  EXPECT_EQ(set, expected);
+}
+
+TEST(IntervalSetTest, AddIntervalsFromPairs) {
+  interval_set_type set;
+  const std::vector<std::pair<int, int>> intervals{{5, 8}, {1, 5}};
+  set.AddIntervals(intervals.begin(), intervals.end());
+  const UnsafeIntervalSet expected{{1, 8}};
+  EXPECT_EQ(set, expected);
+}
+
+// Returns the members of 'set' within [0, limit).
+std::set<int> Members(const interval_set_type& set, int limit) {
+  std::set<int> members;
+  for (int i = 0; i < limit; ++i) {
+    if (set.Contains(i)) members.insert(i);
+  }
+  return members;
+}
+
+// Compares all operations against a std::set of the same values.
+TEST(IntervalSetTest, RandomOperationsMatchSetOfValues) {
+  constexpr int kLimit = 200;
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<int> value(0, kLimit - 1);
+  std::uniform_int_distribution<int> length(0, 12);
+  std::uniform_int_distribution<int> operation(0, 3);
+  interval_set_type set;
+  std::set<int> reference;
+  for (int step = 0; step < 2000; ++step) {
+    const int min = value(generator);
+    const int max = std::min(min + length(generator), kLimit);
+    const interval_type interval{min, max};
+    switch (operation(generator)) {
+      case 0:
+        set.Add(interval);
+        for (int i = interval.min; i < interval.max; ++i) reference.insert(i);
+        break;
+      case 1:
+        set.Difference(interval);
+        for (int i = interval.min; i < interval.max; ++i) reference.erase(i);
+        break;
+      case 2: {
+        const interval_set_type other{interval,
+                                      {std::min(max + 3, kLimit), kLimit}};
+        set.Difference(other);
+        for (int i = 0; i < kLimit; ++i) {
+          if (other.Contains(i)) reference.erase(i);
+        }
+        break;
+      }
+      default: {
+        const interval_set_type other{{0, 1}, interval};
+        set.Union(other);
+        for (int i = 0; i < kLimit; ++i) {
+          if (other.Contains(i)) reference.insert(i);
+        }
+        break;
+      }
+    }
+    ASSERT_EQ(Members(set, kLimit), reference) << "at step " << step;
+    // Every member is found in the interval that LowerBound() returns.
+    const interval_set_type& const_set(set);
+    for (const int i : reference) {
+      const auto found = const_set.LowerBound(i);
+      ASSERT_NE(found, const_set.end());
+      EXPECT_TRUE(AsInterval(*found).contains(i));
+      EXPECT_EQ(const_set.Find(i), found);
+    }
+  }
+}
+
 typedef AddIntervalTestData ComplementTestData;
 
 TEST(IntervalSetTest, ComplementEmptyInitial) {
@@ -1115,6 +1196,20 @@ TEST(DisjointIntervalSetTest, MustEmplaceOverlapsUpper) {
   EXPECT_DEATH(iset.must_emplace(45, 55), "Failed to emplace");
 }
 
+TEST(DisjointIntervalSetTest, Erase) {
+  IntIntervalSet iset;
+  iset.must_emplace(30, 40);
+  iset.must_emplace(50, 60);
+  const auto next = iset.erase(iset.find(35));
+  ASSERT_NE(next, iset.end());
+  EXPECT_EQ(next->first, 50);
+  EXPECT_EQ(iset.find(35), iset.end());
+  // Erased range can be re-occupied.
+  iset.must_emplace(31, 39);
+  EXPECT_EQ(iset.find(35)->first, 31);
+  DisjointIntervalConsistencyCheck(iset);
+}
+
 TEST(DisjointIntervalMapTest, FindInterval) {
   IntIntervalSet iset;
   iset.must_emplace(20, 25);
@@ -201,7 +201,15 @@ class MapTree {
   // TODO(fangism): TryEmplaceHint(), like map::emplace_hint.
 
   // Erasure
-  // TODO(fangism): void Erase(key);
+
+  // Removes the subtree at 'pos', and returns an iterator to the element that
+  // followed it.  Only iterators and pointers into the removed subtree are
+  // invalidated.
+  iterator Erase(iterator pos) { return subtrees_.erase(pos); }
+
+  // Removes the subtree at 'key', if it exists.
+  // Returns the number of subtrees removed (0 or 1).
+  size_t Erase(const key_type& key) { return subtrees_.erase(key); }
 
   // Iteration/Navigation
 
@@ -190,6 +190,45 @@ TEST(MapTreeTest, EmplaceSecondKey) {
   EXPECT_EQ(m.Find(9), first_iter);  // iterator stability on insert
 }
 
+TEST(MapTreeTest, EraseByKey) {
+  MapTreeTestType m("foo",  //
+                    KV{3, MapTreeTestType("bar")},
+                    KV{4, MapTreeTestType("baz")});
+  EXPECT_EQ(m.Erase(5), 0);  // no such key
+  EXPECT_EQ(m.Children().size(), 2);
+
+  const MapTreeTestType* survivor = &m.Find(4)->second;
+  EXPECT_EQ(m.Erase(3), 1);
+  EXPECT_EQ(m.Children().size(), 1);
+  EXPECT_EQ(m.Find(3), m.end());
+  // Remaining nodes are unaffected.
+  EXPECT_EQ(&m.Find(4)->second, survivor);
+  EXPECT_EQ(survivor->Parent(), &m);
+  EXPECT_TRUE(m.CheckIntegrity());
+
+  EXPECT_EQ(m.Erase(3), 0);  // already gone
+}
+
+TEST(MapTreeTest, EraseByIteratorWhileIterating) {
+  MapTreeTestType m("foo",  //
+                    KV{1, MapTreeTestType("a",  //
+                                          KV{5, MapTreeTestType("x")})},
+                    KV{2, MapTreeTestType("b")},  //
+                    KV{3, MapTreeTestType("c")});
+  // Erase nodes with odd keys, including whole subtrees.
+  for (auto iter = m.begin(); iter != m.end();) {
+    if (iter->first % 2) {
+      iter = m.Erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  ASSERT_EQ(m.Children().size(), 1);
+  EXPECT_EQ(m.begin()->first, 2);
+  EXPECT_EQ(m.begin()->second.Value(), "b");
+  EXPECT_TRUE(m.CheckIntegrity());
+}
+
 TEST(MapTreeTest, InitializeMultipleChildrenWithDuplicateKey) {
   const MapTreeTestType m("foo",  //
                           KV{4, MapTreeTestType("bbb")},
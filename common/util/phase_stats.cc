@@ -0,0 +1,219 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/phase_stats.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "json/json.h"
+
+namespace verible {
+
+namespace internal {
+ABSL_CONST_INIT thread_local int64_t thread_allocated_bytes = 0;
+ABSL_CONST_INIT bool allocation_counting_enabled = false;
+}  // namespace internal
+
+namespace {
+ABSL_CONST_INIT std::atomic<PhaseStatsCollector*> global_collector{nullptr};
+ABSL_CONST_INIT thread_local ScopedPhase* current_phase = nullptr;
+ABSL_CONST_INIT thread_local const std::string* current_file = nullptr;
+
+double ToMilliseconds(absl::Duration duration) {
+  return absl::ToDoubleMilliseconds(duration);
+}
+
+Json::Value ToJson(const PhaseStatsCollector::PhaseList& phases) {
+  Json::Value json(Json::arrayValue);
+  for (const auto& phase : phases) {
+    Json::Value entry(Json::objectValue);
+    entry["phase"] = phase.first;
+    entry["count"] = Json::Int64(phase.second.count);
+    entry["wall_ms"] = ToMilliseconds(phase.second.wall_time);
+    entry["cpu_ms"] = ToMilliseconds(phase.second.cpu_time);
+    entry["allocated_bytes"] = Json::Int64(phase.second.allocated_bytes);
+    json.append(entry);
+  }
+  return json;
+}
+}  // namespace
+
+PhaseStats& PhaseStats::operator+=(const PhaseStats& other) {
+  count += other.count;
+  wall_time += other.wall_time;
+  cpu_time += other.cpu_time;
+  allocated_bytes += other.allocated_bytes;
+  return *this;
+}
+
+void PhaseStatsCollector::Record(absl::string_view file,
+                                 absl::string_view phase,
+                                 const PhaseStats& stats) {
+  absl::MutexLock lock(&mutex_);
+  auto& file_stats = stats_[std::string(file)];
+  auto found = file_stats.find(phase);
+  if (found == file_stats.end()) {
+    found = file_stats.emplace(std::string(phase), PhaseStats()).first;
+    if (std::find(phase_order_.begin(), phase_order_.end(), phase) ==
+        phase_order_.end()) {
+      // Nested phases finish first, but are listed after their enclosing one.
+      const std::string prefix = absl::StrCat(phase, "/");
+      const auto first_nested = std::find_if(
+          phase_order_.begin(), phase_order_.end(),
+          [&prefix](const std::string& p) {
+            return absl::StartsWith(p, prefix);
+          });
+      phase_order_.emplace(first_nested, phase);
+    }
+  }
+  found->second += stats;
+}
+
+PhaseStatsCollector::PhaseList PhaseStatsCollector::RunTotals() const {
+  absl::MutexLock lock(&mutex_);
+  PhaseList totals;
+  totals.reserve(phase_order_.size());
+  for (const auto& phase : phase_order_) {
+    PhaseStats total;
+    for (const auto& file_stats : stats_) {
+      const auto found = file_stats.second.find(phase);
+      if (found != file_stats.second.end()) total += found->second;
+    }
+    totals.emplace_back(phase, total);
+  }
+  return totals;
+}
+
+std::map<std::string, PhaseStatsCollector::PhaseList>
+PhaseStatsCollector::PerFile() const {
+  absl::MutexLock lock(&mutex_);
+  std::map<std::string, PhaseList> result;
+  for (const auto& file_stats : stats_) {
+    if (file_stats.first.empty()) continue;
+    auto& phases = result[file_stats.first];
+    for (const auto& phase : phase_order_) {
+      const auto found = file_stats.second.find(phase);
+      if (found != file_stats.second.end()) phases.push_back(*found);
+    }
+  }
+  return result;
+}
+
+void PhaseStatsCollector::PrintTable(std::ostream& stream) const {
+  constexpr int kPhaseWidth = 36;
+  stream << std::left << std::setw(kPhaseWidth) << "phase" << std::right
+         << std::setw(10) << "count" << std::setw(12) << "wall ms"
+         << std::setw(12) << "cpu ms" << std::setw(14) << "alloc KiB"
+         << std::endl;
+  const auto old_flags = stream.flags();
+  const auto old_precision = stream.precision();
+  stream << std::fixed << std::setprecision(2);
+  for (const auto& phase : RunTotals()) {
+    // Indent nested phases under their enclosing phase.
+    const absl::string_view path(phase.first);
+    const int depth = std::count(path.begin(), path.end(), '/');
+    const absl::string_view name = path.substr(path.find_last_of('/') + 1);
+    const PhaseStats& stats = phase.second;
+    stream << std::left << std::setw(kPhaseWidth)
+           << absl::StrCat(std::string(2 * depth, ' '), name) << std::right
+           << std::setw(10) << stats.count << std::setw(12)
+           << ToMilliseconds(stats.wall_time) << std::setw(12)
+           << ToMilliseconds(stats.cpu_time) << std::setw(14);
+    if (AllocationCountingEnabled()) {
+      stream << stats.allocated_bytes / 1024.0;
+    } else {
+      stream << "-";
+    }
+    stream << std::endl;
+  }
+  stream.flags(old_flags);
+  stream.precision(old_precision);
+}
+
+void PhaseStatsCollector::PrintJson(std::ostream& stream) const {
+  Json::Value json(Json::objectValue);
+  json["allocation_counting"] = AllocationCountingEnabled();
+  json["run"] = ToJson(RunTotals());
+  Json::Value& files = json["files"] = Json::Value(Json::arrayValue);
+  for (const auto& file : PerFile()) {
+    Json::Value entry(Json::objectValue);
+    entry["file"] = file.first;
+    entry["phases"] = ToJson(file.second);
+    files.append(entry);
+  }
+  stream << json;
+}
+
+PhaseStatsCollector* GlobalPhaseStats() {
+  return global_collector.load(std::memory_order_acquire);
+}
+
+void SetGlobalPhaseStats(PhaseStatsCollector* collector) {
+  global_collector.store(collector, std::memory_order_release);
+}
+
+ScopedPhase::ScopedPhase(absl::string_view name)
+    : collector_(GlobalPhaseStats()) {
+  if (collector_ == nullptr) return;
+  parent_ = current_phase;
+  path_ = parent_ == nullptr ? std::string(name)
+                             : absl::StrCat(parent_->path_, "/", name);
+  current_phase = this;
+  allocated_start_ = ThreadAllocatedBytes();
+  cpu_start_ = ThreadCpuTime();
+  wall_start_ = absl::Now();
+}
+
+ScopedPhase::~ScopedPhase() {
+  if (collector_ == nullptr) return;
+  PhaseStats stats;
+  stats.count = 1;
+  stats.wall_time = absl::Now() - wall_start_;
+  stats.cpu_time = ThreadCpuTime() - cpu_start_;
+  stats.allocated_bytes = ThreadAllocatedBytes() - allocated_start_;
+  current_phase = parent_;
+  collector_->Record(
+      current_file == nullptr ? absl::string_view() : *current_file, path_,
+      stats);
+}
+
+ScopedStatsFile::ScopedStatsFile(absl::string_view file)
+    : file_(file), previous_file_(current_file) {
+  current_file = &file_;
+}
+
+ScopedStatsFile::~ScopedStatsFile() { current_file = previous_file_; }
+
+absl::Duration ThreadCpuTime() {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return absl::ZeroDuration();
+  }
+  return absl::DurationFromTimespec(ts);
+}
+
+int64_t ThreadAllocatedBytes() { return internal::thread_allocated_bytes; }
+
+bool AllocationCountingEnabled() {
+  return internal::allocation_counting_enabled;
+}
+
+}  // namespace verible
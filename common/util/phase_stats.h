@@ -0,0 +1,172 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_COMMON_UTIL_PHASE_STATS_H_
+#define VERIBLE_COMMON_UTIL_PHASE_STATS_H_
+
+// Lightweight per-phase instrumentation of wall time, CPU time and allocated
+// bytes.
+//
+// Libraries mark their phases with ScopedPhase, and tools mark the file being
+// processed with ScopedStatsFile:
+//
+//   PhaseStatsCollector collector;
+//   SetGlobalPhaseStats(&collector);
+//   for (const auto& filename : files) {
+//     ScopedStatsFile file_scope(filename);
+//     ...
+//       { ScopedPhase phase("parse"); ... }
+//   }
+//   SetGlobalPhaseStats(nullptr);
+//   collector.PrintTable(std::cerr);
+//
+// Without a global collector, ScopedPhase costs a single atomic load.
+// Phases started while another phase is active on the same thread are
+// recorded under the path of the enclosing phase, e.g. "parse/lex", so that
+// top-level phases never overlap.
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace verible {
+
+// Resources consumed by one phase, summed over all of its occurrences.
+struct PhaseStats {
+  int64_t count = 0;
+  absl::Duration wall_time;
+  absl::Duration cpu_time;
+  int64_t allocated_bytes = 0;
+
+  PhaseStats& operator+=(const PhaseStats& other);
+};
+
+// Thread-safe accumulator of PhaseStats per file and phase.
+class PhaseStatsCollector {
+ public:
+  // Phases in order of first occurrence, with their stats.
+  using PhaseList = std::vector<std::pair<std::string, PhaseStats>>;
+
+  PhaseStatsCollector() = default;
+
+  PhaseStatsCollector(const PhaseStatsCollector&) = delete;
+  PhaseStatsCollector& operator=(const PhaseStatsCollector&) = delete;
+
+  // Adds 'stats' to the totals of 'phase' in 'file'.  'file' may be empty for
+  // work that is not attributed to any file.
+  void Record(absl::string_view file, absl::string_view phase,
+              const PhaseStats& stats);
+
+  // Returns the stats of every phase, summed over all files.
+  PhaseList RunTotals() const;
+
+  // Returns the stats of every phase of every non-empty file, by file name.
+  std::map<std::string, PhaseList> PerFile() const;
+
+  // Prints RunTotals() as a human-readable table, with nested phases indented
+  // under their enclosing phase.
+  void PrintTable(std::ostream& stream) const;
+
+  // Prints RunTotals() and PerFile() as a JSON object.
+  void PrintJson(std::ostream& stream) const;
+
+ private:
+  mutable absl::Mutex mutex_;
+
+  // Phase names in order of first occurrence.
+  std::vector<std::string> phase_order_ ABSL_GUARDED_BY(mutex_);
+
+  // Stats by file, then by phase.
+  std::map<std::string, std::map<std::string, PhaseStats, std::less<>>>
+      stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Returns the collector that ScopedPhase records into, or nullptr if
+// instrumentation is disabled (the default).
+PhaseStatsCollector* GlobalPhaseStats();
+
+// Sets the collector that ScopedPhase records into.  Pass nullptr to disable
+// instrumentation.  'collector' must outlive all active ScopedPhases.
+void SetGlobalPhaseStats(PhaseStatsCollector* collector);
+
+// Measures the resources consumed during its lifetime, and records them into
+// the global collector (if any) under 'name', attributed to the file of the
+// innermost ScopedStatsFile on the current thread.
+class ScopedPhase {
+ public:
+  explicit ScopedPhase(absl::string_view name);
+  ~ScopedPhase();
+
+  ScopedPhase(const ScopedPhase&) = delete;
+  ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+ private:
+  // nullptr when instrumentation was disabled upon construction.
+  PhaseStatsCollector* const collector_;
+
+  // Enclosing phase on this thread, restored upon destruction.
+  ScopedPhase* parent_ = nullptr;
+
+  // Slash-separated names of all enclosing phases and this one.
+  std::string path_;
+
+  absl::Time wall_start_;
+  absl::Duration cpu_start_;
+  int64_t allocated_start_ = 0;
+};
+
+// Attributes all phases on the current thread to 'file' during its lifetime.
+class ScopedStatsFile {
+ public:
+  explicit ScopedStatsFile(absl::string_view file);
+  ~ScopedStatsFile();
+
+  ScopedStatsFile(const ScopedStatsFile&) = delete;
+  ScopedStatsFile& operator=(const ScopedStatsFile&) = delete;
+
+ private:
+  const std::string file_;
+  const std::string* const previous_file_;
+};
+
+// Returns the CPU time consumed by the current thread so far.
+absl::Duration ThreadCpuTime();
+
+// Returns the number of bytes allocated by the current thread so far, or 0 if
+// allocations are not counted (see AllocationCountingEnabled()).
+int64_t ThreadAllocatedBytes();
+
+// Returns true if the binary links //common/util:allocation_counter, which
+// counts the bytes allocated by operator new.
+bool AllocationCountingEnabled();
+
+namespace internal {
+// Updated by //common/util:allocation_counter.
+ABSL_CONST_INIT extern thread_local int64_t thread_allocated_bytes;
+ABSL_CONST_INIT extern bool allocation_counting_enabled;
+}  // namespace internal
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_PHASE_STATS_H_
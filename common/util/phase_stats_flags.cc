@@ -0,0 +1,60 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/phase_stats_flags.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "absl/flags/flag.h"
+#include "absl/memory/memory.h"
+
+ABSL_FLAG(bool, print_stats, false,
+          "If true, print the wall time, CPU time and allocated bytes of each "
+          "processing phase, totalled over all files, to stderr upon exit.");
+
+ABSL_FLAG(std::string, stats_json, "",
+          "If provided, write the wall time, CPU time and allocated bytes of "
+          "each processing phase, per file and totalled over all files, as "
+          "JSON to this file upon exit.");
+
+namespace verible {
+
+ScopedPhaseStatsReport::ScopedPhaseStatsReport() {
+  if (!absl::GetFlag(FLAGS_print_stats) &&
+      absl::GetFlag(FLAGS_stats_json).empty()) {
+    return;
+  }
+  collector_ = absl::make_unique<PhaseStatsCollector>();
+  SetGlobalPhaseStats(collector_.get());
+}
+
+ScopedPhaseStatsReport::~ScopedPhaseStatsReport() {
+  if (collector_ == nullptr) return;
+  SetGlobalPhaseStats(nullptr);
+  if (absl::GetFlag(FLAGS_print_stats)) {
+    collector_->PrintTable(std::cerr);
+  }
+  const std::string json_file = absl::GetFlag(FLAGS_stats_json);
+  if (!json_file.empty()) {
+    std::ofstream stream(json_file);
+    collector_->PrintJson(stream);
+    if (!stream.good()) {
+      std::cerr << "Failed to write statistics to " << json_file << std::endl;
+    }
+  }
+}
+
+}  // namespace verible
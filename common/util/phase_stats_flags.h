@@ -0,0 +1,46 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_COMMON_UTIL_PHASE_STATS_FLAGS_H_
+#define VERIBLE_COMMON_UTIL_PHASE_STATS_FLAGS_H_
+
+#include <memory>
+
+#include "common/util/phase_stats.h"
+
+namespace verible {
+
+// Enables phase statistics collection if --print_stats or --stats_json was
+// given, and reports the statistics upon destruction.
+// Construct one in main(), after InitCommandLine():
+//
+//   const auto args = InitCommandLine(usage, &argc, &argv);
+//   const ScopedPhaseStatsReport stats_report;
+//
+class ScopedPhaseStatsReport {
+ public:
+  ScopedPhaseStatsReport();
+  ~ScopedPhaseStatsReport();
+
+  ScopedPhaseStatsReport(const ScopedPhaseStatsReport&) = delete;
+  ScopedPhaseStatsReport& operator=(const ScopedPhaseStatsReport&) = delete;
+
+ private:
+  // nullptr when no statistics were requested.
+  std::unique_ptr<PhaseStatsCollector> collector_;
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_PHASE_STATS_FLAGS_H_
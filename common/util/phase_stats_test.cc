@@ -0,0 +1,196 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/phase_stats.h"
+
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "json/json.h"
+
+namespace verible {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Returns the names of 'phases', in order.
+std::vector<std::string> PhaseNames(
+    const PhaseStatsCollector::PhaseList& phases) {
+  std::vector<std::string> names;
+  for (const auto& phase : phases) names.push_back(phase.first);
+  return names;
+}
+
+// Installs a global collector for the duration of a test.
+class PhaseStatsTest : public ::testing::Test {
+ protected:
+  PhaseStatsTest() { SetGlobalPhaseStats(&collector_); }
+  ~PhaseStatsTest() override { SetGlobalPhaseStats(nullptr); }
+
+  PhaseStatsCollector collector_;
+};
+
+TEST(PhaseStatsCollectorTest, Empty) {
+  const PhaseStatsCollector collector;
+  EXPECT_TRUE(collector.RunTotals().empty());
+  EXPECT_TRUE(collector.PerFile().empty());
+}
+
+TEST(PhaseStatsCollectorTest, RecordAccumulates) {
+  PhaseStatsCollector collector;
+  PhaseStats stats;
+  stats.count = 1;
+  stats.wall_time = absl::Milliseconds(2);
+  stats.cpu_time = absl::Milliseconds(1);
+  stats.allocated_bytes = 100;
+  collector.Record("a.sv", "lex", stats);
+  collector.Record("a.sv", "parse", stats);
+  collector.Record("b.sv", "lex", stats);
+  collector.Record("", "lex", stats);
+
+  const auto totals = collector.RunTotals();
+  EXPECT_THAT(PhaseNames(totals), ElementsAre("lex", "parse"));
+  EXPECT_EQ(totals[0].second.count, 3);
+  EXPECT_EQ(totals[0].second.wall_time, absl::Milliseconds(6));
+  EXPECT_EQ(totals[0].second.cpu_time, absl::Milliseconds(3));
+  EXPECT_EQ(totals[0].second.allocated_bytes, 300);
+  EXPECT_EQ(totals[1].second.count, 1);
+
+  const auto per_file = collector.PerFile();
+  ASSERT_EQ(per_file.size(), 2);  // excludes unattributed work
+  EXPECT_THAT(PhaseNames(per_file.at("a.sv")), ElementsAre("lex", "parse"));
+  EXPECT_THAT(PhaseNames(per_file.at("b.sv")), ElementsAre("lex"));
+}
+
+TEST(ScopedPhaseTest, DisabledByDefault) {
+  ASSERT_EQ(GlobalPhaseStats(), nullptr);
+  PhaseStatsCollector collector;
+  { const ScopedPhase phase("lex"); }
+  EXPECT_TRUE(collector.RunTotals().empty());
+}
+
+TEST_F(PhaseStatsTest, RecordsPhasesPerFile) {
+  {
+    const ScopedStatsFile file("a.sv");
+    { const ScopedPhase phase("lex"); }
+    { const ScopedPhase phase("parse"); }
+  }
+  {
+    const ScopedStatsFile file("b.sv");
+    const ScopedPhase phase("lex");
+  }
+  const auto totals = collector_.RunTotals();
+  EXPECT_THAT(PhaseNames(totals), ElementsAre("lex", "parse"));
+  EXPECT_EQ(totals[0].second.count, 2);
+  EXPECT_EQ(totals[1].second.count, 1);
+  const auto per_file = collector_.PerFile();
+  EXPECT_THAT(PhaseNames(per_file.at("a.sv")), ElementsAre("lex", "parse"));
+  EXPECT_THAT(PhaseNames(per_file.at("b.sv")), ElementsAre("lex"));
+}
+
+TEST_F(PhaseStatsTest, NestedPhasesRecordPaths) {
+  {
+    const ScopedPhase outer("parse");
+    { const ScopedPhase inner("lex"); }
+    { const ScopedPhase inner("lex"); }
+  }
+  { const ScopedPhase phase("lex"); }
+  EXPECT_THAT(PhaseNames(collector_.RunTotals()),
+              ElementsAre("parse", "parse/lex", "lex"));
+}
+
+TEST_F(PhaseStatsTest, NestedFilesRestoreEnclosingFile) {
+  const ScopedStatsFile outer("a.sv");
+  { const ScopedStatsFile inner("b.sv"); }
+  { const ScopedPhase phase("lex"); }
+  const auto per_file = collector_.PerFile();
+  ASSERT_EQ(per_file.size(), 1);
+  EXPECT_EQ(per_file.begin()->first, "a.sv");
+}
+
+TEST_F(PhaseStatsTest, ThreadsRecordIntoSameCollector) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([i]() {
+      const ScopedStatsFile file(i % 2 ? "odd.sv" : "even.sv");
+      for (int j = 0; j < 100; ++j) {
+        const ScopedPhase phase("work");
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  const auto totals = collector_.RunTotals();
+  ASSERT_EQ(totals.size(), 1);
+  EXPECT_EQ(totals[0].second.count, 400);
+  EXPECT_EQ(collector_.PerFile().size(), 2);
+}
+
+TEST_F(PhaseStatsTest, MeasuresCpuTime) {
+  {
+    const ScopedPhase phase("spin");
+    const absl::Duration start = ThreadCpuTime();
+    while (ThreadCpuTime() - start < absl::Milliseconds(5)) {
+    }
+  }
+  const auto totals = collector_.RunTotals();
+  ASSERT_EQ(totals.size(), 1);
+  EXPECT_GE(totals[0].second.cpu_time, absl::Milliseconds(5));
+  EXPECT_GE(totals[0].second.wall_time, totals[0].second.cpu_time);
+}
+
+TEST(PhaseStatsCollectorTest, PrintTableIndentsNestedPhases) {
+  PhaseStatsCollector collector;
+  PhaseStats stats;
+  stats.count = 7;
+  collector.Record("a.sv", "parse", stats);
+  collector.Record("a.sv", "parse/lex", stats);
+  std::ostringstream stream;
+  collector.PrintTable(stream);
+  EXPECT_TRUE(absl::StrContains(stream.str(), "\nparse "));
+  EXPECT_TRUE(absl::StrContains(stream.str(), "\n  lex "));
+}
+
+TEST(PhaseStatsCollectorTest, PrintJson) {
+  PhaseStatsCollector collector;
+  PhaseStats stats;
+  stats.count = 2;
+  stats.wall_time = absl::Milliseconds(3);
+  stats.allocated_bytes = 42;
+  collector.Record("a.sv", "lex", stats);
+
+  std::istringstream stream([&collector]() {
+    std::ostringstream output;
+    collector.PrintJson(output);
+    return output.str();
+  }());
+  Json::Value json;
+  stream >> json;
+  EXPECT_EQ(json["allocation_counting"].asBool(), AllocationCountingEnabled());
+  ASSERT_EQ(json["run"].size(), 1);
+  EXPECT_EQ(json["run"][0]["phase"].asString(), "lex");
+  EXPECT_EQ(json["run"][0]["count"].asInt64(), 2);
+  EXPECT_DOUBLE_EQ(json["run"][0]["wall_ms"].asDouble(), 3.0);
+  EXPECT_EQ(json["run"][0]["allocated_bytes"].asInt64(), 42);
+  ASSERT_EQ(json["files"].size(), 1);
+  EXPECT_EQ(json["files"][0]["file"].asString(), "a.sv");
+  EXPECT_EQ(json["files"][0]["phases"][0]["phase"].asString(), "lex");
+}
+
+}  // namespace
+}  // namespace verible
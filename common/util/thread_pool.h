@@ -0,0 +1,82 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_COMMON_UTIL_THREAD_POOL_H_
+#define VERIBLE_COMMON_UTIL_THREAD_POOL_H_
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace verible {
+
+// ThreadPool runs scheduled work on a fixed set of worker threads.
+// Work items are started in the order in which they were scheduled.
+// Destruction waits until all scheduled work has finished.
+//
+// A pool without threads runs all work synchronously inside Schedule(), which
+// is convenient for honoring a user-requested level of parallelism of 1.
+//
+// Typical usage:
+//   {
+//     ThreadPool pool(jobs);
+//     for (auto& item : items) {
+//       pool.Schedule([&item]() { Process(&item); });
+//     }
+//   }  // all items are processed here
+//
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t num_threads);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;
+
+  // Waits for all scheduled work to finish.
+  ~ThreadPool();
+
+  // Number of worker threads.
+  size_t NumThreads() const { return threads_.size(); }
+
+  // Queues 'work' to run on any worker thread.  'work' must not throw.
+  void Schedule(std::function<void()> work);
+
+  // Number of threads to use for 'jobs' parallel jobs, where values <= 1 mean
+  // no parallelism, and 0 means one job per hardware thread.
+  static size_t ThreadsForJobs(int jobs);
+
+ private:
+  void WorkerLoop();
+
+  bool HasWorkOrStopping() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !queue_.empty() || stopping_;
+  }
+
+  absl::Mutex mutex_;
+  std::deque<std::function<void()>> queue_ ABSL_GUARDED_BY(mutex_);
+  bool stopping_ ABSL_GUARDED_BY(mutex_) = false;
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_THREAD_POOL_H_
@@ -0,0 +1,97 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/thread_pool.h"
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace {
+
+TEST(ThreadPoolTest, ThreadsForJobs) {
+  EXPECT_EQ(ThreadPool::ThreadsForJobs(-1), 0);
+  EXPECT_EQ(ThreadPool::ThreadsForJobs(1), 0);
+  EXPECT_EQ(ThreadPool::ThreadsForJobs(2), 2);
+  EXPECT_EQ(ThreadPool::ThreadsForJobs(7), 7);
+  // 0 means "all hardware threads", which could be 1.
+  EXPECT_EQ(ThreadPool::ThreadsForJobs(0),
+            ThreadPool::ThreadsForJobs(std::thread::hardware_concurrency()));
+}
+
+TEST(ThreadPoolTest, NoThreadsRunsSynchronously) {
+  ThreadPool pool(0);
+  EXPECT_EQ(pool.NumThreads(), 0);
+  const auto caller = std::this_thread::get_id();
+  std::vector<int> order;
+  for (int i = 0; i < 5; ++i) {
+    pool.Schedule([&order, caller, i]() {
+      EXPECT_EQ(std::this_thread::get_id(), caller);
+      order.push_back(i);
+    });
+    // Already done.
+    EXPECT_EQ(order.size(), i + 1);
+  }
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST(ThreadPoolTest, DestructorWaitsForAllWork) {
+  for (size_t num_threads : {1, 2, 8}) {
+    std::atomic<int> count(0);
+    {
+      ThreadPool pool(num_threads);
+      EXPECT_EQ(pool.NumThreads(), num_threads);
+      for (int i = 0; i < 1000; ++i) {
+        pool.Schedule([&count]() { ++count; });
+      }
+    }
+    EXPECT_EQ(count, 1000) << "threads: " << num_threads;
+  }
+}
+
+TEST(ThreadPoolTest, SingleThreadPreservesOrder) {
+  std::vector<int> order;
+  {
+    ThreadPool pool(1);
+    for (int i = 0; i < 100; ++i) {
+      pool.Schedule([&order, i]() { order.push_back(i); });
+    }
+  }
+  ASSERT_EQ(order.size(), 100);
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(order[i], i);
+}
+
+TEST(ThreadPoolTest, WorkCanScheduleMoreWork) {
+  std::atomic<int> count(0);
+  {
+    ThreadPool pool(4);
+    for (int i = 0; i < 10; ++i) {
+      pool.Schedule([&pool, &count]() {
+        ++count;
+        pool.Schedule([&count]() { ++count; });
+      });
+    }
+  }
+  EXPECT_EQ(count, 20);
+}
+
+TEST(ThreadPoolTest, IdlePoolShutsDown) {
+  ThreadPool pool(3);  // never given any work
+}
+
+}  // namespace
+}  // namespace verible
@@ -21,6 +21,7 @@
 #include <iosfwd>  // IWYU pragma: keep
 #include <iterator>
 #include <set>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -279,7 +280,25 @@ class VectorTree : private _VectorTreeImpl {
     AdoptSubtree(std::forward<Args>(args)...);
   }
 
-  ~VectorTree() { CHECK(CheckIntegrity()); }
+  // Destroys the descendants without recursion: the children of every node
+  // are moved out of it before it is destroyed, so every node is destroyed
+  // without children.
+  ~VectorTree() {
+    CHECK(CheckChildLinks());
+    if (children_.empty()) return;
+    std::vector<subnodes_type> pending;
+    pending.push_back(std::move(children_));
+    while (!pending.empty()) {
+      subnodes_type nodes(std::move(pending.back()));
+      pending.pop_back();
+      for (auto& node : nodes) {
+        if (!node.children_.empty()) {
+          CHECK(node.CheckChildLinks());
+          pending.push_back(std::move(node.children_));
+        }
+      }
+    }
+  }
 
   // Swaps values and subtrees of two nodes.
   // This operation is safe for unrelated trees (no common ancestor).
@@ -544,12 +563,24 @@ class VectorTree : private _VectorTreeImpl {
   // TODO(fangism): provide unidirectional iterator views, forward and reversed,
   // using NextLeaf() and PreviousLeaf().
 
-  // Returns true if parent-child links are valid in entire tree.
-  bool CheckIntegrity() const {
+  // Returns true if the direct children of this node link back to it.
+  bool CheckChildLinks() const {
     for (const auto& child : children_) {
       CHECK_EQ(child.Parent(), this)
           << "Inconsistency: child's parent does not point back to this node!";
-      if (!child.CheckIntegrity()) return false;
+    }
+    return true;
+  }
+
+  // Returns true if parent-child links are valid in entire tree.
+  // This does not recurse, so it handles trees of any depth.
+  bool CheckIntegrity() const {
+    std::vector<const this_type*> pending{this};
+    while (!pending.empty()) {
+      const this_type* node = pending.back();
+      pending.pop_back();
+      if (!node->CheckChildLinks()) return false;
+      for (const auto& child : node->children_) pending.push_back(&child);
     }
     return true;
   }
@@ -560,67 +591,66 @@ class VectorTree : private _VectorTreeImpl {
   //     Whole node gives access to immediate children (and subtree).
   //   * Apply function is const vs. mutating.
   // All combinations of the above are provided.
+  // The function is a template parameter (instead of a std::function) so that
+  // it can be inlined into the traversal.  Functions that accept a node are
+  // applied to nodes, all others are applied to node values.
 
   // Visits all tree nodes in pre-order traversal applying function to all nodes
-  // (non-modifying).  Useful for checking invariants between parents and
-  // their children.
-  void ApplyPreOrder(const std::function<void(const this_type&)>& f) const {
-    f(*this);
-    for (const auto& child : Children()) {
-      child.ApplyPreOrder(f);
+  // or node values (non-modifying).  Useful for checking invariants between
+  // parents and their children.
+  template <typename F>
+  void ApplyPreOrder(F&& f) const {
+    if constexpr (std::is_invocable_v<F&, const this_type&>) {
+      f(*this);
+      for (const auto& child : Children()) {
+        child.ApplyPreOrder(f);
+      }
+    } else {
+      ApplyPreOrder([&f](const this_type& t) { f(t.Value()); });
     }
   }
 
-  // This variant of ApplyPreOrder expects a function on the underlying
-  // value_type (const&).
-  void ApplyPreOrder(const std::function<void(const value_type&)>& f) const {
-    ApplyPreOrder([&f](const this_type& t) { f(t.Value()); });
-  }
-
   // Visits all tree nodes in pre-order traversal applying function to all nodes
-  // (modifying).
-  void ApplyPreOrder(const std::function<void(this_type&)>& f) {
-    f(*this);
-    for (auto& child : Children()) {
-      child.ApplyPreOrder(f);
+  // or node values (modifying).  Useful for applying transformations.
+  template <typename F>
+  void ApplyPreOrder(F&& f) {
+    if constexpr (std::is_invocable_v<F&, this_type&>) {
+      f(*this);
+      for (auto& child : Children()) {
+        child.ApplyPreOrder(f);
+      }
+    } else {
+      ApplyPreOrder([&f](this_type& t) { f(t.Value()); });
     }
   }
 
-  // Visits all tree nodes in pre-order traversal applying function to all node
-  // values (modifying).  Useful for applying transformations.
-  void ApplyPreOrder(const std::function<void(value_type&)>& f) {
-    ApplyPreOrder([&f](this_type& t) { f(t.Value()); });
-  }
-
   // Visits all tree nodes in post-order traversal applying function to all
-  // nodes (non-modifying).  Useful for checking invariants between parents and
-  // their children.
-  void ApplyPostOrder(const std::function<void(const this_type&)>& f) const {
-    for (const auto& child : Children()) {
-      child.ApplyPostOrder(f);
+  // nodes or node values (non-modifying).  Useful for checking invariants
+  // between parents and their children.
+  template <typename F>
+  void ApplyPostOrder(F&& f) const {
+    if constexpr (std::is_invocable_v<F&, const this_type&>) {
+      for (const auto& child : Children()) {
+        child.ApplyPostOrder(f);
+      }
+      f(*this);
+    } else {
+      ApplyPostOrder([&f](const this_type& t) { f(t.Value()); });
     }
-    f(*this);
-  }
-
-  // This variant of ApplyPostOrder expects a function on the underlying
-  // value_type (const&).
-  void ApplyPostOrder(const std::function<void(const value_type&)>& f) const {
-    ApplyPostOrder([&f](const this_type& t) { f(t.Value()); });
   }
 
   // Visits all tree nodes in post-order traversal applying function to all
-  // nodes (modifying).  Useful for applying transformations.
-  void ApplyPostOrder(const std::function<void(this_type&)>& f) {
-    for (auto& child : Children()) {
-      child.ApplyPostOrder(f);
+  // nodes or node values (modifying).  Useful for applying transformations.
+  template <typename F>
+  void ApplyPostOrder(F&& f) {
+    if constexpr (std::is_invocable_v<F&, this_type&>) {
+      for (auto& child : Children()) {
+        child.ApplyPostOrder(f);
+      }
+      f(*this);
+    } else {
+      ApplyPostOrder([&f](this_type& t) { f(t.Value()); });
     }
-    f(*this);
-  }
-
-  // Visits all tree nodes in post-order traversal applying function to all node
-  // values (modifying).  Useful for applying transformations.
-  void ApplyPostOrder(const std::function<void(value_type&)>& f) {
-    ApplyPostOrder([&f](this_type& t) { f(t.Value()); });
   }
 
   // Recursively transform a VectorTree<T> to VectorTree<S>.
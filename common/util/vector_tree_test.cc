@@ -2055,5 +2055,19 @@ TEST(VectorTreeTest, PrintTreeCustom) {
 })");
 }
 
+// Tests that trees deeper than the call stack would allow are checked and
+// destroyed.
+TEST(VectorTreeTest, VeryDeepTree) {
+  typedef VectorTree<int> tree_type;
+  constexpr int kDepth = 1000000;
+  tree_type tree(0);
+  tree_type* node = &tree;
+  for (int i = 1; i <= kDepth; ++i) {
+    node = node->NewChild(i);
+  }
+  EXPECT_TRUE(tree.CheckIntegrity());
+  EXPECT_EQ(node->Value(), kDepth);
+}
+
 }  // namespace
 }  // namespace verible
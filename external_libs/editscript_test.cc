@@ -16,6 +16,7 @@
 
 #include <cstring>
 #include <iostream>
+#include <random>
 #include <set>
 #include <sstream>
 #include <vector>
@@ -272,5 +273,62 @@ TEST(DiffTest, StrictSupersequence) {
   EXPECT_EQ(ToString(actual), ToString(expect));
 }
 
+// Returns a random sequence of 'size' tokens from an alphabet of 'alphabet'
+// tokens.
+std::vector<int> RandomTokens(std::mt19937 *generator, int size, int alphabet) {
+  std::uniform_int_distribution<int> token(0, alphabet - 1);
+  std::vector<int> tokens(size);
+  for (auto &t : tokens) t = token(*generator);
+  return tokens;
+}
+
+// Returns a copy of 'tokens' with random runs replaced, inserted and deleted.
+std::vector<int> RandomlyEdited(std::mt19937 *generator,
+                                const std::vector<int> &tokens, int alphabet) {
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::uniform_int_distribution<int> token(0, alphabet - 1);
+  std::vector<int> edited;
+  for (const int t : tokens) {
+    const int roll = percent(*generator);
+    if (roll < 3) continue;                              // delete
+    if (roll < 6) edited.push_back(token(*generator));   // insert
+    edited.push_back(roll < 9 ? token(*generator) : t);  // replace or keep
+  }
+  return edited;
+}
+
+TEST(DiffTest, ParallelMatchesSerial) {
+  std::mt19937 generator(20210917);
+  for (const int alphabet : {2, 16, 1000}) {
+    for (const int size : {0, 1, 7, 100, 3000}) {
+      const std::vector<int> tokens1(RandomTokens(&generator, size, alphabet));
+      const std::vector<int> tokens2(
+          RandomlyEdited(&generator, tokens1, alphabet));
+      const Edits serial = GetTokenDiffs(tokens1.begin(), tokens1.end(),
+                                         tokens2.begin(), tokens2.end());
+      for (const int threads : {1, 2, 3, 8}) {
+        // A tiny threshold exercises the parallel bisection on small inputs.
+        const Edits parallel =
+            GetTokenDiffsInParallel(tokens1.begin(), tokens1.end(),
+                                    tokens2.begin(), tokens2.end(), threads, 8);
+        EXPECT_EQ(ToString(parallel), ToString(serial))
+            << "alphabet: " << alphabet << ", size: " << size
+            << ", threads: " << threads;
+      }
+    }
+  }
+}
+
+TEST(DiffTest, ParallelUnrelatedSequences) {
+  std::mt19937 generator(1);
+  const std::vector<int> tokens1(RandomTokens(&generator, 2000, 4));
+  const std::vector<int> tokens2(RandomTokens(&generator, 2500, 4));
+  const Edits serial = GetTokenDiffs(tokens1.begin(), tokens1.end(),
+                                     tokens2.begin(), tokens2.end());
+  const Edits parallel = GetTokenDiffsInParallel(
+      tokens1.begin(), tokens1.end(), tokens2.begin(), tokens2.end(), 4, 16);
+  EXPECT_EQ(ToString(parallel), ToString(serial));
+}
+
 }  // namespace
 }  // namespace diff
@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -64,13 +65,15 @@ static const Matcher& AlwaysStarMatcher() {
   return matcher;
 }
 
-void AlwaysCombRule::HandleSymbol(const verible::Symbol& symbol,
-                                  const SyntaxTreeContext& context) {
-  // Check for offending use of always @*
-  verible::matcher::BoundSymbolManager manager;
-  if (AlwaysStarMatcher().Matches(symbol, &manager)) {
-    violations_.insert(LintViolation(symbol, kMessage, context));
-  }
+std::vector<Matcher> AlwaysCombRule::Matchers() const {
+  return {AlwaysStarMatcher()};
+}
+
+void AlwaysCombRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const SyntaxTreeContext& context) {
+  violations_.insert(LintViolation(symbol, kMessage, context));
 }
 
 LintRuleStatus AlwaysCombRule::Report() const {
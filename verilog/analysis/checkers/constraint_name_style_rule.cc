@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
@@ -66,27 +67,30 @@ static const Matcher& ConstraintMatcher() {
   return matcher;
 }
 
-void ConstraintNameStyleRule::HandleSymbol(const verible::Symbol& symbol,
-                                           const SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (ConstraintMatcher().Matches(symbol, &manager)) {
-    // Since an out-of-line definition is always followed by a forward
-    // declaration somewhere else (in this case inside a class), we can just
-    // ignore all out-of-line definitions to  avoid duplicate lint errors on
-    // the same name.
-    if (IsOutOfLineConstraintDefinition(symbol)) {
-      return;
-    }
-
-    const auto& identifier_token =
-        GetSymbolIdentifierFromConstraintDeclaration(symbol);
-
-    const auto constraint_name = identifier_token.text();
-
-    if (!verible::IsLowerSnakeCaseWithDigits(constraint_name) ||
-        !absl::EndsWith(constraint_name, "_c"))
-      violations_.insert(LintViolation(identifier_token, kMessage, context));
+std::vector<Matcher> ConstraintNameStyleRule::Matchers() const {
+  return {ConstraintMatcher()};
+}
+
+void ConstraintNameStyleRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const SyntaxTreeContext& context) {
+  // Since an out-of-line definition is always followed by a forward
+  // declaration somewhere else (in this case inside a class), we can just
+  // ignore all out-of-line definitions to  avoid duplicate lint errors on
+  // the same name.
+  if (IsOutOfLineConstraintDefinition(symbol)) {
+    return;
   }
+
+  const auto& identifier_token =
+      GetSymbolIdentifierFromConstraintDeclaration(symbol);
+
+  const auto constraint_name = identifier_token.text();
+
+  if (!verible::IsLowerSnakeCaseWithDigits(constraint_name) ||
+      !absl::EndsWith(constraint_name, "_c"))
+    violations_.insert(LintViolation(identifier_token, kMessage, context));
 }
 
 LintRuleStatus ConstraintNameStyleRule::Report() const {
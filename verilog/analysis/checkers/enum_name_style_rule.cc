@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
@@ -60,24 +61,27 @@ static const Matcher& TypedefMatcher() {
   return matcher;
 }
 
-void EnumNameStyleRule::HandleSymbol(const verible::Symbol& symbol,
-                                     const SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (TypedefMatcher().Matches(symbol, &manager)) {
-    // TODO: This can be changed to checking type of child (by index) when we
-    // have consistent shape for all kTypeDeclaration nodes.
-    if (!FindAllEnumTypes(symbol).empty()) {
-      const auto* identifier_leaf = GetIdentifierFromTypeDeclaration(symbol);
-      const auto name = ABSL_DIE_IF_NULL(identifier_leaf)->get().text();
-      if (!verible::IsLowerSnakeCaseWithDigits(name) ||
-          !(absl::EndsWith(name, "_t") || absl::EndsWith(name, "_e"))) {
-        violations_.insert(
-            LintViolation(identifier_leaf->get(), kMessage, context));
-      }
-    } else {
-      // Not an enum definition
-      return;
+std::vector<Matcher> EnumNameStyleRule::Matchers() const {
+  return {TypedefMatcher()};
+}
+
+void EnumNameStyleRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const SyntaxTreeContext& context) {
+  // TODO: This can be changed to checking type of child (by index) when we
+  // have consistent shape for all kTypeDeclaration nodes.
+  if (!FindAllEnumTypes(symbol).empty()) {
+    const auto* identifier_leaf = GetIdentifierFromTypeDeclaration(symbol);
+    const auto name = ABSL_DIE_IF_NULL(identifier_leaf)->get().text();
+    if (!verible::IsLowerSnakeCaseWithDigits(name) ||
+        !(absl::EndsWith(name, "_t") || absl::EndsWith(name, "_e"))) {
+      violations_.insert(
+          LintViolation(identifier_leaf->get(), kMessage, context));
     }
+  } else {
+    // Not an enum definition
+    return;
   }
 }
 
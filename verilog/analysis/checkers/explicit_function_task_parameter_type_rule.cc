@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "common/analysis/citation.h"
@@ -65,15 +66,19 @@ static const Matcher& PortMatcher() {
   return matcher;
 }
 
-void ExplicitFunctionTaskParameterTypeRule::HandleSymbol(
-    const verible::Symbol& symbol, const SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (PortMatcher().Matches(symbol, &manager)) {
-    const auto* type_node = GetTypeOfTaskFunctionPortItem(symbol);
-    if (!IsStorageTypeOfDataTypeSpecified(*ABSL_DIE_IF_NULL(type_node))) {
-      const auto* port_id = GetIdentifierFromTaskFunctionPortItem(symbol);
-      violations_.insert(LintViolation(*port_id, kMessage, context));
-    }
+std::vector<verible::matcher::Matcher>
+ExplicitFunctionTaskParameterTypeRule::Matchers() const {
+  return {PortMatcher()};
+}
+
+void ExplicitFunctionTaskParameterTypeRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const SyntaxTreeContext& context) {
+  const auto* type_node = GetTypeOfTaskFunctionPortItem(symbol);
+  if (!IsStorageTypeOfDataTypeSpecified(*ABSL_DIE_IF_NULL(type_node))) {
+    const auto* port_id = GetIdentifierFromTaskFunctionPortItem(symbol);
+    violations_.insert(LintViolation(*port_id, kMessage, context));
   }
 }
 
@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
@@ -83,21 +84,25 @@ static bool HasStringAssignment(const verible::Symbol& param_decl) {
          verilog_tokentype::TK_StringLiteral;
 }
 
-void ExplicitParameterStorageTypeRule::HandleSymbol(
-    const verible::Symbol& symbol, const SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (ParamMatcher().Matches(symbol, &manager)) {
-    // 'parameter type' declarations have a storage type declared.
-    if (IsParamTypeDeclaration(symbol)) return;
-
-    const auto* type_info_symbol = GetParamTypeInfoSymbol(symbol);
-    if (IsTypeInfoEmpty(*ABSL_DIE_IF_NULL(type_info_symbol))) {
-      if (exempt_string_ && HasStringAssignment(symbol)) return;
-      const verible::TokenInfo& param_name = GetParameterNameToken(symbol);
-      violations_.insert(LintViolation(
-          param_name, absl::StrCat(kMessage, "(", param_name.text(), ")."),
-          context));
-    }
+std::vector<verible::matcher::Matcher>
+ExplicitParameterStorageTypeRule::Matchers() const {
+  return {ParamMatcher()};
+}
+
+void ExplicitParameterStorageTypeRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const SyntaxTreeContext& context) {
+  // 'parameter type' declarations have a storage type declared.
+  if (IsParamTypeDeclaration(symbol)) return;
+
+  const auto* type_info_symbol = GetParamTypeInfoSymbol(symbol);
+  if (IsTypeInfoEmpty(*ABSL_DIE_IF_NULL(type_info_symbol))) {
+    if (exempt_string_ && HasStringAssignment(symbol)) return;
+    const verible::TokenInfo& param_name = GetParameterNameToken(symbol);
+    violations_.insert(LintViolation(
+        param_name, absl::StrCat(kMessage, "(", param_name.text(), ")."),
+        context));
   }
 }
 
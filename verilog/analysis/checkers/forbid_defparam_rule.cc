@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "common/analysis/citation.h"
@@ -53,16 +54,18 @@ static const Matcher& OverrideMatcher() {
   return matcher;
 }
 
-void ForbidDefparamRule::HandleSymbol(
-    const verible::Symbol& symbol, const verible::SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (OverrideMatcher().Matches(symbol, &manager)) {
-    const auto& defparam_token =
-        GetSubtreeAsLeaf(symbol, NodeEnum::kParameterOverride, 0).get();
-    CHECK_EQ(defparam_token.token_enum(), TK_defparam);
-    violations_.insert(
-        verible::LintViolation(defparam_token, kMessage, context));
-  }
+std::vector<Matcher> ForbidDefparamRule::Matchers() const {
+  return {OverrideMatcher()};
+}
+
+void ForbidDefparamRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const verible::SyntaxTreeContext& context) {
+  const auto& defparam_token =
+      GetSubtreeAsLeaf(symbol, NodeEnum::kParameterOverride, 0).get();
+  CHECK_EQ(defparam_token.token_enum(), TK_defparam);
+  violations_.insert(verible::LintViolation(defparam_token, kMessage, context));
 }
 
 verible::LintRuleStatus ForbidDefparamRule::Report() const {
@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "common/analysis/citation.h"
@@ -59,16 +60,20 @@ static const Matcher& EnumMatcher() {
   return matcher;
 }
 
-void ForbiddenAnonymousEnumsRule::HandleSymbol(
-    const verible::Symbol& symbol, const verible::SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (EnumMatcher().Matches(symbol, &manager)) {
-    // Check if it is preceded by a typedef
-    if (!context.DirectParentsAre({NodeEnum::kDataTypePrimitive,
-                                   NodeEnum::kDataType,
-                                   NodeEnum::kTypeDeclaration})) {
-      violations_.insert(LintViolation(symbol, kMessage, context));
-    }
+std::vector<verible::matcher::Matcher>
+ForbiddenAnonymousEnumsRule::Matchers() const {
+  return {EnumMatcher()};
+}
+
+void ForbiddenAnonymousEnumsRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const verible::SyntaxTreeContext& context) {
+  // Check if it is preceded by a typedef
+  if (!context.DirectParentsAre({NodeEnum::kDataTypePrimitive,
+                                 NodeEnum::kDataType,
+                                 NodeEnum::kTypeDeclaration})) {
+    violations_.insert(LintViolation(symbol, kMessage, context));
   }
 }
 
@@ -17,6 +17,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -68,16 +69,19 @@ ForbiddenMacroRule::InvalidMacrosMap() {
   return *invalid_symbols;
 }
 
-void ForbiddenMacroRule::HandleSymbol(
-    const verible::Symbol& symbol, const verible::SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (MacroCallMatcher().Matches(symbol, &manager)) {
-    if (auto leaf = manager.GetAs<verible::SyntaxTreeLeaf>("name")) {
-      const auto& imm = InvalidMacrosMap();
-      if (imm.find(std::string(leaf->get().text())) != imm.end()) {
-        violations_.insert(
-            verible::LintViolation(leaf->get(), FormatReason(*leaf), context));
-      }
+std::vector<Matcher> ForbiddenMacroRule::Matchers() const {
+  return {MacroCallMatcher()};
+}
+
+void ForbiddenMacroRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const verible::SyntaxTreeContext& context) {
+  if (auto leaf = manager.GetAs<verible::SyntaxTreeLeaf>("name")) {
+    const auto& imm = InvalidMacrosMap();
+    if (imm.find(std::string(leaf->get().text())) != imm.end()) {
+      violations_.insert(
+          verible::LintViolation(leaf->get(), FormatReason(*leaf), context));
     }
   }
 }
@@ -17,6 +17,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -85,16 +86,19 @@ ForbiddenSystemTaskFunctionRule::InvalidSymbolsMap() {
   return *invalid_symbols;
 }
 
-void ForbiddenSystemTaskFunctionRule::HandleSymbol(
-    const verible::Symbol& symbol, const verible::SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (IdMatcher().Matches(symbol, &manager)) {
-    if (auto leaf = manager.GetAs<verible::SyntaxTreeLeaf>("name")) {
-      const auto& ism = InvalidSymbolsMap();
-      if (ism.find(std::string(leaf->get().text())) != ism.end()) {
-        violations_.insert(
-            verible::LintViolation(leaf->get(), FormatReason(*leaf), context));
-      }
+std::vector<Matcher> ForbiddenSystemTaskFunctionRule::Matchers() const {
+  return {IdMatcher()};
+}
+
+void ForbiddenSystemTaskFunctionRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const verible::SyntaxTreeContext& context) {
+  if (auto leaf = manager.GetAs<verible::SyntaxTreeLeaf>("name")) {
+    const auto& ism = InvalidSymbolsMap();
+    if (ism.find(std::string(leaf->get().text())) != ism.end()) {
+      violations_.insert(
+          verible::LintViolation(leaf->get(), FormatReason(*leaf), context));
     }
   }
 }
@@ -63,34 +63,37 @@ static const Matcher& BlockMatcher() {
   return matcher;
 }
 
-void GenerateLabelPrefixRule::HandleSymbol(
-    const verible::Symbol& symbol, const verible::SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (BlockMatcher().Matches(symbol, &manager)) {
-    // Exclude case generate statements, as kGenerateBlock is generated for
-    // each 'case' item too.
-    if (context.IsInside(NodeEnum::kGenerateCaseItemList)) {
-      return;
-    }
+std::vector<Matcher> GenerateLabelPrefixRule::Matchers() const {
+  return {BlockMatcher()};
+}
 
-    for (const auto& child : SymbolCastToNode(symbol).children()) {
-      const verible::TokenInfo* label = nullptr;
-      switch (NodeEnum(SymbolCastToNode(*child).Tag().tag)) {
-        case NodeEnum::kBegin:
-          label = GetBeginLabelTokenInfo(*child);
-          break;
-        case NodeEnum::kEnd:
-          label = GetEndLabelTokenInfo(*child);
-          break;
-        default:
-          continue;
-      }
+void GenerateLabelPrefixRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const verible::SyntaxTreeContext& context) {
+  // Exclude case generate statements, as kGenerateBlock is generated for
+  // each 'case' item too.
+  if (context.IsInside(NodeEnum::kGenerateCaseItemList)) {
+    return;
+  }
+
+  for (const auto& child : SymbolCastToNode(symbol).children()) {
+    const verible::TokenInfo* label = nullptr;
+    switch (NodeEnum(SymbolCastToNode(*child).Tag().tag)) {
+      case NodeEnum::kBegin:
+        label = GetBeginLabelTokenInfo(*child);
+        break;
+      case NodeEnum::kEnd:
+        label = GetEndLabelTokenInfo(*child);
+        break;
+      default:
+        continue;
+    }
 
-      if (label != nullptr) {
-        if (!(absl::StartsWith(label->text(), "g_") ||
-              absl::StartsWith(label->text(), "gen_"))) {
-          violations_.insert(verible::LintViolation(*label, kMessage, context));
-        }
+    if (label != nullptr) {
+      if (!(absl::StartsWith(label->text(), "g_") ||
+            absl::StartsWith(label->text(), "gen_"))) {
+        violations_.insert(verible::LintViolation(*label, kMessage, context));
       }
     }
   }
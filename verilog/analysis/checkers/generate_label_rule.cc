@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "common/analysis/citation.h"
@@ -63,12 +64,15 @@ static const Matcher& BlockMatcher() {
   return matcher;
 }
 
-void GenerateLabelRule::HandleSymbol(
-    const verible::Symbol& symbol, const verible::SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (BlockMatcher().Matches(symbol, &manager)) {
-    violations_.insert(verible::LintViolation(symbol, kMessage, context));
-  }
+std::vector<Matcher> GenerateLabelRule::Matchers() const {
+  return {BlockMatcher()};
+}
+
+void GenerateLabelRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const verible::SyntaxTreeContext& context) {
+  violations_.insert(verible::LintViolation(symbol, kMessage, context));
 }
 
 verible::LintRuleStatus GenerateLabelRule::Report() const {
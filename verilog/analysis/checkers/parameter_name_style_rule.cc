@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -93,34 +94,37 @@ std::string ParameterNameStyleRule::ViolationMsg(absl::string_view symbol_type,
                       bit_list);
 }
 
-void ParameterNameStyleRule::HandleSymbol(const verible::Symbol& symbol,
-                                          const SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (ParamDeclMatcher().Matches(symbol, &manager)) {
-    if (IsParamTypeDeclaration(symbol)) return;
-
-    const auto param_decl_token = GetParamKeyword(symbol);
-
-    auto identifiers = GetAllParameterNameTokens(symbol);
-
-    for (auto id : identifiers) {
-      const auto param_name = id->text();
-      uint32_t observed_style = 0;
-      if (verible::IsUpperCamelCaseWithDigits(param_name))
-        observed_style |= kUpperCamelCase;
-      if (verible::IsNameAllCapsUnderscoresDigits(param_name))
-        observed_style |= kAllCaps;
-
-      if (param_decl_token == TK_localparam && localparam_allowed_style_ &&
-          (observed_style & localparam_allowed_style_) == 0) {
-        violations_.insert(LintViolation(
-            *id, ViolationMsg("localparam", localparam_allowed_style_),
-            context));
-      } else if (param_decl_token == TK_parameter && parameter_allowed_style_ &&
-                 (observed_style & parameter_allowed_style_) == 0) {
-        violations_.insert(LintViolation(
-            *id, ViolationMsg("parameter", parameter_allowed_style_), context));
-      }
+std::vector<verible::matcher::Matcher>
+ParameterNameStyleRule::Matchers() const {
+  return {ParamDeclMatcher()};
+}
+
+void ParameterNameStyleRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const SyntaxTreeContext& context) {
+  if (IsParamTypeDeclaration(symbol)) return;
+
+  const auto param_decl_token = GetParamKeyword(symbol);
+
+  auto identifiers = GetAllParameterNameTokens(symbol);
+
+  for (auto id : identifiers) {
+    const auto param_name = id->text();
+    uint32_t observed_style = 0;
+    if (verible::IsUpperCamelCaseWithDigits(param_name))
+      observed_style |= kUpperCamelCase;
+    if (verible::IsNameAllCapsUnderscoresDigits(param_name))
+      observed_style |= kAllCaps;
+
+    if (param_decl_token == TK_localparam && localparam_allowed_style_ &&
+        (observed_style & localparam_allowed_style_) == 0) {
+      violations_.insert(LintViolation(
+          *id, ViolationMsg("localparam", localparam_allowed_style_), context));
+    } else if (param_decl_token == TK_parameter && parameter_allowed_style_ &&
+               (observed_style & parameter_allowed_style_) == 0) {
+      violations_.insert(LintViolation(
+          *id, ViolationMsg("parameter", parameter_allowed_style_), context));
     }
   }
 }
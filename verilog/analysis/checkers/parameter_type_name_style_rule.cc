@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
@@ -68,20 +69,23 @@ static const Matcher& ParamDeclMatcher() {
   return matcher;
 }
 
-void ParameterTypeNameStyleRule::HandleSymbol(
-    const verible::Symbol& symbol, const SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (ParamDeclMatcher().Matches(symbol, &manager)) {
-    const verible::TokenInfo* param_name_token = nullptr;
-    if (!IsParamTypeDeclaration(symbol)) return;
+std::vector<Matcher> ParameterTypeNameStyleRule::Matchers() const {
+  return {ParamDeclMatcher()};
+}
+
+void ParameterTypeNameStyleRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const SyntaxTreeContext& context) {
+  const verible::TokenInfo* param_name_token = nullptr;
+  if (!IsParamTypeDeclaration(symbol)) return;
 
-    param_name_token = &GetSymbolIdentifierFromParamDeclaration(symbol);
-    const auto param_name = param_name_token->text();
+  param_name_token = &GetSymbolIdentifierFromParamDeclaration(symbol);
+  const auto param_name = param_name_token->text();
 
-    if (!verible::IsLowerSnakeCaseWithDigits(param_name) ||
-        !absl::EndsWith(param_name, "_t"))
-      violations_.insert(LintViolation(*param_name_token, kMessage, context));
-  }
+  if (!verible::IsLowerSnakeCaseWithDigits(param_name) ||
+      !absl::EndsWith(param_name, "_t"))
+    violations_.insert(LintViolation(*param_name_token, kMessage, context));
 }
 
 LintRuleStatus ParameterTypeNameStyleRule::Report() const {
@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -57,15 +58,18 @@ static const Matcher& IdMatcher() {
   return matcher;
 }
 
-void PlusargAssignmentRule::HandleSymbol(
-    const verible::Symbol& symbol, const verible::SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (IdMatcher().Matches(symbol, &manager)) {
-    if (auto leaf = manager.GetAs<verible::SyntaxTreeLeaf>("name")) {
-      if (kForbiddenFunctionName == leaf->get().text()) {
-        violations_.insert(
-            verible::LintViolation(leaf->get(), FormatReason(), context));
-      }
+std::vector<Matcher> PlusargAssignmentRule::Matchers() const {
+  return {IdMatcher()};
+}
+
+void PlusargAssignmentRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const verible::SyntaxTreeContext& context) {
+  if (auto leaf = manager.GetAs<verible::SyntaxTreeLeaf>("name")) {
+    if (kForbiddenFunctionName == leaf->get().text()) {
+      violations_.insert(
+          verible::LintViolation(leaf->get(), FormatReason(), context));
     }
   }
 }
@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
@@ -67,20 +68,23 @@ static const Matcher& ParamDeclMatcher() {
   return matcher;
 }
 
-void PositiveMeaningParameterNameRule::HandleSymbol(
-    const verible::Symbol& symbol, const SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (ParamDeclMatcher().Matches(symbol, &manager)) {
-    if (IsParamTypeDeclaration(symbol)) return;
+std::vector<Matcher> PositiveMeaningParameterNameRule::Matchers() const {
+  return {ParamDeclMatcher()};
+}
+
+void PositiveMeaningParameterNameRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const SyntaxTreeContext& context) {
+  if (IsParamTypeDeclaration(symbol)) return;
 
-    auto identifiers = GetAllParameterNameTokens(symbol);
-    for (const auto& id : identifiers) {
-      const auto param_name = id->text();
+  auto identifiers = GetAllParameterNameTokens(symbol);
+  for (const auto& id : identifiers) {
+    const auto param_name = id->text();
 
-      if (absl::StartsWithIgnoreCase(param_name, "disable"))
-        violations_.insert(LintViolation(
-            *id, absl::StrCat(kMessage, "  (got: ", param_name, ")"), context));
-    }
+    if (absl::StartsWithIgnoreCase(param_name, "disable"))
+      violations_.insert(LintViolation(
+          *id, absl::StrCat(kMessage, "  (got: ", param_name, ")"), context));
   }
 }
 
@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "common/analysis/citation.h"
@@ -71,26 +72,29 @@ static const Matcher& ParamDeclMatcher() {
 }
 
 // TODO(kathuriac): Also check the 'interface' and 'program' constructs.
-void ProperParameterDeclarationRule::HandleSymbol(
-    const verible::Symbol& symbol, const SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (ParamDeclMatcher().Matches(symbol, &manager)) {
-    const auto param_decl_token = GetParamKeyword(symbol);
-    if (param_decl_token == TK_parameter) {
-      // Check if the context is inside a class or module, and a
-      // kFormalParameterList.
-      if (ContextIsInsideClass(context) &&
-          !ContextIsInsideFormalParameterList(context)) {
-        violations_.insert(LintViolation(symbol, kParameterMessage, context));
-      } else if (ContextIsInsideModule(context) &&
-                 !ContextIsInsideFormalParameterList(context)) {
-        violations_.insert(LintViolation(symbol, kParameterMessage, context));
-      }
-    } else if (param_decl_token == TK_localparam) {
-      // If the context is not inside a class or module, report violation.
-      if (!ContextIsInsideClass(context) && !ContextIsInsideModule(context))
-        violations_.insert(LintViolation(symbol, kLocalParamMessage, context));
+std::vector<Matcher> ProperParameterDeclarationRule::Matchers() const {
+  return {ParamDeclMatcher()};
+}
+
+void ProperParameterDeclarationRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const SyntaxTreeContext& context) {
+  const auto param_decl_token = GetParamKeyword(symbol);
+  if (param_decl_token == TK_parameter) {
+    // Check if the context is inside a class or module, and a
+    // kFormalParameterList.
+    if (ContextIsInsideClass(context) &&
+        !ContextIsInsideFormalParameterList(context)) {
+      violations_.insert(LintViolation(symbol, kParameterMessage, context));
+    } else if (ContextIsInsideModule(context) &&
+               !ContextIsInsideFormalParameterList(context)) {
+      violations_.insert(LintViolation(symbol, kParameterMessage, context));
     }
+  } else if (param_decl_token == TK_localparam) {
+    // If the context is not inside a class or module, report violation.
+    if (!ContextIsInsideClass(context) && !ContextIsInsideModule(context))
+      violations_.insert(LintViolation(symbol, kLocalParamMessage, context));
   }
 }
 
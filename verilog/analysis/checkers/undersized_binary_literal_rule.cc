@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
@@ -74,35 +75,37 @@ static const Matcher& NumberMatcher() {
   return matcher;
 }
 
-void UndersizedBinaryLiteralRule::HandleSymbol(
-    const verible::Symbol& symbol, const SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (NumberMatcher().Matches(symbol, &manager)) {
-    if (auto width_leaf = manager.GetAs<SyntaxTreeLeaf>("width")) {
-      if (auto base_leaf = manager.GetAs<SyntaxTreeLeaf>("base")) {
-        if (auto digits_leaf = manager.GetAs<SyntaxTreeLeaf>("digits")) {
-          auto width_text = width_leaf->get().text();
-          auto base_text = base_leaf->get().text();
-          auto digits_text = digits_leaf->get().text();
-          size_t width;
-          if (absl::SimpleAtoi(width_text, &width)) {
-            const BasedNumber number(base_text, digits_text);
-            CHECK(number.ok)
-                << "Expecting valid numeric literal from lexer, but got: "
-                << digits_text;
-            // Detect binary values, whose literal width is shorter than the
-            // declared width.
-            // Allow 'b0 and 'b? as an exception.
-            CHECK_EQ(number.base,
-                     'b');  // guaranteed by matching TK_BinBase
-            if (width > number.literal.length() && number.literal != "0" &&
-                number.literal != "?") {
-              violations_.insert(LintViolation(
-                  digits_leaf->get(),
-                  FormatReason(width_text, base_text, digits_text), context));
-            }
-          }  // else width is not constant, so ignore
-        }
+std::vector<Matcher> UndersizedBinaryLiteralRule::Matchers() const {
+  return {NumberMatcher()};
+}
+
+void UndersizedBinaryLiteralRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const SyntaxTreeContext& context) {
+  if (auto width_leaf = manager.GetAs<SyntaxTreeLeaf>("width")) {
+    if (auto base_leaf = manager.GetAs<SyntaxTreeLeaf>("base")) {
+      if (auto digits_leaf = manager.GetAs<SyntaxTreeLeaf>("digits")) {
+        auto width_text = width_leaf->get().text();
+        auto base_text = base_leaf->get().text();
+        auto digits_text = digits_leaf->get().text();
+        size_t width;
+        if (absl::SimpleAtoi(width_text, &width)) {
+          const BasedNumber number(base_text, digits_text);
+          CHECK(number.ok)
+              << "Expecting valid numeric literal from lexer, but got: "
+              << digits_text;
+          // Detect binary values, whose literal width is shorter than the
+          // declared width.
+          // Allow 'b0 and 'b? as an exception.
+          CHECK_EQ(number.base, 'b');  // guaranteed by matching TK_BinBase
+          if (width > number.literal.length() && number.literal != "0" &&
+              number.literal != "?") {
+            violations_.insert(LintViolation(
+                digits_leaf->get(),
+                FormatReason(width_text, base_text, digits_text), context));
+          }
+        }  // else width is not constant, so ignore
       }
     }
   }
@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "common/analysis/citation.h"
@@ -62,14 +63,17 @@ std::string V2001GenerateBeginRule::GetDescription(
       GetStyleGuideCitation(kTopic), ".");
 }
 
-void V2001GenerateBeginRule::HandleSymbol(
-    const verible::Symbol& symbol, const verible::SyntaxTreeContext& context) {
-  verible::matcher::BoundSymbolManager manager;
-  if (GenerateRegionMatcher().Matches(symbol, &manager)) {
-    if (const auto* block = manager.GetAs<verible::SyntaxTreeNode>("block")) {
-      violations_.insert(LintViolation(verible::GetLeftmostLeaf(*block)->get(),
-                                       kMessage, context));
-    }
+std::vector<Matcher> V2001GenerateBeginRule::Matchers() const {
+  return {GenerateRegionMatcher()};
+}
+
+void V2001GenerateBeginRule::HandleMatch(
+    size_t matcher_index, const verible::Symbol& symbol,
+    const verible::matcher::BoundSymbolManager& manager,
+    const verible::SyntaxTreeContext& context) {
+  if (const auto* block = manager.GetAs<verible::SyntaxTreeNode>("block")) {
+    violations_.insert(LintViolation(verible::GetLeftmostLeaf(*block)->get(),
+                                     kMessage, context));
   }
 }
 
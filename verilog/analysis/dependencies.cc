@@ -15,12 +15,15 @@
 #include "verilog/analysis/dependencies.h"
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "common/strings/compare.h"
 #include "common/strings/display_utils.h"
 #include "common/util/logging.h"
 #include "verilog/analysis/symbol_table.h"
 #include "verilog/analysis/verilog_project.h"
+#include "verilog/analysis/verilog_skim.h"
 
 namespace verilog {
 
@@ -121,6 +124,34 @@ FileDependencies::FileDependencies(const SymbolTable& symbol_table)
   // All the work is done by the initializers.
 }
 
+FileDependencies::FileDependencies(symbol_index_type symbols_index)
+    : root_symbols_index(std::move(symbols_index)),
+      file_deps(CreateFileDependenciesFromSymbolMap(root_symbols_index)) {}
+
+FileDependencies SkimmedFileDependencies(
+    const std::vector<std::pair<const VerilogSourceFile*, SkimmedSource>>&
+        skimmed_files) {
+  VLOG(1) << __FUNCTION__;
+  FileDependencies::symbol_index_type symbols_index;
+  for (const auto& skimmed : skimmed_files) {
+    for (const absl::string_view name : skimmed.second.declarations) {
+      FileDependencies::SymbolData& symbol_data(symbols_index[name]);
+      // Take the first definition, arbitrarily.
+      if (symbol_data.definer == nullptr) symbol_data.definer = skimmed.first;
+    }
+  }
+  for (const auto& skimmed : skimmed_files) {
+    for (const auto* names : {&skimmed.second.package_references,
+                              &skimmed.second.instantiated_types}) {
+      for (const absl::string_view name : *names) {
+        symbols_index[name].referencers.insert(skimmed.first);
+      }
+    }
+  }
+  VLOG(1) << "end of " << __FUNCTION__;
+  return FileDependencies(std::move(symbols_index));
+}
+
 bool FileDependencies::Empty() const {
   for (const auto& ref : file_deps) {
     for (const auto& def : ref.second) {
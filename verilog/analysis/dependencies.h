@@ -19,10 +19,13 @@
 #include <iosfwd>
 #include <map>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "common/strings/compare.h"
 #include "verilog/analysis/symbol_table.h"
+#include "verilog/analysis/verilog_skim.h"
 
 namespace verilog {
 
@@ -88,6 +91,10 @@ struct FileDependencies {
   // Once initialized, all data members are const.
   explicit FileDependencies(const SymbolTable& symbol_table);
 
+  // Computes the dependency graph from an index of symbols collected by
+  // other means (see SkimmedFileDependencies()).
+  explicit FileDependencies(symbol_index_type symbols_index);
+
   bool Empty() const;
 
   // Visit every edge with a function.
@@ -103,6 +110,15 @@ struct FileDependencies {
 
 std::ostream& operator<<(std::ostream&, const FileDependencies&);
 
+// Approximates the dependencies between files from their lexical skims (see
+// SkimVerilogSource()), without parsing or a symbol table.  A file depends on
+// the (first) file that declares a design unit, package or class that it
+// instantiates or references with '::'.
+// The skims' string_views must outlive the returned object.
+FileDependencies SkimmedFileDependencies(
+    const std::vector<std::pair<const VerilogSourceFile*, SkimmedSource>>&
+        skimmed_files);
+
 }  // namespace verilog
 
 #endif  // VERIBLE_VERILOG_ANALYSIS_DEPENDENCIES_H_
@@ -14,10 +14,14 @@
 
 #include "verilog/analysis/dependencies.h"
 
+#include <utility>
+#include <vector>
+
 #include "absl/status/status.h"
 #include "common/util/file_util.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "verilog/analysis/verilog_skim.h"
 
 namespace verilog {
 namespace {
@@ -354,5 +358,62 @@ TEST(FileDependenciesTest, ModuleDiamondDependencies) {
   }
 }
 
+TEST(SkimmedFileDependenciesTest, PackageAndModuleDependencies) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  ASSERT_TRUE(CreateDir(sources_dir).ok());
+
+  VerilogProject project(sources_dir, {/* no include paths */});
+
+  ScopedTestFile ppp(sources_dir,
+                     "package ppp;\n"
+                     "  typedef logic [3:0] nibble_t;\n"
+                     "endpackage\n");
+  ScopedTestFile qqq(sources_dir,
+                     "module qqq;\n"
+                     "  ppp::nibble_t n;\n"
+                     "endmodule\n");
+  ScopedTestFile mmm(sources_dir,
+                     "module mmm;\n"
+                     "  import ppp::*;\n"
+                     "  qqq qqq_i();\n"
+                     "  undeclared u();\n"
+                     "endmodule\n");
+
+  std::vector<std::pair<const VerilogSourceFile*, SkimmedSource>> skims;
+  for (const auto* tf : {&ppp, &qqq, &mmm}) {
+    const auto status_or_file =
+        project.OpenTranslationUnit(Basename(tf->filename()));
+    ASSERT_TRUE(status_or_file.ok()) << status_or_file.status().message();
+    const VerilogSourceFile* file = *status_or_file;
+    skims.emplace_back(
+        file, SkimVerilogSource(file->GetTextStructure()->Contents()));
+  }
+  const VerilogSourceFile* ppp_file = skims[0].first;
+  const VerilogSourceFile* qqq_file = skims[1].first;
+  const VerilogSourceFile* mmm_file = skims[2].first;
+
+  const FileDependencies file_deps(SkimmedFileDependencies(skims));
+  EXPECT_EQ(file_deps.file_deps.size(), 2) << file_deps;
+  {
+    const auto found_ref = file_deps.file_deps.find(mmm_file);
+    ASSERT_NE(found_ref, file_deps.file_deps.end()) << file_deps;
+    EXPECT_EQ(found_ref->second.size(), 2) << file_deps;
+    const auto found_ppp = found_ref->second.find(ppp_file);
+    ASSERT_NE(found_ppp, found_ref->second.end()) << file_deps;
+    EXPECT_THAT(found_ppp->second, ElementsAre("ppp"));
+    const auto found_qqq = found_ref->second.find(qqq_file);
+    ASSERT_NE(found_qqq, found_ref->second.end()) << file_deps;
+    EXPECT_THAT(found_qqq->second, ElementsAre("qqq"));
+  }
+  {
+    const auto found_ref = file_deps.file_deps.find(qqq_file);
+    ASSERT_NE(found_ref, file_deps.file_deps.end()) << file_deps;
+    const auto found_def = found_ref->second.find(ppp_file);
+    ASSERT_NE(found_def, found_ref->second.end()) << file_deps;
+    EXPECT_THAT(found_def->second, ElementsAre("ppp"));
+  }
+}
+
 }  // namespace
 }  // namespace verilog
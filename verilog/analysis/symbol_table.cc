@@ -14,7 +14,10 @@
 
 #include "verilog/analysis/symbol_table.h"
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <stack>
 
@@ -30,6 +33,7 @@
 #include "common/text/visitors.h"
 #include "common/util/enum_flags.h"
 #include "common/util/logging.h"
+#include "common/util/phase_stats.h"
 #include "common/util/spacer.h"
 #include "common/util/value_saver.h"
 #include "verilog/CST/class.h"
@@ -168,7 +172,9 @@ class SymbolTable::Builder : public TreeContextVisitor {
       : source_(&source),
         token_context_(MakeTokenContext()),
         symbol_table_(symbol_table),
-        current_scope_(&symbol_table_->MutableRoot()) {}
+        current_scope_(&symbol_table_->MutableRoot()) {
+    RecordContributingFile(source);
+  }
 
   std::vector<absl::Status> TakeDiagnostics() {
     return std::move(diagnostics_);
@@ -267,7 +273,8 @@ class SymbolTable::Builder : public TreeContextVisitor {
         DescendEnumType(node);
         break;
       default:
-        Descend(node);
+        // No scope changes, so deeply nested expressions need not recurse.
+        VisitChildrenLater(node);
         break;
     }
     VLOG(1) << "end of " << __FUNCTION__ << " [node]: " << tag;
@@ -305,8 +312,11 @@ class SymbolTable::Builder : public TreeContextVisitor {
       // Empty refs are non-actionable and must be excluded.
       DependentReferences& ref(Ref());
       if (!ref.Empty()) {
-        builder_->current_scope_->Value().local_references_to_bind.emplace_back(
-            std::move(ref));
+        SymbolTableNode* scope = builder_->current_scope_;
+        ReferenceComponentNode* root = ref.components.get();
+        scope->Value().local_references_to_bind.emplace_back(std::move(ref));
+        builder_->symbol_table_->RecordReference(scope, builder_->source_,
+                                                 root);
       }
       builder_->reference_builders_.pop();
       builder_->reference_branch_point_ = saved_branch_point_;  // restore
@@ -816,7 +826,9 @@ class SymbolTable::Builder : public TreeContextVisitor {
                                              .file_origin = source_,
                                              .syntax_origin = &element,
                                          });
-    if (!p.second) {
+    if (p.second) {
+      symbol_table_->RecordSymbol(&p.first->second);
+    } else {
       DiagnoseSymbolAlreadyExists(name);
     }
     return p.first->second;  // scope of the new (or pre-existing symbol)
@@ -840,7 +852,9 @@ class SymbolTable::Builder : public TreeContextVisitor {
             // associate this instance with its declared type
             .declared_type = *ABSL_DIE_IF_NULL(declaration_type_info_),  // copy
         });
-    if (!p.second) {
+    if (p.second) {
+      symbol_table_->RecordSymbol(&p.first->second);
+    } else {
       DiagnoseSymbolAlreadyExists(name);
     }
     VLOG(1) << "end of " << __FUNCTION__ << ": " << name;
@@ -1103,6 +1117,7 @@ class SymbolTable::Builder : public TreeContextVisitor {
                    });
     SymbolTableNode* inner_symbol = &p.first->second;
     if (p.second) {
+      symbol_table_->RecordSymbol(inner_symbol);
       // If injection succeeded, then the outer_scope did not already contain a
       // forward declaration of the inner symbol to be defined.
       // Diagnose this non-fatally, but continue.
@@ -1199,6 +1214,7 @@ class SymbolTable::Builder : public TreeContextVisitor {
     VerilogSourceFile* const included_file = *status_or_file;
     if (included_file == nullptr) return;
     VLOG(1) << "opened include file: " << included_file->ResolvedPath();
+    RecordContributingFile(*included_file);
 
     const auto parse_status = included_file->Parse();
     if (!parse_status.ok()) {
@@ -1220,6 +1236,13 @@ class SymbolTable::Builder : public TreeContextVisitor {
     }
   }
 
+  // Remembers which files contributed to the translation unit being built,
+  // in support of SymbolTable::RemoveTranslationUnit().
+  void RecordContributingFile(const VerilogSourceFile& file) {
+    symbol_table_->RecordContributingFile(translation_unit_, &file);
+    symbol_table_->unresolved_files_.insert(&file);
+  }
+
   std::string CurrentScopeFullPath() const {
     return ContextFullPath(*current_scope_);
   }
@@ -1240,6 +1263,9 @@ class SymbolTable::Builder : public TreeContextVisitor {
   // TODO(fangism): maintain a vector/stack of these for richer diagnostics
   const VerilogSourceFile* source_;
 
+  // The translation unit being built (the initial 'source_').
+  const VerilogSourceFile* const translation_unit_ = source_;
+
   // For human-readable debugging.
   // This should be constructed using MakeTokenContext(), after setting
   // 'source_'.
@@ -1433,16 +1459,49 @@ static const SymbolTableNode* CanonicalizeTypeForMemberLookup(
   return current_context;
 }
 
+// Looks up a single name as a direct member of scopes.
+// When a SymbolTableScopeIndex is available, the name is mapped to its
+// interned id only once, and each scope lookup is an integer hash probe.
+// Otherwise, this falls back to SymbolTableNode::Find() (string compares).
+class ScopeMemberLookup {
+ public:
+  ScopeMemberLookup(absl::string_view name, const SymbolTableScopeIndex* index)
+      : name_(name),
+        index_(index),
+        id_(index != nullptr ? index->FindId(name)
+                             : SymbolTableScopeIndex::kNotFound) {}
+
+  // Returns true if the name is known to not be defined in any scope.
+  bool Undefined() const {
+    return index_ != nullptr && id_ == SymbolTableScopeIndex::kNotFound;
+  }
+
+  // Returns the member of 'scope' with this name, or nullptr.
+  const SymbolTableNode* In(const SymbolTableNode& scope) const {
+    if (index_ != nullptr) {
+      if (Undefined()) return nullptr;
+      return index_->FindMember(scope, id_);
+    }
+    const auto found = scope.Find(name_);
+    if (found == scope.end()) return nullptr;
+    return &found->second;
+  }
+
+ private:
+  const absl::string_view name_;
+  const SymbolTableScopeIndex* const index_;
+  const SymbolTableScopeIndex::id_type id_;
+};
+
 // Search through base class's scopes for a symbol.
 static const SymbolTableNode* LookupSymbolThroughInheritedScopes(
-    const SymbolTableNode& context, absl::string_view symbol) {
+    const SymbolTableNode& context, const ScopeMemberLookup& symbol) {
+  if (symbol.Undefined()) return nullptr;
   const SymbolTableNode* current_context = &context;
   do {
     // Look directly in current scope.
-    const auto found = current_context->Find(symbol);
-    if (found != current_context->end()) {
-      return &found->second;
-    }
+    const SymbolTableNode* found = symbol.In(*current_context);
+    if (found != nullptr) return found;
     // TODO: lookup imported namespaces and symbols
 
     // Point to next inherited scope.
@@ -1463,7 +1522,8 @@ static const SymbolTableNode* LookupSymbolThroughInheritedScopes(
 
 // Search up-scope, stopping at the first symbol found in the nearest scope.
 static const SymbolTableNode* LookupSymbolUpwards(
-    const SymbolTableNode& context, absl::string_view symbol) {
+    const SymbolTableNode& context, const ScopeMemberLookup& symbol) {
+  if (symbol.Undefined()) return nullptr;
   const SymbolTableNode* current_context = &context;
   do {
     const SymbolTableNode* found =
@@ -1483,8 +1543,9 @@ static absl::Status DiagnoseUnqualifiedSymbolResolutionFailure(
                                           ContextFullPath(context), "."));
 }
 
-static void ResolveReferenceComponentNodeLocal(ReferenceComponentNode& node,
-                                               const SymbolTableNode& context) {
+static void ResolveReferenceComponentNodeLocal(
+    ReferenceComponentNode& node, const SymbolTableNode& context,
+    const SymbolTableScopeIndex* index) {
   ReferenceComponent& component(node.Value());
   VLOG(2) << __FUNCTION__ << ": " << component;
   // If already resolved, skip.
@@ -1496,19 +1557,21 @@ static void ResolveReferenceComponentNodeLocal(ReferenceComponentNode& node,
 
   // Only try to resolve using the same scope in which the reference appeared,
   // local, without upward search.
-  const auto found = context.Find(key);
-  if (found != context.end()) {
-    component.resolved_symbol = &found->second;
+  const SymbolTableNode* found = ScopeMemberLookup(key, index).In(context);
+  if (found != nullptr) {
+    component.resolved_symbol = found;
   }
 }
 
 static void ResolveUnqualifiedName(ReferenceComponent& component,
                                    const SymbolTableNode& context,
+                                   const SymbolTableScopeIndex* index,
                                    std::vector<absl::Status>* diagnostics) {
   VLOG(2) << __FUNCTION__ << ": " << component;
   const absl::string_view key(component.identifier);
   // Find the first symbol whose name matches, without regard to its metatype.
-  const SymbolTableNode* resolved = LookupSymbolUpwards(context, key);
+  const SymbolTableNode* resolved =
+      LookupSymbolUpwards(context, ScopeMemberLookup(key, index));
   if (resolved == nullptr) {
     diagnostics->emplace_back(
         DiagnoseUnqualifiedSymbolResolutionFailure(key, context));
@@ -1526,17 +1589,18 @@ static void ResolveUnqualifiedName(ReferenceComponent& component,
 // lookups.
 static void ResolveImmediateMember(ReferenceComponent& component,
                                    const SymbolTableNode& context,
+                                   const SymbolTableScopeIndex* index,
                                    std::vector<absl::Status>* diagnostics) {
   VLOG(2) << __FUNCTION__ << ": " << component;
   const absl::string_view key(component.identifier);
-  const auto found = context.Find(key);
-  if (found == context.end()) {
+  const SymbolTableNode* found = ScopeMemberLookup(key, index).In(context);
+  if (found == nullptr) {
     diagnostics->emplace_back(
         DiagnoseMemberSymbolResolutionFailure(key, context));
     return;
   }
 
-  const SymbolTableNode& found_symbol = found->second;
+  const SymbolTableNode& found_symbol = *found;
   const auto resolve_status = component.ResolveSymbol(found_symbol);
   if (!resolve_status.ok()) {
     diagnostics->push_back(resolve_status);
@@ -1546,6 +1610,7 @@ static void ResolveImmediateMember(ReferenceComponent& component,
 
 static void ResolveDirectMember(ReferenceComponent& component,
                                 const SymbolTableNode& context,
+                                const SymbolTableScopeIndex* index,
                                 std::vector<absl::Status>* diagnostics) {
   VLOG(2) << __FUNCTION__ << ": " << component;
 
@@ -1561,8 +1626,8 @@ static void ResolveDirectMember(ReferenceComponent& component,
   }
 
   const absl::string_view key(component.identifier);
-  const auto* found =
-      LookupSymbolThroughInheritedScopes(*canonical_context, key);
+  const auto* found = LookupSymbolThroughInheritedScopes(
+      *canonical_context, ScopeMemberLookup(key, index));
   if (found == nullptr) {
     diagnostics->emplace_back(
         DiagnoseMemberSymbolResolutionFailure(key, *canonical_context));
@@ -1583,6 +1648,7 @@ static void ResolveDirectMember(ReferenceComponent& component,
 // traversal).
 static void ResolveReferenceComponentNode(
     ReferenceComponentNode& node, const SymbolTableNode& context,
+    const SymbolTableScopeIndex* index,
     std::vector<absl::Status>* diagnostics) {
   ReferenceComponent& component(node.Value());
   VLOG(2) << __FUNCTION__ << ": " << component;
@@ -1592,11 +1658,11 @@ static void ResolveReferenceComponentNode(
     case ReferenceType::kUnqualified: {
       // root node: lookup this symbol from its context upward
       CHECK(node.Parent() == nullptr);
-      ResolveUnqualifiedName(component, context, diagnostics);
+      ResolveUnqualifiedName(component, context, index, diagnostics);
       break;
     }
     case ReferenceType::kImmediate: {
-      ResolveImmediateMember(component, context, diagnostics);
+      ResolveImmediateMember(component, context, index, diagnostics);
       break;
     }
     case ReferenceType::kDirectMember: {
@@ -1606,7 +1672,7 @@ static void ResolveReferenceComponentNode(
       const SymbolTableNode* parent_scope = parent_component.resolved_symbol;
       if (parent_scope == nullptr) return;  // leave this subtree unresolved
 
-      ResolveDirectMember(component, *parent_scope, diagnostics);
+      ResolveDirectMember(component, *parent_scope, index, diagnostics);
       break;
     }
     case ReferenceType::kMemberOfTypeOfParent: {
@@ -1635,7 +1701,7 @@ static void ResolveReferenceComponentNode(
           type_info.user_defined_type->Value().resolved_symbol;
       if (type_scope == nullptr) return;
 
-      ResolveDirectMember(component, *type_scope, diagnostics);
+      ResolveDirectMember(component, *type_scope, index, diagnostics);
       break;
     }
   }
@@ -1652,25 +1718,27 @@ ReferenceComponentMap ReferenceComponentNodeMapView(
 }
 
 void DependentReferences::Resolve(const SymbolTableNode& context,
-                                  std::vector<absl::Status>* diagnostics) {
+                                  std::vector<absl::Status>* diagnostics,
+                                  const SymbolTableScopeIndex* index) {
   VLOG(1) << __FUNCTION__;
   if (components == nullptr) return;
   // References are arranged in dependency trees.
   // Parent node references must be resolved before children nodes,
   // hence a pre-order traversal.
   components->ApplyPreOrder(
-      [&context, diagnostics](ReferenceComponentNode& node) {
-        ResolveReferenceComponentNode(node, context, diagnostics);
+      [&context, index, diagnostics](ReferenceComponentNode& node) {
+        ResolveReferenceComponentNode(node, context, index, diagnostics);
         // TODO: minor optimization, when resolution for a node fails,
         // skip checking that node's subtree; early terminate.
       });
   VLOG(1) << "end of " << __FUNCTION__;
 }
 
-void DependentReferences::ResolveLocally(const SymbolTableNode& context) {
+void DependentReferences::ResolveLocally(const SymbolTableNode& context,
+                                         const SymbolTableScopeIndex* index) {
   if (components == nullptr) return;
   // Only attempt to resolve the reference root, and none of its subtrees.
-  ResolveReferenceComponentNodeLocal(*components, context);
+  ResolveReferenceComponentNodeLocal(*components, context, index);
 }
 
 absl::StatusOr<SymbolTableNode*> DependentReferences::ResolveOnlyBaseLocally(
@@ -1781,15 +1849,17 @@ void SymbolInfo::VerifySymbolTableRoot(const SymbolTableNode* root) const {
 }
 
 void SymbolInfo::Resolve(const SymbolTableNode& context,
-                         std::vector<absl::Status>* diagnostics) {
+                         std::vector<absl::Status>* diagnostics,
+                         const SymbolTableScopeIndex* index) {
   for (auto& local_ref : local_references_to_bind) {
-    local_ref.Resolve(context, diagnostics);
+    local_ref.Resolve(context, diagnostics, index);
   }
 }
 
-void SymbolInfo::ResolveLocally(const SymbolTableNode& context) {
+void SymbolInfo::ResolveLocally(const SymbolTableNode& context,
+                                const SymbolTableScopeIndex* index) {
   for (auto& local_ref : local_references_to_bind) {
-    local_ref.ResolveLocally(context);
+    local_ref.ResolveLocally(context, index);
   }
 }
 
@@ -1843,14 +1913,431 @@ void SymbolTable::CheckIntegrity() const {
       [=](const SymbolInfo& s) { s.VerifySymbolTableRoot(root); });
 }
 
+constexpr SymbolTableScopeIndex::id_type SymbolTableScopeIndex::kNotFound;
+
+void SymbolTableScopeIndex::Rebuild(const SymbolTableNode& root) {
+  Clear();
+  root.ApplyPreOrder([this](const SymbolTableNode& node) { IndexScope(node); });
+}
+
+void SymbolTableScopeIndex::IndexScope(const SymbolTableNode& scope) {
+  for (const auto& member : scope) {
+    const id_type id = interner_.Intern(member.first);
+    members_[std::make_pair(&scope, id)] = &member.second;
+  }
+}
+
+void SymbolTableScopeIndex::IndexMember(const SymbolTableNode& member) {
+  const id_type id = interner_.Intern(*ABSL_DIE_IF_NULL(member.Key()));
+  members_[std::make_pair(ABSL_DIE_IF_NULL(member.Parent()), id)] = &member;
+}
+
+void SymbolTableScopeIndex::RemoveSubtree(const SymbolTableNode& member) {
+  member.ApplyPreOrder([this](const SymbolTableNode& node) {
+    const id_type id = FindId(*node.Key());
+    if (id == kNotFound) return;
+    members_.erase(std::make_pair(node.Parent(), id));
+  });
+}
+
+void SymbolTableScopeIndex::Clear() {
+  interner_.clear();
+  members_.clear();
+}
+
 void SymbolTable::Resolve(std::vector<absl::Status>* diagnostics) {
-  symbol_table_root_.ApplyPreOrder(
-      [=](SymbolTableNode& node) { node.Value().Resolve(node, diagnostics); });
+  const verible::ScopedPhase phase("symbol-table-resolve");
+  scope_index_.Rebuild(symbol_table_root_);
+  const SymbolTableScopeIndex* index = &scope_index_;
+  symbol_table_root_.ApplyPreOrder([=](SymbolTableNode& node) {
+    node.Value().Resolve(node, diagnostics, index);
+  });
+  // Everything is up-to-date.
+  unresolved_files_.clear();
+  changed_names_.clear();
+  dependencies_indexed_ = false;  // bindings changed
+}
+
+void SymbolTable::RecordContributingFile(const VerilogSourceFile* unit,
+                                         const VerilogSourceFile* file) {
+  translation_unit_files_[unit].insert(file);
+  file_translation_units_[file].insert(unit);
+}
+
+void SymbolTable::RecordSymbol(SymbolTableNode* symbol) {
+  file_symbols_[symbol->Value().file_origin].push_back(symbol);
+}
+
+void SymbolTable::RecordReference(SymbolTableNode* scope,
+                                  const VerilogSourceFile* file,
+                                  ReferenceComponentNode* root) {
+  file_references_[file].push_back(root);
+  reference_origins_[root] = ReferenceOrigin{scope, file};
+  if (dependencies_indexed_) IndexReference(root);
+}
+
+void SymbolTable::IndexDependencies() {
+  if (dependencies_indexed_) return;
+  reference_names_.clear();
+  name_references_.clear();
+  type_users_.clear();
+  symbol_references_.clear();
+  symbol_table_root_.ApplyPreOrder([this](SymbolTableNode& node) {
+    IndexTypes(&node);
+    for (auto& ref : node.Value().local_references_to_bind) {
+      if (!ref.Empty()) IndexReference(ref.components.get());
+    }
+  });
+  dependencies_indexed_ = true;
+}
+
+void SymbolTable::IndexReference(ReferenceComponentNode* root) {
+  root->ApplyPreOrder([this, root](ReferenceComponentNode& node) {
+    const ReferenceComponent& component(node.Value());
+    name_references_[reference_names_.Intern(component.identifier)].insert(
+        root);
+    if (component.resolved_symbol != nullptr) {
+      symbol_references_[component.resolved_symbol].insert(&node);
+    }
+  });
+}
+
+void SymbolTable::IndexTypes(SymbolTableNode* symbol) {
+  const SymbolInfo& info(symbol->Value());
+  for (const ReferenceComponentNode* type :
+       {info.declared_type.user_defined_type,
+        info.parent_type.user_defined_type}) {
+    if (type != nullptr) type_users_[type].insert(symbol);
+  }
+}
+
+void SymbolTable::UnindexReference(ReferenceComponentNode* root) {
+  reference_origins_.erase(root);
+  root->ApplyPreOrder([this, root](ReferenceComponentNode& node) {
+    const ReferenceComponent& component(node.Value());
+    const auto id = reference_names_.Find(component.identifier);
+    if (id != verible::StringInterner::kNotFound) {
+      const auto found = name_references_.find(id);
+      if (found != name_references_.end()) found->second.erase(root);
+    }
+    if (component.resolved_symbol != nullptr) {
+      const auto found = symbol_references_.find(component.resolved_symbol);
+      if (found != symbol_references_.end()) found->second.erase(&node);
+    }
+    type_users_.erase(&node);
+  });
+}
+
+void SymbolTable::UnbindReference(ReferenceComponentNode* root) {
+  root->ApplyPreOrder([this](ReferenceComponentNode& node) {
+    const SymbolTableNode*& resolved(node.Value().resolved_symbol);
+    if (resolved == nullptr) return;
+    const auto found = symbol_references_.find(resolved);
+    if (found != symbol_references_.end()) found->second.erase(&node);
+    resolved = nullptr;
+  });
+}
+
+std::vector<const VerilogSourceFile*> SymbolTable::RemoveTranslationUnit(
+    const VerilogSourceFile& file) {
+  VLOG(1) << __FUNCTION__ << ": " << file.ReferencedPath();
+  IndexDependencies();
+
+  // Translation units to retract, in the same order that Build() uses.
+  std::set<const VerilogSourceFile*, VerilogSourceFile::Less> units;
+  // Files whose contributions are retracted, and those yet to be visited.
+  std::set<const VerilogSourceFile*> files;
+  std::vector<const VerilogSourceFile*> pending_files;
+  const auto retract_unit = [&](const VerilogSourceFile* unit) {
+    if (!units.insert(unit).second) return;
+    pending_files.push_back(unit);
+    const auto found = translation_unit_files_.find(unit);
+    if (found == translation_unit_files_.end()) return;
+    pending_files.insert(pending_files.end(), found->second.begin(),
+                         found->second.end());
+  };
+  // Retracting any contribution of a file retracts every translation unit
+  // that it contributed to.
+  const auto retract_file = [&](const VerilogSourceFile* f) {
+    if (f != nullptr && files.count(f) == 0) pending_files.push_back(f);
+  };
+  {
+    const auto found = file_translation_units_.find(&file);
+    if (found == file_translation_units_.end()) {
+      retract_unit(&file);  // not built yet
+    } else {
+      for (const VerilogSourceFile* unit : found->second) retract_unit(unit);
+    }
+  }
+
+  // Grow the set of retracted translation units until it accounts for all
+  // contributions inside of removed subtrees, and for all symbols whose types
+  // refer to removed references.
+  absl::flat_hash_set<SymbolTableNode*> removed_symbols;
+  while (!pending_files.empty()) {
+    const VerilogSourceFile* f = pending_files.back();
+    pending_files.pop_back();
+    if (!files.insert(f).second) continue;
+    {
+      const auto found = file_translation_units_.find(f);
+      if (found != file_translation_units_.end()) {
+        for (const VerilogSourceFile* unit : found->second) {
+          retract_unit(unit);
+        }
+      }
+    }
+    {
+      const auto found = file_references_.find(f);
+      if (found != file_references_.end()) {
+        for (ReferenceComponentNode* root : found->second) {
+          root->ApplyPreOrder([&](const ReferenceComponentNode& node) {
+            const auto users = type_users_.find(&node);
+            if (users == type_users_.end()) return;
+            for (const SymbolTableNode* user : users->second) {
+              retract_file(user->Value().file_origin);
+            }
+          });
+        }
+      }
+    }
+    const auto found = file_symbols_.find(f);
+    if (found == file_symbols_.end()) continue;
+    for (SymbolTableNode* symbol : found->second) {
+      if (removed_symbols.contains(symbol)) continue;
+      symbol->ApplyPreOrder([&](SymbolTableNode& node) {
+        if (!removed_symbols.insert(&node).second) return;
+        retract_file(node.Value().file_origin);
+        for (const auto& ref : node.Value().local_references_to_bind) {
+          if (ref.Empty()) continue;
+          const auto origin = reference_origins_.find(ref.components.get());
+          if (origin != reference_origins_.end()) {
+            retract_file(origin->second.file);
+          }
+        }
+      });
+    }
+  }
+
+  // Retract references in surviving scopes.
+  absl::flat_hash_map<SymbolTableNode*,
+                      absl::flat_hash_set<const ReferenceComponentNode*>>
+      retracted_references;
+  for (const VerilogSourceFile* f : files) {
+    const auto found = file_references_.find(f);
+    if (found == file_references_.end()) continue;
+    for (ReferenceComponentNode* root : found->second) {
+      SymbolTableNode* scope = reference_origins_.at(root).scope;
+      if (!removed_symbols.contains(scope)) {
+        retracted_references[scope].insert(root);
+        UnindexReference(root);
+      }
+    }
+  }
+  for (auto& scope_references : retracted_references) {
+    std::vector<DependentReferences>& refs(
+        scope_references.first->Value().local_references_to_bind);
+    // DependentReferences are not move-assignable, so rebuild the vector.
+    std::vector<DependentReferences> kept;
+    kept.reserve(refs.size());
+    for (auto& ref : refs) {
+      if (scope_references.second.count(ref.components.get()) == 0) {
+        kept.push_back(std::move(ref));
+      }
+    }
+    refs.swap(kept);
+  }
+
+  // Remove symbols, with all of the references in their scopes.
+  std::vector<std::string> removed_names;
+  std::vector<SymbolTableNode*> removed_subtrees;
+  for (SymbolTableNode* symbol : removed_symbols) {
+    SymbolInfo& info(symbol->Value());
+    for (auto& ref : info.local_references_to_bind) {
+      if (!ref.Empty()) UnindexReference(ref.components.get());
+    }
+    for (const ReferenceComponentNode* type :
+         {info.declared_type.user_defined_type,
+          info.parent_type.user_defined_type}) {
+      const auto found = type_users_.find(type);
+      if (found != type_users_.end()) found->second.erase(symbol);
+    }
+    symbol_references_.erase(symbol);
+    removed_names.emplace_back(*symbol->Key());
+    if (!removed_symbols.contains(symbol->Parent())) {
+      removed_subtrees.push_back(symbol);
+    }
+  }
+  for (SymbolTableNode* symbol : removed_subtrees) {
+    if (!scope_index_.empty()) scope_index_.RemoveSubtree(*symbol);
+    const absl::string_view key(*symbol->Key());
+    symbol->Parent()->Erase(key);
+  }
+
+  // Surviving references that could have been bound to removed symbols need
+  // to be resolved again.  This also releases any pointers to removed symbols.
+  for (std::string& name : removed_names) {
+    const auto id = reference_names_.Find(name);
+    if (id != verible::StringInterner::kNotFound) {
+      const auto found = name_references_.find(id);
+      if (found != name_references_.end()) {
+        for (ReferenceComponentNode* root : found->second) {
+          UnbindReference(root);
+        }
+      }
+    }
+    changed_names_.insert(std::move(name));
+  }
+
+  for (const VerilogSourceFile* unit : units) {
+    const auto found = translation_unit_files_.find(unit);
+    if (found == translation_unit_files_.end()) continue;
+    for (const VerilogSourceFile* f : found->second) {
+      const auto unit_set = file_translation_units_.find(f);
+      if (unit_set == file_translation_units_.end()) continue;
+      unit_set->second.erase(unit);
+      if (unit_set->second.empty()) file_translation_units_.erase(unit_set);
+    }
+    translation_unit_files_.erase(found);
+  }
+  for (const VerilogSourceFile* f : files) {
+    file_symbols_.erase(f);
+    file_references_.erase(f);
+    unresolved_files_.erase(f);
+  }
+  return std::vector<const VerilogSourceFile*>(units.begin(), units.end());
+}
+
+// Returns the keys of the path from the root to 'node'.
+static std::vector<absl::string_view> SymbolPath(const SymbolTableNode& node) {
+  std::vector<absl::string_view> path;
+  for (const SymbolTableNode* n = &node; n->Parent() != nullptr;
+       n = n->Parent()) {
+    path.push_back(*n->Key());
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+void SymbolTable::ResolveIncrementally(std::vector<absl::Status>* diagnostics) {
+  VLOG(1) << __FUNCTION__;
+  const verible::ScopedPhase phase("symbol-table-resolve");
+  const bool rebuild_index = scope_index_.empty();
+  if (rebuild_index) scope_index_.Rebuild(symbol_table_root_);
+  IndexDependencies();
+
+  // References that need to be resolved (again), by the roots of their
+  // components, and the components whose bindings may have changed.
+  absl::flat_hash_set<ReferenceComponentNode*> affected_references;
+  std::vector<const ReferenceComponentNode*> affected_components;
+  const auto mark_affected = [&](ReferenceComponentNode* root, bool unbind) {
+    if (!affected_references.insert(root).second) return;
+    if (unbind) UnbindReference(root);
+    root->ApplyPreOrder([&](const ReferenceComponentNode& node) {
+      affected_components.push_back(&node);
+    });
+  };
+
+  // References from newly built files were never resolved.
+  // Symbols added by newly built files may shadow or satisfy any reference
+  // that mentions their names.
+  for (const VerilogSourceFile* f : unresolved_files_) {
+    const auto symbols = file_symbols_.find(f);
+    if (symbols != file_symbols_.end()) {
+      for (SymbolTableNode* symbol : symbols->second) {
+        changed_names_.emplace(*symbol->Key());
+        if (!rebuild_index) scope_index_.IndexMember(*symbol);
+        IndexTypes(symbol);
+      }
+    }
+    const auto references = file_references_.find(f);
+    if (references != file_references_.end()) {
+      for (ReferenceComponentNode* root : references->second) {
+        mark_affected(root, false);
+      }
+    }
+  }
+  for (const std::string& name : changed_names_) {
+    const auto id = reference_names_.Find(name);
+    if (id == verible::StringInterner::kNotFound) continue;
+    const auto found = name_references_.find(id);
+    if (found == name_references_.end()) continue;
+    for (ReferenceComponentNode* root : found->second) {
+      mark_affected(root, true);
+    }
+  }
+
+  // References that look up members through affected type references are
+  // also affected, transitively: those in the scopes of symbols whose types
+  // depend on affected references, and those with components bound to such
+  // symbols.
+  absl::flat_hash_set<SymbolTableNode*> affected_scopes;
+  std::vector<SymbolTableNode*> pending_scopes;
+  const auto affect_type_users = [&](const ReferenceComponentNode* type) {
+    const auto users = type_users_.find(type);
+    if (users == type_users_.end()) return;
+    for (SymbolTableNode* user : users->second) {
+      if (affected_scopes.insert(user).second) pending_scopes.push_back(user);
+    }
+  };
+  while (!affected_components.empty() || !pending_scopes.empty()) {
+    if (!affected_components.empty()) {
+      const ReferenceComponentNode* type = affected_components.back();
+      affected_components.pop_back();
+      affect_type_users(type);
+      continue;
+    }
+    SymbolTableNode* scope = pending_scopes.back();
+    pending_scopes.pop_back();
+    scope->ApplyPreOrder([&](SymbolTableNode& node) {
+      for (auto& ref : node.Value().local_references_to_bind) {
+        if (!ref.Empty()) mark_affected(ref.components.get(), true);
+      }
+    });
+    const auto bound = symbol_references_.find(scope);
+    if (bound == symbol_references_.end()) continue;
+    // Copy, because unbinding references modifies symbol_references_.
+    const std::vector<ReferenceComponentNode*> components(bound->second.begin(),
+                                                          bound->second.end());
+    for (ReferenceComponentNode* component : components) {
+      affect_type_users(component);
+      if (!component->Children().empty()) {
+        mark_affected(component->Root(), true);
+      }
+    }
+  }
+
+  // Resolve in the order that Resolve() would: scopes in pre-order, and
+  // references in their order within each scope.
+  absl::flat_hash_set<SymbolTableNode*> scopes;
+  for (ReferenceComponentNode* root : affected_references) {
+    scopes.insert(reference_origins_.at(root).scope);
+  }
+  std::vector<std::pair<std::vector<absl::string_view>, SymbolTableNode*>>
+      ordered_scopes;
+  ordered_scopes.reserve(scopes.size());
+  for (SymbolTableNode* scope : scopes) {
+    ordered_scopes.emplace_back(SymbolPath(*scope), scope);
+  }
+  std::sort(ordered_scopes.begin(), ordered_scopes.end());
+  for (const auto& scope : ordered_scopes) {
+    for (auto& ref : scope.second->Value().local_references_to_bind) {
+      if (ref.Empty()) continue;
+      ReferenceComponentNode* root = ref.components.get();
+      if (!affected_references.contains(root)) continue;
+      ref.Resolve(*scope.second, diagnostics, &scope_index_);
+      IndexReference(root);
+    }
+  }
+  unresolved_files_.clear();
+  changed_names_.clear();
 }
 
 void SymbolTable::ResolveLocallyOnly() {
+  scope_index_.Rebuild(symbol_table_root_);
+  const SymbolTableScopeIndex* index = &scope_index_;
   symbol_table_root_.ApplyPreOrder(
-      [=](SymbolTableNode& node) { node.Value().ResolveLocally(node); });
+      [=](SymbolTableNode& node) { node.Value().ResolveLocally(node, index); });
+  dependencies_indexed_ = false;  // bindings changed
 }
 
 std::ostream& SymbolTable::PrintSymbolDefinitions(std::ostream& stream) const {
@@ -1880,6 +2367,8 @@ static void ParseFileAndBuildSymbolTable(
   // Continue, in case syntax-error recovery left a partial syntax tree.
 
   // Amend symbol table by analyzing this translation unit.
+  const verible::ScopedStatsFile stats_file(source->ReferencedPath());
+  const verible::ScopedPhase phase("symbol-table-build");
   const std::vector<absl::Status> statuses =
       BuildSymbolTable(*source, symbol_table, project);
   // Forward diagnostics.
@@ -1907,6 +2396,38 @@ void SymbolTable::BuildSingleTranslationUnit(
   ParseFileAndBuildSymbolTable(translation_unit, this, project_, diagnostics);
 }
 
+void SymbolTable::UpdateTranslationUnit(
+    absl::string_view referenced_file_name, absl::string_view new_contents,
+    std::vector<absl::Status>* diagnostics) {
+  if (project_ == nullptr) {
+    diagnostics->push_back(absl::FailedPreconditionError(
+        "Updating a translation unit requires a VerilogProject."));
+    return;
+  }
+  const VerilogSourceFile* file =
+      project_->LookupRegisteredFile(referenced_file_name);
+  if (file == nullptr) {
+    diagnostics->push_back(absl::NotFoundError(
+        absl::StrCat("File not found in project: ", referenced_file_name)));
+    return;
+  }
+
+  const std::vector<const VerilogSourceFile*> retracted_units =
+      RemoveTranslationUnit(*file);
+  const auto update_status =
+      project_->UpdateFileContents(referenced_file_name, new_contents);
+  if (!update_status.ok()) diagnostics->push_back(update_status);
+
+  for (const VerilogSourceFile* unit : retracted_units) {
+    // Get the mutable file from the project that owns it.
+    VerilogSourceFile* source =
+        project_->LookupRegisteredFile(unit->ReferencedPath());
+    if (source == nullptr) continue;
+    ParseFileAndBuildSymbolTable(source, this, project_, diagnostics);
+  }
+  ResolveIncrementally(diagnostics);
+}
+
 std::vector<absl::Status> BuildSymbolTable(const VerilogSourceFile& source,
                                            SymbolTable* symbol_table,
                                            VerilogProject* project) {
@@ -18,10 +18,17 @@
 #include <functional>
 #include <iosfwd>
 #include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "common/strings/compare.h"
+#include "common/strings/string_interner.h"
 #include "common/text/symbol.h"
 #include "common/util/map_tree.h"
 #include "common/util/vector_tree.h"
@@ -41,6 +48,9 @@ using SymbolTableNode =
 
 std::ostream& SymbolTableNodeFullPath(std::ostream&, const SymbolTableNode&);
 
+class SymbolTableScopeIndex;  // forward declaration, defined below
+class SymbolTableIndex;       // forward declaration, see symbol_table_index.h
+
 // Classify what type of element a particular symbol is defining.
 enum class SymbolMetaType {
   kRoot,
@@ -213,11 +223,15 @@ struct DependentReferences {
   void VerifySymbolTableRoot(const SymbolTableNode* root) const;
 
   // Attempt to resolve all symbol references.
+  // If 'index' is provided, it is used to accelerate scope member lookups,
+  // and must be up-to-date with the symbol table that contains 'context'.
   void Resolve(const SymbolTableNode& context,
-               std::vector<absl::Status>* diagnostics);
+               std::vector<absl::Status>* diagnostics,
+               const SymbolTableScopeIndex* index = nullptr);
 
   // Attempt to resolve only local symbol references.
-  void ResolveLocally(const SymbolTableNode& context);
+  void ResolveLocally(const SymbolTableNode& context,
+                      const SymbolTableScopeIndex* index = nullptr);
 
   // Attempt to only resolve the base of the reference (the first component).
   absl::StatusOr<SymbolTableNode*> ResolveOnlyBaseLocally(
@@ -340,11 +354,14 @@ struct SymbolInfo {
   absl::string_view CreateAnonymousScope(absl::string_view base);
 
   // Attempt to resolve all symbol references.
+  // 'index' is optional, see DependentReferences::Resolve().
   void Resolve(const SymbolTableNode& context,
-               std::vector<absl::Status>* diagnostics);
+               std::vector<absl::Status>* diagnostics,
+               const SymbolTableScopeIndex* index = nullptr);
 
   // Attempt to resolve only symbols local to 'context' (no upward search).
-  void ResolveLocally(const SymbolTableNode& context);
+  void ResolveLocally(const SymbolTableNode& context,
+                      const SymbolTableScopeIndex* index = nullptr);
 
   // Internal consistency check.
   void VerifySymbolTableRoot(const SymbolTableNode* root) const;
@@ -385,6 +402,73 @@ struct SymbolInfo {
   references_map_view_type LocalReferencesMapViewForTesting() const;
 };
 
+// SymbolTableScopeIndex is a lookup accelerator for a tree of SymbolTableNodes.
+// SymbolTableNode stores each scope's members in an ordered map keyed by
+// string, which gives deterministic iteration order (for printing), but every
+// Find() costs O(lg N) string comparisons, and that cost is paid again at
+// every scope visited by upward and inherited-scope searches.
+// This index interns every member name to a dense integer id once, and keeps
+// all (scope, id) -> member associations in a single flat hash table.
+// Resolving a reference then costs one string hash (to find its id), followed
+// by one integer hash probe per scope searched.  Names that are not defined
+// anywhere fail immediately, without climbing any scopes.
+//
+// The index refers to nodes and keys of the tree that it was built from,
+// and thus, must be rebuilt (or updated) after that tree is modified.
+class SymbolTableScopeIndex {
+ public:
+  using id_type = verible::StringInterner::id_type;
+
+  static constexpr id_type kNotFound = verible::StringInterner::kNotFound;
+
+  SymbolTableScopeIndex() = default;
+
+  SymbolTableScopeIndex(const SymbolTableScopeIndex&) = delete;
+  SymbolTableScopeIndex(SymbolTableScopeIndex&&) = default;
+  SymbolTableScopeIndex& operator=(const SymbolTableScopeIndex&) = delete;
+  SymbolTableScopeIndex& operator=(SymbolTableScopeIndex&&) = default;
+
+  // Discards any previous contents, and indexes every scope in the tree
+  // rooted at 'root'.
+  void Rebuild(const SymbolTableNode& root);
+
+  // Adds the immediate members of 'scope' to the index.
+  void IndexScope(const SymbolTableNode& scope);
+
+  // Adds a single 'member' (which must have a parent scope) to the index.
+  void IndexMember(const SymbolTableNode& member);
+
+  // Removes 'member' and all of its descendants from the index.
+  // This must be called before 'member' is erased from its parent scope.
+  void RemoveSubtree(const SymbolTableNode& member);
+
+  void Clear();
+
+  bool empty() const { return members_.empty(); }
+
+  // Returns the id of a symbol name, or kNotFound if no scope in the index
+  // has a member by that name.
+  id_type FindId(absl::string_view name) const { return interner_.Find(name); }
+
+  // Returns the member of 'scope' with name-id 'id', or nullptr if there is
+  // no such member.  This is equivalent to scope.Find(name).
+  const SymbolTableNode* FindMember(const SymbolTableNode& scope,
+                                    id_type id) const {
+    const auto found = members_.find(std::make_pair(&scope, id));
+    if (found == members_.end()) return nullptr;
+    return found->second;
+  }
+
+ private:
+  // Dense ids for all member names (by string contents).
+  verible::StringInterner interner_;
+
+  // (scope, member-name-id) -> member
+  absl::flat_hash_map<std::pair<const SymbolTableNode*, id_type>,
+                      const SymbolTableNode*>
+      members_;
+};
+
 // This map type represents the global namespace of preprocessor macro
 // definitions.
 // The string_view key should be a substring of text whose memory is owned by
@@ -417,6 +501,9 @@ class SymbolTable {
   class Builder;  // implementation detail
   class Tester;   // test-only
 
+  // Serialization needs direct access to internal state.
+  friend class SymbolTableIndex;
+
  public:
   // If 'project' is nullptr, caller assumes responsibility for managing files
   // and string memory, otherwise string memory is owned by 'project'.
@@ -467,6 +554,48 @@ class SymbolTable {
   // is intended.
   void ResolveLocallyOnly();
 
+  // Retracts every symbol definition and reference contributed by 'file',
+  // so that the file may be modified and rebuilt without rebuilding the
+  // entire symbol table.
+  // Contributions from all files that were `include-d while building the same
+  // translation unit(s) are retracted along with it.  Other translation units
+  // may have to be retracted as well: those that share an included file with
+  // a retracted one, and those that contributed definitions or references
+  // inside of removed scopes (e.g. out-of-line method definitions of a removed
+  // class).
+  // Surviving references that were bound to removed symbols are unbound.
+  // Returns the translation units that were retracted, which need to be
+  // rebuilt (e.g. with BuildSingleTranslationUnit()) before calling
+  // ResolveIncrementally().  If 'file' was never built before (and is not
+  // included by any built translation unit), it is returned as a new
+  // translation unit.
+  // This only visits the retracted contributions (and the surviving references
+  // that mention their names), except that the first call after a full
+  // Resolve() indexes the dependencies among all symbols and references.
+  std::vector<const VerilogSourceFile*> RemoveTranslationUnit(
+      const VerilogSourceFile& file);
+
+  // Resolves only the references that may have been affected by files built
+  // since the last full Resolve(): references that originate from those
+  // files, references that mention any symbol name that was removed or
+  // added since then, and references that depend on the types of such
+  // references.
+  // Like RemoveTranslationUnit(), this only visits the affected references.
+  // Only diagnostics from the re-resolved references are reported.
+  // Known limitation: when a removed definition was previously rejected as a
+  // duplicate of a definition in another file, the surviving definition is
+  // not re-arbitrated.
+  void ResolveIncrementally(std::vector<absl::Status>* diagnostics);
+
+  // Replaces the contents of a previously built file with 'new_contents',
+  // and updates the symbol table accordingly: RemoveTranslationUnit(),
+  // VerilogProject::UpdateFileContents(), rebuilding all retracted
+  // translation units, and ResolveIncrementally().
+  // This requires a VerilogProject.
+  void UpdateTranslationUnit(absl::string_view referenced_file_name,
+                             absl::string_view new_contents,
+                             std::vector<absl::Status>* diagnostics);
+
   // Print only the information about symbols defined (no references).
   // This will print the results of Build().
   std::ostream& PrintSymbolDefinitions(std::ostream&) const;
@@ -483,6 +612,39 @@ class SymbolTable {
   // Verify internal structural and pointer consistency.
   void CheckIntegrity() const;
 
+ private:  // methods
+  // The following methods maintain the per-file contributions and the
+  // dependency index, in support of incremental updates.
+
+  // Records that 'file' contributed to the translation unit 'unit'.
+  void RecordContributingFile(const VerilogSourceFile* unit,
+                              const VerilogSourceFile* file);
+
+  // Records a newly defined 'symbol' as a contribution of its file_origin.
+  void RecordSymbol(SymbolTableNode* symbol);
+
+  // Records a newly added reference (by the 'root' of its components), which
+  // is stored in 'scope', as a contribution of 'file'.
+  void RecordReference(SymbolTableNode* scope, const VerilogSourceFile* file,
+                       ReferenceComponentNode* root);
+
+  // Indexes the dependencies among all symbols and references, unless they
+  // are already indexed.
+  void IndexDependencies();
+
+  // Indexes the names and bindings of all components of a reference.
+  void IndexReference(ReferenceComponentNode* root);
+
+  // Indexes the type references of a symbol's declared and parent types.
+  void IndexTypes(SymbolTableNode* symbol);
+
+  // Removes all components of a reference from the dependency index.
+  void UnindexReference(ReferenceComponentNode* root);
+
+  // Forgets all resolved bindings of a reference, so that it may be resolved
+  // again.
+  void UnbindReference(ReferenceComponentNode* root);
+
  private:  // data
   // This owns all files used to construct the symbol table and therefore,
   // owns all string_views inside the symbol table and outlives objects of
@@ -502,6 +664,81 @@ class SymbolTable {
 
   // All macro definitions/references interact through this global namespace.
   MacroSymbolMap macro_symbols_;
+
+  // Hash-based member lookup index used during symbol resolution.
+  // This is rebuilt at the start of each Resolve*() pass, and maintained
+  // across RemoveTranslationUnit() and ResolveIncrementally().
+  SymbolTableScopeIndex scope_index_;
+
+  // The following fields support incremental updates.
+
+  // Files that contributed to each built translation unit (keyed by
+  // translation unit), including the translation unit itself and all files
+  // that it `include-d.
+  std::map<const VerilogSourceFile*, std::set<const VerilogSourceFile*>>
+      translation_unit_files_;
+
+  // The reverse of translation_unit_files_: the translation units to which
+  // each file contributed.
+  std::map<const VerilogSourceFile*, std::set<const VerilogSourceFile*>>
+      file_translation_units_;
+
+  // Symbols defined by each file, including nested ones.
+  absl::flat_hash_map<const VerilogSourceFile*, std::vector<SymbolTableNode*>>
+      file_symbols_;
+
+  // References that originated from each file, by the roots of their
+  // components.
+  absl::flat_hash_map<const VerilogSourceFile*,
+                      std::vector<ReferenceComponentNode*>>
+      file_references_;
+
+  // Where a reference is stored, and where it originated from.
+  struct ReferenceOrigin {
+    // The scope whose local_references_to_bind holds the reference.
+    SymbolTableNode* scope;
+    // The file that contributed the reference (nullptr if unknown).
+    const VerilogSourceFile* file;
+  };
+
+  // Origin of every reference, keyed by the root of its components.
+  absl::flat_hash_map<const ReferenceComponentNode*, ReferenceOrigin>
+      reference_origins_;
+
+  // Files whose contributions were built since the last full Resolve().
+  std::set<const VerilogSourceFile*> unresolved_files_;
+
+  // Names of symbols that were removed since the last full Resolve().
+  // These are copies, because removed symbols' names may refer to text that
+  // no longer exists.
+  absl::flat_hash_set<std::string> changed_names_;
+
+  // The following fields index the dependencies among symbols and references.
+  // They are built on demand after a full Resolve(), and kept up-to-date by
+  // RemoveTranslationUnit() and ResolveIncrementally(), so that those only
+  // visit the affected entries.
+
+  bool dependencies_indexed_ = false;
+
+  // Dense ids for the names of all reference components.
+  verible::StringInterner reference_names_;
+
+  // References that have a component with each name (by id), by the roots of
+  // their components.
+  absl::flat_hash_map<verible::StringInterner::id_type,
+                      absl::flat_hash_set<ReferenceComponentNode*>>
+      name_references_;
+
+  // Symbols whose declared type or parent type is each type reference
+  // component.
+  absl::flat_hash_map<const ReferenceComponentNode*,
+                      absl::flat_hash_set<SymbolTableNode*>>
+      type_users_;
+
+  // Reference components that are bound to each symbol.
+  absl::flat_hash_map<const SymbolTableNode*,
+                      absl::flat_hash_set<ReferenceComponentNode*>>
+      symbol_references_;
 };
 
 // Construct a partial symbol table and bindings locations from a single source
@@ -0,0 +1,92 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures SymbolTable::Build() and SymbolTable::Resolve() on a multi-file
+// project.  Files are parsed once, outside of the measurements.
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "common/util/file_util.h"
+#include "common/util/logging.h"
+#include "verilog/analysis/symbol_table.h"
+#include "verilog/analysis/verilog_project.h"
+#include "verilog/tools/corpus/benchmark_corpus.h"
+
+namespace verilog {
+namespace {
+
+constexpr int kUnitsPerFile = 20;
+
+// Writes and parses a project with 'num_files' files.
+std::unique_ptr<VerilogProject> MakeProject(int num_files) {
+  const std::string dir = verible::file::JoinPath(
+      std::filesystem::temp_directory_path().string(),
+      absl::StrCat("verible_symbol_table_benchmark_", num_files));
+  const auto file_names =
+      corpus::WriteBenchmarkProject(dir, num_files, kUnitsPerFile);
+  CHECK(file_names.ok()) << file_names.status();
+  auto project =
+      absl::make_unique<VerilogProject>(dir, std::vector<std::string>{});
+  CHECK(project->OpenTranslationUnits(*file_names, /* jobs= */ 0).ok());
+  project->ParseAll(/* jobs= */ 0);
+  return project;
+}
+
+void BM_SymbolTableBuild(benchmark::State& state) {
+  const auto project = MakeProject(state.range(0));
+  for (auto _ : state) {
+    SymbolTable symbol_table(project.get());
+    std::vector<absl::Status> diagnostics;
+    symbol_table.Build(&diagnostics);
+    benchmark::DoNotOptimize(diagnostics.size());
+  }
+}
+BENCHMARK(BM_SymbolTableBuild)
+    ->RangeMultiplier(4)
+    ->Range(4, 64)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SymbolTableResolve(benchmark::State& state) {
+  const auto project = MakeProject(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto symbol_table = absl::make_unique<SymbolTable>(project.get());
+    std::vector<absl::Status> diagnostics;
+    symbol_table->Build(&diagnostics);
+    state.ResumeTiming();
+
+    symbol_table->Resolve(&diagnostics);
+    benchmark::DoNotOptimize(diagnostics.size());
+
+    state.PauseTiming();
+    symbol_table.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_SymbolTableResolve)
+    ->RangeMultiplier(4)
+    ->Range(4, 64)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace verilog
+
+BENCHMARK_MAIN();
@@ -0,0 +1,844 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/analysis/symbol_table_index.h"
+
+#include <iostream>
+#include <set>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "common/text/text_structure.h"
+#include "common/text/token_info.h"
+#include "common/text/tree_utils.h"
+#include "common/util/logging.h"
+#include "verilog/analysis/verilog_project.h"
+
+// Serialized format (version 1), whitespace-separated tokens:
+//
+//   verible-symbol-table-index 1
+//   files <count>
+//     <path:string> <content-hash>                    (per file)
+//   units <count>
+//     <file> <count> <file>... <count> [<code> <message:string>]...
+//   nodes <count>                                     (pre-order, root first)
+//     <parent> <key:text> <metatype> <file> <syntax:text>
+//     <declared-type:type> <parent-type:type>
+//     <count> <anonymous-name:string>...
+//   refs <count>
+//     <node> <count> [<parent> <ref-type> <metatype> <identifier:text>
+//                     <resolved-node>]...            (components in pre-order)
+//
+// where
+//   string: <length>:<bytes>
+//   text:   - (none) | f<file>:<offset>:<length> | s<string>
+//   type:   <syntax:text> <ref> <component>    (-1 -1 for no reference)
+//
+// All references to files, nodes, refs and components are indices into their
+// respective sections, and -1 means none.
+
+namespace verilog {
+
+namespace {
+
+constexpr absl::string_view kIndexHeader = "verible-symbol-table-index";
+constexpr int kIndexVersion = 1;
+
+// Token enum of synthetic syntax origins.  Only their text is meaningful.
+constexpr int kSyntheticTokenEnum = -1;
+
+void WriteString(absl::string_view text, std::ostream& stream) {
+  stream << text.length() << ':' << text;
+}
+
+// Position of text, either inside a file, or stored by value.
+struct TextRecord {
+  bool present = false;
+  int file = -1;  // when >= 0, refers to [offset, offset + length) in file
+  size_t offset = 0;
+  size_t length = 0;
+  absl::string_view value;  // when file < 0, points into serialized index
+};
+
+struct TypeRecord {
+  TextRecord syntax;
+  int ref = -1;
+  int component = -1;
+};
+
+struct FileRecord {
+  absl::string_view path;
+  uint64_t hash = 0;
+};
+
+struct UnitRecord {
+  int file = -1;
+  std::vector<int> files;  // includes 'file'
+  std::vector<absl::Status> diagnostics;
+};
+
+struct NodeRecord {
+  int parent = -1;
+  TextRecord key;
+  SymbolMetaType metatype = SymbolMetaType::kRoot;
+  int file = -1;
+  TextRecord syntax;
+  TypeRecord declared_type;
+  TypeRecord parent_type;
+  std::vector<absl::string_view> anonymous_names;
+};
+
+struct ComponentRecord {
+  int parent = -1;
+  ReferenceType ref_type = ReferenceType::kUnqualified;
+  SymbolMetaType required_metatype = SymbolMetaType::kUnspecified;
+  TextRecord identifier;
+  int resolved = -1;
+};
+
+struct RefRecord {
+  int node = -1;
+  std::vector<ComponentRecord> components;
+};
+
+// Tokenizer for the serialized index.  All methods return false on failure.
+class IndexReader {
+ public:
+  explicit IndexReader(absl::string_view text) : rest_(text) {}
+
+  bool Word(absl::string_view expected) { return NextToken() == expected; }
+
+  template <typename T>
+  bool Int(T* value) {
+    return absl::SimpleAtoi(NextToken(), value);
+  }
+
+  // Reads the number of records that follow.  Every record takes at least
+  // one byte, so larger counts are rejected before anything is allocated
+  // for them.
+  bool Count(size_t* count) {
+    return Int(count) && *count <= rest_.length();
+  }
+
+  // Reads an int in [-1, limit).
+  bool Index(int limit, int* value) {
+    return Int(value) && *value >= -1 && *value < limit;
+  }
+
+  bool String(absl::string_view* value) {
+    SkipSpace();
+    const size_t colon = rest_.find(':');
+    if (colon == absl::string_view::npos) return false;
+    size_t length;
+    if (!absl::SimpleAtoi(rest_.substr(0, colon), &length)) return false;
+    rest_.remove_prefix(colon + 1);
+    if (length > rest_.length()) return false;
+    *value = rest_.substr(0, length);
+    rest_.remove_prefix(length);
+    return true;
+  }
+
+  bool Text(int num_files, TextRecord* text) {
+    SkipSpace();
+    if (rest_.empty()) return false;
+    const char kind = rest_.front();
+    if (kind == 's') {
+      rest_.remove_prefix(1);
+      text->present = true;
+      return String(&text->value);
+    }
+    const absl::string_view token = NextToken();
+    if (token == "-") return true;
+    if (kind != 'f') return false;
+    const std::vector<absl::string_view> fields =
+        absl::StrSplit(token.substr(1), ':');
+    text->present = true;
+    return fields.size() == 3 && absl::SimpleAtoi(fields[0], &text->file) &&
+           text->file >= 0 && text->file < num_files &&
+           absl::SimpleAtoi(fields[1], &text->offset) &&
+           absl::SimpleAtoi(fields[2], &text->length);
+  }
+
+  bool Type(int num_files, TypeRecord* type) {
+    // Reference indices are validated once all refs are known.
+    return Text(num_files, &type->syntax) && Int(&type->ref) &&
+           Int(&type->component);
+  }
+
+  bool Done() {
+    SkipSpace();
+    return rest_.empty();
+  }
+
+ private:
+  void SkipSpace() {
+    while (!rest_.empty() && (rest_.front() == ' ' || rest_.front() == '\n')) {
+      rest_.remove_prefix(1);
+    }
+  }
+
+  absl::string_view NextToken() {
+    SkipSpace();
+    size_t end = 0;
+    while (end < rest_.length() && rest_[end] != ' ' && rest_[end] != '\n') {
+      ++end;
+    }
+    const absl::string_view token = rest_.substr(0, end);
+    rest_.remove_prefix(end);
+    return token;
+  }
+
+  absl::string_view rest_;
+};
+
+// All records of a serialized index.
+struct IndexRecords {
+  std::vector<FileRecord> files;
+  std::vector<UnitRecord> units;
+  std::vector<NodeRecord> nodes;
+  std::vector<RefRecord> refs;
+};
+
+absl::Status MalformedIndexError(absl::string_view section) {
+  return absl::DataLossError(
+      absl::StrCat("Malformed symbol table index in section: ", section));
+}
+
+absl::Status ParseIndexRecords(absl::string_view serialized,
+                               IndexRecords* records) {
+  IndexReader reader(serialized);
+  int version;
+  if (!reader.Word(kIndexHeader) || !reader.Int(&version)) {
+    return absl::InvalidArgumentError("Not a symbol table index.");
+  }
+  if (version != kIndexVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported symbol table index version: ", version));
+  }
+
+  size_t count;
+  if (!reader.Word("files") || !reader.Count(&count)) {
+    return MalformedIndexError("files");
+  }
+  records->files.resize(count);
+  for (auto& file : records->files) {
+    if (!reader.String(&file.path) || !reader.Int(&file.hash)) {
+      return MalformedIndexError("files");
+    }
+  }
+  const int num_files = records->files.size();
+
+  if (!reader.Word("units") || !reader.Count(&count)) {
+    return MalformedIndexError("units");
+  }
+  records->units.resize(count);
+  for (auto& unit : records->units) {
+    size_t num_unit_files, num_diagnostics;
+    if (!reader.Index(num_files, &unit.file) || unit.file < 0 ||
+        !reader.Count(&num_unit_files)) {
+      return MalformedIndexError("units");
+    }
+    unit.files.resize(num_unit_files);
+    for (int& file : unit.files) {
+      if (!reader.Index(num_files, &file) || file < 0) {
+        return MalformedIndexError("units");
+      }
+    }
+    if (!reader.Count(&num_diagnostics)) return MalformedIndexError("units");
+    for (size_t i = 0; i < num_diagnostics; ++i) {
+      int code;
+      absl::string_view message;
+      if (!reader.Int(&code) || !reader.String(&message)) {
+        return MalformedIndexError("units");
+      }
+      unit.diagnostics.emplace_back(static_cast<absl::StatusCode>(code),
+                                    message);
+    }
+  }
+
+  if (!reader.Word("nodes") || !reader.Count(&count) || count == 0) {
+    return MalformedIndexError("nodes");
+  }
+  records->nodes.resize(count);
+  for (size_t n = 0; n < count; ++n) {
+    NodeRecord& node(records->nodes[n]);
+    int metatype;
+    size_t num_anonymous_names;
+    if (!reader.Index(n, &node.parent) || (node.parent < 0) != (n == 0) ||
+        !reader.Text(num_files, &node.key) || (node.key.present == (n == 0)) ||
+        !reader.Int(&metatype) || metatype < 0 ||
+        metatype > static_cast<int>(SymbolMetaType::kCallable) ||
+        !reader.Index(num_files, &node.file) ||
+        !reader.Text(num_files, &node.syntax) ||
+        !reader.Type(num_files, &node.declared_type) ||
+        !reader.Type(num_files, &node.parent_type) ||
+        !reader.Count(&num_anonymous_names)) {
+      return MalformedIndexError("nodes");
+    }
+    node.metatype = static_cast<SymbolMetaType>(metatype);
+    node.anonymous_names.resize(num_anonymous_names);
+    for (auto& name : node.anonymous_names) {
+      if (!reader.String(&name)) return MalformedIndexError("nodes");
+    }
+  }
+  const int num_nodes = records->nodes.size();
+
+  if (!reader.Word("refs") || !reader.Count(&count)) {
+    return MalformedIndexError("refs");
+  }
+  records->refs.resize(count);
+  for (auto& ref : records->refs) {
+    size_t num_components;
+    if (!reader.Index(num_nodes, &ref.node) || ref.node < 0 ||
+        !reader.Count(&num_components) || num_components == 0) {
+      return MalformedIndexError("refs");
+    }
+    ref.components.resize(num_components);
+    for (size_t c = 0; c < num_components; ++c) {
+      ComponentRecord& component(ref.components[c]);
+      int ref_type, metatype;
+      if (!reader.Index(c, &component.parent) ||
+          (component.parent < 0) != (c == 0) || !reader.Int(&ref_type) ||
+          ref_type < 0 ||
+          ref_type > static_cast<int>(ReferenceType::kMemberOfTypeOfParent) ||
+          !reader.Int(&metatype) || metatype < 0 ||
+          metatype > static_cast<int>(SymbolMetaType::kCallable) ||
+          !reader.Text(num_files, &component.identifier) ||
+          !component.identifier.present ||
+          !reader.Index(num_nodes, &component.resolved)) {
+        return MalformedIndexError("refs");
+      }
+      component.ref_type = static_cast<ReferenceType>(ref_type);
+      component.required_metatype = static_cast<SymbolMetaType>(metatype);
+    }
+  }
+  if (!reader.Done()) return MalformedIndexError("end");
+
+  // Validate type references, now that all refs are known.
+  const auto valid_type = [records](const TypeRecord& type) {
+    if (type.ref < 0) return type.ref == -1 && type.component == -1;
+    return type.ref < static_cast<int>(records->refs.size()) &&
+           type.component >= 0 &&
+           type.component <
+               static_cast<int>(records->refs[type.ref].components.size());
+  };
+  for (const auto& node : records->nodes) {
+    if (!valid_type(node.declared_type) || !valid_type(node.parent_type)) {
+      return MalformedIndexError("nodes");
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+uint64_t SymbolTableIndex::HashContents(absl::string_view contents) {
+  // 64-bit FNV-1a: simple, and stable across runs and platforms.
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const char c : contents) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+static absl::string_view FileContents(const VerilogSourceFile* file) {
+  const verible::TextStructureView* text_structure = file->GetTextStructure();
+  if (text_structure == nullptr) return "";
+  return text_structure->Contents();
+}
+
+absl::Status SymbolTableIndex::Save(const SymbolTable& symbol_table,
+                                    const DiagnosticsMap& build_diagnostics,
+                                    std::ostream* stream) {
+  const VerilogProject* project = symbol_table.Project();
+  if (project == nullptr) {
+    return absl::FailedPreconditionError(
+        "Saving a symbol table index requires a VerilogProject.");
+  }
+
+  // Number all contributing files, ordered by name.
+  std::set<const VerilogSourceFile*, VerilogSourceFile::Less> sorted_files;
+  for (const auto& unit : symbol_table.translation_unit_files_) {
+    sorted_files.insert(unit.first);
+    sorted_files.insert(unit.second.begin(), unit.second.end());
+  }
+  const std::vector<const VerilogSourceFile*> files(sorted_files.begin(),
+                                                    sorted_files.end());
+  absl::flat_hash_map<const VerilogSourceFile*, int> file_ids;
+  for (size_t i = 0; i < files.size(); ++i) file_ids[files[i]] = i;
+  const auto file_id = [&file_ids](const VerilogSourceFile* file) {
+    const auto found = file_ids.find(file);
+    return found == file_ids.end() ? -1 : found->second;
+  };
+
+  // Number all symbols in pre-order.
+  std::vector<const SymbolTableNode*> nodes;
+  absl::flat_hash_map<const SymbolTableNode*, int> node_ids;
+  symbol_table.Root().ApplyPreOrder([&](const SymbolTableNode& node) {
+    node_ids[&node] = nodes.size();
+    nodes.push_back(&node);
+  });
+  const auto node_id = [&node_ids](const SymbolTableNode* node) {
+    if (node == nullptr) return -1;
+    const auto found = node_ids.find(node);
+    return found == node_ids.end() ? -1 : found->second;
+  };
+
+  // Number all reference components (for type references).
+  absl::flat_hash_map<const ReferenceComponentNode*, std::pair<int, int>>
+      component_ids;
+  int num_refs = 0;
+  for (const SymbolTableNode* node : nodes) {
+    for (const auto& ref : node->Value().local_references_to_bind) {
+      if (ref.Empty()) continue;
+      int component = 0;
+      ref.components->ApplyPreOrder(
+          [&](const ReferenceComponentNode& component_node) {
+            component_ids[&component_node] = {num_refs, component++};
+          });
+      ++num_refs;
+    }
+  }
+
+  const auto write_text = [&](absl::string_view text) {
+    if (text.empty()) {
+      *stream << '-';
+      return;
+    }
+    const VerilogSourceFile* file = project->LookupFileOrigin(text);
+    const int id = file_id(file);
+    if (id < 0) {
+      *stream << 's';
+      WriteString(text, *stream);
+      return;
+    }
+    *stream << 'f' << id << ':'
+            << std::distance(FileContents(file).begin(), text.begin()) << ':'
+            << text.length();
+  };
+  const auto write_syntax = [&](const verible::Symbol* syntax) {
+    write_text(syntax == nullptr ? absl::string_view()
+                                 : verible::StringSpanOfSymbol(*syntax));
+  };
+  const auto write_type = [&](const DeclarationTypeInfo& type) {
+    write_syntax(type.syntax_origin);
+    const auto found = component_ids.find(type.user_defined_type);
+    if (found == component_ids.end()) {
+      *stream << " -1 -1";
+    } else {
+      *stream << ' ' << found->second.first << ' ' << found->second.second;
+    }
+  };
+
+  *stream << kIndexHeader << ' ' << kIndexVersion << '\n';
+
+  *stream << "files " << files.size() << '\n';
+  for (const VerilogSourceFile* file : files) {
+    WriteString(file->ReferencedPath(), *stream);
+    *stream << ' ' << HashContents(FileContents(file)) << '\n';
+  }
+
+  const std::set<const VerilogSourceFile*, VerilogSourceFile::Less> units(
+      [&symbol_table]() {
+        std::set<const VerilogSourceFile*, VerilogSourceFile::Less> result;
+        for (const auto& unit : symbol_table.translation_unit_files_) {
+          result.insert(unit.first);
+        }
+        return result;
+      }());
+  *stream << "units " << units.size() << '\n';
+  for (const VerilogSourceFile* unit : units) {
+    const auto& unit_files(symbol_table.translation_unit_files_.at(unit));
+    *stream << file_id(unit) << ' ' << unit_files.size();
+    for (const VerilogSourceFile* file : unit_files) {
+      *stream << ' ' << file_id(file);
+    }
+    const auto found =
+        build_diagnostics.find(std::string(unit->ReferencedPath()));
+    if (found == build_diagnostics.end()) {
+      *stream << " 0\n";
+      continue;
+    }
+    *stream << ' ' << found->second.size();
+    for (const auto& status : found->second) {
+      *stream << ' ' << static_cast<int>(status.code()) << ' ';
+      WriteString(status.message(), *stream);
+    }
+    *stream << '\n';
+  }
+
+  *stream << "nodes " << nodes.size() << '\n';
+  for (const SymbolTableNode* node : nodes) {
+    const SymbolInfo& info(node->Value());
+    *stream << node_id(node->Parent()) << ' ';
+    write_text(node->Parent() == nullptr ? absl::string_view() : *node->Key());
+    *stream << ' ' << static_cast<int>(info.metatype) << ' '
+            << file_id(info.file_origin) << ' ';
+    write_syntax(info.syntax_origin);
+    *stream << ' ';
+    write_type(info.declared_type);
+    *stream << ' ';
+    write_type(info.parent_type);
+    *stream << ' ' << info.anonymous_scope_names.size();
+    for (const auto& name : info.anonymous_scope_names) {
+      *stream << ' ';
+      WriteString(*name, *stream);
+    }
+    *stream << '\n';
+  }
+
+  *stream << "refs " << num_refs << '\n';
+  for (const SymbolTableNode* node : nodes) {
+    for (const auto& ref : node->Value().local_references_to_bind) {
+      if (ref.Empty()) continue;
+      std::vector<const ReferenceComponentNode*> components;
+      ref.components->ApplyPreOrder(
+          [&components](const ReferenceComponentNode& component_node) {
+            components.push_back(&component_node);
+          });
+      *stream << node_id(node) << ' ' << components.size();
+      for (const ReferenceComponentNode* component_node : components) {
+            const ReferenceComponent& component(component_node->Value());
+            const int parent =
+                component_node->Parent() == nullptr
+                    ? -1
+                    : component_ids.at(component_node->Parent()).second;
+            *stream << ' ' << parent << ' '
+                    << static_cast<int>(component.ref_type) << ' '
+                    << static_cast<int>(component.required_metatype) << ' ';
+            write_text(component.identifier);
+            *stream << ' ' << node_id(component.resolved_symbol);
+      }
+      *stream << '\n';
+    }
+  }
+
+  if (!stream->good()) {
+    return absl::InternalError("Error writing symbol table index.");
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SymbolTableIndex::Load(absl::string_view serialized,
+                                    SymbolTable* symbol_table) {
+  VLOG(1) << __FUNCTION__;
+  VerilogProject* project = symbol_table->project_;
+  if (project == nullptr) {
+    return absl::FailedPreconditionError(
+        "Loading a symbol table index requires a VerilogProject.");
+  }
+  SymbolTableNode& root(symbol_table->MutableRoot());
+  if (!root.Children().empty() ||
+      !root.Value().local_references_to_bind.empty()) {
+    return absl::FailedPreconditionError(
+        "Symbol table index can only be loaded into an empty symbol table.");
+  }
+
+  IndexRecords records;
+  {
+    const auto status = ParseIndexRecords(serialized, &records);
+    if (!status.ok()) return status;
+  }
+  const size_t num_files = records.files.size();
+  const size_t num_nodes = records.nodes.size();
+  const size_t num_refs = records.refs.size();
+
+  // Find the current versions of all files.  Translation units must have been
+  // opened by the caller, included files are opened here.
+  std::vector<bool> is_unit_file(num_files, false);
+  for (const auto& unit : records.units) is_unit_file[unit.file] = true;
+  std::vector<const VerilogSourceFile*> current_files(num_files, nullptr);
+  std::vector<bool> up_to_date(num_files, false);
+  for (size_t f = 0; f < num_files; ++f) {
+    const absl::string_view path(records.files[f].path);
+    const VerilogSourceFile* file = project->LookupRegisteredFile(path);
+    if (file == nullptr && !is_unit_file[f]) {
+      const auto status_or_file = project->OpenIncludedFile(path);
+      if (status_or_file.ok()) file = *status_or_file;
+    }
+    if (file == nullptr || file->GetTextStructure() == nullptr) continue;
+    current_files[f] = file;
+    up_to_date[f] =
+        HashContents(FileContents(file)) == records.files[f].hash;
+  }
+
+  // Reject text positions that lie outside of up-to-date files.
+  const auto valid_text = [&](const TextRecord& text) {
+    return text.file < 0 || !up_to_date[text.file] ||
+           text.offset + text.length <=
+               FileContents(current_files[text.file]).length();
+  };
+  for (const auto& node : records.nodes) {
+    if (!valid_text(node.key) || !valid_text(node.syntax) ||
+        !valid_text(node.declared_type.syntax) ||
+        !valid_text(node.parent_type.syntax)) {
+      return MalformedIndexError("nodes");
+    }
+  }
+  for (const auto& ref : records.refs) {
+    for (const auto& component : ref.components) {
+      if (!valid_text(component.identifier)) {
+        return MalformedIndexError("refs");
+      }
+    }
+  }
+
+  // Nodes whose names are generated (not file text), to find the origin of
+  // references to anonymous scopes.
+  std::map<std::pair<int, absl::string_view>, int> generated_name_nodes;
+  for (size_t n = 1; n < num_nodes; ++n) {
+    const NodeRecord& node(records.nodes[n]);
+    if (node.key.file < 0) {
+      generated_name_nodes[{node.parent, node.key.value}] = n;
+    }
+  }
+  // The file from which each reference originated, or -1 if unknown.
+  std::vector<int> ref_files(num_refs, -1);
+  for (size_t r = 0; r < num_refs; ++r) {
+    const RefRecord& ref(records.refs[r]);
+    const TextRecord& base(ref.components.front().identifier);
+    if (base.file >= 0) {
+      ref_files[r] = base.file;
+      continue;
+    }
+    const auto found = generated_name_nodes.find({ref.node, base.value});
+    ref_files[r] = found == generated_name_nodes.end()
+                       ? records.nodes[ref.node].file
+                       : records.nodes[found->second].file;
+  }
+
+  std::vector<std::vector<int>> units_of_file(num_files);
+  for (size_t u = 0; u < records.units.size(); ++u) {
+    for (const int f : records.units[u].files) units_of_file[f].push_back(u);
+  }
+
+  // Determine which translation units cannot be restored.  Start with those
+  // that have changed, and grow the set until no restored element depends on
+  // any element of a stale translation unit.
+  std::vector<bool> stale_units(records.units.size(), false);
+  for (size_t u = 0; u < records.units.size(); ++u) {
+    const UnitRecord& unit(records.units[u]);
+    // Only restore translation units that were opened by the caller.
+    if (current_files[unit.file] == nullptr ||
+        project->LookupRegisteredFile(records.files[unit.file].path) ==
+            nullptr) {
+      stale_units[u] = true;
+      continue;
+    }
+    for (const int f : unit.files) {
+      if (!up_to_date[f]) stale_units[u] = true;
+    }
+  }
+  std::vector<bool> stale_files(num_files);
+  std::vector<bool> removed_nodes(num_nodes);
+  std::vector<bool> dropped_refs(num_refs);
+  while (true) {
+    std::fill(stale_files.begin(), stale_files.end(), false);
+    for (size_t u = 0; u < records.units.size(); ++u) {
+      if (!stale_units[u]) continue;
+      for (const int f : records.units[u].files) stale_files[f] = true;
+    }
+    const auto is_stale_file = [&stale_files](int f) {
+      return f >= 0 && stale_files[f];
+    };
+    for (size_t n = 1; n < num_nodes; ++n) {
+      const NodeRecord& node(records.nodes[n]);
+      removed_nodes[n] =
+          removed_nodes[node.parent] || is_stale_file(node.file);
+    }
+    for (size_t r = 0; r < num_refs; ++r) {
+      dropped_refs[r] =
+          removed_nodes[records.refs[r].node] || is_stale_file(ref_files[r]);
+    }
+
+    // Files that contributed to removed elements, or depend on them.
+    std::set<int> affected_files;
+    const auto affect = [&](int f) {
+      if (f >= 0 && !stale_files[f]) affected_files.insert(f);
+    };
+    for (size_t n = 1; n < num_nodes; ++n) {
+      const NodeRecord& node(records.nodes[n]);
+      if (removed_nodes[n]) {
+        affect(node.file);
+        continue;
+      }
+      for (const TypeRecord* type : {&node.declared_type, &node.parent_type}) {
+        if (type->ref >= 0 && dropped_refs[type->ref]) affect(node.file);
+      }
+    }
+    for (size_t r = 0; r < num_refs; ++r) {
+      if (dropped_refs[r]) {
+        affect(ref_files[r]);
+        continue;
+      }
+      for (const auto& component : records.refs[r].components) {
+        if (component.resolved >= 0 && removed_nodes[component.resolved]) {
+          affect(ref_files[r]);
+        }
+      }
+    }
+
+    bool grew = false;
+    for (size_t u = 0; u < records.units.size(); ++u) {
+      if (stale_units[u]) continue;
+      for (const int f : records.units[u].files) {
+        if (stale_files[f] || affected_files.count(f) > 0) {
+          stale_units[u] = true;
+          grew = true;
+          break;
+        }
+      }
+    }
+    if (!grew) break;
+  }
+
+  // From here on, nothing can fail.
+  const auto file_text = [&](const TextRecord& text) {
+    return FileContents(current_files[text.file])
+        .substr(text.offset, text.length);
+  };
+  const auto make_syntax_origin =
+      [&](const TextRecord& text) -> const verible::Symbol* {
+    if (!text.present) return nullptr;
+    absl::string_view span;
+    if (text.file >= 0) {
+      span = file_text(text);
+    } else {
+      strings_.emplace_back(text.value);
+      span = strings_.back();
+    }
+    syntax_origins_.emplace_back(
+        verible::TokenInfo(kSyntheticTokenEnum, span));
+    return &syntax_origins_.back();
+  };
+  // Generated names are owned by the scope that generated them.
+  const auto resolve_text = [&](const TextRecord& text,
+                                const SymbolInfo& scope) -> absl::string_view {
+    if (text.file >= 0) return file_text(text);
+    for (const auto& name : scope.anonymous_scope_names) {
+      if (*name == text.value) return *name;
+    }
+    strings_.emplace_back(text.value);
+    return strings_.back();
+  };
+
+  std::vector<SymbolTableNode*> restored_nodes(num_nodes, nullptr);
+  for (size_t n = 0; n < num_nodes; ++n) {
+    if (removed_nodes[n]) continue;
+    const NodeRecord& node(records.nodes[n]);
+    SymbolTableNode* restored = &root;
+    if (n > 0) {
+      SymbolTableNode& parent(*restored_nodes[node.parent]);
+      const absl::string_view key = resolve_text(node.key, parent.Value());
+      const auto p = parent.TryEmplace(
+          key, SymbolInfo{
+                   .metatype = node.metatype,
+                   .file_origin =
+                       node.file < 0 ? nullptr : current_files[node.file],
+                   .syntax_origin = make_syntax_origin(node.syntax),
+               });
+      restored = &p.first->second;
+      SymbolInfo& info(restored->Value());
+      if (p.second && info.file_origin != nullptr) {
+        symbol_table->RecordSymbol(restored);
+      }
+      info.declared_type.syntax_origin =
+          make_syntax_origin(node.declared_type.syntax);
+      info.parent_type.syntax_origin =
+          make_syntax_origin(node.parent_type.syntax);
+    }
+    for (const absl::string_view name : node.anonymous_names) {
+      restored->Value().anonymous_scope_names.emplace_back(
+          absl::make_unique<const std::string>(name));
+    }
+    restored_nodes[n] = restored;
+  }
+
+  std::vector<std::vector<ReferenceComponentNode*>> restored_components(
+      num_refs);
+  for (size_t r = 0; r < num_refs; ++r) {
+    if (dropped_refs[r]) continue;
+    const RefRecord& ref(records.refs[r]);
+    SymbolInfo& scope(restored_nodes[ref.node]->Value());
+    // Reserve children in advance to keep component nodes address-stable.
+    std::vector<size_t> num_children(ref.components.size(), 0);
+    for (const auto& component : ref.components) {
+      if (component.parent >= 0) ++num_children[component.parent];
+    }
+    DependentReferences restored;
+    auto& components(restored_components[r]);
+    for (const auto& component : ref.components) {
+      const SymbolTableNode* resolved =
+          component.resolved < 0 || removed_nodes[component.resolved]
+              ? nullptr
+              : restored_nodes[component.resolved];
+      const ReferenceComponent value{
+          .identifier = resolve_text(component.identifier, scope),
+          .ref_type = component.ref_type,
+          .required_metatype = component.required_metatype,
+          .resolved_symbol = resolved,
+      };
+      ReferenceComponentNode* new_node;
+      if (component.parent < 0) {
+        restored.components = absl::make_unique<ReferenceComponentNode>(value);
+        new_node = restored.components.get();
+      } else {
+        new_node = components[component.parent]->NewChild(value);
+      }
+      new_node->Children().reserve(num_children[components.size()]);
+      components.push_back(new_node);
+    }
+    ReferenceComponentNode* root = restored.components.get();
+    scope.local_references_to_bind.push_back(std::move(restored));
+    symbol_table->RecordReference(
+        restored_nodes[ref.node],
+        ref_files[r] < 0 ? nullptr : current_files[ref_files[r]], root);
+  }
+
+  // Link declared types to their (restored) references.
+  const auto restored_type = [&](const TypeRecord& type)
+      -> const ReferenceComponentNode* {
+    if (type.ref < 0 || dropped_refs[type.ref]) return nullptr;
+    return restored_components[type.ref][type.component];
+  };
+  for (size_t n = 1; n < num_nodes; ++n) {
+    if (removed_nodes[n]) continue;
+    const NodeRecord& node(records.nodes[n]);
+    SymbolInfo& info(restored_nodes[n]->Value());
+    info.declared_type.user_defined_type = restored_type(node.declared_type);
+    info.parent_type.user_defined_type = restored_type(node.parent_type);
+  }
+
+  for (size_t u = 0; u < records.units.size(); ++u) {
+    if (stale_units[u]) continue;
+    const UnitRecord& unit(records.units[u]);
+    for (const int f : unit.files) {
+      symbol_table->RecordContributingFile(current_files[unit.file],
+                                           current_files[f]);
+    }
+    restored_units_[std::string(records.files[unit.file].path)] =
+        unit.diagnostics;
+  }
+  VLOG(1) << "end of " << __FUNCTION__ << ": restored "
+          << restored_units_.size() << " of " << records.units.size()
+          << " translation units";
+  return absl::OkStatus();
+}
+
+}  // namespace verilog
@@ -0,0 +1,112 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_VERILOG_ANALYSIS_SYMBOL_TABLE_INDEX_H_
+#define VERIBLE_VERILOG_ANALYSIS_SYMBOL_TABLE_INDEX_H_
+
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "common/text/concrete_syntax_leaf.h"
+#include "verilog/analysis/symbol_table.h"
+
+namespace verilog {
+
+// SymbolTableIndex is a serialized form of a built SymbolTable, which lets
+// tools skip parsing files that have not changed since the index was saved.
+//
+// The index records every definition and reference, the resolutions of
+// references (as far as they were resolved at the time of saving), the
+// build diagnostics of each translation unit, and a content hash of every
+// file that contributed to each translation unit.  Text (symbol names,
+// reference identifiers, syntax spans) is recorded as byte ranges of the
+// originating files, so that a restored symbol table points into the same
+// file contents as a freshly built one.
+//
+// Loading restores only translation units whose files are all unchanged.
+// Translation units that contributed to (or were bound by build-time
+// references to) any part of a stale translation unit are treated as stale
+// as well, following the same rules as SymbolTable::RemoveTranslationUnit().
+// Stale translation units are left to the caller to rebuild.
+//
+// Typical usage:
+//   VerilogProject project(...);
+//   project.OpenTranslationUnit(...);  // open files in loop
+//   SymbolTableIndex index;            // must outlive symbol_table
+//   SymbolTable symbol_table(&project);
+//   index.Load(serialized, &symbol_table);  // ignore failures
+//   for (...each translation unit...) {
+//     if (!index.RestoredTranslationUnits().count(file)) {
+//       symbol_table.BuildSingleTranslationUnit(file, &diagnostics);
+//     }
+//   }
+//   SymbolTableIndex::Save(symbol_table, unit_diagnostics, &stream);
+//   symbol_table.Resolve(&diagnostics);
+//
+class SymbolTableIndex {
+ public:
+  // Build diagnostics keyed by translation unit (referenced path).
+  using DiagnosticsMap = std::map<std::string, std::vector<absl::Status>>;
+
+  // Writes a serialized representation of 'symbol_table' to 'stream'.
+  // 'symbol_table' must have a VerilogProject.
+  // 'build_diagnostics' are saved with the corresponding translation units.
+  static absl::Status Save(const SymbolTable& symbol_table,
+                           const DiagnosticsMap& build_diagnostics,
+                           std::ostream* stream);
+
+  SymbolTableIndex() = default;
+
+  // Restored symbol tables may point to memory owned by this object.
+  SymbolTableIndex(const SymbolTableIndex&) = delete;
+  SymbolTableIndex(SymbolTableIndex&&) = delete;
+  SymbolTableIndex& operator=(const SymbolTableIndex&) = delete;
+  SymbolTableIndex& operator=(SymbolTableIndex&&) = delete;
+
+  // Restores all up-to-date translation units from 'serialized' (produced by
+  // Save()) into 'symbol_table', which must be empty and have a
+  // VerilogProject.  Translation units that are not registered in the project
+  // are not restored.  Included files are opened as needed.
+  // On error, 'symbol_table' is left unmodified.
+  // This object must outlive 'symbol_table'.
+  absl::Status Load(absl::string_view serialized, SymbolTable* symbol_table);
+
+  // Translation units restored by Load(), with their saved build diagnostics.
+  const DiagnosticsMap& RestoredTranslationUnits() const {
+    return restored_units_;
+  }
+
+  // Content hash used to detect changed files.
+  static uint64_t HashContents(absl::string_view contents);
+
+ private:
+  // Stand-ins for syntax tree origins of restored symbols, which only
+  // preserve the spanned text.
+  std::deque<verible::SyntaxTreeLeaf> syntax_origins_;
+
+  // Storage for generated names that are not owned by any symbol.
+  std::deque<std::string> strings_;
+
+  DiagnosticsMap restored_units_;
+};
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_ANALYSIS_SYMBOL_TABLE_INDEX_H_
@@ -0,0 +1,298 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/analysis/symbol_table_index.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "common/util/file_util.h"
+#include "gtest/gtest.h"
+#include "verilog/analysis/symbol_table.h"
+#include "verilog/analysis/verilog_project.h"
+
+namespace verilog {
+namespace {
+
+using verible::file::CreateDir;
+using verible::file::JoinPath;
+using verible::file::testing::ScopedTestFile;
+
+std::string PrintDefinitions(const SymbolTable& symbol_table) {
+  std::ostringstream stream;
+  symbol_table.PrintSymbolDefinitions(stream);
+  return stream.str();
+}
+
+std::string PrintReferences(const SymbolTable& symbol_table) {
+  std::ostringstream stream;
+  symbol_table.PrintSymbolReferences(stream);
+  return stream.str();
+}
+
+// Builds the translation units that are not restored by 'index', and returns
+// all build diagnostics by translation unit.
+SymbolTableIndex::DiagnosticsMap BuildMissingUnits(
+    const std::vector<absl::string_view>& units, const SymbolTableIndex& index,
+    SymbolTable* symbol_table) {
+  SymbolTableIndex::DiagnosticsMap diagnostics(
+      index.RestoredTranslationUnits());
+  for (const auto unit : units) {
+    const std::string key(unit);
+    if (diagnostics.find(key) != diagnostics.end()) continue;
+    symbol_table->BuildSingleTranslationUnit(unit, &diagnostics[key]);
+  }
+  return diagnostics;
+}
+
+TEST(SymbolTableIndexTest, HashContentsIsStable) {
+  EXPECT_EQ(SymbolTableIndex::HashContents(""), 0xcbf29ce484222325ULL);
+  EXPECT_EQ(SymbolTableIndex::HashContents("module m; endmodule"),
+            SymbolTableIndex::HashContents("module m; endmodule"));
+  EXPECT_NE(SymbolTableIndex::HashContents("module m; endmodule"),
+            SymbolTableIndex::HashContents("module n; endmodule"));
+}
+
+TEST(SymbolTableIndexTest, SaveRequiresProject) {
+  SymbolTable symbol_table(nullptr);
+  std::ostringstream stream;
+  EXPECT_EQ(SymbolTableIndex::Save(symbol_table, {}, &stream).code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+TEST(SymbolTableIndexTest, LoadRequiresProject) {
+  SymbolTable symbol_table(nullptr);
+  SymbolTableIndex index;
+  EXPECT_EQ(index.Load("", &symbol_table).code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+TEST(SymbolTableIndexTest, EmptyRoundTrip) {
+  VerilogProject project(".", {});
+  std::ostringstream stream;
+  {
+    SymbolTable symbol_table(&project);
+    EXPECT_TRUE(SymbolTableIndex::Save(symbol_table, {}, &stream).ok());
+  }
+  SymbolTable symbol_table(&project);
+  SymbolTableIndex index;
+  EXPECT_TRUE(index.Load(stream.str(), &symbol_table).ok());
+  EXPECT_TRUE(index.RestoredTranslationUnits().empty());
+  EXPECT_TRUE(symbol_table.Root().Children().empty());
+}
+
+TEST(SymbolTableIndexTest, RejectsForeignData) {
+  VerilogProject project(".", {});
+  SymbolTable symbol_table(&project);
+  SymbolTableIndex index;
+  EXPECT_EQ(index.Load("", &symbol_table).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(index.Load("module m; endmodule", &symbol_table).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(index.Load("verible-symbol-table-index 999", &symbol_table).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(SymbolTableIndexTest, RejectsMalformedData) {
+  VerilogProject project(".", {});
+  SymbolTable symbol_table(&project);
+  SymbolTableIndex index;
+  for (const absl::string_view serialized : {
+           "verible-symbol-table-index 1",
+           "verible-symbol-table-index 1 files 1 5:a.sv",
+           "verible-symbol-table-index 1 files 0 units 1 0 0 0",
+           "verible-symbol-table-index 1 files 0 units 0 nodes 0 refs 0",
+           // root node must not have a parent
+           "verible-symbol-table-index 1 files 0 units 0 nodes 1 "
+           "0 - 0 -1 - - -1 -1 - -1 -1 0 refs 0",
+           // dangling declared type
+           "verible-symbol-table-index 1 files 0 units 0 nodes 1 "
+           "-1 - 0 -1 - - 0 0 - -1 -1 0 refs 0",
+           // trailing garbage
+           "verible-symbol-table-index 1 files 0 units 0 nodes 1 "
+           "-1 - 0 -1 - - -1 -1 - -1 -1 0 refs 0 x",
+       }) {
+    EXPECT_EQ(index.Load(serialized, &symbol_table).code(),
+              absl::StatusCode::kDataLoss)
+        << serialized;
+    EXPECT_TRUE(symbol_table.Root().Children().empty());
+    EXPECT_TRUE(index.RestoredTranslationUnits().empty());
+  }
+}
+
+TEST(SymbolTableIndexTest, RejectsHugeCounts) {
+  VerilogProject project(".", {});
+  SymbolTable symbol_table(&project);
+  SymbolTableIndex index;
+  // Counts that exceed the remaining data must be rejected before anything
+  // is allocated for them.
+  for (const absl::string_view serialized : {
+           "verible-symbol-table-index 1 files 18446744073709551615",
+           "verible-symbol-table-index 1 files 0 units 4000000000 0 0 0",
+           "verible-symbol-table-index 1 files 1 1:a 7 units 1 "
+           "0 4000000000 0",
+           "verible-symbol-table-index 1 files 0 units 0 nodes 4000000000",
+           "verible-symbol-table-index 1 files 0 units 0 nodes 1 "
+           "-1 - 0 -1 - - -1 -1 - -1 -1 4000000000 refs 0",
+           "verible-symbol-table-index 1 files 0 units 0 nodes 1 "
+           "-1 - 0 -1 - - -1 -1 - -1 -1 0 refs 4000000000",
+           "verible-symbol-table-index 1 files 0 units 0 nodes 1 "
+           "-1 - 0 -1 - - -1 -1 - -1 -1 0 refs 1 0 4000000000",
+       }) {
+    EXPECT_EQ(index.Load(serialized, &symbol_table).code(),
+              absl::StatusCode::kDataLoss)
+        << serialized;
+    EXPECT_TRUE(symbol_table.Root().Children().empty());
+  }
+}
+
+TEST(SymbolTableIndexTest, RoundTrip) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  ASSERT_TRUE(CreateDir(sources_dir).ok());
+
+  ScopedTestFile pp_src(sources_dir,
+                        "package pp;\n"
+                        "  typedef struct { int a; } s_t;\n"
+                        "  typedef enum { X, Y } e_t;\n"
+                        "endpackage\n",
+                        "pp.sv");
+  ScopedTestFile cc_src(sources_dir,
+                        "class cc;\n"
+                        "  extern function int ff(int x);\n"
+                        "endclass\n"
+                        "function int cc::ff(int x);\n"
+                        "  return x;\n"
+                        "endfunction\n",
+                        "cc.sv");
+  ScopedTestFile qq_src(sources_dir,
+                        "module qq;\n"
+                        "  pp::s_t s;\n"
+                        "  rr rr_inst(.a(s.a));\n"
+                        "  `include \"inc.svh\"\n"
+                        "endmodule\n",
+                        "qq.sv");
+  ScopedTestFile inc_src(sources_dir, "wire w;\n", "inc.svh");
+  const std::vector<absl::string_view> units{"pp.sv", "cc.sv", "qq.sv"};
+
+  std::string serialized;
+  std::string expected_definitions, expected_references;
+  {
+    VerilogProject project(sources_dir, {sources_dir});
+    for (const auto unit : units) {
+      ASSERT_TRUE(project.OpenTranslationUnit(unit).ok());
+    }
+    SymbolTable symbol_table(&project);
+    SymbolTableIndex index;
+    const auto diagnostics = BuildMissingUnits(units, index, &symbol_table);
+    std::ostringstream stream;
+    ASSERT_TRUE(
+        SymbolTableIndex::Save(symbol_table, diagnostics, &stream).ok());
+    serialized = stream.str();
+
+    std::vector<absl::Status> resolve_diagnostics;
+    symbol_table.Resolve(&resolve_diagnostics);
+    expected_definitions = PrintDefinitions(symbol_table);
+    expected_references = PrintReferences(symbol_table);
+  }
+
+  VerilogProject project(sources_dir, {sources_dir});
+  for (const auto unit : units) {
+    ASSERT_TRUE(project.OpenTranslationUnit(unit).ok());
+  }
+  SymbolTable symbol_table(&project);
+  SymbolTableIndex index;
+  ASSERT_TRUE(index.Load(serialized, &symbol_table).ok());
+  EXPECT_EQ(index.RestoredTranslationUnits().size(), units.size());
+  // The included file is opened when the index is loaded.
+  EXPECT_NE(project.LookupRegisteredFile("inc.svh"), nullptr);
+
+  // Nothing is left to build.
+  for (const auto unit : units) {
+    EXPECT_NE(index.RestoredTranslationUnits().find(std::string(unit)),
+              index.RestoredTranslationUnits().end());
+  }
+
+  std::vector<absl::Status> resolve_diagnostics;
+  symbol_table.Resolve(&resolve_diagnostics);
+  EXPECT_EQ(PrintDefinitions(symbol_table), expected_definitions);
+  EXPECT_EQ(PrintReferences(symbol_table), expected_references);
+}
+
+TEST(SymbolTableIndexTest, ChangedFilesAreNotRestored) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  ASSERT_TRUE(CreateDir(sources_dir).ok());
+
+  ScopedTestFile pp_src(sources_dir,
+                        "module pp;\n"
+                        "endmodule\n",
+                        "pp.sv");
+  ScopedTestFile qq_src(sources_dir,
+                        "module qq;\n"
+                        "endmodule\n",
+                        "qq.sv");
+  ScopedTestFile rr_src(sources_dir,
+                        "module rr;\n"
+                        "  `include \"inc.svh\"\n"
+                        "endmodule\n",
+                        "rr.sv");
+  const std::vector<absl::string_view> units{"pp.sv", "qq.sv", "rr.sv"};
+
+  std::string serialized;
+  {
+    ScopedTestFile inc_src(sources_dir, "wire w;\n", "inc.svh");
+    VerilogProject project(sources_dir, {sources_dir});
+    for (const auto unit : units) {
+      ASSERT_TRUE(project.OpenTranslationUnit(unit).ok());
+    }
+    SymbolTable symbol_table(&project);
+    SymbolTableIndex index;
+    const auto diagnostics = BuildMissingUnits(units, index, &symbol_table);
+    std::ostringstream stream;
+    ASSERT_TRUE(
+        SymbolTableIndex::Save(symbol_table, diagnostics, &stream).ok());
+    serialized = stream.str();
+  }
+
+  // Change the included file.
+  ScopedTestFile inc_src(sources_dir, "wire v;\n", "inc.svh");
+  VerilogProject project(sources_dir, {sources_dir});
+  // Leave out qq.sv.
+  for (const auto unit : {"pp.sv", "rr.sv"}) {
+    ASSERT_TRUE(project.OpenTranslationUnit(unit).ok());
+  }
+  SymbolTable symbol_table(&project);
+  SymbolTableIndex index;
+  ASSERT_TRUE(index.Load(serialized, &symbol_table).ok());
+  const auto& restored(index.RestoredTranslationUnits());
+  EXPECT_EQ(restored.size(), 1);
+  EXPECT_NE(restored.find("pp.sv"), restored.end());
+
+  const SymbolTableNode& root(symbol_table.Root());
+  EXPECT_NE(root.Find("pp"), root.end());
+  EXPECT_EQ(root.Find("qq"), root.end());
+  EXPECT_EQ(root.Find("rr"), root.end());
+
+  BuildMissingUnits({"pp.sv", "rr.sv"}, index, &symbol_table);
+  const auto found_rr = root.Find("rr");
+  ASSERT_NE(found_rr, root.end());
+  EXPECT_NE(found_rr->second.Find("v"), found_rr->second.end());
+  EXPECT_EQ(found_rr->second.Find("w"), found_rr->second.end());
+}
+
+}  // namespace
+}  // namespace verilog
@@ -45,6 +45,7 @@ class SymbolTable::Tester : public SymbolTable {
 
 namespace {
 
+using testing::ElementsAre;
 using testing::ElementsAreArray;
 using testing::HasSubstr;
 using verible::file::Basename;
@@ -292,6 +293,98 @@ TEST(DependentReferencesTest, PrintNonRootResolved) {
 })");
 }
 
+TEST(SymbolTableScopeIndexTest, EmptyIndex) {
+  const SymbolTableNode root(SymbolInfo{.metatype = SymbolMetaType::kRoot});
+  SymbolTableScopeIndex index;
+  index.Rebuild(root);
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(index.FindId("foo"), SymbolTableScopeIndex::kNotFound);
+}
+
+TEST(SymbolTableScopeIndexTest, FindMembersMatchesFind) {
+  typedef SymbolTableNode::key_value_type KV;
+  const SymbolTableNode root(
+      SymbolInfo{.metatype = SymbolMetaType::kRoot},
+      KV{"p_pkg",
+         SymbolTableNode(
+             SymbolInfo{.metatype = SymbolMetaType::kPackage},
+             KV{"c_class", SymbolTableNode(SymbolInfo{
+                               .metatype = SymbolMetaType::kClass})},
+             KV{"p_pkg", SymbolTableNode(SymbolInfo{
+                             .metatype = SymbolMetaType::kParameter})})},
+      KV{"c_class",
+         SymbolTableNode(SymbolInfo{.metatype = SymbolMetaType::kClass})});
+  SymbolTableScopeIndex index;
+  index.Rebuild(root);
+  EXPECT_FALSE(index.empty());
+
+  MUST_ASSIGN_LOOKUP_SYMBOL(p_pkg, root, "p_pkg");
+  MUST_ASSIGN_LOOKUP_SYMBOL(root_c_class, root, "c_class");
+  MUST_ASSIGN_LOOKUP_SYMBOL(pkg_c_class, p_pkg, "c_class");
+  MUST_ASSIGN_LOOKUP_SYMBOL(pkg_p_pkg, p_pkg, "p_pkg");
+
+  // Same names share ids, regardless of scope.
+  const auto p_pkg_id = index.FindId("p_pkg");
+  const auto c_class_id = index.FindId("c_class");
+  ASSERT_NE(p_pkg_id, SymbolTableScopeIndex::kNotFound);
+  ASSERT_NE(c_class_id, SymbolTableScopeIndex::kNotFound);
+  EXPECT_NE(p_pkg_id, c_class_id);
+  EXPECT_EQ(index.FindId("nonexistent"), SymbolTableScopeIndex::kNotFound);
+
+  EXPECT_EQ(index.FindMember(root, p_pkg_id), &p_pkg);
+  EXPECT_EQ(index.FindMember(root, c_class_id), &root_c_class);
+  EXPECT_EQ(index.FindMember(p_pkg, c_class_id), &pkg_c_class);
+  EXPECT_EQ(index.FindMember(p_pkg, p_pkg_id), &pkg_p_pkg);
+  // leaf scopes have no members
+  EXPECT_EQ(index.FindMember(pkg_c_class, c_class_id), nullptr);
+
+  index.Clear();
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(index.FindId("p_pkg"), SymbolTableScopeIndex::kNotFound);
+}
+
+TEST(SymbolTableScopeIndexTest, ResolveWithIndex) {
+  typedef SymbolTableNode::key_value_type KV;
+  SymbolTableNode root(
+      SymbolInfo{.metatype = SymbolMetaType::kRoot},
+      KV{"p_pkg",
+         SymbolTableNode(
+             SymbolInfo{.metatype = SymbolMetaType::kPackage},
+             KV{"c_class", SymbolTableNode(SymbolInfo{
+                               .metatype = SymbolMetaType::kClass})})});
+  MUST_ASSIGN_LOOKUP_SYMBOL(p_pkg, root, "p_pkg");
+  MUST_ASSIGN_LOOKUP_SYMBOL(c_class, p_pkg, "c_class");
+
+  SymbolTableScopeIndex index;
+  index.Rebuild(root);
+
+  // Resolve "p_pkg::c_class" upward from inside the class's scope.
+  DependentReferences dep_refs{
+      .components = absl::make_unique<ReferenceComponentNode>(
+          ReferenceComponent{.identifier = "p_pkg",
+                             .ref_type = ReferenceType::kUnqualified,
+                             .required_metatype = SymbolMetaType::kPackage},
+          ReferenceComponentNode(
+              ReferenceComponent{.identifier = "c_class",
+                                 .ref_type = ReferenceType::kDirectMember,
+                                 .required_metatype = SymbolMetaType::kClass}))};
+  std::vector<absl::Status> diagnostics;
+  dep_refs.Resolve(c_class, &diagnostics, &index);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+  EXPECT_EQ(dep_refs.components->Value().resolved_symbol, &p_pkg);
+  EXPECT_EQ(dep_refs.LastLeaf()->Value().resolved_symbol, &c_class);
+
+  // Names unknown to the index fail to resolve.
+  DependentReferences bad_ref{
+      .components = absl::make_unique<ReferenceComponentNode>(
+          ReferenceComponent{.identifier = "q_pkg",
+                             .ref_type = ReferenceType::kUnqualified,
+                             .required_metatype = SymbolMetaType::kPackage})};
+  bad_ref.Resolve(c_class, &diagnostics, &index);
+  ASSERT_EQ(diagnostics.size(), 1);
+  EXPECT_EQ(bad_ref.components->Value().resolved_symbol, nullptr);
+}
+
 TEST(SymbolTablePrintTest, PrintClass) {
   TestVerilogSourceFile src("foobar.sv",
                             "module ss;\n"
@@ -8357,6 +8450,315 @@ TEST(BuildSymbolTableTest, IncludedTwiceFromDifferentFiles) {
   EXPECT_EMPTY_STATUSES(resolve_diagnostics);
 }
 
+TEST(IncrementalSymbolTableTest, UpdateDefinitionFile) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  ASSERT_TRUE(CreateDir(sources_dir).ok());
+
+  ScopedTestFile pp_src(sources_dir,
+                        "module pp;\n"
+                        "endmodule\n",
+                        "pp.sv");
+  ScopedTestFile qq_src(sources_dir,
+                        "module qq;\n"
+                        "  pp pp_inst();\n"
+                        "endmodule\n",
+                        "qq.sv");
+
+  VerilogProject project(sources_dir, {});
+  for (const auto* file : {&pp_src, &qq_src}) {
+    ASSERT_TRUE(project.OpenTranslationUnit(Basename(file->filename())).ok());
+  }
+
+  SymbolTable symbol_table(&project);
+  const SymbolTableNode& root_symbol(symbol_table.Root());
+  std::vector<absl::Status> diagnostics;
+  symbol_table.Build(&diagnostics);
+  symbol_table.Resolve(&diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+
+  {
+    MUST_ASSIGN_LOOKUP_SYMBOL(pp, root_symbol, "pp");
+    MUST_ASSIGN_LOOKUP_SYMBOL(qq, root_symbol, "qq");
+    MUST_ASSIGN_LOOKUP_SYMBOL(pp_inst, qq, "pp_inst");
+    EXPECT_EQ(pp_inst_info.declared_type.user_defined_type->Value()
+                  .resolved_symbol,
+              &pp);
+  }
+
+  // Rename the definition: the reference to it becomes unresolved.
+  symbol_table.UpdateTranslationUnit("pp.sv",
+                                     "module rr;\n"
+                                     "endmodule\n",
+                                     &diagnostics);
+  EXPECT_EQ(diagnostics.size(), 1);  // "pp" is no longer defined
+  diagnostics.clear();
+  EXPECT_EQ(root_symbol.Find("pp"), root_symbol.end());
+  {
+    MUST_ASSIGN_LOOKUP_SYMBOL(rr, root_symbol, "rr");
+    EXPECT_EQ(rr_info.file_origin, project.LookupRegisteredFile("pp.sv"));
+    MUST_ASSIGN_LOOKUP_SYMBOL(qq, root_symbol, "qq");
+    MUST_ASSIGN_LOOKUP_SYMBOL(pp_inst, qq, "pp_inst");
+    EXPECT_EQ(pp_inst_info.declared_type.user_defined_type->Value()
+                  .resolved_symbol,
+              nullptr);
+  }
+
+  // Restore the definition: the reference is bound again.
+  symbol_table.UpdateTranslationUnit("pp.sv",
+                                     "module pp;\n"
+                                     "endmodule\n",
+                                     &diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+  EXPECT_EQ(root_symbol.Find("rr"), root_symbol.end());
+  {
+    MUST_ASSIGN_LOOKUP_SYMBOL(pp, root_symbol, "pp");
+    MUST_ASSIGN_LOOKUP_SYMBOL(qq, root_symbol, "qq");
+    MUST_ASSIGN_LOOKUP_SYMBOL(pp_inst, qq, "pp_inst");
+    EXPECT_EQ(pp_inst_info.declared_type.user_defined_type->Value()
+                  .resolved_symbol,
+              &pp);
+  }
+}
+
+TEST(IncrementalSymbolTableTest, UpdateReferencingFile) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  ASSERT_TRUE(CreateDir(sources_dir).ok());
+
+  ScopedTestFile pp_src(sources_dir,
+                        "module pp;\n"
+                        "endmodule\n",
+                        "pp.sv");
+  ScopedTestFile qq_src(sources_dir,
+                        "module qq;\n"
+                        "endmodule\n",
+                        "qq.sv");
+
+  VerilogProject project(sources_dir, {});
+  for (const auto* file : {&pp_src, &qq_src}) {
+    ASSERT_TRUE(project.OpenTranslationUnit(Basename(file->filename())).ok());
+  }
+
+  SymbolTable symbol_table(&project);
+  const SymbolTableNode& root_symbol(symbol_table.Root());
+  std::vector<absl::Status> diagnostics;
+  symbol_table.Build(&diagnostics);
+  symbol_table.Resolve(&diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+
+  MUST_ASSIGN_LOOKUP_SYMBOL(pp, root_symbol, "pp");
+
+  symbol_table.UpdateTranslationUnit("qq.sv",
+                                     "module qq;\n"
+                                     "  pp pp_inst();\n"
+                                     "endmodule\n",
+                                     &diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+
+  // The unchanged definition was not rebuilt.
+  const auto pp_after_update = root_symbol.Find("pp");
+  ASSERT_NE(pp_after_update, root_symbol.end());
+  EXPECT_EQ(&pp_after_update->second, &pp);
+
+  MUST_ASSIGN_LOOKUP_SYMBOL(qq, root_symbol, "qq");
+  MUST_ASSIGN_LOOKUP_SYMBOL(pp_inst, qq, "pp_inst");
+  EXPECT_EQ(
+      pp_inst_info.declared_type.user_defined_type->Value().resolved_symbol,
+      &pp);
+}
+
+TEST(IncrementalSymbolTableTest, UpdateIncludedFile) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  ASSERT_TRUE(CreateDir(sources_dir).ok());
+
+  ScopedTestFile included_file(sources_dir,
+                               "// verilog_syntax: parse-as-module-body\n"
+                               "wire ww;\n",
+                               "wires.sv");
+  ScopedTestFile pp_src(sources_dir,
+                        "module pp;\n"
+                        "`include \"wires.sv\"\n"
+                        "  assign ww = 1'b0;\n"
+                        "endmodule\n",
+                        "pp.sv");
+
+  VerilogProject project(sources_dir, {sources_dir});
+  ASSERT_TRUE(project.OpenTranslationUnit(Basename(pp_src.filename())).ok());
+
+  SymbolTable symbol_table(&project);
+  const SymbolTableNode& root_symbol(symbol_table.Root());
+  std::vector<absl::Status> diagnostics;
+  symbol_table.Build(&diagnostics);
+  symbol_table.Resolve(&diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+
+  // Changing the included file rebuilds the translation unit that includes it.
+  // Build() also opened the included file as a translation unit of its own.
+  const VerilogSourceFile* included = project.LookupRegisteredFile("wires.sv");
+  ASSERT_NE(included, nullptr);
+  const std::vector<const VerilogSourceFile*> retracted =
+      symbol_table.RemoveTranslationUnit(*included);
+  EXPECT_THAT(retracted,
+              ElementsAre(project.LookupRegisteredFile("pp.sv"), included));
+  EXPECT_TRUE(root_symbol.Children().empty());
+
+  for (const auto* file : retracted) {
+    symbol_table.BuildSingleTranslationUnit(file->ReferencedPath(),
+                                            &diagnostics);
+  }
+  symbol_table.ResolveIncrementally(&diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+
+  // Renaming the wire breaks the reference to it.
+  symbol_table.UpdateTranslationUnit("wires.sv",
+                                     "// verilog_syntax: parse-as-module-body\n"
+                                     "wire vv;\n",
+                                     &diagnostics);
+  EXPECT_EQ(diagnostics.size(), 1);  // "ww" is no longer defined
+  MUST_ASSIGN_LOOKUP_SYMBOL(pp, root_symbol, "pp");
+  MUST_ASSIGN_LOOKUP_SYMBOL(vv, pp, "vv");
+  EXPECT_EQ(vv_info.file_origin, included);
+  EXPECT_EQ(pp.Find("ww"), pp.end());
+}
+
+TEST(IncrementalSymbolTableTest, UpdateTypedefRebindsMemberReferences) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  ASSERT_TRUE(CreateDir(sources_dir).ok());
+
+  ScopedTestFile classes_src(sources_dir,
+                             "class aa;\n"
+                             "  int mm;\n"
+                             "endclass\n"
+                             "class bb;\n"
+                             "  int mm;\n"
+                             "endclass\n",
+                             "classes.sv");
+  ScopedTestFile typedef_src(sources_dir, "typedef aa tt;\n", "tt.sv");
+  ScopedTestFile user_src(sources_dir,
+                          "module uu;\n"
+                          "  tt obj;\n"
+                          "  assign obj.mm = 1'b0;\n"
+                          "endmodule\n",
+                          "uu.sv");
+
+  VerilogProject project(sources_dir, {});
+  for (const auto* file : {&classes_src, &typedef_src, &user_src}) {
+    ASSERT_TRUE(project.OpenTranslationUnit(Basename(file->filename())).ok());
+  }
+
+  SymbolTable symbol_table(&project);
+  const SymbolTableNode& root_symbol(symbol_table.Root());
+  std::vector<absl::Status> diagnostics;
+  symbol_table.Build(&diagnostics);
+  symbol_table.Resolve(&diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+
+  MUST_ASSIGN_LOOKUP_SYMBOL(aa, root_symbol, "aa");
+  MUST_ASSIGN_LOOKUP_SYMBOL(aa_mm, aa, "mm");
+  MUST_ASSIGN_LOOKUP_SYMBOL(bb, root_symbol, "bb");
+  MUST_ASSIGN_LOOKUP_SYMBOL(bb_mm, bb, "mm");
+  MUST_ASSIGN_LOOKUP_SYMBOL(uu, root_symbol, "uu");
+  const auto member_binding = [&uu_info]() -> const SymbolTableNode* {
+    for (const auto& ref : uu_info.local_references_to_bind) {
+      if (ref.components->Value().identifier != "obj") continue;
+      if (ref.components->Children().empty()) continue;
+      return ref.components->Children().front().Value().resolved_symbol;
+    }
+    return nullptr;
+  };
+  EXPECT_EQ(member_binding(), &aa_mm);
+
+  // Neither "obj" nor "mm" changes, but "obj.mm" is looked up through the
+  // type of "obj", which now aliases another class.
+  symbol_table.UpdateTranslationUnit("tt.sv", "typedef bb tt;\n",
+                                     &diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+  EXPECT_EQ(member_binding(), &bb_mm);
+}
+
+TEST(IncrementalSymbolTableTest, UpdateFileWithAnonymousType) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  ASSERT_TRUE(CreateDir(sources_dir).ok());
+
+  constexpr absl::string_view text(
+      "typedef struct {\n"
+      "  int aa;\n"
+      "} ss_t;\n");
+  ScopedTestFile src(sources_dir, text, "ss.sv");
+
+  VerilogProject project(sources_dir, {});
+  ASSERT_TRUE(project.OpenTranslationUnit("ss.sv").ok());
+
+  SymbolTable symbol_table(&project);
+  const SymbolTableNode& root_symbol(symbol_table.Root());
+  std::vector<absl::Status> diagnostics;
+  symbol_table.Build(&diagnostics);
+  symbol_table.Resolve(&diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+  const size_t num_refs = root_symbol.Value().local_references_to_bind.size();
+
+  // Self-references to the anonymous struct are retracted with it, even
+  // though their names do not come from the file's text.
+  symbol_table.UpdateTranslationUnit("ss.sv", text, &diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+  EXPECT_EQ(root_symbol.Value().local_references_to_bind.size(), num_refs);
+}
+
+TEST(IncrementalSymbolTableTest, RemoveClassRetractsOutOfLineDefinitions) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  ASSERT_TRUE(CreateDir(sources_dir).ok());
+
+  ScopedTestFile class_src(sources_dir,
+                           "class cc;\n"
+                           "  extern function int ff(logic ll);\n"
+                           "endclass\n",
+                           "cc.sv");
+  ScopedTestFile method_src(sources_dir,
+                            "function int cc::ff(logic ll);\n"
+                            "  bit bb;\n"
+                            "endfunction\n",
+                            "ff.sv");
+
+  VerilogProject project(sources_dir, {});
+  for (const auto* file : {&class_src, &method_src}) {
+    ASSERT_TRUE(project.OpenTranslationUnit(Basename(file->filename())).ok());
+  }
+
+  SymbolTable symbol_table(&project);
+  const SymbolTableNode& root_symbol(symbol_table.Root());
+  std::vector<absl::Status> diagnostics;
+  symbol_table.Build(&diagnostics);
+  symbol_table.Resolve(&diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+
+  // The method definition's local symbols live inside the class, so the file
+  // containing the definition has to be retracted along with the class.
+  const VerilogSourceFile* class_file = project.LookupRegisteredFile("cc.sv");
+  const VerilogSourceFile* method_file = project.LookupRegisteredFile("ff.sv");
+  const std::vector<const VerilogSourceFile*> retracted =
+      symbol_table.RemoveTranslationUnit(*class_file);
+  EXPECT_THAT(retracted, ElementsAre(class_file, method_file));
+  EXPECT_TRUE(root_symbol.Children().empty());
+  EXPECT_TRUE(root_symbol.Value().local_references_to_bind.empty());
+
+  for (const auto* file : retracted) {
+    symbol_table.BuildSingleTranslationUnit(file->ReferencedPath(),
+                                            &diagnostics);
+  }
+  symbol_table.ResolveIncrementally(&diagnostics);
+  EXPECT_EMPTY_STATUSES(diagnostics);
+
+  MUST_ASSIGN_LOOKUP_SYMBOL(cc, root_symbol, "cc");
+  MUST_ASSIGN_LOOKUP_SYMBOL(ff, cc, "ff");
+  MUST_ASSIGN_LOOKUP_SYMBOL(bb, ff, "bb");
+  EXPECT_EQ(bb_info.file_origin, method_file);
+}
+
 struct FileListTestCase {
   absl::string_view contents;
   std::vector<absl::string_view> expected_files;
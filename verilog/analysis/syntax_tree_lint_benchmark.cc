@@ -0,0 +1,72 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures syntax tree linting time versus the number of enabled syntax tree
+// lint rules.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "common/analysis/syntax_tree_linter.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/util/logging.h"
+#include "verilog/analysis/lint_rule_registry.h"
+#include "verilog/analysis/verilog_analyzer.h"
+#include "verilog/tools/corpus/benchmark_corpus.h"
+
+namespace verilog {
+namespace {
+
+const verible::ConcreteSyntaxTree& BenchmarkTree() {
+  static const auto* const analyzer = [] {
+    auto analyzer = VerilogAnalyzer::AnalyzeAutomaticMode(
+        corpus::BenchmarkSource(400), "benchmark.sv");
+    CHECK(analyzer->ParseStatus().ok());
+    return analyzer.release();
+  }();
+  return analyzer->Data().SyntaxTree();
+}
+
+void BM_SyntaxTreeLint(benchmark::State& state) {
+  const auto& tree = BenchmarkTree();
+  auto rule_names = analysis::RegisteredSyntaxTreeRulesNames();
+  std::sort(rule_names.begin(), rule_names.end());
+  rule_names.resize(std::min<size_t>(state.range(0), rule_names.size()));
+  state.SetLabel(absl::StrCat(rule_names.size(), " rules"));
+  for (auto _ : state) {
+    verible::SyntaxTreeLinter linter;
+    for (const auto& name : rule_names) {
+      linter.AddRule(analysis::CreateSyntaxTreeLintRule(name));
+    }
+    linter.Lint(*tree);
+    benchmark::DoNotOptimize(linter.ReportStatus());
+  }
+}
+BENCHMARK(BM_SyntaxTreeLint)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Arg(16)
+    ->Arg(32)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace verilog
+
+BENCHMARK_MAIN();
@@ -25,11 +25,15 @@
 #include <utility>
 #include <vector>
 
+#include "absl/flags/flag.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "common/analysis/file_analyzer.h"
+#include "common/lexer/token_generator.h"
 #include "common/lexer/token_stream_adapter.h"
 #include "common/strings/comment_utils.h"
 #include "common/text/concrete_syntax_leaf.h"
@@ -38,18 +42,38 @@
 #include "common/text/text_structure.h"
 #include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
+#include "common/text/tree_utils.h"
 #include "common/text/visitors.h"
 #include "common/util/container_util.h"
 #include "common/util/logging.h"
+#include "common/util/phase_stats.h"
 #include "common/util/status_macros.h"
+#include "common/util/thread_pool.h"
+#include "verilog/CST/verilog_nonterminals.h"
 #include "verilog/analysis/verilog_excerpt_parse.h"
+#include "verilog/analysis/verilog_top_level_split.h"
 #include "verilog/parser/verilog_lexer.h"
 #include "verilog/parser/verilog_lexical_context.h"
 #include "verilog/parser/verilog_parser.h"
 #include "verilog/parser/verilog_token_classifications.h"
 #include "verilog/parser/verilog_token_enum.h"
+#include "verilog/preprocessor/verilog_macro_registry.h"
 #include "verilog/preprocessor/verilog_preprocess.h"
 
+ABSL_FLAG(int, verilog_parse_jobs, 1,
+          "Number of concurrent parses to split a large file into, cutting "
+          "between top-level module, interface, program and package "
+          "declarations (0: one per hardware thread, 1: parse serially).");
+
+ABSL_FLAG(std::vector<std::string>, verilog_defines, {},
+          "Comma-separated macros to define before preprocessing each file, "
+          "as NAME or NAME=VALUE (like +define+NAME=VALUE).");
+
+ABSL_FLAG(bool, verilog_filter_branches, false,
+          "If true, evaluate `ifdef, `ifndef, `elsif and `else with the macros "
+          "defined so far (and by --verilog_defines), and parse only the "
+          "active branches.");
+
 namespace verilog {
 
 using verible::FileAnalyzer;
@@ -59,8 +83,45 @@ using verible::container::InsertKeyOrDie;
 
 const char VerilogAnalyzer::kParseDirectiveName[] = "verilog_syntax:";
 
+// Returns the macros of --verilog_defines, which are preprocessed once and
+// shared by all the files that are analyzed, until the flag changes.
+// Returns an error if one of the defines is invalid.
+static absl::StatusOr<std::shared_ptr<const SharedMacroRegistry>>
+SharedMacrosFromFlags() {
+  static absl::Mutex mutex(absl::kConstInit);
+  static auto* defines = new std::vector<std::string>;
+  static auto* registry =
+      new absl::StatusOr<std::shared_ptr<const SharedMacroRegistry>>(nullptr);
+  const std::vector<std::string> flag_defines =
+      absl::GetFlag(FLAGS_verilog_defines);
+  if (flag_defines.empty()) return nullptr;
+  absl::MutexLock lock(&mutex);
+  if ((registry->ok() && **registry == nullptr) || *defines != flag_defines) {
+    VerilogPreprocess::Config config;
+    config.defines = flag_defines;
+    *registry = VerilogPreprocess::BuildMacroRegistry({}, config);
+    *defines = flag_defines;
+  }
+  return *registry;
+}
+
+static VerilogPreprocess::Config PreprocessConfigFromFlags() {
+  VerilogPreprocess::Config config;
+  const auto shared_macros = SharedMacrosFromFlags();
+  if (shared_macros.ok()) {
+    config.shared_macros = *shared_macros;
+  } else {
+    // Preprocessing every file with the invalid defines reports the error
+    // with the file's other preprocessor errors.
+    config.defines = absl::GetFlag(FLAGS_verilog_defines);
+  }
+  config.filter_branches = absl::GetFlag(FLAGS_verilog_filter_branches);
+  return config;
+}
+
 absl::Status VerilogAnalyzer::Tokenize() {
   if (!tokenized_) {
+    const verible::ScopedPhase phase("lex");
     VerilogLexer lexer{Data().Contents()};
     tokenized_ = true;
     lex_status_ = FileAnalyzer::Tokenize(&lexer);
@@ -204,12 +265,24 @@ std::unique_ptr<VerilogAnalyzer> VerilogAnalyzer::AnalyzeAutomaticMode(
 }
 
 void VerilogAnalyzer::FilterTokensForSyntaxTree() {
+  const verible::ScopedPhase phase("filter");
   data_.FilterTokens(&VerilogLexer::KeepSyntaxTreeTokens);
 }
 
-void VerilogAnalyzer::ContextualizeTokens() {
+void VerilogAnalyzer::ContextualizeTokens(bool collect_top_level_ends) {
+  const verible::ScopedPhase phase("lexical-context");
   LexicalContext context;
-  context.TransformVerilogSymbols(data_.MakeTokenStreamReferenceView());
+  if (!collect_top_level_ends) {
+    context.TransformVerilogSymbols(data_.MakeTokenStreamReferenceView());
+    return;
+  }
+  top_level_ends_.clear();
+  context.TransformVerilogSymbols(
+      data_.MakeTokenStreamReferenceView(), [this](const TokenInfo& token) {
+        if (IsTopLevelDeclarationEnd(token.token_enum())) {
+          top_level_ends_.push_back(&token);
+        }
+      });
 }
 
 // Analyzes Verilog code: lexer, filter, parser.
@@ -222,14 +295,26 @@ absl::Status VerilogAnalyzer::Analyze() {
   // Here would be one place to analyze the raw token stream.
   FilterTokensForSyntaxTree();
 
+  // Only large inputs are worth parsing in chunks concurrently.
+  const size_t parse_threads = verible::ThreadPool::ThreadsForJobs(
+      parse_jobs_.value_or(absl::GetFlag(FLAGS_verilog_parse_jobs)));
+  const bool parse_in_chunks =
+      parse_threads > 1 &&
+      Data().GetTokenStreamView().size() >= 2 * kMinTokensPerParseChunk;
+
   // Disambiguate tokens using lexical context.
-  ContextualizeTokens();
+  ContextualizeTokens(parse_in_chunks);
 
   // pseudo-preprocess token stream.
   // TODO(fangism): preprocessor_.Configure();
   //   Not all analyses will want to preprocess.
   {
-    VerilogPreprocess preprocessor;
+    const verible::ScopedPhase phase("preprocess");
+    VerilogPreprocess::Config config = preprocess_config_.has_value()
+                                           ? *preprocess_config_
+                                           : PreprocessConfigFromFlags();
+    if (include_file_opener_) config.include_file_opener = include_file_opener_;
+    VerilogPreprocess preprocessor(std::move(config));
     preprocessor_data_ = preprocessor.ScanStream(Data().GetTokenStreamView());
     if (!preprocessor_data_.errors.empty()) {
       for (const auto& error : preprocessor_data_.errors) {
@@ -245,11 +330,18 @@ absl::Status VerilogAnalyzer::Analyze() {
     // TODO(fangism): could we just move, swap, or directly reference?
   }
 
-  auto generator = MakeTokenViewer(Data().GetTokenStreamView());
-  VerilogParser parser(&generator);
-  parse_status_ = FileAnalyzer::Parse(&parser);
-  // Here would be appropriate for analyzing the syntax tree.
-  max_used_stack_size_ = parser.MaxUsedStackSize();
+  {
+    const verible::ScopedPhase phase("parse");
+    if (parse_in_chunks && ParseTopLevelChunks(parse_threads)) {
+      parse_status_ = absl::OkStatus();
+    } else {
+      auto generator = MakeTokenViewer(Data().GetTokenStreamView());
+      VerilogParser parser(&generator);
+      parse_status_ = FileAnalyzer::Parse(&parser);
+      // Here would be appropriate for analyzing the syntax tree.
+      max_used_stack_size_ = parser.MaxUsedStackSize();
+    }
+  }
 
   // Expand macro arguments that are parseable as expressions.
   if (parse_status_.ok() && SyntaxTree() != nullptr) {
@@ -259,6 +351,78 @@ absl::Status VerilogAnalyzer::Analyze() {
   return parse_status_;
 }
 
+bool VerilogAnalyzer::CompactTokens() {
+  if (!MutableData().CompactTokens()) return false;
+  verible::TokenStreamView().swap(preprocessor_data_.preprocessed_token_stream);
+  top_level_ends_.clear();
+  return true;
+}
+
+bool VerilogAnalyzer::ParseTopLevelChunks(size_t num_threads) {
+  const verible::TokenStreamView& tokens = Data().GetTokenStreamView();
+  const std::vector<size_t> cuts = BalanceSplitPoints(
+      FindTopLevelSplitPoints(tokens, top_level_ends_), tokens.size(),
+      num_threads, kMinTokensPerParseChunk);
+  top_level_ends_.clear();
+  if (cuts.empty()) return false;
+  VLOG(1) << "Parsing " << filename_ << " in " << cuts.size() + 1
+          << " chunks.";
+
+  // Each chunk gets its own parser, and hence its own ParserParam.  The
+  // generated parser is pure, and the only global it reads, the trace level
+  // verilog_debug, is set once before the first parse (see
+  // verilog_parse_wrapper), so chunks can be parsed concurrently.
+  struct Chunk {
+    verible::TokenStreamView::const_iterator begin;
+    verible::TokenStreamView::const_iterator end;
+    absl::Status status;
+    verible::ConcreteSyntaxTree root;
+    size_t max_used_stack_size = 0;
+  };
+  std::vector<Chunk> chunks(cuts.size() + 1);
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    chunks[i].begin = tokens.begin() + (i == 0 ? 0 : cuts[i - 1]);
+    chunks[i].end = i < cuts.size() ? tokens.begin() + cuts[i] : tokens.end();
+  }
+  {
+    verible::ThreadPool pool(std::min(num_threads, chunks.size()));
+    for (auto& chunk : chunks) {
+      pool.Schedule([&chunk]() {
+        auto iter = chunk.begin;
+        const auto end = chunk.end;
+        verible::TokenGenerator generator = [&iter, end]() {
+          return iter != end ? **iter++ : TokenInfo::EOFToken();
+        };
+        VerilogParser parser(&generator);
+        chunk.status = parser.Parse();
+        chunk.root = parser.TakeRoot();
+        chunk.max_used_stack_size = parser.MaxUsedStackSize();
+      });
+    }
+  }  // waits for all chunks
+
+  for (const auto& chunk : chunks) {
+    if (!chunk.status.ok() || chunk.root == nullptr ||
+        chunk.root->Tag() != verible::NodeTag(NodeEnum::kDescriptionList)) {
+      VLOG(1) << "Chunk failed to parse, parsing " << filename_
+              << " serially.";
+      return false;
+    }
+  }
+
+  // Stitch all description lists into the first.
+  auto& root = verible::SymbolCastToNode(*chunks.front().root);
+  max_used_stack_size_ = 0;
+  for (auto& chunk : chunks) {
+    max_used_stack_size_ =
+        std::max(max_used_stack_size_, chunk.max_used_stack_size);
+    if (&chunk == &chunks.front()) continue;
+    root.AppendChild(verible::ForwardChildren(chunk.root));
+  }
+  MutableData().MutableSyntaxTree() = std::move(chunks.front().root);
+  return true;
+}
+
 namespace {
 using verible::MutableTreeVisitorRecursive;
 using verible::SymbolPtr;
@@ -347,6 +511,7 @@ class MacroCallArgExpander : public MutableTreeVisitorRecursive {
 }  // namespace
 
 void VerilogAnalyzer::ExpandMacroCallArgExpressions() {
+  const verible::ScopedPhase phase("macro-arg-expansion");
   VLOG(2) << __FUNCTION__;
   MacroCallArgExpander expander(Data().Contents());
   ABSL_DIE_IF_NULL(SyntaxTree())
@@ -19,11 +19,16 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "common/analysis/file_analyzer.h"
+#include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
+#include "verilog/preprocessor/verilog_include_cache.h"
 #include "verilog/preprocessor/verilog_preprocess.h"
 
 namespace verilog {
@@ -52,6 +57,30 @@ class VerilogAnalyzer : public verible::FileAnalyzer {
 
   size_t MaxUsedStackSize() const { return max_used_stack_size_; }
 
+  // Sets the number of concurrent parses that Analyze() may split a large
+  // input into, cutting between top-level declarations; 0 means one per
+  // hardware thread, and 1 parses serially.  The syntax tree is the same
+  // either way.  Defaults to --verilog_parse_jobs.
+  void SetParseJobs(int jobs) { parse_jobs_ = jobs; }
+
+  // Configures the preprocessing steps of Analyze() (see VerilogPreprocess).
+  // Defaults to --verilog_defines and --verilog_filter_branches.
+  void SetPreprocessConfig(VerilogPreprocess::Config config) {
+    preprocess_config_ = std::move(config);
+  }
+
+  // Lets the preprocessor open `included files to learn their macro
+  // definitions (see VerilogPreprocess).  This applies on top of the
+  // preprocessing config, whether it is set or taken from flags.
+  // Unset by default.
+  void SetIncludeFileOpener(IncludeFileOpener opener) {
+    include_file_opener_ = std::move(opener);
+  }
+
+  // Inputs are only split into chunks of at least this many tokens, because
+  // smaller ones parse faster than threads start.
+  static constexpr size_t kMinTokensPerParseChunk = 1 << 14;
+
   // Automatically analyze with the correct parsing mode, as detected
   // by parser directive comments.
   static std::unique_ptr<VerilogAnalyzer> AnalyzeAutomaticMode(
@@ -61,13 +90,21 @@ class VerilogAnalyzer : public verible::FileAnalyzer {
     return preprocessor_data_;
   }
 
+  // Moves the tokens into compact storage, for analyses that are kept after
+  // parsing (see TextStructureView::CompactTokens()).  This clears the
+  // preprocessed token stream of PreprocessorData(), which points into the
+  // moved tokens.  Returns false, and changes nothing, if the tokens cannot be
+  // stored compactly.
+  bool CompactTokens();
+
   // Maybe this belongs in a subclass like VerilogFileAnalyzer?
   // TODO(fangism): Retain a copy of the token stream transformer because it
   // may contain tokens backed by generated text.
 
  protected:
   // Apply context-based disambiguation of tokens.
-  void ContextualizeTokens();
+  // If 'collect_top_level_ends', also records top_level_ends_.
+  void ContextualizeTokens(bool collect_top_level_ends = false);
 
   // Scan comments for parsing mode directives.
   // Returns a string that is first argument of the directive, e.g.:
@@ -85,6 +122,14 @@ class VerilogAnalyzer : public verible::FileAnalyzer {
   // syntax tree.  If parsing fails, leave the MacroArg token unexpanded.
   void ExpandMacroCallArgExpressions();
 
+  // Parses the preprocessed token stream as chunks of top-level
+  // declarations on up to 'num_threads' threads, cutting after the
+  // declarations in top_level_ends_, and concatenates their description
+  // lists.  Returns false without producing a syntax tree if the stream
+  // cannot be cut, or if any chunk fails to parse, so that the caller can
+  // parse serially, with the usual diagnostics.
+  bool ParseTopLevelChunks(size_t num_threads);
+
   // Information about parser internals.
 
   // True if input text has already been lexed.
@@ -93,6 +138,19 @@ class VerilogAnalyzer : public verible::FileAnalyzer {
   // Maximum symbol stack depth.
   size_t max_used_stack_size_;
 
+  // Number of concurrent parses; unset means --verilog_parse_jobs.
+  absl::optional<int> parse_jobs_;
+
+  // Ends of top-level declarations, as verified by the LexicalContext, that
+  // are candidate places for ParseTopLevelChunks() to cut.
+  std::vector<const verible::TokenInfo*> top_level_ends_;
+
+  // Preprocessing steps; unset means the ones selected by flags.
+  absl::optional<VerilogPreprocess::Config> preprocess_config_;
+
+  // Opens `included files for the preprocessor, if set.
+  IncludeFileOpener include_file_opener_;
+
   // Preprocessor.
   VerilogPreprocessData preprocessor_data_;
 
@@ -0,0 +1,47 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures VerilogAnalyzer::Analyze(), which lexes, preprocesses and parses.
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "verilog/analysis/verilog_analyzer.h"
+#include "verilog/tools/corpus/benchmark_corpus.h"
+#include "verilog/tools/corpus/corpus_benchmark_args.h"
+
+namespace verilog {
+namespace {
+
+void BM_VerilogAnalyzerAnalyze(benchmark::State& state) {
+  const std::string source(
+      corpus::GenerateSource(corpus::CorpusBenchmarkOptions(state)));
+  for (auto _ : state) {
+    VerilogAnalyzer analyzer(source, "benchmark.sv");
+    const auto status = analyzer.Analyze();
+    if (!status.ok()) {
+      state.SkipWithError(status.ToString().c_str());
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_VerilogAnalyzerAnalyze)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace verilog
+
+BENCHMARK_MAIN();
@@ -24,6 +24,7 @@
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "common/analysis/file_analyzer.h"
@@ -36,6 +37,7 @@
 #include "common/text/token_info.h"
 #include "common/text/token_info_test_util.h"
 #include "common/text/token_stream_view.h"
+#include "common/text/tree_compare.h"
 #include "common/text/tree_utils.h"
 #include "common/util/casts.h"
 #include "common/util/logging.h"
@@ -812,5 +814,44 @@ TEST_F(VerilogAnalyzerInternalsTest, ScanParsingModeDirective) {
   }
 }
 
+// Returns enough independent modules to be parsed in several chunks.
+std::string ManyModules(int count) {
+  std::string text;
+  for (int i = 0; i < count; ++i) {
+    absl::StrAppend(&text, "module m", i, "(input a, output b);\n",
+                    "  assign b = a;\n", "endmodule : m", i, "\n");
+  }
+  return text;
+}
+
+TEST(AnalyzeVerilogTest, ParseInChunksMatchesSerialParse) {
+  // Enough tokens for four chunks.
+  const std::string text = ManyModules(
+      4 * VerilogAnalyzer::kMinTokensPerParseChunk / 20 + 1);
+  VerilogAnalyzer serial(text, "<file>");
+  serial.SetParseJobs(1);
+  ASSERT_OK(serial.Analyze());
+  VerilogAnalyzer chunked(text, "<file>");
+  chunked.SetParseJobs(4);
+  ASSERT_OK(chunked.Analyze());
+  EXPECT_TRUE(verible::EqualTreesByEnumString(serial.SyntaxTree().get(),
+                                              chunked.SyntaxTree().get()));
+}
+
+TEST(AnalyzeVerilogTest, ParseInChunksReportsSerialSyntaxErrors) {
+  const int count = 4 * VerilogAnalyzer::kMinTokensPerParseChunk / 20 + 1;
+  std::string text = ManyModules(count / 2);
+  absl::StrAppend(&text, "module bad; wire; endmodule\n",
+                  ManyModules(count / 2));
+  VerilogAnalyzer serial(text, "<file>");
+  serial.SetParseJobs(1);
+  EXPECT_FALSE(serial.Analyze().ok());
+  VerilogAnalyzer chunked(text, "<file>");
+  chunked.SetParseJobs(4);
+  EXPECT_FALSE(chunked.Analyze().ok());
+  EXPECT_EQ(serial.LinterTokenErrorMessages(false),
+            chunked.LinterTokenErrorMessages(false));
+}
+
 }  // namespace
 }  // namespace verilog
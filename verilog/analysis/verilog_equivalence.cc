@@ -21,10 +21,14 @@
 #include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <utility>
 
+#include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
-#include "common/lexer/token_stream_adapter.h"
+#include "common/lexer/lexer.h"
 #include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
 #include "common/util/enum_flags.h"
@@ -53,31 +57,6 @@ std::ostream& operator<<(std::ostream& stream, DiffStatus status) {
   return kDiffStatusStringMap.Unparse(status, stream);
 }
 
-// Lex a token into smaller substrings/subtokens.
-// Lexical errors are reported to errstream.
-// Returns true if lexing succeeded, false on error.
-static bool LexText(absl::string_view text, TokenSequence* subtokens,
-                    std::ostream* errstream) {
-  VLOG(1) << __FUNCTION__;
-  VerilogLexer lexer(text);
-  // Reservation slot to capture first error token, if any.
-  auto err_tok = TokenInfo::EOFToken(text);
-  // Lex token's text into subtokens.
-  const auto status = MakeTokenSequence(
-      &lexer, text, subtokens, [&](const TokenInfo& err) { err_tok = err; });
-  if (!status.ok()) {
-    VLOG(1) << "lex error on: " << err_tok;
-    if (errstream != nullptr) {
-      (*errstream) << "Error lexing text: " << text << std::endl
-                   << "subtoken: " << err_tok << std::endl
-                   << status.message() << std::endl;
-      // TODO(fangism): print relative offsets
-    }
-    return false;
-  }
-  return true;
-}
-
 static void VerilogTokenPrinter(const TokenInfo& token, std::ostream& stream) {
   stream << '(' << verilog_symbol_name(token.token_enum()) << ") " << token;
 }
@@ -93,10 +72,10 @@ DiffStatus VerilogLexicallyEquivalent(
         equal_comparator,
     std::ostream* errstream) {
   // Bind some Verilog-specific parameters.
-  return LexicallyEquivalent(
+  return StreamingLexicallyEquivalent(
       left, right,
-      [=](absl::string_view text, TokenSequence* tokens) {
-        return LexText(text, tokens, errstream);
+      [](absl::string_view text) -> std::unique_ptr<verible::Lexer> {
+        return absl::make_unique<VerilogLexer>(text);
       },
       ShouldRecursivelyAnalyzeToken,  //
       remove_predicate,               //
@@ -233,6 +212,145 @@ DiffStatus LexicallyEquivalent(
   return DiffStatus::kDifferent;
 }
 
+namespace {
+// Lexes one input of StreamingLexicallyEquivalent on demand, skipping removed
+// tokens.
+class SignificantTokenStream {
+ public:
+  SignificantTokenStream(
+      absl::string_view text, std::unique_ptr<verible::Lexer> lexer,
+      const std::function<bool(const TokenInfo&)>& remove_predicate)
+      : text_(text),
+        lexer_(std::move(lexer)),
+        remove_predicate_(remove_predicate) {}
+
+  // Lexes the next significant token into Current().  Returns false if it is
+  // a lexical error.  Must not be called after reaching EOF.
+  bool Advance() {
+    do {
+      current_ = lexer_->DoNextToken();
+      if (lexer_->TokenIsError(current_)) return false;
+    } while (!current_.isEOF() && remove_predicate_(current_));
+    // Like MakeTokenSequence, point EOF to the end of the text.
+    if (current_.isEOF()) current_ = TokenInfo::EOFToken(text_);
+    return true;
+  }
+
+  const TokenInfo& Current() const { return current_; }
+
+  // Adds the number of significant tokens after Current(), up to and
+  // including EOF, to 'count'.  Returns false on a lexical error.
+  bool CountRemaining(size_t* count) {
+    while (!current_.isEOF()) {
+      if (!Advance()) return false;
+      ++*count;
+    }
+    return true;
+  }
+
+ private:
+  const absl::string_view text_;
+  const std::unique_ptr<verible::Lexer> lexer_;
+  const std::function<bool(const TokenInfo&)>& remove_predicate_;
+  TokenInfo current_ = TokenInfo::EOFToken();
+};
+
+void ReportLexicalError(const TokenInfo& error_token, absl::string_view side,
+                        std::ostream* errstream) {
+  VLOG(1) << "lex error on: " << error_token;
+  if (errstream == nullptr) return;
+  *errstream << "Lexical error from " << side
+             << " input text at subtoken: " << error_token << std::endl;
+}
+}  // namespace
+
+DiffStatus StreamingLexicallyEquivalent(
+    absl::string_view left_text, absl::string_view right_text,
+    const std::function<std::unique_ptr<verible::Lexer>(absl::string_view)>&
+        make_lexer,
+    const std::function<bool(const verible::TokenInfo&)>& recursion_predicate,
+    const std::function<bool(const verible::TokenInfo&)>& remove_predicate,
+    const std::function<bool(const verible::TokenInfo&,
+                             const verible::TokenInfo&)>& equal_comparator,
+    const std::function<void(const verible::TokenInfo&, std::ostream&)>&
+        token_printer,
+    std::ostream* errstream) {
+  VLOG(2) << __FUNCTION__;
+  SignificantTokenStream left(left_text, make_lexer(left_text),
+                              remove_predicate);
+  SignificantTokenStream right(right_text, make_lexer(right_text),
+                               remove_predicate);
+  for (size_t index = 0;; ++index) {
+    if (!left.Advance()) {
+      ReportLexicalError(left.Current(), "left", errstream);
+      return DiffStatus::kLeftError;
+    }
+    if (!right.Advance()) {
+      ReportLexicalError(right.Current(), "right", errstream);
+      return DiffStatus::kRightError;
+    }
+    const TokenInfo& l = left.Current();
+    const TokenInfo& r = right.Current();
+
+    // Explanation of a difference, only collected for errstream.
+    std::string details;
+    bool equal;
+    if (l.token_enum() != r.token_enum()) {
+      equal = false;
+      if (errstream != nullptr) {
+        std::ostringstream stream;
+        stream << "Mismatched token enums.  got: ";
+        token_printer(l, stream);
+        stream << " vs. ";
+        token_printer(r, stream);
+        stream << std::endl;
+        details = stream.str();
+      }
+    } else if (recursion_predicate(l)) {
+      // Recursively lex and compare.
+      VLOG(1) << "recursively lex-ing and comparing";
+      std::ostringstream stream;
+      const DiffStatus status = StreamingLexicallyEquivalent(
+          l.text(), r.text(), make_lexer, recursion_predicate,
+          remove_predicate, equal_comparator, token_printer,
+          errstream != nullptr ? &stream : nullptr);
+      if (status == DiffStatus::kLeftError ||
+          status == DiffStatus::kRightError) {
+        if (errstream != nullptr) *errstream << stream.str();
+        return status;
+      }
+      equal = status == DiffStatus::kEquivalent;
+      details = stream.str();
+    } else {
+      equal = equal_comparator(l, r);  // non-recursive comparator
+    }
+
+    if (equal) {
+      if (l.isEOF()) return DiffStatus::kEquivalent;  // both at end
+      continue;
+    }
+    if (errstream != nullptr) {
+      // Copy the mismatched tokens, before lexing the rest of both inputs
+      // (in constant memory) to report their lengths.
+      const TokenInfo left_token(l);
+      const TokenInfo right_token(r);
+      size_t l_size = index + 1;
+      size_t r_size = index + 1;
+      if (left.CountRemaining(&l_size) && right.CountRemaining(&r_size) &&
+          l_size != r_size) {
+        *errstream << "Mismatch in token sequence lengths: " << l_size
+                   << " vs. " << r_size << std::endl;
+      }
+      *errstream << details << "First mismatched token [" << index << "]: ";
+      token_printer(left_token, *errstream);
+      *errstream << " vs. ";
+      token_printer(right_token, *errstream);
+      *errstream << std::endl;
+    }
+    return DiffStatus::kDifferent;
+  }
+}
+
 DiffStatus FormatEquivalent(absl::string_view left, absl::string_view right,
                             std::ostream* errstream) {
   return VerilogLexicallyEquivalent(
@@ -17,8 +17,10 @@
 
 #include <functional>
 #include <iosfwd>
+#include <memory>
 
 #include "absl/strings/string_view.h"
+#include "common/lexer/lexer.h"
 #include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
 
@@ -54,8 +56,28 @@ DiffStatus LexicallyEquivalent(
     std::function<void(const verible::TokenInfo&, std::ostream&)> token_printer,
     std::ostream* errstream = nullptr);
 
+// Same as LexicallyEquivalent, but lexes both inputs in lockstep, one token
+// at a time from lexers created by 'make_lexer', and stops at the first
+// difference, so that memory use does not grow with the size of the inputs.
+// Unlike LexicallyEquivalent, lexical errors that follow the first difference
+// are not detected, so such inputs compare kDifferent (instead of k*Error).
+// Only when errstream is provided are the remaining tokens lexed (and counted)
+// for the report on a difference.
+DiffStatus StreamingLexicallyEquivalent(
+    absl::string_view left, absl::string_view right,
+    const std::function<std::unique_ptr<verible::Lexer>(absl::string_view)>&
+        make_lexer,
+    const std::function<bool(const verible::TokenInfo&)>& recursion_predicate,
+    const std::function<bool(const verible::TokenInfo&)>& remove_predicate,
+    const std::function<bool(const verible::TokenInfo&,
+                             const verible::TokenInfo&)>& equal_comparator,
+    const std::function<void(const verible::TokenInfo&, std::ostream&)>&
+        token_printer,
+    std::ostream* errstream = nullptr);
+
 // Returns a DiffStatus that captures 'equivalence' ignoring tokens filtered
 // out by remove_predicate, and using the equal_comparator binary predicate.
+// Compares with StreamingLexicallyEquivalent.
 // If errstream is provided, print detailed error message to that stream.
 DiffStatus VerilogLexicallyEquivalent(
     absl::string_view left, absl::string_view right,
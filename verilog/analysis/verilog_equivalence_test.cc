@@ -16,10 +16,12 @@
 
 #include <iostream>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "common/text/token_info.h"
@@ -346,6 +348,38 @@ struct ObfuscationTestCase {
   DiffStatus expect_match;
 };
 
+TEST(FormatEquivalentTest, StopsAtFirstDifference) {
+  // Lexical errors after the first difference are not examined.
+  std::ostringstream errs;
+  ExpectCompareWithErrstream(FormatEquivalent, DiffStatus::kDifferent,
+                             "module foo; 123badid", "module bar; good_id",
+                             &errs);
+  EXPECT_TRUE(absl::StrContains(errs.str(), "First mismatched token [1]:"))
+      << "full message:\n"
+      << errs.str();
+  // Without a stream to report to, nothing after the difference is lexed.
+  EXPECT_EQ(FormatEquivalent("module foo; 123badid", "module bar; good_id"),
+            DiffStatus::kDifferent);
+}
+
+TEST(FormatEquivalentTest, ManyTokens) {
+  std::string left, right;
+  for (int i = 0; i < 10000; ++i) {
+    absl::StrAppend(&left, "wire w", i, ";\n");
+    absl::StrAppend(&right, "  wire  w", i, " ;");
+  }
+  ExpectCompareWithErrstream(FormatEquivalent, DiffStatus::kEquivalent, left,
+                             right);
+  absl::StrAppend(&right, " extra");
+  std::ostringstream errs;
+  ExpectCompareWithErrstream(FormatEquivalent, DiffStatus::kDifferent, left,
+                             right, &errs);
+  EXPECT_TRUE(absl::StrContains(
+      errs.str(), "Mismatch in token sequence lengths: 30001 vs. 30002"))
+      << "full message:\n"
+      << errs.str();
+}
+
 TEST(ObfuscationEquivalentTest, Various) {
   const ObfuscationTestCase kTestCases[] = {
       {"", "", DiffStatus::kEquivalent},
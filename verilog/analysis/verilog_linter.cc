@@ -31,6 +31,7 @@
 #include "absl/strings/string_view.h"
 #include "common/analysis/line_lint_rule.h"
 #include "common/analysis/line_linter.h"
+#include "common/analysis/lint_rule_profile.h"
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/lint_waiver.h"
 #include "common/analysis/syntax_tree_lint_rule.h"
@@ -46,6 +47,7 @@
 #include "common/text/token_info.h"
 #include "common/util/file_util.h"
 #include "common/util/logging.h"
+#include "common/util/phase_stats.h"
 #include "common/util/user_interaction.h"
 #include "verilog/analysis/default_rules.h"
 #include "verilog/analysis/lint_rule_registry.h"
@@ -380,6 +382,14 @@ absl::Status VerilogLinter::Configure(const LinterConfiguration& configuration,
     syntax_tree_linter_.AddRule(std::move(rule));
   }
 
+  profile_ = verible::GlobalLintRuleProfile();
+  if (profile_ != nullptr) {
+    text_structure_linter_.EnableProfiling();
+    line_linter_.EnableProfiling();
+    token_stream_linter_.EnableProfiling();
+    syntax_tree_linter_.EnableProfiling();
+  }
+
   absl::Status rc = absl::OkStatus();
   for (const auto& waiver_file :
        absl::StrSplit(configuration.external_waivers, ',', absl::SkipEmpty())) {
@@ -403,24 +413,47 @@ absl::Status VerilogLinter::Configure(const LinterConfiguration& configuration,
 void VerilogLinter::Lint(const TextStructureView& text_structure,
                          absl::string_view filename) {
   // Collect all lint waivers in an initial pass.
-  lint_waiver_.ProcessTokenRangesByLine(text_structure);
+  {
+    const verible::ScopedPhase phase("lint-waivers");
+    lint_waiver_.ProcessTokenRangesByLine(text_structure);
+  }
 
   // Analyze general text structure.
-  text_structure_linter_.Lint(text_structure, filename);
+  {
+    const verible::ScopedPhase phase("lint-text-structure");
+    text_structure_linter_.Lint(text_structure, filename);
+  }
 
   // Analyze lines of text.
-  line_linter_.Lint(text_structure.Lines());
+  {
+    const verible::ScopedPhase phase("lint-lines");
+    line_linter_.Lint(text_structure.Lines());
+  }
 
   // Analyze token stream.
-  token_stream_linter_.Lint(text_structure.TokenStream());
+  {
+    const verible::ScopedPhase phase("lint-token-stream");
+    token_stream_linter_.Lint(text_structure.TokenStream());
+  }
 
   // Analyze syntax tree.
   const verible::ConcreteSyntaxTree& syntax_tree = text_structure.SyntaxTree();
   if (syntax_tree != nullptr) {
+    const verible::ScopedPhase phase("lint-syntax-tree");
     syntax_tree_linter_.Lint(*syntax_tree);
   }
 }
 
+// Adds the 'costs' of the rules that reported 'statuses' to 'profile'.
+static void AddRuleCosts(const std::vector<LintRuleStatus>& statuses,
+                         const std::vector<verible::LintRuleCost>& costs,
+                         verible::LintRuleProfile* profile) {
+  CHECK_EQ(statuses.size(), costs.size());
+  for (size_t i = 0; i < statuses.size(); ++i) {
+    profile->Add(statuses[i].lint_rule_name, costs[i]);
+  }
+}
+
 static void AppendLintRuleStatuses(
     const std::vector<LintRuleStatus>& new_statuses,
     const verible::LintWaiver& waivers, const LineColumnMap& line_map,
@@ -452,14 +485,19 @@ std::vector<LintRuleStatus> VerilogLinter::ReportStatus(
     const LineColumnMap& line_map, absl::string_view text_base) {
   std::vector<LintRuleStatus> statuses;
   const verible::LintWaiver& waivers = lint_waiver_.GetLintWaiver();
-  AppendLintRuleStatuses(line_linter_.ReportStatus(), waivers, line_map,
-                         text_base, &statuses);
-  AppendLintRuleStatuses(text_structure_linter_.ReportStatus(), waivers,
-                         line_map, text_base, &statuses);
-  AppendLintRuleStatuses(token_stream_linter_.ReportStatus(), waivers, line_map,
-                         text_base, &statuses);
-  AppendLintRuleStatuses(syntax_tree_linter_.ReportStatus(), waivers, line_map,
-                         text_base, &statuses);
+  // Statuses carry the names of their rules, for profiling.
+  const auto append = [&](const std::vector<LintRuleStatus>& new_statuses,
+                          const std::vector<verible::LintRuleCost>& costs) {
+    if (profile_ != nullptr) AddRuleCosts(new_statuses, costs, profile_);
+    AppendLintRuleStatuses(new_statuses, waivers, line_map, text_base,
+                           &statuses);
+  };
+  append(line_linter_.ReportStatus(), line_linter_.RuleCosts());
+  append(text_structure_linter_.ReportStatus(),
+         text_structure_linter_.RuleCosts());
+  append(token_stream_linter_.ReportStatus(),
+         token_stream_linter_.RuleCosts());
+  append(syntax_tree_linter_.ReportStatus(), syntax_tree_linter_.RuleCosts());
   return statuses;
 }
 
@@ -489,13 +527,18 @@ absl::StatusOr<std::vector<LintRuleStatus>> VerilogLintTextStructure(
     const TextStructureView& text_structure, bool show_context) {
   // Create the linter, add rules, and run it.
   VerilogLinter linter;
-  const absl::Status configuration_status = linter.Configure(config, filename);
-  if (!configuration_status.ok()) {
-    return configuration_status;
+  {
+    const verible::ScopedPhase phase("lint-configure");
+    const absl::Status configuration_status =
+        linter.Configure(config, filename);
+    if (!configuration_status.ok()) {
+      return configuration_status;
+    }
   }
 
   linter.Lint(text_structure, filename);
 
+  const verible::ScopedPhase phase("lint-report");
   absl::string_view text_base = text_structure.Contents();
   // Each enabled lint rule yields a collection of violations.
   return linter.ReportStatus(text_structure.GetLineColumnMap(), text_base);
@@ -23,6 +23,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "common/analysis/line_linter.h"
+#include "common/analysis/lint_rule_profile.h"
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/lint_waiver.h"
 #include "common/analysis/syntax_tree_linter.h"
@@ -96,6 +97,8 @@ class VerilogLinter {
   VerilogLinter();
 
   // Configures the internal linters, enabling select rules.
+  // If there is a verible::GlobalLintRuleProfile(), also enables measuring the
+  // cost of each rule.
   absl::Status Configure(const LinterConfiguration& configuration,
                          absl::string_view lintee_filename);
 
@@ -104,6 +107,7 @@ class VerilogLinter {
             absl::string_view filename);
 
   // Reports lint findings.
+  // When profiling, adds the costs of all rules to the profile.
   std::vector<verible::LintRuleStatus> ReportStatus(
       const verible::LineColumnMap&, absl::string_view text_base);
 
@@ -122,6 +126,9 @@ class VerilogLinter {
 
   // Tracks the set of waived lines per rule.
   verible::LintWaiverBuilder lint_waiver_;
+
+  // Accumulates the costs of rules across linters, if profiling (not owned).
+  verible::LintRuleProfile* profile_ = nullptr;
 };
 
 // Creates a linter configuration from global flags.
@@ -0,0 +1,55 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures linting with all registered lint rules enabled.
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "common/util/logging.h"
+#include "verilog/analysis/verilog_analyzer.h"
+#include "verilog/analysis/verilog_linter.h"
+#include "verilog/analysis/verilog_linter_configuration.h"
+#include "verilog/tools/corpus/benchmark_corpus.h"
+#include "verilog/tools/corpus/corpus_benchmark_args.h"
+
+namespace verilog {
+namespace {
+
+void BM_VerilogLintAllRules(benchmark::State& state) {
+  const std::string source(
+      corpus::GenerateSource(corpus::CorpusBenchmarkOptions(state)));
+  VerilogAnalyzer analyzer(source, "benchmark.sv");
+  CHECK(analyzer.Analyze().ok());
+  LinterConfiguration config;
+  config.UseRuleSet(RuleSet::kAll);
+  for (auto _ : state) {
+    const auto statuses =
+        VerilogLintTextStructure("benchmark.sv", config, analyzer.Data());
+    if (!statuses.ok()) {
+      state.SkipWithError(statuses.status().ToString().c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(statuses->size());
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_VerilogLintAllRules)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace verilog
+
+BENCHMARK_MAIN();
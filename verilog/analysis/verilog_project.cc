@@ -15,6 +15,7 @@
 #include "verilog/analysis/verilog_project.h"
 
 #include <iostream>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -23,9 +24,12 @@
 #include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
+#include "common/strings/range.h"
 #include "common/text/text_structure.h"
 #include "common/util/file_util.h"
 #include "common/util/logging.h"
+#include "common/util/phase_stats.h"
+#include "common/util/thread_pool.h"
 #include "verilog/analysis/verilog_analyzer.h"
 
 namespace verilog {
@@ -37,6 +41,7 @@ VerilogSourceFile::VerilogSourceFile(absl::string_view referenced_path,
 absl::Status VerilogSourceFile::Open() {
   // Don't re-open.  analyzed_structure_ should be set/written once only.
   if (state_ != State::kInitialized) return status_;
+  const verible::ScopedStatsFile stats_file(ReferencedPath());
 
   // Load file contents.
   std::string content;
@@ -54,13 +59,20 @@ absl::Status VerilogSourceFile::Open() {
 absl::Status VerilogSourceFile::Parse() {
   // Parsed state is cached.
   if (state_ == State::kParsed) return status_;
+  const verible::ScopedStatsFile stats_file(ReferencedPath());
 
   // Open file and load contents if not already done.
   status_ = Open();
   if (!status_.ok()) return status_;
 
   // Lex, parse, populate underlying TextStructureView.
+  if (include_file_opener_) {
+    analyzed_structure_->SetIncludeFileOpener(include_file_opener_);
+  }
   status_ = analyzed_structure_->Analyze();
+  // Project analyses only need the syntax tree from here on, so keep the
+  // tokens of files in compact form.
+  analyzed_structure_->CompactTokens();
   state_ = State::kParsed;
   return status_;
 }
@@ -84,6 +96,9 @@ std::ostream& operator<<(std::ostream& stream,
 }
 
 absl::Status InMemoryVerilogSourceFile::Open() {
+  // Don't re-open, contents may have been replaced by
+  // VerilogProject::UpdateFileContents().
+  if (state_ != State::kInitialized) return status_;
   analyzed_structure_ = ABSL_DIE_IF_NULL(
       absl::make_unique<VerilogAnalyzer>(contents_for_open_, ResolvedPath()));
   state_ = State::kOpened;
@@ -117,13 +132,18 @@ absl::StatusOr<VerilogSourceFile*> VerilogProject::OpenFile(
   CHECK(inserted.second);  // otherwise, would have already returned above
   const auto file_iter = inserted.first;
   VerilogSourceFile& file(*file_iter->second);
+  file.include_file_opener_ = include_file_opener_;
 
   // Read the file's contents.
   const absl::Status status = file.Open();
   if (!status.ok()) return status;
 
-  const absl::string_view contents(file.GetTextStructure()->Contents());
+  RegisterFileContents(file.GetTextStructure()->Contents(), file_iter);
+  return &file;
+}
 
+void VerilogProject::RegisterFileContents(
+    absl::string_view contents, file_set_type::const_iterator file_iter) {
   // Register the file's contents range in string_view_map_.
   string_view_map_.must_emplace(contents);
 
@@ -132,8 +152,24 @@ absl::StatusOr<VerilogSourceFile*> VerilogProject::OpenFile(
   const auto map_inserted =
       buffer_to_analyzer_map_.emplace(contents.begin(), file_iter);
   CHECK(map_inserted.second);
+}
 
-  return &file;
+void VerilogProject::UnregisterFileContents(
+    file_set_type::const_iterator file_iter) {
+  for (auto iter = buffer_to_analyzer_map_.begin();
+       iter != buffer_to_analyzer_map_.end(); ++iter) {
+    if (iter->second != file_iter) continue;
+    // Lookup the whole range by its first character.  Empty ranges can never
+    // be found, and thus need no removal.
+    const auto found_range = string_view_map_.find(
+        verible::make_string_view_range(iter->first, iter->first + 1));
+    if (found_range != string_view_map_.end()) {
+      string_view_map_.must_erase(verible::make_string_view_range(
+          found_range->first, found_range->second));
+    }
+    buffer_to_analyzer_map_.erase(iter);
+    return;
+  }
 }
 
 absl::StatusOr<VerilogSourceFile*> VerilogProject::OpenTranslationUnit(
@@ -152,7 +188,71 @@ absl::StatusOr<VerilogSourceFile*> VerilogProject::OpenTranslationUnit(
   const std::string resolved_filename =
       verible::file::JoinPath(TranslationUnitRoot(), referenced_filename);
 
-  return OpenFile(referenced_filename, resolved_filename, Corpus());
+  const auto file_or_status =
+      OpenFile(referenced_filename, resolved_filename, Corpus());
+  if (file_or_status.ok()) translation_units_.push_back(*file_or_status);
+  return file_or_status;
+}
+
+absl::Status VerilogProject::OpenTranslationUnits(
+    const std::vector<std::string>& referenced_filenames, int jobs) {
+  // The file map and the string range registry are not thread-safe, so only
+  // reading files is done concurrently.  Entries are created first, and their
+  // contents are registered afterwards.
+  std::vector<file_set_type::iterator> new_files;
+  for (const auto& referenced_filename : referenced_filenames) {
+    if (files_.find(referenced_filename) != files_.end()) continue;
+    const auto inserted = files_.emplace(
+        referenced_filename,
+        absl::make_unique<VerilogSourceFile>(
+            referenced_filename,
+            verible::file::JoinPath(TranslationUnitRoot(), referenced_filename),
+            Corpus()));
+    inserted.first->second->include_file_opener_ = include_file_opener_;
+    new_files.push_back(inserted.first);
+  }
+
+  {
+    verible::ThreadPool pool(verible::ThreadPool::ThreadsForJobs(jobs));
+    for (const auto& file_iter : new_files) {
+      VerilogSourceFile* file = file_iter->second.get();
+      // Errors are retained in each file's Status().
+      pool.Schedule([file]() { file->Open().IgnoreError(); });
+    }
+  }  // wait for all files to be read
+
+  for (const auto& file_iter : new_files) {
+    VerilogSourceFile* file = file_iter->second.get();
+    if (!file->Status().ok()) continue;
+    RegisterFileContents(file->GetTextStructure()->Contents(), file_iter);
+    translation_units_.push_back(file);
+  }
+
+  for (const auto& referenced_filename : referenced_filenames) {
+    const auto status = files_.find(referenced_filename)->second->Status();
+    if (!status.ok()) return status;
+  }
+  return absl::OkStatus();
+}
+
+void VerilogProject::ParseAll(int jobs) {
+  ParseFiles(translation_units_, jobs);
+}
+
+void VerilogProject::ParseFiles(const std::vector<VerilogSourceFile*>& files,
+                                int jobs) {
+  VLOG(1) << __FUNCTION__ << ": " << files.size() << " files";
+  // Parsing does not touch any state shared between files, except for the
+  // project's registry of file contents, which only Open() would modify, and
+  // the thread-safe cache of `included files.
+  // Hence, unopened files are skipped, and each file is parsed only once.
+  std::set<VerilogSourceFile*> scheduled;
+  verible::ThreadPool pool(verible::ThreadPool::ThreadsForJobs(jobs));
+  for (VerilogSourceFile* file : files) {
+    if (file == nullptr || file->GetTextStructure() == nullptr) continue;
+    if (!scheduled.insert(file).second) continue;
+    pool.Schedule([file]() { file->Parse().IgnoreError(); });
+  }
 }
 
 absl::Status VerilogProject::IncludeFileNotFoundError(
@@ -201,16 +301,32 @@ void VerilogProject::AddVirtualFile(absl::string_view referenced_filename,
       referenced_filename, absl::make_unique<InMemoryVerilogSourceFile>(
                                referenced_filename, content));
   CHECK(inserted.second);
-  const auto file_iter = inserted.first;
+  inserted.first->second->include_file_opener_ = include_file_opener_;
+  RegisterFileContents(content, inserted.first);
+}
 
-  // Register the file's contents range in string_view_map_.
-  string_view_map_.must_emplace(content);
+absl::Status VerilogProject::UpdateFileContents(
+    absl::string_view referenced_filename, absl::string_view contents) {
+  const auto file_iter = files_.find(referenced_filename);
+  if (file_iter == files_.end()) {
+    return absl::NotFoundError(
+        absl::StrCat("File '", referenced_filename, "' is not registered."));
+  }
+  VerilogSourceFile& file(*file_iter->second);
+  if (file.analyzed_structure_ == nullptr &&
+      file.GetTextStructure() != nullptr) {
+    return absl::FailedPreconditionError(
+        absl::StrCat("Contents of file '", referenced_filename,
+                     "' are not managed by this project."));
+  }
 
-  // Map the start of the file's contents to its corresponding owner
-  // VerilogSourceFile.
-  const auto map_inserted =
-      buffer_to_analyzer_map_.emplace(content.begin(), file_iter);
-  CHECK(map_inserted.second);
+  UnregisterFileContents(file_iter);
+  file.analyzed_structure_ =
+      absl::make_unique<VerilogAnalyzer>(contents, file.ResolvedPath());
+  file.state_ = VerilogSourceFile::State::kOpened;
+  file.status_ = absl::OkStatus();
+  RegisterFileContents(file.GetTextStructure()->Contents(), file_iter);
+  return file.status_;
 }
 
 std::vector<absl::Status> VerilogProject::GetErrorStatuses() const {
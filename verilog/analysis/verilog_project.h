@@ -26,6 +26,7 @@
 #include "common/strings/string_memory_map.h"
 #include "common/text/text_structure.h"
 #include "verilog/analysis/verilog_analyzer.h"
+#include "verilog/preprocessor/verilog_include_cache.h"
 
 namespace verilog {
 
@@ -63,7 +64,8 @@ class VerilogSourceFile {
   virtual absl::Status Parse();
 
   // After Open(), the underlying text structure contains at least the file's
-  // contents.  After Parse(), it may contain other analyzed structural forms.
+  // contents.  After Parse(), it may contain other analyzed structural forms,
+  // with its tokens in compact form (see TextStructureView::CompactTokens()).
   // Before Open(), this returns nullptr.
   virtual const verible::TextStructureView* GetTextStructure() const;
 
@@ -142,6 +144,10 @@ class VerilogSourceFile {
   // Holds the file's string contents in owned memory, along with other forms
   // like token streams and syntax tree.
   std::unique_ptr<VerilogAnalyzer> analyzed_structure_;
+
+  // Lets Parse() follow `include directives (see
+  // VerilogAnalyzer::SetIncludeFileOpener()), if set.
+  IncludeFileOpener include_file_opener_;
 };
 
 // Printable representation for debugging.
@@ -214,7 +220,8 @@ class VerilogProject {
                  absl::string_view corpus = "")
       : translation_unit_root_(root),
         include_paths_(include_paths),
-        corpus_(corpus) {}
+        corpus_(corpus),
+        include_file_opener_(include_cache_.MakeOpener(include_paths_)) {}
 
   VerilogProject(const VerilogProject&) = delete;
   VerilogProject(VerilogProject&&) = delete;
@@ -240,6 +247,25 @@ class VerilogProject {
   absl::StatusOr<VerilogSourceFile*> OpenTranslationUnit(
       absl::string_view referenced_filename);
 
+  // Opens several translation units, like OpenTranslationUnit(), reading up to
+  // 'jobs' files concurrently (see verible::ThreadPool::ThreadsForJobs()).
+  // All files are attempted.  Returns the first error in the order of
+  // 'referenced_filenames'.
+  absl::Status OpenTranslationUnits(
+      const std::vector<std::string>& referenced_filenames, int jobs);
+
+  // Parses all successfully opened translation units (in the order in which
+  // they were opened) that are not yet parsed, using up to 'jobs' threads.
+  // Each file owns an independent analyzer, so the results are the same as
+  // calling VerilogSourceFile::Parse() on each file in sequence.
+  // Parse errors are retained in each file's Status().
+  void ParseAll(int jobs);
+
+  // Like ParseAll(), but only for 'files', which must belong to this project.
+  // Null entries and files that are not opened (or failed to open) are
+  // skipped.
+  void ParseFiles(const std::vector<VerilogSourceFile*>& files, int jobs);
+
   // Opens a file that was `included.
   // If the file was previously opened, that data is returned.
   absl::StatusOr<VerilogSourceFile*> OpenIncludedFile(
@@ -249,6 +275,17 @@ class VerilogProject {
   void AddVirtualFile(absl::string_view referenced_filename,
                       absl::string_view content);
 
+  // Replaces the contents of a previously registered file, as if it were
+  // re-opened with 'contents' (which are copied).  The VerilogSourceFile object
+  // remains the same, but needs to be Parse()d again.
+  // Any string_views into the previous contents are invalidated, so all
+  // structures derived from them (e.g. SymbolTable contributions, see
+  // SymbolTable::RemoveTranslationUnit()) must be released before calling this.
+  // Files whose text structure is managed externally
+  // (ParsedVerilogSourceFile) cannot be updated.
+  absl::Status UpdateFileContents(absl::string_view referenced_filename,
+                                  absl::string_view contents);
+
   // Returns a collection of non-ok diagnostics for the entire project.
   std::vector<absl::Status> GetErrorStatuses() const;
 
@@ -273,11 +310,24 @@ class VerilogProject {
   const VerilogSourceFile* LookupFileOrigin(
       absl::string_view content_substring) const;
 
+  // Returns the cache of `included files that the preprocessing of this
+  // project's files shares.
+  const VerilogIncludeCache& IncludeCache() const { return include_cache_; }
+
  private:
   absl::StatusOr<VerilogSourceFile*> OpenFile(
       absl::string_view referenced_filename,
       absl::string_view resolved_filename, absl::string_view corpus);
 
+  // Registers the memory range of 'contents' as belonging to 'file_iter',
+  // for reverse lookup by LookupFileOrigin().
+  void RegisterFileContents(absl::string_view contents,
+                            file_set_type::const_iterator file_iter);
+
+  // Removes the memory range registration of the file at 'file_iter', if it
+  // has one.
+  void UnregisterFileContents(file_set_type::const_iterator file_iter);
+
   // Error status factory, when include file is not found.
   absl::Status IncludeFileNotFoundError(
       absl::string_view referenced_filename) const;
@@ -296,9 +346,20 @@ class VerilogProject {
   // 'github.com/google/verible').
   const std::string corpus_;
 
+  // `included files that were lexed for preprocessing the files of this
+  // project, which are shared by all of them, so that each is lexed once.
+  VerilogIncludeCache include_cache_;
+
+  // Opens `included files from include_paths_ through include_cache_, for
+  // the preprocessing of every file that this project opens.
+  const IncludeFileOpener include_file_opener_;
+
   // Set of opened files, keyed by referenced (not resolved) filename.
   file_set_type files_;
 
+  // Successfully opened translation units, in the order they were opened.
+  std::vector<VerilogSourceFile*> translation_units_;
+
   // Maps any string_view (substring) to its full source file text
   // (superstring).
   verible::StringViewSuperRangeMap string_view_map_;
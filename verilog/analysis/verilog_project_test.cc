@@ -14,8 +14,13 @@
 
 #include "verilog/analysis/verilog_project.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "absl/memory/memory.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "common/text/text_structure.h"
 #include "common/util/file_util.h"
 #include "common/util/logging.h"
@@ -23,6 +28,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "verilog/CST/module.h"
+#include "verilog/preprocessor/verilog_include_cache.h"
 
 namespace verilog {
 namespace {
@@ -97,6 +103,11 @@ TEST(VerilogSourceFileTest, ParseValidFile) {
   EXPECT_NE(tokens, nullptr);
   const auto* tree = &text_structure->SyntaxTree();
   EXPECT_NE(tree, nullptr);
+  // Tokens are kept in compact form.
+  EXPECT_TRUE(tokens->empty());
+  const auto* compact_tokens = text_structure->GetCompactTokens();
+  ASSERT_NE(compact_tokens, nullptr);
+  EXPECT_EQ(compact_tokens->tokens[0].text(), "localparam");
 
   // Re-parsing doesn't change anything
   EXPECT_TRUE(file.Parse().ok());
@@ -104,6 +115,7 @@ TEST(VerilogSourceFileTest, ParseValidFile) {
   EXPECT_EQ(file.GetTextStructure(), text_structure);
   EXPECT_EQ(&text_structure->TokenStream(), tokens);
   EXPECT_EQ(&text_structure->SyntaxTree(), tree);
+  EXPECT_EQ(text_structure->GetCompactTokens(), compact_tokens);
 }
 
 TEST(VerilogSourceFileTest, ParseInvalidFile) {
@@ -311,6 +323,56 @@ TEST(VerilogProjectTest, LookupFileOriginTest) {
             verilog_source_file2);
 }
 
+TEST(VerilogProjectTest, UpdateFileContents) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, "srcs");
+  EXPECT_TRUE(CreateDir(sources_dir).ok());
+  VerilogProject project(sources_dir, {});
+
+  EXPECT_FALSE(project.UpdateFileContents("not-registered.sv", "").ok());
+
+  const ScopedTestFile tf(sources_dir, "module m;\nendmodule\n");
+  const auto status_or_file =
+      project.OpenTranslationUnit(Basename(tf.filename()));
+  VerilogSourceFile* verilog_source_file = *status_or_file;
+  EXPECT_TRUE(verilog_source_file->Parse().ok());
+
+  constexpr absl::string_view new_text("class c;\nendclass\n");
+  EXPECT_TRUE(
+      project.UpdateFileContents(Basename(tf.filename()), new_text).ok());
+  // Same file object, with new contents.
+  EXPECT_EQ(project.LookupRegisteredFile(Basename(tf.filename())),
+            verilog_source_file);
+  const TextStructureView& text_structure(
+      *verilog_source_file->GetTextStructure());
+  EXPECT_EQ(text_structure.Contents(), new_text);
+  EXPECT_EQ(text_structure.SyntaxTree(), nullptr);  // not yet parsed
+
+  // New contents are registered for reverse lookup.
+  EXPECT_EQ(project.LookupFileOrigin(text_structure.Contents().substr(2, 4)),
+            verilog_source_file);
+  // The given text itself is not registered, only the file's copy of it.
+  EXPECT_EQ(project.LookupFileOrigin(new_text), nullptr);
+
+  EXPECT_TRUE(verilog_source_file->Parse().ok());
+  EXPECT_NE(verilog_source_file->GetTextStructure()->SyntaxTree(), nullptr);
+}
+
+TEST(VerilogProjectTest, UpdateVirtualFileContents) {
+  VerilogProject project(".", {});
+  project.AddVirtualFile("virtual.sv", "module m;\nendmodule\n");
+  EXPECT_TRUE(project.UpdateFileContents("virtual.sv", "module n;\n").ok());
+  const auto* file = project.LookupRegisteredFile("virtual.sv");
+  ASSERT_NE(file, nullptr);
+  ASSERT_NE(file->GetTextStructure(), nullptr);
+  EXPECT_EQ(file->GetTextStructure()->Contents(), "module n;\n");
+
+  // Opening does not revert to the original contents.
+  auto* mutable_file = project.LookupRegisteredFile("virtual.sv");
+  EXPECT_TRUE(mutable_file->Open().ok());
+  EXPECT_EQ(file->GetTextStructure()->Contents(), "module n;\n");
+}
+
 TEST(VerilogProjectTest, LookupFileOriginTestMoreFiles) {
   const auto tempdir = ::testing::TempDir();
   const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
@@ -401,6 +463,135 @@ TEST(VerilogProjectTest, ValidTranslationUnit) {
   }
 }
 
+TEST(VerilogProjectTest, OpenTranslationUnitsConcurrently) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  EXPECT_TRUE(CreateDir(sources_dir).ok());
+  VerilogProject project(sources_dir, {});
+
+  std::vector<std::unique_ptr<ScopedTestFile>> files;
+  std::vector<std::string> file_names;
+  for (int i = 0; i < 10; ++i) {
+    files.push_back(absl::make_unique<ScopedTestFile>(
+        sources_dir, absl::StrCat("module m", i, ";\nendmodule\n")));
+    file_names.emplace_back(Basename(files.back()->filename()));
+  }
+  // Previously opened files are not opened again.
+  const auto first_or_status = project.OpenTranslationUnit(file_names[3]);
+  ASSERT_TRUE(first_or_status.ok());
+  // Duplicates are harmless.
+  file_names.push_back(file_names[5]);
+
+  EXPECT_TRUE(project.OpenTranslationUnits(file_names, 4).ok());
+  EXPECT_TRUE(project.GetErrorStatuses().empty());
+  EXPECT_EQ(project.LookupRegisteredFile(file_names[3]), *first_or_status);
+  for (int i = 0; i < 10; ++i) {
+    const VerilogSourceFile* file = project.LookupRegisteredFile(file_names[i]);
+    ASSERT_NE(file, nullptr);
+    const absl::string_view contents(file->GetTextStructure()->Contents());
+    EXPECT_EQ(contents, absl::StrCat("module m", i, ";\nendmodule\n"));
+    // Contents are registered for reverse lookup.
+    EXPECT_EQ(project.LookupFileOrigin(contents.substr(7, 2)), file);
+  }
+}
+
+TEST(VerilogProjectTest, OpenTranslationUnitsReportsFirstError) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  EXPECT_TRUE(CreateDir(sources_dir).ok());
+  VerilogProject project(sources_dir, {});
+
+  const ScopedTestFile tf(sources_dir, "module m;\nendmodule\n");
+  const std::string existing(Basename(tf.filename()));
+  const auto status = project.OpenTranslationUnits(
+      {existing, "missing1.sv", "missing2.sv"}, 2);
+  EXPECT_FALSE(status.ok());
+  EXPECT_TRUE(absl::StrContains(status.message(), "missing1.sv"))
+      << status.message();
+  EXPECT_EQ(project.GetErrorStatuses().size(), 2);
+  // All files were attempted.
+  EXPECT_NE(project.LookupRegisteredFile(existing)->GetTextStructure(),
+            nullptr);
+}
+
+TEST(VerilogProjectTest, ParseAll) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  EXPECT_TRUE(CreateDir(sources_dir).ok());
+  VerilogProject project(sources_dir, {sources_dir});
+
+  const ScopedTestFile good1(sources_dir, "module m1;\nendmodule\n");
+  const ScopedTestFile good2(sources_dir, "module m2;\nendmodule\n");
+  const ScopedTestFile bad(sources_dir, "module 3;\nendmodule\n");
+  const ScopedTestFile include(sources_dir, "wire w;\n");
+  const std::vector<std::string> file_names{
+      std::string(Basename(good1.filename())),
+      std::string(Basename(good2.filename())),
+      std::string(Basename(bad.filename()))};
+  ASSERT_TRUE(project.OpenTranslationUnits(file_names, 2).ok());
+  const auto include_or_status =
+      project.OpenIncludedFile(Basename(include.filename()));
+  ASSERT_TRUE(include_or_status.ok());
+
+  for (const int jobs : {1, 3}) {
+    project.ParseAll(jobs);
+    for (int i = 0; i < 2; ++i) {
+      const VerilogSourceFile* file =
+          project.LookupRegisteredFile(file_names[i]);
+      EXPECT_TRUE(file->Status().ok()) << file->Status();
+      const auto* tree =
+          ABSL_DIE_IF_NULL(file->GetTextStructure()->SyntaxTree().get());
+      EXPECT_EQ(FindAllModuleDeclarations(*tree).size(), 1);
+    }
+    EXPECT_FALSE(project.LookupRegisteredFile(file_names[2])->Status().ok());
+    // Included files are not parsed on their own.
+    EXPECT_EQ((*include_or_status)->GetTextStructure()->SyntaxTree().get(),
+              nullptr);
+  }
+}
+
+TEST(VerilogProjectTest, ParseAllLexesSharedIncludeOnce) {
+  const auto tempdir = ::testing::TempDir();
+  const std::string sources_dir = JoinPath(tempdir, __FUNCTION__);
+  const std::string includes_dir = JoinPath(sources_dir, "includes");
+  EXPECT_TRUE(CreateDir(sources_dir).ok());
+  EXPECT_TRUE(CreateDir(includes_dir).ok());
+  VerilogProject project(sources_dir, {includes_dir});
+
+  const ScopedTestFile header(includes_dir,
+                              "`ifndef DEFS_SVH\n"
+                              "`define DEFS_SVH\n"
+                              "`define WIDTH 8\n"
+                              "`endif\n");
+  const std::string include_directive =
+      absl::StrCat("`include \"", Basename(header.filename()), "\"\n");
+  std::vector<std::unique_ptr<ScopedTestFile>> files;
+  std::vector<std::string> file_names;
+  for (int i = 0; i < 4; ++i) {
+    files.push_back(absl::make_unique<ScopedTestFile>(
+        sources_dir,
+        absl::StrCat(include_directive, include_directive, "module m", i,
+                     ";\n  wire [`WIDTH-1:0] w;\nendmodule\n")));
+    file_names.emplace_back(Basename(files.back()->filename()));
+  }
+  ASSERT_TRUE(project.OpenTranslationUnits(file_names, 2).ok());
+  // Concurrent first uses of the header might each lex it, so the first file
+  // is parsed on its own.
+  project.ParseFiles({project.LookupRegisteredFile(file_names[0])}, 1);
+  project.ParseAll(2);
+
+  for (const auto& file_name : file_names) {
+    const VerilogSourceFile* file = project.LookupRegisteredFile(file_name);
+    EXPECT_TRUE(file->Status().ok()) << file->Status();
+  }
+  // Every file opens the header once, because its second `include is skipped
+  // by the include guard, but the header is only lexed for the first file.
+  const VerilogIncludeCache& cache = project.IncludeCache();
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.misses(), 1);
+  EXPECT_EQ(cache.hits(), 3);
+}
+
 TEST(VerilogProjectTest, ValidIncludeFile) {
   const auto tempdir = ::testing::TempDir();
   const std::string sources_dir = JoinPath(tempdir, "srcs");
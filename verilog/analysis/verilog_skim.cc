@@ -0,0 +1,304 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/analysis/verilog_skim.h"
+
+#include <cstddef>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "common/text/compact_token_stream.h"
+#include "common/text/token_info.h"
+#include "common/util/logging.h"
+#include "verilog/parser/verilog_lexer.h"
+#include "verilog/parser/verilog_token_enum.h"
+
+namespace verilog {
+
+using verible::CompactTokenSequence;
+using verible::TokenInfo;
+
+namespace {
+
+// Appends names to a list, skipping the ones already in it.
+class UniqueNames {
+ public:
+  explicit UniqueNames(std::vector<absl::string_view>* names)
+      : names_(names) {}
+
+  void Add(absl::string_view name) {
+    if (seen_.insert(name).second) names_->push_back(name);
+  }
+
+ private:
+  std::vector<absl::string_view>* names_;
+  absl::flat_hash_set<absl::string_view> seen_;
+};
+
+bool IsIdentifier(int token_enum) {
+  return token_enum == SymbolIdentifier || token_enum == EscapedIdentifier;
+}
+
+// Returns the keyword that ends a declaration started by 'token_enum', or 0.
+int DeclarationEnd(int token_enum) {
+  switch (token_enum) {
+    case TK_module:
+    case TK_macromodule:
+      return TK_endmodule;
+    case TK_interface:
+      return TK_endinterface;
+    case TK_program:
+      return TK_endprogram;
+    case TK_primitive:
+      return TK_endprimitive;
+    case TK_package:
+      return TK_endpackage;
+    case TK_class:
+      return TK_endclass;
+    default:
+      return 0;
+  }
+}
+
+// Returns true if instances can appear in the body of a declaration that is
+// ended by 'end_keyword'.
+bool HasInstances(int end_keyword) {
+  return end_keyword == TK_endmodule || end_keyword == TK_endinterface ||
+         end_keyword == TK_endprogram;
+}
+
+bool IsDeclarationEnd(int token_enum) {
+  switch (token_enum) {
+    case TK_endmodule:
+    case TK_endinterface:
+    case TK_endprogram:
+    case TK_endprimitive:
+    case TK_endpackage:
+    case TK_endclass:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool StartsItem(int token_enum) {
+  switch (token_enum) {
+    case ';':
+    case TK_begin:
+    case TK_end:
+    case TK_generate:
+    case TK_endgenerate:
+    case TK_else:
+      return true;
+    default:
+      return false;
+  }
+}
+
+class Skimmer {
+ public:
+  Skimmer(const CompactTokenSequence& tokens, SkimmedSource* result)
+      : tokens_(tokens),
+        declarations_(&result->declarations),
+        package_references_(&result->package_references),
+        includes_(&result->includes),
+        instantiated_types_(&result->instantiated_types) {}
+
+  void Scan() {
+    bool item_start = false;
+    for (size_t i = 0; i < tokens_.size(); ++i) {
+      const int token_enum = Enum(i);
+      if (item_start && !open_declarations_.empty() &&
+          HasInstances(open_declarations_.back())) {
+        MatchInstance(i);
+      }
+      item_start = StartsItem(token_enum);
+
+      switch (token_enum) {
+        case PP_include:
+          if (Enum(i + 1) == TK_StringLiteral) {
+            const absl::string_view path = tokens_.text(i + 1);
+            if (path.length() >= 2) {
+              includes_.Add(path.substr(1, path.length() - 2));
+            }
+          }
+          break;
+        case TK_SCOPE_RES:
+          if (i > 0 && Enum(i - 1) == SymbolIdentifier) {
+            package_references_.Add(tokens_.text(i - 1));
+          }
+          break;
+        case TK_bind:
+          MatchBindInstance(i + 1);
+          break;
+        case TK_begin:
+        case TK_end:
+          // Skip block labels, so that the next item is recognized.
+          if (Enum(i + 1) == ':' && IsIdentifier(Enum(i + 2))) i += 2;
+          break;
+        default:
+          if (IsDeclarationEnd(token_enum)) {
+            CloseDeclaration(token_enum);
+          } else if (StartsDeclaration(i)) {
+            if (open_declarations_.empty()) MatchDeclarationName(i + 1);
+            if (!IsAlternativeHeader(i)) {
+              open_declarations_.push_back(DeclarationEnd(token_enum));
+            }
+          }
+      }
+    }
+  }
+
+ private:
+  // Returns the enum of the i'th token, or 0 (like EOF) if there is none.
+  int Enum(size_t i) const {
+    return i < tokens_.size() ? tokens_.token_enum(i) : 0;
+  }
+
+  bool StartsDeclaration(size_t i) const {
+    const int token_enum = Enum(i);
+    if (DeclarationEnd(token_enum) == 0) return false;
+    const int previous = i > 0 ? Enum(i - 1) : 0;
+    // 'extern module' declarations have no body.
+    if (previous == TK_extern) return false;
+    switch (token_enum) {
+      case TK_interface:
+        // 'interface class' is matched at 'class', and 'virtual interface'
+        // is a reference.
+        return Enum(i + 1) != TK_class && previous != TK_virtual;
+      case TK_class:
+        // 'typedef class' is a forward declaration.
+        return previous != TK_typedef;
+      default:
+        return true;
+    }
+  }
+
+  // Closes the innermost open declaration ended by 'end_keyword', and any
+  // declarations nested in it that were left open.
+  void CloseDeclaration(int end_keyword) {
+    for (size_t depth = open_declarations_.size(); depth > 0; --depth) {
+      if (open_declarations_[depth - 1] == end_keyword) {
+        open_declarations_.resize(depth - 1);
+        return;
+      }
+    }
+  }
+
+  // Returns true if the declaration keyword at token i is in the `else or
+  // `elsif branch of a preprocessor conditional, right after the header of
+  // another declaration of the same kind, like in:
+  //   `ifdef FOO
+  //   module m(input a);
+  //   `else
+  //   module m(input b);
+  //   `endif
+  // Only the first header opens a declaration then, because there is only
+  // one end keyword.
+  bool IsAlternativeHeader(size_t i) const {
+    if (open_declarations_.empty() ||
+        open_declarations_.back() != DeclarationEnd(Enum(i))) {
+      return false;
+    }
+    return (i >= 1 && Enum(i - 1) == PP_else) ||
+           (i >= 2 && Enum(i - 2) == PP_elsif);
+  }
+
+  // Records the declared name that starts at token i.
+  void MatchDeclarationName(size_t i) {
+    if (Enum(i) == TK_automatic || Enum(i) == TK_static) ++i;
+    if (IsIdentifier(Enum(i))) declarations_.Add(tokens_.text(i));
+  }
+
+  // Records an instance 'type [#(...)] name [...] (' that starts at token i.
+  void MatchInstance(size_t i) {
+    if (!IsIdentifier(Enum(i))) return;
+    const size_t type = i++;
+    if (Enum(i) == '#') {
+      ++i;
+      if (Enum(i) == '(') {
+        i = SkipBalanced(i, '(', ')');
+      } else {
+        ++i;  // delay value
+      }
+    }
+    if (!IsIdentifier(Enum(i))) return;
+    ++i;
+    while (Enum(i) == '[') i = SkipBalanced(i, '[', ']');
+    if (Enum(i) == '(') instantiated_types_.Add(tokens_.text(type));
+  }
+
+  // Records the instance of 'bind target[: instances] instance' that starts
+  // at token i (after 'bind').
+  void MatchBindInstance(size_t i) {
+    if (!IsIdentifier(Enum(i))) return;
+    ++i;
+    // Hierarchical target
+    while (Enum(i) == '.' && IsIdentifier(Enum(i + 1))) i += 2;
+    if (Enum(i) == ':') {
+      do {
+        i += 2;  // ':' or ',', and an instance name
+      } while (Enum(i) == ',');
+    }
+    MatchInstance(i);
+  }
+
+  // Returns the position after the 'close' that balances the 'open' at
+  // token i, or the end of tokens.
+  size_t SkipBalanced(size_t i, int open, int close) const {
+    int depth = 0;
+    for (; i < tokens_.size(); ++i) {
+      const int token_enum = Enum(i);
+      if (token_enum == open) {
+        ++depth;
+      } else if (token_enum == close && --depth == 0) {
+        return i + 1;
+      }
+    }
+    return i;
+  }
+
+  // Skimming mostly looks at token enums, which are stored densely here.
+  const CompactTokenSequence& tokens_;
+
+  UniqueNames declarations_;
+  UniqueNames package_references_;
+  UniqueNames includes_;
+  UniqueNames instantiated_types_;
+
+  // End keywords of the declarations that contain the current token.
+  std::vector<int> open_declarations_;
+};
+
+}  // namespace
+
+SkimmedSource SkimVerilogSource(absl::string_view text) {
+  VLOG(2) << __FUNCTION__;
+  CompactTokenSequence tokens(text);
+  VerilogLexer lexer(text);
+  while (true) {
+    const TokenInfo& token(lexer.DoNextToken());
+    if (token.isEOF()) break;
+    if (!VerilogLexer::KeepSyntaxTreeTokens(token)) continue;
+    if (lexer.TokenIsError(token)) continue;
+    tokens.push_back(token);
+  }
+
+  SkimmedSource result;
+  Skimmer(tokens, &result).Scan();
+  return result;
+}
+
+}  // namespace verilog
@@ -0,0 +1,58 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Lexer-only extraction of what a source file declares and references, for
+// fast dependency discovery without parsing or building a symbol table.
+
+#ifndef VERIBLE_VERILOG_ANALYSIS_VERILOG_SKIM_H_
+#define VERIBLE_VERILOG_ANALYSIS_VERILOG_SKIM_H_
+
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace verilog {
+
+// Names found in a source file by SkimVerilogSource().
+// Each list is in order of first appearance, without duplicates, and its
+// string_views point into the skimmed text.
+struct SkimmedSource {
+  // Modules, interfaces, programs, primitives, packages and classes that are
+  // not nested inside another one of these.
+  std::vector<absl::string_view> declarations;
+
+  // Packages (or classes) that are imported, or named before '::'.
+  std::vector<absl::string_view> package_references;
+
+  // Paths of `include directives, without quotes.
+  std::vector<absl::string_view> includes;
+
+  // Types of the instances in module, interface and program bodies (and
+  // bind directives).
+  std::vector<absl::string_view> instantiated_types;
+};
+
+// Scans 'text' in a single pass over its tokens, without parsing it.
+// This trades exactness for speed:
+//   * All branches of preprocessor conditionals are scanned, and macros are
+//     not expanded.
+//   * An instance is recognized as 'type [#(...)] name [...] (' at the start
+//     of an item (after ';', begin, end, generate, endgenerate or else), so
+//     instances directly under an if or for header are missed.
+//   * Lexical errors are skipped.
+SkimmedSource SkimVerilogSource(absl::string_view text);
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_ANALYSIS_VERILOG_SKIM_H_
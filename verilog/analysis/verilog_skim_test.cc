@@ -0,0 +1,146 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/analysis/verilog_skim.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace verilog {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+TEST(SkimVerilogSourceTest, Empty) {
+  const SkimmedSource skim = SkimVerilogSource("");
+  EXPECT_THAT(skim.declarations, IsEmpty());
+  EXPECT_THAT(skim.package_references, IsEmpty());
+  EXPECT_THAT(skim.includes, IsEmpty());
+  EXPECT_THAT(skim.instantiated_types, IsEmpty());
+}
+
+TEST(SkimVerilogSourceTest, TopLevelDeclarations) {
+  const SkimmedSource skim = SkimVerilogSource(
+      "module m; endmodule\n"
+      "macromodule mm; endmodule\n"
+      "interface automatic i; endinterface\n"
+      "program static p; endprogram\n"
+      "primitive u(o, a); endprimitive\n"
+      "package k; endpackage\n"
+      "class c; endclass\n"
+      "virtual class vc; endclass\n"
+      "interface class ic; endclass\n");
+  EXPECT_THAT(skim.declarations,
+              ElementsAre("m", "mm", "i", "p", "u", "k", "c", "vc", "ic"));
+}
+
+TEST(SkimVerilogSourceTest, NotNestedDeclarations) {
+  const SkimmedSource skim = SkimVerilogSource(
+      "package k;\n"
+      "  typedef class fwd;\n"
+      "  class c; endclass\n"
+      "  class fwd; endclass\n"
+      "endpackage\n"
+      "module m;\n"
+      "  module n; endmodule\n"
+      "  virtual interface vi v;\n"
+      "endmodule\n"
+      "extern module e(input a);\n"
+      "module z; endmodule\n");
+  EXPECT_THAT(skim.declarations, ElementsAre("k", "m", "z"));
+}
+
+TEST(SkimVerilogSourceTest, ConditionalHeaders) {
+  const SkimmedSource skim = SkimVerilogSource(
+      "`ifdef FOO\n"
+      "module m(input a);\n"
+      "`else\n"
+      "module m(input b);\n"
+      "`endif\n"
+      "endmodule\n"
+      "module n; endmodule\n");
+  EXPECT_THAT(skim.declarations, ElementsAre("m", "n"));
+}
+
+TEST(SkimVerilogSourceTest, PackageReferences) {
+  const SkimmedSource skim = SkimVerilogSource(
+      "import p::*;\n"
+      "module m import q::x; (input r::t a);\n"
+      "  p::t b;\n"
+      "  initial $display(s::f());\n"
+      "endmodule\n");
+  EXPECT_THAT(skim.package_references, ElementsAre("p", "q", "r", "s"));
+}
+
+TEST(SkimVerilogSourceTest, Includes) {
+  const SkimmedSource skim = SkimVerilogSource(
+      "`include \"a.svh\"\n"
+      "module m;\n"
+      "`include \"dir/b.svh\"\n"
+      "endmodule\n"
+      "`include \"a.svh\"\n"
+      "`include `MACRO_PATH\n");
+  EXPECT_THAT(skim.includes, ElementsAre("a.svh", "dir/b.svh"));
+}
+
+TEST(SkimVerilogSourceTest, Instances) {
+  const SkimmedSource skim = SkimVerilogSource(
+      "module m;\n"
+      "  wire w;\n"
+      "  a a_i();\n"
+      "  b #(.W(8)) b_i(.x(w));\n"
+      "  c c_i[3:0] (.*);\n"
+      "  my_type_t not_an_instance;\n"
+      "  generate\n"
+      "    d d_i();\n"
+      "  endgenerate\n"
+      "  if (1) begin : blk\n"
+      "    e e_i();\n"
+      "  end else begin\n"
+      "    f f_i();\n"
+      "  end\n"
+      "  a another_a();\n"
+      "  assign w = g(1);\n"
+      "endmodule\n"
+      "interface i;\n"
+      "  h h_i();\n"
+      "endinterface\n");
+  EXPECT_THAT(skim.instantiated_types,
+              ElementsAre("a", "b", "c", "d", "e", "f", "h"));
+}
+
+TEST(SkimVerilogSourceTest, NoInstancesInClassesOrPackages) {
+  const SkimmedSource skim = SkimVerilogSource(
+      "package p;\n"
+      "  foo bar();\n"
+      "endpackage\n"
+      "class c;\n"
+      "  foo bar();\n"
+      "endclass\n"
+      "foo bar();\n");
+  EXPECT_THAT(skim.instantiated_types, IsEmpty());
+}
+
+TEST(SkimVerilogSourceTest, BindInstances) {
+  const SkimmedSource skim = SkimVerilogSource(
+      "bind top checker_a ca(.*);\n"
+      "bind top.sub checker_b cb(.*);\n"
+      "bind top : t1, t2 checker_c #(1) cc(.*);\n");
+  EXPECT_THAT(skim.instantiated_types,
+              ElementsAre("checker_a", "checker_b", "checker_c"));
+}
+
+}  // namespace
+}  // namespace verilog
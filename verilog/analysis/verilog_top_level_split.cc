@@ -0,0 +1,137 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/analysis/verilog_top_level_split.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "verilog/parser/verilog_token_enum.h"
+
+namespace verilog {
+
+using verible::TokenInfo;
+using verible::TokenStreamView;
+
+bool IsTopLevelDeclarationEnd(int token_enum) {
+  switch (token_enum) {
+    case TK_endmodule:
+    case TK_endinterface:
+    case TK_endprogram:
+    case TK_endpackage:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if the token at 'index' starts a declaration that is closed by
+// one of the IsTopLevelDeclarationEnd() keywords.
+static bool StartsDeclaration(const TokenStreamView& tokens, size_t index) {
+  switch (tokens[index]->token_enum()) {
+    case TK_module:
+    case TK_macromodule:
+    case TK_program:
+    case TK_package:
+      break;
+    case TK_interface:
+      // Exclude 'interface class' (closed by 'endclass') and
+      // 'virtual interface' references.
+      if (index + 1 < tokens.size() &&
+          tokens[index + 1]->token_enum() == TK_class) {
+        return false;
+      }
+      if (index > 0 && tokens[index - 1]->token_enum() == TK_virtual) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+  // Extern declarations have no body, and hence no end keyword.
+  return index == 0 || tokens[index - 1]->token_enum() != TK_extern;
+}
+
+std::vector<size_t> FindTopLevelSplitPoints(
+    const TokenStreamView& tokens,
+    const std::vector<const TokenInfo*>& verified_ends) {
+  std::vector<size_t> split_points;
+  // Mis-counted keywords (e.g. an 'interface' port type) only ever increase
+  // these depths, which suppresses cutting rather than cutting wrongly.
+  int declaration_depth = 0;
+  int conditional_depth = 0;
+  auto verified = verified_ends.begin();
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    const TokenInfo& token = *tokens[i];
+    const int token_enum = token.token_enum();
+    if (token_enum == PP_ifdef || token_enum == PP_ifndef) {
+      ++conditional_depth;
+      continue;
+    }
+    if (token_enum == PP_endif) {
+      --conditional_depth;
+      continue;
+    }
+    if (StartsDeclaration(tokens, i)) {
+      ++declaration_depth;
+      continue;
+    }
+    if (!IsTopLevelDeclarationEnd(token_enum)) continue;
+    --declaration_depth;
+    if (declaration_depth != 0 || conditional_depth != 0) continue;
+
+    // Both sequences are in stream order, so advance through verified_ends
+    // in step with the tokens.
+    while (verified != verified_ends.end() &&
+           std::less<const TokenInfo*>()(*verified, &token)) {
+      ++verified;
+    }
+    if (verified == verified_ends.end() || *verified != &token) continue;
+
+    // Keep the optional end label with its declaration.
+    size_t cut = i + 1;
+    if (cut + 1 < tokens.size() && tokens[cut]->token_enum() == ':') {
+      cut += 2;
+    }
+    // Never leave only the EOF token for the last part.
+    if (cut < tokens.size() && !tokens[cut]->isEOF()) {
+      split_points.push_back(cut);
+    }
+    i = cut - 1;
+  }
+  return split_points;
+}
+
+std::vector<size_t> BalanceSplitPoints(const std::vector<size_t>& split_points,
+                                       size_t num_tokens, size_t max_chunks,
+                                       size_t min_chunk_tokens) {
+  std::vector<size_t> cuts;
+  if (max_chunks <= 1) return cuts;
+  const size_t target = std::max(num_tokens / max_chunks, min_chunk_tokens);
+  size_t chunk_begin = 0;
+  for (const size_t point : split_points) {
+    if (cuts.size() + 1 == max_chunks) break;
+    if (point - chunk_begin < target) continue;
+    if (num_tokens - point < min_chunk_tokens) break;
+    cuts.push_back(point);
+    chunk_begin = point;
+  }
+  return cuts;
+}
+
+}  // namespace verilog
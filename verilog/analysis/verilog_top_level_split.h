@@ -0,0 +1,59 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Functions for cutting a token stream between top-level declarations, so
+// that the pieces can be parsed independently (and concurrently).
+
+#ifndef VERIBLE_VERILOG_ANALYSIS_VERILOG_TOP_LEVEL_SPLIT_H_
+#define VERIBLE_VERILOG_ANALYSIS_VERILOG_TOP_LEVEL_SPLIT_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+
+namespace verilog {
+
+// Returns true for the keywords that end a top-level declaration that
+// FindTopLevelSplitPoints() can cut after: endmodule, endinterface,
+// endprogram and endpackage.
+bool IsTopLevelDeclarationEnd(int token_enum);
+
+// Returns the positions in 'tokens' (a filtered, contextualized and
+// preprocessed token stream) before which the stream can be cut, such that
+// every part parses as source text, and the concatenation of the parts'
+// description lists is the description list of the whole.
+// Cuts are only placed right after the end of a module, interface, program or
+// package declaration (including its optional end label) that is neither
+// nested in another declaration nor inside a preprocessor conditional.
+// 'verified_ends' must list, in stream order, the declaration end tokens
+// after which LexicalContext reported being AtTopLevel(); ends that are not
+// listed are not cut after.
+// Positions are strictly increasing, and never leave a part empty (or with
+// only the EOF token).
+std::vector<size_t> FindTopLevelSplitPoints(
+    const verible::TokenStreamView& tokens,
+    const std::vector<const verible::TokenInfo*>& verified_ends);
+
+// Selects from 'split_points' (as returned by FindTopLevelSplitPoints) at
+// most 'max_chunks' - 1 cuts that divide 'num_tokens' tokens into chunks of
+// similar size, none of which has fewer than 'min_chunk_tokens' tokens.
+std::vector<size_t> BalanceSplitPoints(const std::vector<size_t>& split_points,
+                                       size_t num_tokens, size_t max_chunks,
+                                       size_t min_chunk_tokens);
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_ANALYSIS_VERILOG_TOP_LEVEL_SPLIT_H_
@@ -0,0 +1,157 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/analysis/verilog_top_level_split.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "verilog/analysis/verilog_analyzer.h"
+#include "verilog/parser/verilog_lexical_context.h"
+
+namespace verilog {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+using verible::TokenInfo;
+
+// Lexes 'code', and returns the text of the first token after every split
+// point found in it.
+std::vector<std::string> SplitTokenTexts(absl::string_view code,
+                                         bool verify_ends = true) {
+  VerilogAnalyzer analyzer(code, "<test>");
+  EXPECT_TRUE(analyzer.Tokenize().ok());
+  analyzer.FilterTokensForSyntaxTree();
+  std::vector<const TokenInfo*> ends;
+  LexicalContext context;
+  context.TransformVerilogSymbols(
+      analyzer.MutableData().MakeTokenStreamReferenceView(),
+      [&ends](const TokenInfo& token) {
+        if (IsTopLevelDeclarationEnd(token.token_enum())) {
+          ends.push_back(&token);
+        }
+      });
+  if (!verify_ends) ends.clear();
+  const verible::TokenStreamView& tokens =
+      analyzer.Data().GetTokenStreamView();
+  std::vector<std::string> texts;
+  for (const size_t point : FindTopLevelSplitPoints(tokens, ends)) {
+    texts.emplace_back(tokens[point]->text());
+  }
+  return texts;
+}
+
+TEST(FindTopLevelSplitPointsTest, Empty) {
+  EXPECT_THAT(SplitTokenTexts(""), IsEmpty());
+}
+
+TEST(FindTopLevelSplitPointsTest, SingleDeclaration) {
+  EXPECT_THAT(SplitTokenTexts("module m; endmodule"), IsEmpty());
+}
+
+TEST(FindTopLevelSplitPointsTest, BetweenDeclarations) {
+  EXPECT_THAT(SplitTokenTexts("module m; endmodule\n"
+                              "package p; endpackage\n"
+                              "interface i; endinterface\n"
+                              "program q; endprogram\n"
+                              "typedef int t;\n"),
+              ElementsAre("package", "interface", "program", "typedef"));
+}
+
+TEST(FindTopLevelSplitPointsTest, KeepsEndLabel) {
+  EXPECT_THAT(SplitTokenTexts("module m; endmodule : m\n"
+                              "module n; endmodule : n\n"),
+              ElementsAre("module"));
+  EXPECT_THAT(SplitTokenTexts("module m; endmodule : m\n"
+                              "function f; endfunction\n"),
+              ElementsAre("function"));
+}
+
+TEST(FindTopLevelSplitPointsTest, NotInsideNestedDeclaration) {
+  EXPECT_THAT(SplitTokenTexts("module m;\n"
+                              "  module n; endmodule\n"
+                              "  wire w;\n"
+                              "endmodule\n"
+                              "module k; endmodule\n"),
+              ElementsAre("module"));
+}
+
+TEST(FindTopLevelSplitPointsTest, NotInsideConditional) {
+  EXPECT_THAT(SplitTokenTexts("`ifdef FOO\n"
+                              "module m; endmodule\n"
+                              "module n; endmodule\n"
+                              "`endif\n"
+                              "module k; endmodule\n"),
+              IsEmpty());
+  EXPECT_THAT(SplitTokenTexts("`ifndef FOO\n"
+                              "`define FOO\n"
+                              "`endif\n"
+                              "module m; endmodule\n"
+                              "module n; endmodule\n"),
+              ElementsAre("module"));
+}
+
+TEST(FindTopLevelSplitPointsTest, ExternDeclarationHasNoEnd) {
+  EXPECT_THAT(SplitTokenTexts("extern module e(input a);\n"
+                              "module m; endmodule\n"
+                              "module n; endmodule\n"),
+              ElementsAre("module"));
+}
+
+TEST(FindTopLevelSplitPointsTest, InterfaceClassAndVirtualInterface) {
+  EXPECT_THAT(SplitTokenTexts("interface class c; endclass\n"
+                              "module m;\n"
+                              "  virtual interface i v;\n"
+                              "endmodule\n"
+                              "module n; endmodule\n"),
+              ElementsAre("module"));
+}
+
+TEST(FindTopLevelSplitPointsTest, OnlyVerifiedEnds) {
+  EXPECT_THAT(SplitTokenTexts("module m; endmodule\n"
+                              "module n; endmodule\n",
+                              /* verify_ends= */ false),
+              IsEmpty());
+}
+
+TEST(BalanceSplitPointsTest, SingleChunk) {
+  EXPECT_THAT(BalanceSplitPoints({10, 20, 30}, 40, 1, 0), IsEmpty());
+}
+
+TEST(BalanceSplitPointsTest, EvenChunks) {
+  EXPECT_THAT(BalanceSplitPoints({10, 20, 30, 40, 50, 60, 70, 80, 90}, 100, 4,
+                                 5),
+              ElementsAre(30, 60, 90));
+}
+
+TEST(BalanceSplitPointsTest, AtMostMaxChunks) {
+  EXPECT_THAT(BalanceSplitPoints({10, 20, 30, 40, 50, 60, 70, 80, 90}, 100, 2,
+                                 5),
+              ElementsAre(50));
+}
+
+TEST(BalanceSplitPointsTest, MinimumChunkSize) {
+  EXPECT_THAT(BalanceSplitPoints({10, 20, 90, 95}, 100, 4, 20), IsEmpty());
+  EXPECT_THAT(BalanceSplitPoints({10, 30, 90, 95}, 100, 4, 20),
+              ElementsAre(30));
+}
+
+}  // namespace
+}  // namespace verilog
@@ -37,6 +37,7 @@
 #include "common/util/interval.h"
 #include "common/util/iterator_range.h"
 #include "common/util/logging.h"
+#include "common/util/phase_stats.h"
 #include "common/util/range.h"
 #include "common/util/spacer.h"
 #include "common/util/vector_tree.h"
@@ -80,12 +81,41 @@ class Formatter {
 
   Status Format() { return Format(ExecutionControl()); }
 
+  // Formats the source code one top-level partition at a time, and outputs
+  // each one to stream as soon as it is formatted, instead of keeping all
+  // formatted lines for Emit().
+  Status FormatAndEmit(const ExecutionControl&, std::ostream& stream);
+
   void SelectLines(const LineNumberSet& lines);
 
   // Outputs all of the FormattedExcerpt lines to stream.
   void Emit(std::ostream& stream) const;
 
  private:
+  // Implements Format() when 'stream' is null, and FormatAndEmit() otherwise.
+  Status FormatPartitions(const ExecutionControl&, std::ostream* stream);
+
+  // Aligns and line-wraps the token partitions of 'partitions', and appends
+  // the results to 'formatted_lines'.
+  void FormatPartitionTree(
+      TokenPartitionTree* partitions,
+      std::vector<verible::PreFormatToken>* preformatted_tokens,
+      const ExecutionControl& control,
+      std::vector<verible::FormattedExcerpt>* formatted_lines);
+
+  // Returns an error listing the partially_formatted_lines_, if any.
+  Status SearchLimitStatus() const;
+
+  // Outputs 'lines', each preceded by the original whitespace before it,
+  // starting from byte offset '*position' in the original text.
+  // Advances '*position' past the end of the last line.
+  void EmitLines(const std::vector<verible::FormattedExcerpt>& lines,
+                 int* position, std::ostream& stream) const;
+
+  // Outputs the original whitespace after the last token, starting from byte
+  // offset 'position'.
+  void EmitTrailingWhitespace(int position, std::ostream& stream) const;
+
   // Contains structural information about the code to format, such as
   // TokenSequence from lexing, and ConcreteSyntaxTree from parsing
   const verible::TextStructureView& text_structure_;
@@ -98,6 +128,9 @@ class Formatter {
 
   // Set of formatted lines, populated by calling Format().
   std::vector<verible::FormattedExcerpt> formatted_lines_;
+
+  // Lines whose line-wrap search did not complete within the search limit.
+  std::vector<UnwrappedLine> partially_formatted_lines_;
 };
 
 // TODO(b/148482625): make this public/re-usable for general content comparison.
@@ -110,6 +143,7 @@ Status VerifyFormatting(const verible::TextStructureView& text_structure,
   // Note: We cannot just Tokenize() and compare because Analyze()
   // performs additional transformations like expanding MacroArgs to
   // expression subtrees.
+  const verible::ScopedPhase phase("format-verify");
   const auto reanalyzer =
       VerilogAnalyzer::AnalyzeAutomaticMode(formatted_output, filename);
   const auto relex_status = ABSL_DIE_IF_NULL(reanalyzer)->LexStatus();
@@ -219,6 +253,16 @@ Status FormatVerilog(absl::string_view text, absl::string_view filename,
   Formatter fmt(text_structure, style);
   fmt.SelectLines(lines);
 
+  if (control.stream_top_level_items) {
+    // Format and emit one top-level item at a time.  The whole formatted text
+    // is never held in memory.
+    const Status format_status = fmt.FormatAndEmit(control, formatted_stream);
+    if (control.AnyStop()) {
+      return absl::CancelledError("Halting for diagnostic operation.");
+    }
+    return format_status;
+  }
+
   // Format code.
   const Status format_status = fmt.Format(control);
   if (!format_status.ok()) {
@@ -237,7 +281,10 @@ Status FormatVerilog(absl::string_view text, absl::string_view filename,
 
   // Render formatted text to a temporary buffer, so that it can be verified.
   std::ostringstream output_buffer;
-  fmt.Emit(output_buffer);
+  {
+    const verible::ScopedPhase phase("format-emit");
+    fmt.Emit(output_buffer);
+  }
   const std::string& formatted_text(output_buffer.str());
 
   // Commit verified formatted text to the output stream.
@@ -528,6 +575,16 @@ static void DisableSyntaxBasedRanges(ByteOffsetSet* disabled_ranges,
 }
 
 Status Formatter::Format(const ExecutionControl& control) {
+  return FormatPartitions(control, nullptr);
+}
+
+Status Formatter::FormatAndEmit(const ExecutionControl& control,
+                                std::ostream& stream) {
+  return FormatPartitions(control, &stream);
+}
+
+Status Formatter::FormatPartitions(const ExecutionControl& control,
+                                   std::ostream* stream) {
   const absl::string_view full_text(text_structure_.Contents());
   const auto& token_stream(text_structure_.TokenStream());
 
@@ -545,8 +602,13 @@ Status Formatter::Format(const ExecutionControl& control) {
     // Annotate inter-token information between all adjacent PreFormatTokens.
     // This must be done before any decisions about ExpandableTreeView
     // can be made because they depend on minimum-spacing, and must-break.
-    AnnotateFormattingInformation(style_, text_structure_,
-                                  &unwrapper_data.preformatted_tokens);
+    {
+      const verible::ScopedPhase phase("format-annotate");
+      AnnotateFormattingInformation(style_, text_structure_,
+                                    &unwrapper_data.preformatted_tokens);
+    }
+
+    const verible::ScopedPhase phase("format-partition");
 
     // Determine ranges of disabling the formatter, based on comment controls.
     disabled_ranges_.Union(DisableFormattingRanges(full_text, token_stream));
@@ -585,9 +647,45 @@ Status Formatter::Format(const ExecutionControl& control) {
     }
   }
 
+  TokenPartitionTree* root = tree_unwrapper.MutableTokenPartitions();
+  if (stream == nullptr) {
+    FormatPartitionTree(root, &unwrapper_data.preformatted_tokens, control,
+                        &formatted_lines_);
+    return SearchLimitStatus();
+  }
+
+  // The root partition is always expanded (unless it is empty), so each
+  // top-level partition is aligned and wrapped independently of the others,
+  // and can be emitted as soon as it is formatted.
+  int position = 0;  // tracks with the position in the original full_text
+  for (auto& item : root->Children()) {
+    std::vector<verible::FormattedExcerpt> item_lines;
+    FormatPartitionTree(&item, &unwrapper_data.preformatted_tokens, control,
+                        &item_lines);
+    {
+      const verible::ScopedPhase phase("format-emit");
+      EmitLines(item_lines, &position, *stream);
+      // Pass each item on as soon as it is complete.
+      stream->flush();
+    }
+    // Release the subpartitions of this item, which are no longer needed.
+    std::vector<TokenPartitionTree>().swap(item.Children());
+  }
+  EmitTrailingWhitespace(position, *stream);
+  return SearchLimitStatus();
+}
+
+void Formatter::FormatPartitionTree(
+    TokenPartitionTree* partitions,
+    std::vector<verible::PreFormatToken>* preformatted_tokens,
+    const ExecutionControl& control,
+    std::vector<verible::FormattedExcerpt>* formatted_lines) {
+  const absl::string_view full_text(text_structure_.Contents());
+
   {  // In this pass, perform additional modifications to the partitions and
      // spacings.
-    tree_unwrapper.ApplyPreOrder([&](TokenPartitionTree& node) {
+    const verible::ScopedPhase phase("format-align");
+    partitions->ApplyPreOrder([&](TokenPartitionTree& node) {
       const auto& uwline = node.Value();
       const auto partition_policy = uwline.PartitionPolicy();
 
@@ -600,9 +698,8 @@ Status Formatter::Format(const ExecutionControl& control) {
           // TODO(b/145170750): Adjust inter-token spacing to achieve alignment,
           // but leave partitioning intact.
           // This relies on inter-token spacing having already been annotated.
-          TabularAlignTokenPartitions(&node,
-                                      &unwrapper_data.preformatted_tokens,
-                                      full_text, disabled_ranges_, style_);
+          TabularAlignTokenPartitions(&node, preformatted_tokens, full_text,
+                                      disabled_ranges_, style_);
           break;
         default:
           break;
@@ -610,23 +707,23 @@ Status Formatter::Format(const ExecutionControl& control) {
     });
   }
 
+  const verible::ScopedPhase phase("format-line-wrap");
+
   // Produce sequence of independently operable UnwrappedLines.
   const auto unwrapped_lines = MakeUnwrappedLinesWorklist(
-      *format_tokens_partitions, &unwrapper_data.preformatted_tokens, full_text,
-      disabled_ranges_, style_);
+      *partitions, preformatted_tokens, full_text, disabled_ranges_, style_);
 
   // For each UnwrappedLine: minimize total penalty of wrap/break decisions.
   // TODO(fangism): This could be parallelized if results are written
   // to their own 'slots'.
-  std::vector<const UnwrappedLine*> partially_formatted_lines;
-  formatted_lines_.reserve(unwrapped_lines.size());
+  formatted_lines->reserve(formatted_lines->size() + unwrapped_lines.size());
   for (const auto& uwline : unwrapped_lines) {
     // TODO(fangism): Use different formatting strategies depending on
     // uwline.PartitionPolicy().
     if (uwline.PartitionPolicy() == PartitionPolicyEnum::kSuccessfullyAligned) {
       // For partitions that were successfully aligned, do not search
       // line-wrapping, but instead accept the adjusted padded spacing.
-      formatted_lines_.emplace_back(uwline);
+      formatted_lines->emplace_back(uwline);
     } else {
       // In other case, default to searching for optimal line wrapping.
       const auto optimal_solutions =
@@ -637,22 +734,24 @@ Status Formatter::Format(const ExecutionControl& control) {
                                                 optimal_solutions);
       }
       // Arbitrarily choose the first solution, if there are multiple.
-      formatted_lines_.push_back(optimal_solutions.front());
-      if (!formatted_lines_.back().CompletedFormatting()) {
+      formatted_lines->push_back(optimal_solutions.front());
+      if (!formatted_lines->back().CompletedFormatting()) {
         // Copy over any lines that did not finish wrap searching.
-        partially_formatted_lines.push_back(&uwline);
+        partially_formatted_lines_.push_back(uwline);
       }
     }
   }
+}
 
+Status Formatter::SearchLimitStatus() const {
   // Report any unwrapped lines that failed to complete wrap searching.
-  if (!partially_formatted_lines.empty()) {
+  if (!partially_formatted_lines_.empty()) {
     std::ostringstream err_stream;
     err_stream << "*** Some token partitions failed to complete within the "
                   "search limit:"
                << std::endl;
-    for (const auto* line : partially_formatted_lines) {
-      err_stream << *line << std::endl;
+    for (const auto& line : partially_formatted_lines_) {
+      err_stream << line << std::endl;
     }
     err_stream << "*** end of partially formatted partition list" << std::endl;
     // Treat search state limit like a limited resource.
@@ -663,14 +762,20 @@ Status Formatter::Format(const ExecutionControl& control) {
 }
 
 void Formatter::Emit(std::ostream& stream) const {
-  const absl::string_view full_text(text_structure_.Contents());
   int position = 0;  // tracks with the position in the original full_text
-  for (const auto& line : formatted_lines_) {
+  EmitLines(formatted_lines_, &position, stream);
+  EmitTrailingWhitespace(position, stream);
+}
+
+void Formatter::EmitLines(const std::vector<verible::FormattedExcerpt>& lines,
+                          int* position, std::ostream& stream) const {
+  const absl::string_view full_text(text_structure_.Contents());
+  for (const auto& line : lines) {
     // TODO(fangism): The handling of preserved spaces before tokens is messy:
     // some of it is handled here, some of it is inside FormattedToken.
     const auto front_offset = line.Tokens().front().token->left(full_text);
     const absl::string_view leading_whitespace(
-        full_text.substr(position, front_offset - position));
+        full_text.substr(*position, front_offset - *position));
     FormatWhitespaceWithDisabledByteRanges(full_text, leading_whitespace,
                                            disabled_ranges_, stream);
     // When front of first token is format-disabled, the previous call will
@@ -678,8 +783,13 @@ void Formatter::Emit(std::ostream& stream) const {
     // the left-indentation for this line should be suppressed to avoid
     // being printed twice.
     line.FormattedText(stream, !disabled_ranges_.Contains(front_offset));
-    position = line.Tokens().back().token->right(full_text);
+    *position = line.Tokens().back().token->right(full_text);
   }
+}
+
+void Formatter::EmitTrailingWhitespace(int position,
+                                       std::ostream& stream) const {
+  const absl::string_view full_text(text_structure_.Contents());
   // Handle trailing spaces after last token.
   const absl::string_view trailing_whitespace(full_text.substr(position));
   FormatWhitespaceWithDisabledByteRanges(full_text, trailing_whitespace,
@@ -52,6 +52,15 @@ struct ExecutionControl {
   // convergence: format(format(text)) == format(text).
   bool verify_convergence = true;
 
+  // If true, align, wrap and emit one top-level item (module, package, ...)
+  // at a time, releasing its subpartitions and formatted lines before moving
+  // on to the next one, and yielding the same output.
+  // The formatted text is written directly to the output stream as each item
+  // is completed, without buffering all of it first.
+  // This does not bound memory use by the largest item: the syntax tree,
+  // PreFormatTokens and top-level token partitions still span the whole file.
+  bool stream_top_level_items = false;
+
   // Output stream for diagnostic feedback (not formatting output).
   // This is useful for seeing diagnostics without waiting for a Status
   // to be returned.
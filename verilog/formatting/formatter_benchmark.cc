@@ -0,0 +1,88 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures FormatVerilog() with the default style, as a whole and pass by
+// pass.
+
+#include <sstream>
+#include <string>
+
+#include "absl/time/time.h"
+#include "benchmark/benchmark.h"
+#include "common/util/phase_stats.h"
+#include "verilog/formatting/format_style.h"
+#include "verilog/formatting/formatter.h"
+#include "verilog/tools/corpus/benchmark_corpus.h"
+#include "verilog/tools/corpus/corpus_benchmark_args.h"
+
+namespace verilog {
+namespace formatter {
+namespace {
+
+void BM_FormatVerilog(benchmark::State& state) {
+  const std::string source(
+      corpus::GenerateSource(corpus::CorpusBenchmarkOptions(state)));
+  const FormatStyle style;
+  for (auto _ : state) {
+    std::ostringstream formatted;
+    const auto status = FormatVerilog(source, "benchmark.sv", style, formatted);
+    if (!status.ok()) {
+      state.SkipWithError(status.ToString().c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(formatted.str());
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_FormatVerilog)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMillisecond);
+
+// Formats without the convergence check, and reports the wall time of every
+// phase per iteration, such as the format-partition and format-align passes.
+void BM_FormatVerilogPhases(benchmark::State& state) {
+  const std::string source(
+      corpus::GenerateSource(corpus::CorpusBenchmarkOptions(state)));
+  const FormatStyle style;
+  ExecutionControl control;
+  control.verify_convergence = false;
+  verible::PhaseStatsCollector collector;
+  verible::SetGlobalPhaseStats(&collector);
+  for (auto _ : state) {
+    std::ostringstream formatted;
+    const auto status =
+        FormatVerilog(source, "benchmark.sv", style, formatted, {}, control);
+    if (!status.ok()) {
+      state.SkipWithError(status.ToString().c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(formatted.str());
+  }
+  verible::SetGlobalPhaseStats(nullptr);
+  for (const auto& phase : collector.RunTotals()) {
+    state.counters[phase.first] =
+        benchmark::Counter(absl::ToDoubleSeconds(phase.second.wall_time),
+                           benchmark::Counter::kAvgIterations);
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_FormatVerilogPhases)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace formatter
+}  // namespace verilog
+
+BENCHMARK_MAIN();
@@ -53,6 +53,7 @@ absl::Status VerifyFormatting(const verible::TextStructureView& text_structure,
 
 namespace {
 
+using ::testing::ElementsAre;
 using absl::StatusCode;
 using verible::AlignmentPolicy;
 using verible::IndentationStyle;
@@ -7581,6 +7582,75 @@ TEST(FormatterEndToEndTest, VerilogFormatTest) {
   }
 }
 
+// Tests that formatting one top-level item at a time produces the same
+// results as formatting the whole file at once.
+TEST(FormatterEndToEndTest, StreamTopLevelItems) {
+  FormatStyle style;
+  style.column_limit = 40;
+  style.indentation_spaces = 2;
+  style.wrap_spaces = 4;
+  ExecutionControl control;
+  control.stream_top_level_items = true;
+  for (const auto& test_case : kFormatterTestCases) {
+    VLOG(1) << "code-to-format:\n" << test_case.input << "<EOF>";
+    std::ostringstream stream;
+    const auto status = FormatVerilog(test_case.input, "<filename>", style,
+                                      stream, {}, control);
+    EXPECT_OK(status) << status.message();
+    EXPECT_EQ(stream.str(), test_case.expected) << "code:\n" << test_case.input;
+  }
+}
+
+// Records the output that was flushed so far, at every flush.
+class FlushRecordingBuf : public std::stringbuf {
+ public:
+  const std::vector<std::string>& Flushes() const { return flushes_; }
+
+ protected:
+  int sync() override {
+    flushes_.push_back(str());
+    return 0;
+  }
+
+ private:
+  std::vector<std::string> flushes_;
+};
+
+// Tests that each top-level item is passed on to the output stream as soon as
+// it is formatted.
+TEST(FormatterEndToEndTest, StreamTopLevelItemsFlushesEachItem) {
+  ExecutionControl control;
+  control.stream_top_level_items = true;
+  FlushRecordingBuf buf;
+  std::ostream stream(&buf);
+  const auto status = FormatVerilog(
+      "module  a;endmodule\n"
+      "package  p;endpackage\n"
+      "module  b;endmodule\n",
+      "<filename>", FormatStyle(), stream, {}, control);
+  EXPECT_OK(status) << status.message();
+  EXPECT_THAT(buf.Flushes(),
+              ElementsAre("module a;\n"
+                          "endmodule",
+                          "module a;\n"
+                          "endmodule\n"
+                          "package p;\n"
+                          "endpackage",
+                          "module a;\n"
+                          "endmodule\n"
+                          "package p;\n"
+                          "endpackage\n"
+                          "module b;\n"
+                          "endmodule"));
+  EXPECT_EQ(buf.str(),
+            "module a;\n"
+            "endmodule\n"
+            "package p;\n"
+            "endpackage\n"
+            "module b;\n"
+            "endmodule\n");
+}
+
 TEST(FormatterEndToEndTest, AutoInferAlignment) {
   static constexpr FormatterTestCase kTestCases[] = {
       {"", ""},
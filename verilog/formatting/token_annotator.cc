@@ -14,6 +14,8 @@
 
 #include "verilog/formatting/token_annotator.h"
 
+#include <algorithm>
+#include <initializer_list>
 #include <iterator>
 #include <vector>
 
@@ -21,6 +23,7 @@
 #include "common/formatting/format_token.h"
 #include "common/formatting/tree_annotator.h"
 #include "common/strings/range.h"
+#include "common/text/concrete_syntax_tree.h"
 #include "common/text/syntax_tree_context.h"
 #include "common/text/text_structure.h"
 #include "common/text/token_info.h"
@@ -47,11 +50,117 @@ using FTT = FormatTokenType;
 // This value must be negative.
 static constexpr int kUnhandledSpacesRequired = -1;
 
+// The syntax tree context of a token, reduced to what the context-sensitive
+// rules below look at, so that they do not search the stack of ancestors for
+// every pair of tokens.  Summaries are computed incrementally from the root
+// by ExtendContext(), once per syntax tree node.
+struct ContextSummary {
+  // Tags of the direct parent and grandparent.
+  NodeEnum parent = NodeEnum::kUntagged;
+  NodeEnum grandparent = NodeEnum::kUntagged;
+
+  // Inside kPackedDimensions or kUnpackedDimensions.
+  bool in_declared_dimensions = false;
+  // Inside kDimensionScalar, kDimensionRange, kDimensionSlice or
+  // kCycleDelayRange.
+  bool in_range_like = false;
+  bool in_streaming_concatenation = false;
+  bool in_unary_prefix_expression = false;
+  // Inside kUnaryPrefixExpression before any kExpression.
+  bool in_unary_prefix_operand = false;
+  // Inside kPackedDimensions before any kExpression.
+  bool in_packed_dimensions_outside_expression = false;
+  // Inside kUdpCombEntry or kUdpSequenceEntry.
+  bool in_udp_entry = false;
+  // Inside kActualNamedPort or kPort.
+  bool in_named_port = false;
+  // Inside kGateInstance or kPrimitiveGateInstance.
+  bool in_gate_instance = false;
+  // Inside kInstantiationType, kBindTargetInstance or kExtendsList.
+  bool in_instantiation_type = false;
+
+  bool DirectParentIs(NodeEnum tag) const { return parent == tag; }
+
+  bool DirectParentIsOneOf(std::initializer_list<NodeEnum> tags) const {
+    return std::find(tags.begin(), tags.end(), parent) != tags.end();
+  }
+
+  // Direct parent and grandparent, like SyntaxTreeContext::DirectParentsAre().
+  bool DirectParentsAre(NodeEnum direct_parent,
+                        NodeEnum direct_grandparent) const {
+    return parent == direct_parent && grandparent == direct_grandparent;
+  }
+};
+
+// Returns the summary of the context of the children of 'node', whose own
+// context is summarized by 'context'.
+static ContextSummary ExtendContext(const ContextSummary& context,
+                                    const verible::SyntaxTreeNode& node) {
+  ContextSummary result(context);
+  const auto tag = NodeEnum(node.Tag().tag);
+  result.grandparent = context.parent;
+  result.parent = tag;
+  switch (tag) {
+    case NodeEnum::kPackedDimensions:
+      result.in_declared_dimensions = true;
+      result.in_packed_dimensions_outside_expression = true;
+      break;
+    case NodeEnum::kUnpackedDimensions:
+      result.in_declared_dimensions = true;
+      break;
+    case NodeEnum::kDimensionScalar:
+    case NodeEnum::kDimensionRange:
+    case NodeEnum::kDimensionSlice:
+    case NodeEnum::kCycleDelayRange:
+      result.in_range_like = true;
+      break;
+    case NodeEnum::kStreamingConcatenation:
+      result.in_streaming_concatenation = true;
+      break;
+    case NodeEnum::kUnaryPrefixExpression:
+      result.in_unary_prefix_expression = true;
+      result.in_unary_prefix_operand = true;
+      break;
+    case NodeEnum::kExpression:
+      result.in_unary_prefix_operand = false;
+      result.in_packed_dimensions_outside_expression = false;
+      break;
+    case NodeEnum::kUdpCombEntry:
+    case NodeEnum::kUdpSequenceEntry:
+      result.in_udp_entry = true;
+      break;
+    case NodeEnum::kActualNamedPort:
+    case NodeEnum::kPort:
+      result.in_named_port = true;
+      break;
+    case NodeEnum::kGateInstance:
+    case NodeEnum::kPrimitiveGateInstance:
+      result.in_gate_instance = true;
+      break;
+    case NodeEnum::kInstantiationType:
+    case NodeEnum::kBindTargetInstance:
+    case NodeEnum::kExtendsList:
+      result.in_instantiation_type = true;
+      break;
+    default:
+      break;
+  }
+  return result;
+}
+
+// Summarizes a whole context stack, like ExtendContext() does from the root.
+static ContextSummary SummarizeContext(const SyntaxTreeContext& context) {
+  ContextSummary result;
+  for (const auto* node : context) {
+    result = ExtendContext(result, *node);
+  }
+  return result;
+}
+
 static bool IsUnaryPrefixExpressionOperand(const PreFormatToken& left,
-                                           const SyntaxTreeContext& context) {
+                                           const ContextSummary& context) {
   return (IsUnaryOperator(verilog_tokentype(left.TokenEnum())) &&
-          context.IsInsideFirst({NodeEnum::kUnaryPrefixExpression},
-                                {NodeEnum::kExpression})) ||
+          context.in_unary_prefix_operand) ||
          // Treat '##' like a unary prefix operator.
          left.TokenEnum() == verilog_tokentype::TK_POUNDPOUND;
 }
@@ -107,18 +216,6 @@ static bool PairwiseNonmergeable(const PreFormatToken& ftoken) {
          ftoken.format_token_enum == FormatTokenType::keyword;
 }
 
-static bool InDeclaredDimensions(const SyntaxTreeContext& context) {
-  return context.IsInsideFirst(
-      {NodeEnum::kPackedDimensions, NodeEnum::kUnpackedDimensions}, {});
-}
-
-static bool InRangeLikeContext(const SyntaxTreeContext& context) {
-  return context.IsInsideFirst(
-      {NodeEnum::kDimensionScalar, NodeEnum::kDimensionRange,
-       NodeEnum::kDimensionSlice, NodeEnum::kCycleDelayRange},
-      {});
-}
-
 static bool IsAnySemicolon(const PreFormatToken& ftoken) {
   // These are just syntactically disambiguated versions of ';'.
   return ftoken.TokenEnum() == ';' ||
@@ -131,8 +228,8 @@ static bool IsAnySemicolon(const PreFormatToken& ftoken) {
 // handled, and it is up to the caller to decide what to do when this happens.
 static WithReason<int> SpacesRequiredBetween(
     const PreFormatToken& left, const PreFormatToken& right,
-    const SyntaxTreeContext& left_context,
-    const SyntaxTreeContext& right_context, const FormatStyle& style) {
+    const ContextSummary& left_context, const ContextSummary& right_context,
+    const FormatStyle& style) {
   VLOG(3) << "Spacing between " << verilog_symbol_name(left.TokenEnum())
           << " and " << verilog_symbol_name(right.TokenEnum());
   // Higher precedence rules should be handled earlier in this function.
@@ -162,7 +259,7 @@ static WithReason<int> SpacesRequiredBetween(
   }
 
   // For now, leave everything inside [dimensions] alone.
-  if (InDeclaredDimensions(right_context)) {
+  if (right_context.in_declared_dimensions) {
     // ... except for the spacing before '[' and around ':',
     // which are covered elsewhere.
     if (right.TokenEnum() != '[' && left.TokenEnum() != ':' &&
@@ -205,7 +302,7 @@ static WithReason<int> SpacesRequiredBetween(
     return {1, "Space between return keyword and return value"};
   }
 
-  if (right_context.IsInsideFirst({NodeEnum::kStreamingConcatenation}, {})) {
+  if (right_context.in_streaming_concatenation) {
     if (left.TokenEnum() == TK_LS || left.TokenEnum() == TK_RS) {
       return {0, "No space around streaming operators"};
     } else if (left.format_token_enum == FormatTokenType::numeric_literal ||
@@ -225,7 +322,7 @@ static WithReason<int> SpacesRequiredBetween(
   }
 
   // Do not force space between '^' and '{' operators
-  if (right_context.IsInsideFirst({NodeEnum::kUnaryPrefixExpression}, {})) {
+  if (right_context.in_unary_prefix_expression) {
     if (IsUnaryOperator(static_cast<verilog_tokentype>(left.TokenEnum())) &&
         right.TokenEnum() == '{') {
       return {0, "No space between unary and concatenation operators"};
@@ -240,9 +337,9 @@ static WithReason<int> SpacesRequiredBetween(
     // Inside [], allows 0 or 1 spaces, and symmetrize.
     // TODO(fangism): make this behavior configurable
     if (right.format_token_enum == FormatTokenType::binary_operator &&
-        InRangeLikeContext(right_context)) {
+        right_context.in_range_like) {
       if (style.compact_indexing_and_selections &&
-          !InDeclaredDimensions(right_context)) {
+          !right_context.in_declared_dimensions) {
         return {0,
                 "Compact binary expressions inside indexing / bit selection "
                 "operator []"};
@@ -255,7 +352,7 @@ static WithReason<int> SpacesRequiredBetween(
       return {spaces, "Limit <= 1 space before binary operator inside []."};
     }
     if (left.format_token_enum == FormatTokenType::binary_operator &&
-        InRangeLikeContext(left_context)) {
+        left_context.in_range_like) {
       return {left.before.spaces_required,
               "Symmetrize spaces before and after binary operator inside []."};
     }
@@ -275,8 +372,7 @@ static WithReason<int> SpacesRequiredBetween(
     return {0, "No space inside based numeric literals"};
   }
 
-  if (right_context.IsInsideFirst(
-          {NodeEnum::kUdpCombEntry, NodeEnum::kUdpSequenceEntry}, {})) {
+  if (right_context.in_udp_entry) {
     // Spacing before ';' is handled above
     return {1, "One space around UDP entries"};
   }
@@ -311,12 +407,10 @@ static WithReason<int> SpacesRequiredBetween(
         IsKeywordCallable(verilog_tokentype(left.TokenEnum()))) {
       // TODO(fangism): This logic should use .DirectParentIs() to minimize risk
       // of unintended reach.
-      if (right_context.IsInside(NodeEnum::kActualNamedPort) ||
-          right_context.IsInside(NodeEnum::kPort)) {
+      if (right_context.in_named_port) {
         return {0, "Named port: no space between ID and '('"};
       }
-      if (right_context.IsInside(NodeEnum::kGateInstance) ||
-          right_context.IsInside(NodeEnum::kPrimitiveGateInstance)) {
+      if (right_context.in_gate_instance) {
         return {1, "Module/primitive instance: want space between ID and '('"};
       }
       if (left_context.DirectParentIs(NodeEnum::kModuleHeader)) {
@@ -330,7 +424,7 @@ static WithReason<int> SpacesRequiredBetween(
 
   if (left.TokenEnum() == ':') {
     // Spacing in ranges
-    if (InRangeLikeContext(right_context)) {
+    if (right_context.in_range_like) {
       // Take advantage here that the left token was already annotated (above)
       return {left.before.spaces_required,
               "Symmetrize spaces before and after ':' in bit slice"};
@@ -347,22 +441,22 @@ static WithReason<int> SpacesRequiredBetween(
     if (left.format_token_enum == FormatTokenType::keyword) {
       return {1, "Space between keyword and '{'."};
     }
-    if (right_context.DirectParentsAre(
-            {NodeEnum::kBraceGroup, NodeEnum::kConstraintDeclaration})) {
+    if (right_context.DirectParentsAre(NodeEnum::kBraceGroup,
+                                       NodeEnum::kConstraintDeclaration)) {
       return {1, "Space before '{' when opening a constraint definition body."};
     }
-    if (right_context.DirectParentsAre(
-            {NodeEnum::kBraceGroup, NodeEnum::kCoverPoint})) {
+    if (right_context.DirectParentsAre(NodeEnum::kBraceGroup,
+                                       NodeEnum::kCoverPoint)) {
       return {1, "Space before '{' when opening a coverpoint body."};
     }
-    if (right_context.DirectParentsAre(
-            {NodeEnum::kBraceGroup, NodeEnum::kEnumType})) {
+    if (right_context.DirectParentsAre(NodeEnum::kBraceGroup,
+                                       NodeEnum::kEnumType)) {
       return {1, "Space before '{' when opening an enum type."};
     }
     if (left.TokenEnum() == ')') {
       return {1, "Space betwen ')' and '{', e.g. conditional constraint."};
     }
-    if (left.TokenEnum() == ']' && InDeclaredDimensions(left_context)) {
+    if (left.TokenEnum() == ']' && left_context.in_declared_dimensions) {
       return {1, "Space between declared array type and '{' (e.g. in typedef)"};
     }
     return {0, "No space before '{' in most other contexts."};
@@ -372,8 +466,7 @@ static WithReason<int> SpacesRequiredBetween(
   if ((left.format_token_enum == FormatTokenType::keyword ||
        left.format_token_enum == FormatTokenType::identifier) &&
       right.TokenEnum() == '[') {
-    if (right_context.IsInsideFirst({NodeEnum::kPackedDimensions},
-                                    {NodeEnum::kExpression})) {
+    if (right_context.in_packed_dimensions_outside_expression) {
       // "type [packed...]" (space between type and packed dimensions)
       // avoid touching any expressions inside the packed dimensions
       return {1, "spacing before [packed dimensions] of declarations"};
@@ -384,8 +477,8 @@ static WithReason<int> SpacesRequiredBetween(
   if (left.TokenEnum() == ']' &&
       right.format_token_enum == FormatTokenType::identifier) {
     if (right_context.DirectParentsAre(
-            {NodeEnum::kUnqualifiedId,
-             NodeEnum::kDataTypeImplicitBasicIdDimensions})) {
+            NodeEnum::kUnqualifiedId,
+            NodeEnum::kDataTypeImplicitBasicIdDimensions)) {
       // "[packed...] id" (space between packed dimensions and id)
       return {1, "spacing after [packed dimensions] of declarations"};
     }
@@ -432,7 +525,7 @@ static WithReason<int> SpacesRequiredBetween(
     }
 
     // Spacing in ranges
-    if (InRangeLikeContext(right_context)) {
+    if (right_context.in_range_like) {
       int spaces = right.OriginalLeadingSpaces().length();
       if (spaces > 1) {
         spaces = 1;
@@ -503,10 +596,7 @@ static WithReason<int> SpacesRequiredBetween(
     // classes often appear with method calls like:
     //   type#(params...)::method(...);
     if (left_context.DirectParentIs(NodeEnum::kUnqualifiedId) &&
-        !left_context.IsInsideFirst(
-            {NodeEnum::kInstantiationType, NodeEnum::kBindTargetInstance,
-             NodeEnum::kExtendsList},
-            {})) {
+        !left_context.in_instantiation_type) {
       return {0, "No space before # when direct parent is kUnqualifiedId."};
     } else {
       return {1, "Spaces before # in most other contexts."};
@@ -563,8 +653,8 @@ struct SpacePolicy {
 
 static SpacePolicy SpacesRequiredBetween(
     const FormatStyle& style, const PreFormatToken& left,
-    const PreFormatToken& right, const SyntaxTreeContext& left_context,
-    const SyntaxTreeContext& right_context) {
+    const PreFormatToken& right, const ContextSummary& left_context,
+    const ContextSummary& right_context) {
   // Default for unhandled cases, 1 space to be conservative.
   constexpr int kUnhandledSpacesDefault = 1;
   const auto spaces =
@@ -628,11 +718,11 @@ static WithReason<int> BreakPenaltyBetweenTokens(
   return {0, "no further adjustment (default)"};
 }
 
+// AnnotateFormattingInformation() gets the number of common ancestors from
+// the traversal of the syntax tree, so this is only needed when annotating
+// with explicit contexts.
 static int CommonAncestors(const SyntaxTreeContext& left,
                            const SyntaxTreeContext& right) {
-  // TODO(fangism): re-check of common ancestry is slow (linear-time),
-  // and could be avoided by memoizing the point of common ancestry between
-  // leaves *during* the traversal.
   const auto* shorter = &left;
   const auto* longer = &right;
   // For C++11 compatibility, we use the 3-iterator form of std::mismatch().
@@ -648,24 +738,22 @@ static int CommonAncestors(const SyntaxTreeContext& left,
   return short_common;
 }
 
-// Token-independent break penalty factor.
-static int ContextBasedPenalty(const SyntaxTreeContext& left_context,
-                               const SyntaxTreeContext& right_context) {
+// Token-independent break penalty factor, given the number of ancestors
+// that the left and right tokens' contexts have in common.
+static int ContextBasedPenalty(int common_ancestors) {
   // This factor takes into account syntax tree depth, favoring keeping
   // elements deeper in the tree closer together.
   // The current simple model gives equal weight to every element in the
   // context stack.
   // TODO(fangism): custom weights by syntax tree node type.
   constexpr int kDepthScaleFactor = 2;
-  const int num_common = CommonAncestors(left_context, right_context);
-  const int penalty = num_common * kDepthScaleFactor;
+  const int penalty = common_ancestors * kDepthScaleFactor;
   return penalty;
 }
 
 static WithReason<int> TokensWithContextBreakPenalty(
     const verible::PreFormatToken& left, const verible::PreFormatToken& right,
-    const SyntaxTreeContext& left_context,
-    const SyntaxTreeContext& right_context) {
+    const ContextSummary& left_context, const ContextSummary& right_context) {
   const verilog_tokentype left_type =
       static_cast<verilog_tokentype>(left.TokenEnum());
   const verilog_tokentype right_type =
@@ -694,13 +782,13 @@ static WithReason<int> TokensWithContextBreakPenalty(
 // Returns the split penalty for line-breaking before the right token.
 static WithReason<int> BreakPenaltyBetween(
     const verible::PreFormatToken& left, const verible::PreFormatToken& right,
-    const SyntaxTreeContext& left_context,
-    const SyntaxTreeContext& right_context) {
+    const ContextSummary& left_context, const ContextSummary& right_context,
+    int common_ancestors) {
   VLOG(3) << "Inter-token penalty between "
           << verilog_symbol_name(left.TokenEnum()) << " and "
           << verilog_symbol_name(right.TokenEnum());
 
-  const int depth_penalty = ContextBasedPenalty(left_context, right_context);
+  const int depth_penalty = ContextBasedPenalty(common_ancestors);
   VLOG(3) << "context break penalty: " << depth_penalty;
 
   // This factor only looks at left and right tokens:
@@ -727,10 +815,10 @@ static WithReason<int> BreakPenaltyBetween(
 // Returns decision whether to break, not break, or evaluate both choices.
 static WithReason<SpacingOptions> BreakDecisionBetween(
     const FormatStyle& style, const PreFormatToken& left,
-    const PreFormatToken& right, const SyntaxTreeContext& left_context,
-    const SyntaxTreeContext& right_context) {
+    const PreFormatToken& right, const ContextSummary& left_context,
+    const ContextSummary& right_context) {
   // For now, leave everything inside [dimensions] alone.
-  if (InDeclaredDimensions(right_context)) {
+  if (right_context.in_declared_dimensions) {
     // ... except for the spacing immediately around '[' and ']',
     // which is covered by other rules.
     if (left.TokenEnum() != '[' && left.TokenEnum() != ']' &&
@@ -891,14 +979,12 @@ static WithReason<SpacingOptions> BreakDecisionBetween(
           "Default: leave wrap decision to algorithm"};
 }
 
-// Extern linkage for sake of direct testing, though not exposed in public
-// headers.
-// TODO(fangism): could move this to a -internal.h header.
-void AnnotateFormatToken(const FormatStyle& style,
-                         const PreFormatToken& prev_token,
-                         PreFormatToken* curr_token,
-                         const SyntaxTreeContext& prev_context,
-                         const SyntaxTreeContext& curr_context) {
+static void AnnotateFormatToken(const FormatStyle& style,
+                                const PreFormatToken& prev_token,
+                                PreFormatToken* curr_token,
+                                const ContextSummary& prev_context,
+                                const ContextSummary& curr_context,
+                                int common_ancestors) {
   const auto p = SpacesRequiredBetween(style, prev_token, *curr_token,
                                        prev_context, curr_context);
   curr_token->before.spaces_required = p.spaces_required;
@@ -908,8 +994,9 @@ void AnnotateFormatToken(const FormatStyle& style,
   } else {
     // Update the break penalty and if the curr_token is allowed to
     // break before it.
-    const auto break_penalty = BreakPenaltyBetween(prev_token, *curr_token,
-                                                   prev_context, curr_context);
+    const auto break_penalty =
+        BreakPenaltyBetween(prev_token, *curr_token, prev_context,
+                            curr_context, common_ancestors);
     curr_token->before.break_penalty = break_penalty.value;
     const auto breaker = BreakDecisionBetween(style, prev_token, *curr_token,
                                               prev_context, curr_context);
@@ -919,6 +1006,20 @@ void AnnotateFormatToken(const FormatStyle& style,
   }
 }
 
+// Extern linkage for sake of direct testing, though not exposed in public
+// headers.
+// TODO(fangism): could move this to a -internal.h header.
+void AnnotateFormatToken(const FormatStyle& style,
+                         const PreFormatToken& prev_token,
+                         PreFormatToken* curr_token,
+                         const SyntaxTreeContext& prev_context,
+                         const SyntaxTreeContext& curr_context) {
+  AnnotateFormatToken(style, prev_token, curr_token,
+                      SummarizeContext(prev_context),
+                      SummarizeContext(curr_context),
+                      CommonAncestors(prev_context, curr_context));
+}
+
 void AnnotateFormattingInformation(
     const FormatStyle& style, const verible::TextStructureView& text_structure,
     std::vector<verible::PreFormatToken>* format_tokens) {
@@ -943,16 +1044,20 @@ void AnnotateFormattingInformation(
     ConnectPreFormatTokensPreservedSpaceStarts(buffer_start, format_tokens);
   }
 
-  // Annotate inter-token information using the syntax tree for context.
-  AnnotateFormatTokensUsingSyntaxContext(
+  // Summarize the syntax tree context of every token in one traversal, and
+  // then annotate inter-token information in a single pass over the tokens.
+  const auto summaries = verible::SummarizeTokenContexts<ContextSummary>(
       syntax_tree_root, eof_token, format_tokens->begin(), format_tokens->end(),
-      // lambda: bind the FormatStyle, forwarding all other arguments
-      [&style](const PreFormatToken& prev_token, PreFormatToken* curr_token,
-               const SyntaxTreeContext& prev_context,
-               const SyntaxTreeContext& current_context) {
-        AnnotateFormatToken(style, prev_token, curr_token, prev_context,
-                            current_context);
-      });
+      ExtendContext);
+  const auto& contexts = summaries.contexts;
+  // Tokens beyond the end of context_index are not reached by the traversal,
+  // and are left unannotated.
+  for (size_t i = 1; i < summaries.context_index.size(); ++i) {
+    const int index = summaries.context_index[i];
+    AnnotateFormatToken(style, (*format_tokens)[i - 1], &(*format_tokens)[i],
+                        contexts[index - 1], contexts[index],
+                        summaries.common_ancestors[index]);
+  }
 }
 
 }  // namespace formatter
@@ -578,9 +578,14 @@ void TreeUnwrapper::Visit(const SyntaxTreeNode& node) {
   VLOG(3) << __FUNCTION__ << " node: " << tag;
 
   // This phase is only concerned with creating token partitions (during tree
-  // recursive descent) and setting correct indentation values.  It is ok to
-  // have excessive partitioning during this phase.
+  // descent) and setting correct indentation values.  It is ok to have
+  // excessive partitioning during this phase.
+  // The children are traversed after this returns, followed by LeaveNode().
   SetIndentationsAndCreatePartitions(node);
+}
+
+void TreeUnwrapper::LeaveNode(const SyntaxTreeNode& node) {
+  VLOG(3) << __FUNCTION__ << " node: " << NodeEnum(node.Tag().tag);
 
   // This phase is only concerned with reshaping operations on token partitions,
   // such as merging, flattening, hoisting.  Reshaping should only occur on the
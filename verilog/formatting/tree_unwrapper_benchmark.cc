@@ -0,0 +1,233 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures partitioning generated source files into token partition trees,
+// and whole-tree traversals of the resulting partitions, shaped like those of
+// the formatter's alignment pass (pre-order) and line-wrapping worklist
+// (post-order).  Traversals are measured with the applied function passed
+// through std::function, and passed directly so that it can be inlined, and
+// on a copy of the partitions in a FlatTree.
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "benchmark/benchmark.h"
+#include "common/formatting/token_partition_tree.h"
+#include "common/formatting/unwrapped_line.h"
+#include "common/util/flat_tree.h"
+#include "verilog/analysis/verilog_analyzer.h"
+#include "verilog/formatting/format_style.h"
+#include "verilog/formatting/tree_unwrapper.h"
+#include "verilog/tools/corpus/benchmark_corpus.h"
+#include "verilog/tools/corpus/corpus_benchmark_args.h"
+
+namespace verilog {
+namespace formatter {
+namespace {
+
+using verible::FlatTree;
+using verible::PartitionPolicyEnum;
+using verible::TokenPartitionTree;
+using verible::UnwrappedLine;
+
+// Token partitions of a generated source file, as the formatter sees them
+// before alignment.
+class BenchmarkPartitions {
+ public:
+  explicit BenchmarkPartitions(benchmark::State& state)
+      : source_(corpus::GenerateSource(corpus::CorpusBenchmarkOptions(state))),
+        analyzer_(source_, "benchmark.sv") {
+    const auto status = analyzer_.Analyze();
+    if (!status.ok()) {
+      state.SkipWithError(status.ToString().c_str());
+      return;
+    }
+    const auto& text_structure = analyzer_.Data();
+    unwrapper_data_ =
+        absl::make_unique<UnwrapperData>(text_structure.TokenStream());
+    tree_unwrapper_ = absl::make_unique<TreeUnwrapper>(
+        text_structure, style_, unwrapper_data_->preformatted_tokens);
+    partitions_ = tree_unwrapper_->Unwrap();
+  }
+
+  // Returns nullptr if the source could not be analyzed.
+  const TokenPartitionTree* Partitions() const { return partitions_; }
+
+ private:
+  const std::string source_;
+  VerilogAnalyzer analyzer_;
+  const FormatStyle style_;
+  std::unique_ptr<UnwrapperData> unwrapper_data_;
+  std::unique_ptr<TreeUnwrapper> tree_unwrapper_;
+  const TokenPartitionTree* partitions_ = nullptr;
+};
+
+// Tallies the partitions that the alignment pass would reshape or align.
+struct PolicyCounts {
+  size_t append_fitting = 0;
+  size_t tabular = 0;
+
+  void Add(const TokenPartitionTree& node) { Add(node.Value()); }
+
+  void Add(const UnwrappedLine& line) {
+    switch (line.PartitionPolicy()) {
+      case PartitionPolicyEnum::kAppendFittingSubPartitions:
+        ++append_fitting;
+        break;
+      case PartitionPolicyEnum::kTabularAlignment:
+        ++tabular;
+        break;
+      default:
+        break;
+    }
+  }
+};
+
+void BM_Unwrap(benchmark::State& state) {
+  const std::string source(
+      corpus::GenerateSource(corpus::CorpusBenchmarkOptions(state)));
+  VerilogAnalyzer analyzer(source, "benchmark.sv");
+  const auto status = analyzer.Analyze();
+  if (!status.ok()) {
+    state.SkipWithError(status.ToString().c_str());
+    return;
+  }
+  const auto& text_structure = analyzer.Data();
+  const FormatStyle style;
+  for (auto _ : state) {
+    UnwrapperData unwrapper_data(text_structure.TokenStream());
+    TreeUnwrapper tree_unwrapper(text_structure, style,
+                                 unwrapper_data.preformatted_tokens);
+    benchmark::DoNotOptimize(tree_unwrapper.Unwrap());
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_Unwrap)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_PartitionsPreOrderStdFunction(benchmark::State& state) {
+  const BenchmarkPartitions partitions(state);
+  if (partitions.Partitions() == nullptr) return;
+  for (auto _ : state) {
+    PolicyCounts counts;
+    const std::function<void(const TokenPartitionTree&)> f =
+        [&counts](const TokenPartitionTree& node) { counts.Add(node); };
+    partitions.Partitions()->ApplyPreOrder(f);
+    benchmark::DoNotOptimize(counts);
+  }
+}
+BENCHMARK(BM_PartitionsPreOrderStdFunction)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_PartitionsPreOrder(benchmark::State& state) {
+  const BenchmarkPartitions partitions(state);
+  if (partitions.Partitions() == nullptr) return;
+  for (auto _ : state) {
+    PolicyCounts counts;
+    partitions.Partitions()->ApplyPreOrder(
+        [&counts](const TokenPartitionTree& node) { counts.Add(node); });
+    benchmark::DoNotOptimize(counts);
+  }
+}
+BENCHMARK(BM_PartitionsPreOrder)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_PartitionsPostOrderStdFunction(benchmark::State& state) {
+  const BenchmarkPartitions partitions(state);
+  if (partitions.Partitions() == nullptr) return;
+  for (auto _ : state) {
+    std::vector<const UnwrappedLine*> leaves;
+    const std::function<void(const TokenPartitionTree&)> f =
+        [&leaves](const TokenPartitionTree& node) {
+          if (node.is_leaf()) leaves.push_back(&node.Value());
+        };
+    partitions.Partitions()->ApplyPostOrder(f);
+    benchmark::DoNotOptimize(leaves.data());
+  }
+}
+BENCHMARK(BM_PartitionsPostOrderStdFunction)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_PartitionsPostOrder(benchmark::State& state) {
+  const BenchmarkPartitions partitions(state);
+  if (partitions.Partitions() == nullptr) return;
+  for (auto _ : state) {
+    std::vector<const UnwrappedLine*> leaves;
+    partitions.Partitions()->ApplyPostOrder(
+        [&leaves](const TokenPartitionTree& node) {
+          if (node.is_leaf()) leaves.push_back(&node.Value());
+        });
+    benchmark::DoNotOptimize(leaves.data());
+  }
+}
+BENCHMARK(BM_PartitionsPostOrder)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_FlattenPartitions(benchmark::State& state) {
+  const BenchmarkPartitions partitions(state);
+  if (partitions.Partitions() == nullptr) return;
+  for (auto _ : state) {
+    const FlatTree<UnwrappedLine> flat(*partitions.Partitions());
+    benchmark::DoNotOptimize(flat.size());
+  }
+}
+BENCHMARK(BM_FlattenPartitions)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_FlatPartitionsPreOrder(benchmark::State& state) {
+  const BenchmarkPartitions partitions(state);
+  if (partitions.Partitions() == nullptr) return;
+  const FlatTree<UnwrappedLine> flat(*partitions.Partitions());
+  for (auto _ : state) {
+    PolicyCounts counts;
+    flat.ApplyPreOrder(
+        [&counts](const UnwrappedLine& line) { counts.Add(line); });
+    benchmark::DoNotOptimize(counts);
+  }
+}
+BENCHMARK(BM_FlatPartitionsPreOrder)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_FlatPartitionsPostOrder(benchmark::State& state) {
+  const BenchmarkPartitions partitions(state);
+  if (partitions.Partitions() == nullptr) return;
+  const FlatTree<UnwrappedLine> flat(*partitions.Partitions());
+  for (auto _ : state) {
+    std::vector<const UnwrappedLine*> leaves;
+    flat.ApplyPostOrderIndices([&flat, &leaves](size_t index) {
+      if (flat.is_leaf(index)) leaves.push_back(&flat.Value(index));
+    });
+    benchmark::DoNotOptimize(leaves.data());
+  }
+}
+BENCHMARK(BM_FlatPartitionsPostOrder)
+    ->Apply(corpus::CorpusScalingArgs)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace formatter
+}  // namespace verilog
+
+BENCHMARK_MAIN();
@@ -0,0 +1,44 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures VerilogLexer throughput.
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "common/text/token_info.h"
+#include "verilog/parser/verilog_lexer.h"
+#include "verilog/tools/corpus/benchmark_corpus.h"
+#include "verilog/tools/corpus/corpus_benchmark_args.h"
+
+namespace verilog {
+namespace {
+
+void BM_VerilogLexer(benchmark::State& state) {
+  const std::string source(
+      corpus::GenerateSource(corpus::CorpusBenchmarkOptions(state)));
+  for (auto _ : state) {
+    VerilogLexer lexer(source);
+    size_t num_tokens = 0;
+    while (!lexer.DoNextToken().isEOF()) ++num_tokens;
+    benchmark::DoNotOptimize(num_tokens);
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_VerilogLexer)->Apply(corpus::CorpusScalingArgs);
+
+}  // namespace
+}  // namespace verilog
+
+BENCHMARK_MAIN();
@@ -675,6 +675,14 @@ int LexicalContext::_InterpretToken(int token_enum) const {
   return token_enum;
 }
 
+bool LexicalContext::AtTopLevel() const {
+  // flow_control_stack_ is not consulted, because it is never popped.
+  return !InAnyDeclaration() && !in_extern_declaration_ &&
+         !in_initial_always_final_construct_ && block_stack_.empty() &&
+         balance_stack_.empty() && !randomize_call_tracker_.IsActive() &&
+         !constraint_declaration_tracker_.IsActive();
+}
+
 bool LexicalContext::InFlowControlHeader() const {
   if (flow_control_stack_.empty()) return false;
   return !flow_control_stack_.back().in_body;
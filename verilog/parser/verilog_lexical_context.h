@@ -15,6 +15,7 @@
 #ifndef VERIBLE_VERILOG_PARSER_VERILOG_LEXICAL_CONTEXT_H_
 #define VERIBLE_VERILOG_PARSER_VERILOG_LEXICAL_CONTEXT_H_
 
+#include <functional>
 #include <iosfwd>
 #include <iterator>
 #include <stack>
@@ -249,6 +250,23 @@ class LexicalContext {
     }
   }
 
+  // Same as above, and also calls 'top_level_token' with every token after
+  // which the context is AtTopLevel(), in stream order.
+  void TransformVerilogSymbols(
+      const verible::TokenStreamReferenceView& tokens_view,
+      const std::function<void(const verible::TokenInfo&)>& top_level_token) {
+    for (auto iter : tokens_view) {
+      _AdvanceToken(&*iter);
+      if (AtTopLevel()) top_level_token(*iter);
+    }
+  }
+
+  // Returns true when the tokens seen so far do not leave any tracked
+  // construct open: no module, function or task declaration, procedural
+  // block, begin-end block, or parenthesized/braced group.
+  // Package, interface and class declarations are not tracked.
+  bool AtTopLevel() const;
+
  protected:  // Allow direct testing of some methods.
   // Reads a single token, and may alter it depending on internal state.
   void _AdvanceToken(verible::TokenInfo*);
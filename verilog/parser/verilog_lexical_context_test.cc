@@ -1166,6 +1166,7 @@ class LexicalContextTest : public ::testing::Test, public LexicalContext {
     EXPECT_TRUE(keyword_label_tracker_.ItemMayStart());
     EXPECT_TRUE(balance_stack_.empty());
     EXPECT_TRUE(block_stack_.empty());
+    EXPECT_TRUE(AtTopLevel());
     EXPECT_EQ_REASON(ExpectingBodyItemStart(), true, "first token");
   }
 
@@ -2236,5 +2237,47 @@ endfunction : rat
   ExpectTokenSequence({TK_endfunction, ':', SymbolIdentifier});
 }
 
+TEST_F(LexicalContextTest, AtTopLevelBetweenModules) {
+  const char code[] = R"(
+module m(input a);
+  initial begin
+    f(a);
+  end
+endmodule : m
+module n;
+endmodule
+  )";
+  Tokenize(code);
+  CheckInitialState();
+  ExpectTokenSequence({TK_module, SymbolIdentifier, '(', TK_input});
+  EXPECT_FALSE(AtTopLevel());
+  ExpectTokenSequence({SymbolIdentifier, ')', ';'});
+  EXPECT_FALSE(AtTopLevel());
+  ExpectTokenSequence({TK_initial, TK_begin, SymbolIdentifier, '('});
+  EXPECT_FALSE(AtTopLevel());
+  ExpectTokenSequence({SymbolIdentifier, ')', ';', TK_end});
+  EXPECT_FALSE(AtTopLevel());
+  ExpectTokenSequence({TK_endmodule});
+  EXPECT_TRUE(AtTopLevel());
+  ExpectTokenSequence({':', SymbolIdentifier});
+  EXPECT_TRUE(AtTopLevel());
+  ExpectTokenSequence({TK_module, SymbolIdentifier, ';'});
+  EXPECT_FALSE(AtTopLevel());
+  ExpectTokenSequence({TK_endmodule});
+  EXPECT_TRUE(AtTopLevel());
+}
+
+TEST_F(LexicalContextTest, TopLevelTokenCallback) {
+  const char code[] = "module m; endmodule function f; endfunction";
+  Tokenize(code);
+  std::vector<int> top_level_enums;
+  TransformVerilogSymbols(token_refs_, [&](const TokenInfo& token) {
+    top_level_enums.push_back(token.token_enum());
+  });
+  EXPECT_THAT(top_level_enums,
+              testing::ElementsAre(TK_endmodule, TK_endfunction,
+                                   verible::TK_EOF));
+}
+
 }  // namespace
 }  // namespace verilog
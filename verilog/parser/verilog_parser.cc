@@ -18,7 +18,6 @@
 
 #include "absl/flags/flag.h"
 #include "common/parser/parser_param.h"
-#include "common/util/value_saver.h"
 
 // This flag is referenced in verilog_parse_wrapper (verilog_parser.h),
 // where it controls tracing of the parser.
@@ -36,8 +35,14 @@ extern int verilog_debug;  // symbol defined in bison-generated verilog.tab.cc
 
 // parser wrapper to enable debug traces
 int verilog_parse_wrapper(::verible::ParserParam* param) {
-  const verible::ValueSaver<int> save_global_debug(
-      &verilog_debug, absl::GetFlag(FLAGS_verilog_trace_parser) ? 1 : 0);
+  // verilog_debug is process-global, and files may be parsed concurrently,
+  // so it is set only once, when the first parse starts (after the command
+  // line has been parsed), and never written again.
+  static const bool trace_initialized = [] {
+    verilog_debug = absl::GetFlag(FLAGS_verilog_trace_parser) ? 1 : 0;
+    return true;
+  }();
+  (void)trace_initialized;
   return verilog_parse(param);
 }
 
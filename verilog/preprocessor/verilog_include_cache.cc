@@ -0,0 +1,167 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/preprocessor/verilog_include_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "common/util/file_util.h"
+#include "common/util/logging.h"
+#include "verilog/parser/verilog_lexer.h"
+#include "verilog/parser/verilog_token_enum.h"
+
+namespace verilog {
+
+using verible::TokenInfo;
+using verible::TokenStreamView;
+
+IncludedFile::IncludedFile(absl::string_view resolved_path,
+                           absl::string_view contents)
+    : resolved_path(resolved_path),
+      contents(contents),
+      content_hash(absl::Hash<absl::string_view>()(contents)) {
+  const absl::string_view text(this->contents);
+  VerilogLexer lexer(text);
+  while (true) {
+    const TokenInfo& token(lexer.DoNextToken());
+    if (token.isEOF()) break;
+    if (lexer.TokenIsError(token)) continue;
+    tokens.push_back(token);
+  }
+  tokens.push_back(TokenInfo::EOFToken(text));
+
+  token_view.reserve(tokens.size());
+  for (auto iter = tokens.cbegin(); iter != tokens.cend(); ++iter) {
+    if (VerilogLexer::KeepSyntaxTreeTokens(*iter)) token_view.push_back(iter);
+  }
+  include_guard = FindIncludeGuard(token_view);
+}
+
+absl::string_view FindIncludeGuard(const TokenStreamView& token_view) {
+  size_t size = token_view.size();
+  if (size > 0 && token_view.back()->isEOF()) --size;
+  // `ifndef X `define X <body> `endif
+  if (size < 6) return "";
+  const auto enum_at = [&token_view](size_t i) {
+    return token_view[i]->token_enum();
+  };
+  if (enum_at(0) != PP_ifndef || enum_at(1) != PP_Identifier ||
+      enum_at(2) != PP_define || enum_at(3) != PP_Identifier ||
+      enum_at(4) != PP_define_body) {
+    return "";
+  }
+  const absl::string_view guard = token_view[1]->text();
+  if (token_view[3]->text() != guard) return "";
+
+  // The `ifndef must be closed by the last token, without other branches.
+  int depth = 1;
+  for (size_t i = 5; i < size; ++i) {
+    switch (enum_at(i)) {
+      case PP_ifdef:
+      case PP_ifndef:
+        ++depth;
+        break;
+      case PP_else:
+      case PP_elsif:
+        // Another branch would be taken when the guard is defined.
+        if (depth == 1) return "";
+        break;
+      case PP_endif:
+        if (--depth == 0) return i == size - 1 ? guard : "";
+        break;
+      default:
+        break;
+    }
+  }
+  return "";
+}
+
+std::shared_ptr<const IncludedFile> VerilogIncludeCache::Get(
+    absl::string_view resolved_path, absl::string_view contents) {
+  const size_t content_hash = absl::Hash<absl::string_view>()(contents);
+  {
+    absl::MutexLock lock(&mutex_);
+    const auto found = files_.find(resolved_path);
+    if (found != files_.end() && found->second->content_hash == content_hash &&
+        found->second->contents == contents) {
+      ++hits_;
+      return found->second;
+    }
+    ++misses_;
+  }
+
+  // Lex without holding the lock, so that different files are lexed
+  // concurrently.  If another thread cached the same file meanwhile, either
+  // copy is equally good, and the last one is kept.
+  VLOG(1) << "Lexing included file " << resolved_path;
+  std::shared_ptr<const IncludedFile> file =
+      std::make_shared<IncludedFile>(resolved_path, contents);
+  absl::MutexLock lock(&mutex_);
+  files_[std::string(resolved_path)] = file;
+  return file;
+}
+
+absl::StatusOr<std::shared_ptr<const IncludedFile>> VerilogIncludeCache::Open(
+    absl::string_view resolved_path) {
+  std::string contents;
+  const auto status = verible::file::GetContents(resolved_path, &contents);
+  if (!status.ok()) return status;
+  return Get(resolved_path, contents);
+}
+
+IncludeFileOpener VerilogIncludeCache::MakeOpener(
+    const std::vector<std::string>& include_paths) {
+  return [this, include_paths](absl::string_view referenced_path)
+             -> absl::StatusOr<std::shared_ptr<const IncludedFile>> {
+    for (const auto& include_path : include_paths) {
+      const std::string resolved_path =
+          verible::file::JoinPath(include_path, referenced_path);
+      if (verible::file::FileExists(resolved_path).ok()) {
+        return Open(resolved_path);
+      }
+    }
+    return absl::NotFoundError(absl::StrCat(
+        "Unable to find '", referenced_path,
+        "' among the included paths: ", absl::StrJoin(include_paths, ", ")));
+  };
+}
+
+size_t VerilogIncludeCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return files_.size();
+}
+
+size_t VerilogIncludeCache::hits() const {
+  absl::MutexLock lock(&mutex_);
+  return hits_;
+}
+
+size_t VerilogIncludeCache::misses() const {
+  absl::MutexLock lock(&mutex_);
+  return misses_;
+}
+
+}  // namespace verilog
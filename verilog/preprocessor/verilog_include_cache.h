@@ -0,0 +1,129 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// VerilogIncludeCache keeps `included files lexed once for a whole run, so
+// that the many files that include the same headers share their tokens.
+
+#ifndef VERIBLE_VERILOG_PREPROCESSOR_VERILOG_INCLUDE_CACHE_H_
+#define VERIBLE_VERILOG_PREPROCESSOR_VERILOG_INCLUDE_CACHE_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+
+namespace verilog {
+
+// The lexed contents of an included file, which are never modified after
+// being cached.
+struct IncludedFile {
+  IncludedFile(absl::string_view resolved_path, absl::string_view contents);
+
+  IncludedFile(const IncludedFile&) = delete;
+  IncludedFile& operator=(const IncludedFile&) = delete;
+
+  const std::string resolved_path;
+
+  // Owned copy of the file's text, into which all tokens point.
+  const std::string contents;
+
+  // Hash of 'contents', to tell whether a file changed since it was cached.
+  const size_t content_hash;
+
+  // All tokens of 'contents', ending with an EOF token.  Tokens with lexical
+  // errors are left out, so that they are diagnosed when the file itself is
+  // analyzed, rather than in each file that includes it.
+  verible::TokenSequence tokens;
+
+  // 'tokens' without whitespace and comments (including the EOF token), for
+  // VerilogPreprocess.
+  verible::TokenStreamView token_view;
+
+  // Name of the macro that guards the whole file (see FindIncludeGuard()),
+  // or empty if the file is not guarded.
+  absl::string_view include_guard;
+};
+
+// Returns the name of the macro 'X' if 'token_view' (without whitespace and
+// comments) is a classic include guard:
+//   `ifndef X
+//   `define X
+//   ...
+//   `endif
+// where the `endif closes the `ifndef (without `else or `elsif), and is only
+// followed by the EOF token.  Otherwise, returns an empty string.
+absl::string_view FindIncludeGuard(const verible::TokenStreamView& token_view);
+
+// Opens the file referenced as 'referenced_path' by an `include, or returns
+// an error if it cannot be found or read.
+using IncludeFileOpener =
+    std::function<absl::StatusOr<std::shared_ptr<const IncludedFile>>(
+        absl::string_view referenced_path)>;
+
+// Project-wide cache of lexed included files, keyed by resolved path.
+// An entry is only reused while the file's contents hash the same, so a
+// changed file is lexed again.
+// This class is thread-safe, so a single cache can be shared by all the files
+// of a project that are analyzed concurrently.
+class VerilogIncludeCache {
+ public:
+  VerilogIncludeCache() = default;
+
+  VerilogIncludeCache(const VerilogIncludeCache&) = delete;
+  VerilogIncludeCache& operator=(const VerilogIncludeCache&) = delete;
+
+  // Returns the lexed file for 'resolved_path' with 'contents', lexing it only
+  // if it is not cached yet with the same contents.
+  std::shared_ptr<const IncludedFile> Get(absl::string_view resolved_path,
+                                          absl::string_view contents);
+
+  // Reads the file at 'resolved_path' and returns it like Get().
+  absl::StatusOr<std::shared_ptr<const IncludedFile>> Open(
+      absl::string_view resolved_path);
+
+  // Returns an opener that looks for included files among 'include_paths'
+  // (in order), and opens the first one found through this cache.
+  // This cache must outlive the opener.
+  IncludeFileOpener MakeOpener(const std::vector<std::string>& include_paths);
+
+  // Number of files that are currently cached.
+  size_t size() const;
+
+  // Number of calls to Get() or Open() that were served from the cache, and
+  // that lexed a file.
+  size_t hits() const;
+  size_t misses() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+
+  absl::flat_hash_map<std::string, std::shared_ptr<const IncludedFile>> files_
+      ABSL_GUARDED_BY(mutex_);
+
+  size_t hits_ ABSL_GUARDED_BY(mutex_) = 0;
+  size_t misses_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_PREPROCESSOR_VERILOG_INCLUDE_CACHE_H_
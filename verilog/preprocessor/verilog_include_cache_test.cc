@@ -0,0 +1,170 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/preprocessor/verilog_include_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "common/util/file_util.h"
+#include "gtest/gtest.h"
+
+namespace verilog {
+namespace {
+
+using verible::file::JoinPath;
+
+struct GuardTestCase {
+  absl::string_view text;
+  absl::string_view expected_guard;
+};
+
+TEST(FindIncludeGuardTest, Various) {
+  const GuardTestCase test_cases[] = {
+      {"", ""},
+      {"module m; endmodule\n", ""},
+      {"`ifndef FOO_SVH\n"
+       "`define FOO_SVH\n"
+       "`endif\n",
+       "FOO_SVH"},
+      {"// header comment\n"
+       "`ifndef FOO_SVH  // guard\n"
+       "`define FOO_SVH 1\n"
+       "`ifdef BAR\n"
+       "  `define X 2\n"
+       "`endif\n"
+       "typedef int t;\n"
+       "`endif  // FOO_SVH\n"
+       "// trailing comment\n",
+       "FOO_SVH"},
+      // Different macro names
+      {"`ifndef FOO_SVH\n"
+       "`define BAR_SVH\n"
+       "`endif\n",
+       ""},
+      // `ifdef instead of `ifndef
+      {"`ifdef FOO_SVH\n"
+       "`define FOO_SVH\n"
+       "`endif\n",
+       ""},
+      // Code before the guard
+      {"typedef int t;\n"
+       "`ifndef FOO_SVH\n"
+       "`define FOO_SVH\n"
+       "`endif\n",
+       ""},
+      // Code after the guard
+      {"`ifndef FOO_SVH\n"
+       "`define FOO_SVH\n"
+       "`endif\n"
+       "typedef int t;\n",
+       ""},
+      // The guard is not the only branch
+      {"`ifndef FOO_SVH\n"
+       "`define FOO_SVH\n"
+       "`else\n"
+       "typedef int t;\n"
+       "`endif\n",
+       ""},
+      {"`ifndef FOO_SVH\n"
+       "`define FOO_SVH\n"
+       "`endif\n"
+       "`ifdef BAR\n"
+       "`endif\n",
+       ""},
+      // Function-like macro
+      {"`ifndef FOO_SVH\n"
+       "`define FOO_SVH(x) x\n"
+       "`endif\n",
+       ""},
+  };
+  for (const auto& test : test_cases) {
+    const IncludedFile file("foo.svh", test.text);
+    EXPECT_EQ(file.include_guard, test.expected_guard) << test.text;
+  }
+}
+
+TEST(IncludedFileTest, TokensPointIntoOwnedContents) {
+  std::string text("`define FOO 1\n");
+  const IncludedFile file("foo.svh", text);
+  text.clear();
+  ASSERT_FALSE(file.tokens.empty());
+  EXPECT_TRUE(file.tokens.back().isEOF());
+  EXPECT_EQ(file.tokens.front().text(), "`define");
+  EXPECT_EQ(file.tokens.front().text().data(), file.contents.data());
+  // `define FOO 1 <EOF>
+  ASSERT_EQ(file.token_view.size(), 4);
+  EXPECT_EQ(file.token_view[1]->text(), "FOO");
+  EXPECT_EQ(file.token_view[2]->text(), "1");
+  EXPECT_TRUE(file.token_view[3]->isEOF());
+}
+
+TEST(VerilogIncludeCacheTest, GetReusesSameContents) {
+  VerilogIncludeCache cache;
+  const auto first = cache.Get("a.svh", "`define A\n");
+  const auto second = cache.Get("a.svh", "`define A\n");
+  EXPECT_EQ(first, second);
+  const auto other = cache.Get("b.svh", "`define A\n");
+  EXPECT_NE(other, first);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 2);
+}
+
+TEST(VerilogIncludeCacheTest, GetReplacesChangedContents) {
+  VerilogIncludeCache cache;
+  const auto first = cache.Get("a.svh", "`define A\n");
+  const auto second = cache.Get("a.svh", "`define B\n");
+  EXPECT_NE(first, second);
+  EXPECT_EQ(second->contents, "`define B\n");
+  // The earlier version remains valid for its users.
+  EXPECT_EQ(first->contents, "`define A\n");
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.misses(), 2);
+}
+
+TEST(VerilogIncludeCacheTest, OpenerSearchesIncludePaths) {
+  const std::string dir = JoinPath(testing::TempDir(), "include_cache");
+  const std::string dir1 = JoinPath(dir, "first");
+  const std::string dir2 = JoinPath(dir, "second");
+  ASSERT_TRUE(verible::file::CreateDirs(dir1).ok());
+  ASSERT_TRUE(verible::file::CreateDirs(dir2).ok());
+  const std::string path = JoinPath(dir2, "defs.svh");
+  const absl::string_view contents(
+      "`ifndef DEFS_SVH\n"
+      "`define DEFS_SVH\n"
+      "`endif\n");
+  ASSERT_TRUE(verible::file::SetContents(path, contents).ok());
+
+  VerilogIncludeCache cache;
+  const IncludeFileOpener opener = cache.MakeOpener({dir1, dir2});
+  const auto status_or_file = opener("defs.svh");
+  ASSERT_TRUE(status_or_file.ok()) << status_or_file.status();
+  const auto& file = *status_or_file;
+  EXPECT_EQ(file->resolved_path, path);
+  EXPECT_EQ(file->contents, contents);
+  EXPECT_EQ(file->include_guard, "DEFS_SVH");
+
+  // Reading the same file again does not lex it again.
+  const auto status_or_file2 = opener("defs.svh");
+  ASSERT_TRUE(status_or_file2.ok()) << status_or_file2.status();
+  EXPECT_EQ(*status_or_file2, file);
+  EXPECT_EQ(cache.hits(), 1);
+
+  EXPECT_FALSE(opener("missing.svh").ok());
+}
+
+}  // namespace
+}  // namespace verilog
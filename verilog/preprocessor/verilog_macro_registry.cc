@@ -0,0 +1,72 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/preprocessor/verilog_macro_registry.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "verilog/preprocessor/verilog_include_cache.h"
+
+namespace verilog {
+
+// Returns an error if 'define' would not be a single `define directive of a
+// macro without parameters.
+static absl::Status CheckDefine(absl::string_view define) {
+  const auto error = [define](absl::string_view reason) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid macro definition \"", define, "\": ", reason));
+  };
+  const std::pair<absl::string_view, absl::string_view> name_value =
+      absl::StrSplit(define, absl::MaxSplits('=', 1));
+  const absl::string_view name = name_value.first;
+  if (name.empty()) return error("missing macro name");
+  if (!absl::ascii_isalpha(name[0]) && name[0] != '_') {
+    return error("macro name must start with a letter or '_'");
+  }
+  for (const char c : name) {
+    if (!absl::ascii_isalnum(c) && c != '_' && c != '$') {
+      return error("macro name may only contain letters, digits, '_' and '$'");
+    }
+  }
+  const absl::string_view value = name_value.second;
+  if (value.find_first_of("\n\r") != absl::string_view::npos ||
+      absl::EndsWith(value, "\\")) {
+    return error("macro value must be a single line");
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::shared_ptr<const IncludedFile>> MakeDefinesFile(
+    const std::vector<std::string>& defines) {
+  std::string text;
+  for (const auto& define : defines) {
+    const absl::Status status = CheckDefine(define);
+    if (!status.ok()) return status;
+    const auto name_value = absl::StrSplit(define, absl::MaxSplits('=', 1));
+    absl::StrAppend(&text, "`define ", absl::StrJoin(name_value, " "), "\n");
+  }
+  return std::make_shared<const IncludedFile>("<defines>", text);
+}
+
+}  // namespace verilog
@@ -0,0 +1,83 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// SharedMacroRegistry holds macro definitions that apply to many files, like
+// those of global defines headers, so that they are preprocessed only once.
+
+#ifndef VERIBLE_VERILOG_PREPROCESSOR_VERILOG_MACRO_REGISTRY_H_
+#define VERIBLE_VERILOG_PREPROCESSOR_VERILOG_MACRO_REGISTRY_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/text/macro_definition.h"
+#include "verilog/preprocessor/verilog_include_cache.h"
+
+namespace verilog {
+
+// Macro definitions, keyed by name.
+using MacroDefinitionMap =
+    absl::flat_hash_map<absl::string_view, verible::MacroDefinition>;
+
+// An immutable set of macro definitions, which is safe to share among all the
+// files and threads of a run.  Each file's preprocessor records its own
+// `define and `undef directives on top of it (see VerilogPreprocessData), so
+// this is never copied.
+// Build one with VerilogPreprocess::BuildMacroRegistry().
+class SharedMacroRegistry {
+ public:
+  // 'sources' own the text that 'definitions' refer to.
+  SharedMacroRegistry(MacroDefinitionMap definitions,
+                      std::vector<std::shared_ptr<const IncludedFile>> sources)
+      : definitions_(std::move(definitions)), sources_(std::move(sources)) {}
+
+  SharedMacroRegistry(const SharedMacroRegistry&) = delete;
+  SharedMacroRegistry& operator=(const SharedMacroRegistry&) = delete;
+
+  // Returns the definition of the macro 'name', or nullptr.
+  const verible::MacroDefinition* Find(absl::string_view name) const {
+    const auto found = definitions_.find(name);
+    return found == definitions_.end() ? nullptr : &found->second;
+  }
+
+  const MacroDefinitionMap& Definitions() const { return definitions_; }
+
+  const std::vector<std::shared_ptr<const IncludedFile>>& Sources() const {
+    return sources_;
+  }
+
+  size_t size() const { return definitions_.size(); }
+
+ private:
+  const MacroDefinitionMap definitions_;
+
+  const std::vector<std::shared_ptr<const IncludedFile>> sources_;
+};
+
+// Returns a file of `define directives for 'defines', each of which is "NAME"
+// or "NAME=VALUE", like +define+NAME=VALUE or -DNAME=VALUE of simulators.
+// Returns an error for the first one with an invalid name, or with a value
+// that does not fit on one line.
+absl::StatusOr<std::shared_ptr<const IncludedFile>> MakeDefinesFile(
+    const std::vector<std::string>& defines);
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_PREPROCESSOR_VERILOG_MACRO_REGISTRY_H_
@@ -17,6 +17,7 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -39,8 +40,23 @@ namespace verilog {
 using verible::TokenGenerator;
 using verible::TokenInfo;
 using verible::TokenStreamView;
+using verible::container::FindOrNull;
 using verible::container::InsertOrUpdate;
 
+const verible::MacroDefinition* VerilogPreprocessData::FindMacroDefinition(
+    absl::string_view name) const {
+  const auto* definition = FindOrNull(macro_definitions, name);
+  if (definition != nullptr) return definition;
+  if (shared_macros == nullptr || undefined_shared_macros.contains(name)) {
+    return nullptr;
+  }
+  return shared_macros->Find(name);
+}
+
+// Deeper nesting of included files is assumed to be an unguarded recursive
+// `include, which is not followed.
+static constexpr int kMaxIncludeDepth = 64;
+
 // Copies `define token iterators into a temporary buffer.
 // Assumes that the last token of a definition is the un-lexed definition body.
 // Tokens are copied from the 'generator' into 'define_tokens'.
@@ -180,18 +196,45 @@ std::unique_ptr<VerilogPreprocessError> VerilogPreprocess::ParseMacroDefinition(
 absl::Status VerilogPreprocess::HandleTokenIterator(
     const TokenStreamView::const_iterator iter,
     const StreamIteratorGenerator& generator) {
+  const int token_enum = (*iter)->token_enum();
+  if (config_.filter_branches) {
+    switch (token_enum) {
+      case PP_ifdef:
+      case PP_ifndef:
+      case PP_elsif:
+      case PP_else:
+      case PP_endif:
+        return HandleConditional(iter, generator);
+      default:
+        // Tokens of inactive branches are dropped, one at a time.
+        if (!BranchIsActive()) return absl::OkStatus();
+    }
+  }
   // For now, pass through all macro definition tokens to next consumer
   // (parser).
-  switch ((*iter)->token_enum()) {
+  switch (token_enum) {
     case PP_define:
       return HandleDefine(iter, generator);
+    case PP_undef:
+      if (HandlesUndef()) return HandleUndef(iter, generator);
+      EmitToken(iter);
+      return absl::OkStatus();
+    case PP_include:
+      if (config_.include_file_opener) return HandleInclude(iter, generator);
+      EmitToken(iter);
+      return absl::OkStatus();
     default:
       // All other tokens are passed through unmodified.
-      preprocess_data_.preprocessed_token_stream.push_back(*iter);
+      EmitToken(iter);
       return absl::OkStatus();
   }
 }
 
+void VerilogPreprocess::EmitToken(TokenStreamView::const_iterator iter) {
+  if (include_depth_ > 0) return;
+  preprocess_data_.preprocessed_token_stream.push_back(*iter);
+}
+
 // Stores a macro definition for later use.
 void VerilogPreprocess::RegisterMacroDefinition(
     const MacroDefinition& definition) {
@@ -202,6 +245,7 @@ void VerilogPreprocess::RegisterMacroDefinition(
   if (!inserted) {
     LOG(INFO) << "Re-defining macro " << definition.Name();
   }
+  preprocess_data_.undefined_shared_macros.erase(definition.Name());
   // TODO(fangism): diagnose re-definitions
 }
 
@@ -231,15 +275,168 @@ absl::Status VerilogPreprocess::HandleDefine(
   }
   // For now, forward all definition tokens.
   RegisterMacroDefinition(macro_definition);
-  for (const auto& token : define_tokens) {
-    preprocess_data_.preprocessed_token_stream.push_back(token);
+  for (auto token_iter = define_tokens.begin();
+       token_iter != define_tokens.end(); ++token_iter) {
+    EmitToken(token_iter);
   }
   return absl::OkStatus();
 }
 
-VerilogPreprocessData VerilogPreprocess::ScanStream(
+// Responds to `include "file" directives by scanning the included file for
+// macro definitions.  The directive itself is passed through.
+absl::Status VerilogPreprocess::HandleInclude(
+    const TokenStreamView::const_iterator iter,  // points to `include token
+    const StreamIteratorGenerator& generator) {
+  EmitToken(iter);
+  const TokenStreamView::const_iterator path_iter = generator();
+  if ((*path_iter)->token_enum() != TK_StringLiteral) {
+    // Includes of macro-expanded paths are not followed.
+    return HandleTokenIterator(path_iter, generator);
+  }
+  EmitToken(path_iter);
+
+  const absl::string_view path_text = (*path_iter)->text();
+  const absl::string_view referenced_path =
+      path_text.substr(1, path_text.length() - 2);  // without quotes
+  if (include_depth_ >= kMaxIncludeDepth) {
+    LOG(WARNING) << "Not following `include \"" << referenced_path
+                 << "\" nested " << include_depth_ << " files deep.";
+    return absl::OkStatus();
+  }
+
+  // A guarded file that was already scanned can be skipped without looking
+  // it up again.
+  const auto* previous =
+      FindOrNull(preprocess_data_.included_files, referenced_path);
+  if (previous != nullptr) {
+    const IncludedFile& file(**previous);
+    if (!file.include_guard.empty() &&
+        preprocess_data_.FindMacroDefinition(file.include_guard) != nullptr) {
+      ++preprocess_data_.skipped_includes;
+      return absl::OkStatus();
+    }
+    ScanIncludedFile(referenced_path, file);
+    return absl::OkStatus();
+  }
+
+  const auto status_or_file = config_.include_file_opener(referenced_path);
+  if (!status_or_file.ok()) {
+    // Tolerate missing files, like the rest of the pseudo-preprocessor.
+    VLOG(1) << status_or_file.status().message();
+    return absl::OkStatus();
+  }
+  const std::shared_ptr<const IncludedFile>& file = *status_or_file;
+  // Retain the file, which owns the text of its macro definitions.
+  preprocess_data_.included_files.emplace(referenced_path, file);
+  ScanIncludedFile(referenced_path, *file);
+  return absl::OkStatus();
+}
+
+// Responds to `undef directives by forgetting the macro definition.
+absl::Status VerilogPreprocess::HandleUndef(
+    const TokenStreamView::const_iterator iter,  // points to `undef token
+    const StreamIteratorGenerator& generator) {
+  EmitToken(iter);
+  const TokenStreamView::const_iterator name_iter = generator();
+  if ((*name_iter)->token_enum() != PP_Identifier) {
+    return HandleTokenIterator(name_iter, generator);
+  }
+  EmitToken(name_iter);
+  const absl::string_view name = (*name_iter)->text();
+  preprocess_data_.macro_definitions.erase(name);
+  // Shared definitions are not modified, but hidden.
+  if (preprocess_data_.shared_macros != nullptr &&
+      preprocess_data_.shared_macros->Find(name) != nullptr) {
+    preprocess_data_.undefined_shared_macros.insert(name);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status VerilogPreprocess::ConditionalError(const TokenInfo& token,
+                                                 absl::string_view message) {
+  preprocess_data_.errors.emplace_back(token, std::string(message));
+  return absl::InvalidArgumentError("Error in preprocessor conditional.");
+}
+
+// Evaluates a conditional directive, and updates the state of the innermost
+// conditional block.  The directives themselves are not passed through.
+absl::Status VerilogPreprocess::HandleConditional(
+    const TokenStreamView::const_iterator iter,
+    const StreamIteratorGenerator& generator) {
+  const TokenInfo& directive(**iter);
+  const int directive_enum = directive.token_enum();
+  bool defined = false;
+  if (directive_enum != PP_else && directive_enum != PP_endif) {
+    const TokenStreamView::const_iterator name_iter = generator();
+    if ((*name_iter)->token_enum() != PP_Identifier) {
+      return ConditionalError(
+          **name_iter, absl::StrCat("expected macro name after ",
+                                    directive.text(), ", but got: ",
+                                    (*name_iter)->ToString()));
+    }
+    defined = preprocess_data_.FindMacroDefinition((*name_iter)->text()) !=
+              nullptr;
+  }
+
+  if (directive_enum == PP_ifdef || directive_enum == PP_ifndef) {
+    const bool parent_active = BranchIsActive();
+    const bool active =
+        parent_active && defined == (directive_enum == PP_ifdef);
+    conditional_blocks_.push_back({directive, parent_active, active, active,
+                                   /* in_else= */ false});
+    return absl::OkStatus();
+  }
+
+  if (conditional_blocks_.size() <= conditional_base_) {
+    return ConditionalError(
+        directive,
+        absl::StrCat(directive.text(), " without `ifdef or `ifndef"));
+  }
+  ConditionalBlock& block(conditional_blocks_.back());
+  switch (directive_enum) {
+    case PP_elsif:
+    case PP_else:
+      if (block.in_else) {
+        return ConditionalError(directive,
+                                absl::StrCat(directive.text(), " after `else"));
+      }
+      block.active = block.parent_active && !block.taken &&
+                     (directive_enum == PP_else || defined);
+      block.taken |= block.active;
+      block.in_else = directive_enum == PP_else;
+      break;
+    default:  // PP_endif
+      conditional_blocks_.pop_back();
+  }
+  return absl::OkStatus();
+}
+
+void VerilogPreprocess::ScanIncludedFile(absl::string_view referenced_path,
+                                         const IncludedFile& file) {
+  VLOG(2) << "Scanning included file " << file.resolved_path;
+  // Errors in included files are diagnosed when those files are analyzed,
+  // because their positions do not refer to the including file's text.
+  // The included file's conditional blocks are its own, and any that it leaves
+  // open are closed at its end.
+  const size_t num_errors = preprocess_data_.errors.size();
+  const size_t conditional_base = conditional_base_;
+  conditional_base_ = conditional_blocks_.size();
+  ++include_depth_;
+  const auto status = ScanTokens(file.token_view);
+  --include_depth_;
+  conditional_blocks_.erase(conditional_blocks_.begin() + conditional_base_,
+                            conditional_blocks_.end());
+  conditional_base_ = conditional_base;
+  if (!status.ok()) {
+    VLOG(1) << "Ignoring preprocessing errors in `include \""
+            << referenced_path << "\"";
+    preprocess_data_.errors.erase(preprocess_data_.errors.begin() + num_errors,
+                                  preprocess_data_.errors.end());
+  }
+}
+
+absl::Status VerilogPreprocess::ScanTokens(
     const TokenStreamView& token_stream) {
-  preprocess_data_.preprocessed_token_stream.reserve(token_stream.size());
   auto iter_generator = verible::MakeConstIteratorStreamer(token_stream);
   const auto end = token_stream.end();
   auto iter = iter_generator();
@@ -248,10 +445,83 @@ VerilogPreprocessData VerilogPreprocess::ScanStream(
     const auto status = HandleTokenIterator(iter, iter_generator);
     if (!status.ok()) {
       // Detailed errors are already in preprocessor_data_.errors.
-      break;  // For now, stop after first error.
+      return status;  // For now, stop after first error.
     }
     iter = iter_generator();
   }
+  return absl::OkStatus();
+}
+
+// Registers the configured macro definitions, which are lexed like an included
+// file.
+absl::Status VerilogPreprocess::RegisterPredefinedMacros() {
+  const auto status_or_file = MakeDefinesFile(config_.defines);
+  if (!status_or_file.ok()) return status_or_file.status();
+  const auto& file = *status_or_file;
+  preprocess_data_.included_files.emplace(file->resolved_path, file);
+  ScanIncludedFile(file->resolved_path, *file);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::shared_ptr<const SharedMacroRegistry>>
+VerilogPreprocess::BuildMacroRegistry(
+    const std::vector<std::shared_ptr<const IncludedFile>>& files,
+    const Config& config) {
+  VerilogPreprocess preprocessor(config);
+  if (!config.defines.empty()) {
+    const auto status = preprocessor.RegisterPredefinedMacros();
+    if (!status.ok()) return status;
+  }
+  for (const auto& file : files) {
+    preprocessor.ScanIncludedFile(file->resolved_path, *file);
+  }
+  VerilogPreprocessData& data(preprocessor.preprocess_data_);
+
+  // Flatten the configured registry and this one's changes to it.
+  MacroDefinitionMap definitions;
+  std::vector<std::shared_ptr<const IncludedFile>> sources(files);
+  if (data.shared_macros != nullptr) {
+    for (const auto& entry : data.shared_macros->Definitions()) {
+      if (!data.undefined_shared_macros.contains(entry.first)) {
+        definitions.insert(entry);
+      }
+    }
+    sources.insert(sources.end(), data.shared_macros->Sources().begin(),
+                   data.shared_macros->Sources().end());
+  }
+  for (auto& entry : data.macro_definitions) {
+    definitions.insert_or_assign(entry.first, std::move(entry.second));
+  }
+  for (const auto& entry : data.included_files) {
+    sources.push_back(entry.second);
+  }
+  return std::make_shared<const SharedMacroRegistry>(std::move(definitions),
+                                                     std::move(sources));
+}
+
+VerilogPreprocessData VerilogPreprocess::ScanStream(
+    const TokenStreamView& token_stream) {
+  if (!config_.defines.empty()) {
+    const auto status = RegisterPredefinedMacros();
+    if (!status.ok()) {
+      // The defines have no position of their own, so the error is reported
+      // at the start of the file.
+      preprocess_data_.errors.emplace_back(
+          token_stream.empty() ? verible::TokenInfo::EOFToken()
+                               : *token_stream.front(),
+          std::string(status.message()));
+      return std::move(preprocess_data_);
+    }
+  }
+  preprocess_data_.preprocessed_token_stream.reserve(token_stream.size());
+  const auto status = ScanTokens(token_stream);
+  if (status.ok() && !conditional_blocks_.empty()) {
+    ConditionalError(
+        conditional_blocks_.back().opening_directive,
+        absl::StrCat("unterminated ",
+                     conditional_blocks_.back().opening_directive.text()))
+        .IgnoreError();
+  }
   return std::move(preprocess_data_);
 }
 
@@ -13,9 +13,10 @@
 // limitations under the License.
 
 // VerilogPreprocess is a *pseudo*-preprocessor for Verilog.
-// Unlike a conventional preprocessor, this pseudo-preprocessor does not open
-// included files, nor does it evaluate preprocessor expressions.
-// Instead, it does a best-effort handling of preprocessor directives
+// Unlike a conventional preprocessor, this pseudo-preprocessor only evaluates
+// conditionals and opens included files when configured to, and then only to
+// choose branches and to learn macro definitions.
+// Otherwise, it does a best-effort handling of preprocessor directives
 // locally within one file, and no additional context.
 // For example, it may expand a macro call if its definition happens to be
 // available, but it is not required to do so.
@@ -26,7 +27,6 @@
 // TODO(fangism): expand macros if locally defined, and feed un-lexed
 //   body text to lexer.  This approach works if the definition text
 //   does not depend on the start-condition state at the macro call site.
-// TODO(fangism): implement conditional evaluation policy (`ifdef, `else, ...)
 // TODO(fangism): token concatenation, e.g. a``b
 //   This will produce tokens that are not in the original source text.
 // TODO(fangism): token string-ification (turning symbol names into strings)
@@ -35,22 +35,26 @@
 #ifndef VERIBLE_VERILOG_PREPROCESSOR_VERILOG_PREPROCESS_H_
 #define VERIBLE_VERILOG_PREPROCESSOR_VERILOG_PREPROCESS_H_
 
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "common/text/macro_definition.h"
 #include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
+#include "verilog/preprocessor/verilog_include_cache.h"
+#include "verilog/preprocessor/verilog_macro_registry.h"
 
 namespace verilog {
 
-// TODO(fangism): configuration policy enums.
-
 // VerilogPreprocessError contains preprocessor error information.
 struct VerilogPreprocessError {
   verible::TokenInfo token_info;  // offending token
@@ -64,16 +68,37 @@ struct VerilogPreprocessError {
 // Information that results from preprocessing.
 struct VerilogPreprocessData {
   using MacroDefinition = verible::MacroDefinition;
-  using MacroDefinitionRegistry = std::map<absl::string_view, MacroDefinition>;
+  using MacroDefinitionRegistry = MacroDefinitionMap;
+
+  // Returns the definition of the macro 'name' that is in effect after
+  // preprocessing, or nullptr.
+  const MacroDefinition* FindMacroDefinition(absl::string_view name) const;
 
   // Resulting token stream after preprocessing
   verible::TokenStreamView preprocessed_token_stream;
 
-  // Map of defined macros.
+  // Macros defined (or re-defined) by this file and the files it includes.
   MacroDefinitionRegistry macro_definitions;
 
+  // Definitions shared with other files (Config::shared_macros), which apply
+  // unless they are re-defined in 'macro_definitions', or undefined.
+  std::shared_ptr<const SharedMacroRegistry> shared_macros;
+
+  // Names of shared macros that were undefined by `undef.
+  absl::flat_hash_set<absl::string_view> undefined_shared_macros;
+
   // Sequence of tokens rejected by preprocessing.
   std::vector<VerilogPreprocessError> errors;
+
+  // Files that were scanned for `include directives, keyed by the path with
+  // which they were first included.  These own the text of the macro
+  // definitions that come from them.
+  std::map<absl::string_view, std::shared_ptr<const IncludedFile>>
+      included_files;
+
+  // Number of `include directives that were skipped, because their file's
+  // include guard was already defined.
+  size_t skipped_includes = 0;
 };
 
 // VerilogPreprocess transforms a TokenStreamView.
@@ -84,8 +109,51 @@ class VerilogPreprocess {
   using MacroParameterInfo = verible::MacroParameterInfo;
 
  public:
+  // Optional preprocessing steps.  By default, all tokens are passed through,
+  // and only the file's own macro definitions are registered.
+  struct Config {
+    // If set, files named by `include "..." directives are opened, and their
+    // macro definitions (and nested includes) are registered, as if they were
+    // defined in place.  Their tokens are not added to the preprocessed token
+    // stream, which keeps the `include directive.
+    // A file with an include guard (see FindIncludeGuard()) is skipped
+    // without being opened again once its guard macro is defined.
+    IncludeFileOpener include_file_opener;
+
+    // If set, these macros are defined before the first token.  They are not
+    // copied, and each file only records its own changes to them.
+    std::shared_ptr<const SharedMacroRegistry> shared_macros;
+
+    // Macros that are defined before the first token (after shared_macros),
+    // each as "NAME" or "NAME=VALUE", like +define+NAME=VALUE or -DNAME=VALUE
+    // of simulators.  Unlike shared_macros, these are lexed for every file.
+    std::vector<std::string> defines;
+
+    // If true, `ifdef, `ifndef, `elsif and `else are evaluated with the macros
+    // defined so far, and the tokens of inactive branches are dropped from the
+    // preprocessed token stream, along with all conditional directives.
+    // Definitions, `undef and `include in inactive branches are ignored.
+    bool filter_branches = false;
+  };
+
   VerilogPreprocess() : preprocess_data_() {}
 
+  explicit VerilogPreprocess(Config config)
+      : config_(std::move(config)), preprocess_data_() {
+    preprocess_data_.shared_macros = config_.shared_macros;
+  }
+
+  // Preprocesses 'files' in order, like `included files, and returns the
+  // macros that they define (along with config.shared_macros and
+  // config.defines), for use as Config::shared_macros of many files.
+  // The rest of 'config' applies to 'files'.
+  // Errors in 'files' are ignored, like those of included files, but invalid
+  // config.defines are returned (see MakeDefinesFile()).
+  static absl::StatusOr<std::shared_ptr<const SharedMacroRegistry>>
+  BuildMacroRegistry(
+      const std::vector<std::shared_ptr<const IncludedFile>>& files,
+      const Config& config);
+
   // ScanStream reads in a stream of tokens returns the result as a move
   // of preprocessor_data_.  preprocessor_data_ should not be accessed
   // after this returns.
@@ -104,6 +172,50 @@ class VerilogPreprocess {
   absl::Status HandleDefine(const TokenStreamView::const_iterator,
                             const StreamIteratorGenerator&);
 
+  absl::Status HandleInclude(const TokenStreamView::const_iterator,
+                             const StreamIteratorGenerator&);
+
+  absl::Status HandleUndef(const TokenStreamView::const_iterator,
+                           const StreamIteratorGenerator&);
+
+  // Evaluates `ifdef, `ifndef, `elsif, `else and `endif directives, when
+  // filtering branches.
+  absl::Status HandleConditional(const TokenStreamView::const_iterator,
+                                 const StreamIteratorGenerator&);
+
+  // Records an error at 'token', and returns the status that stops scanning.
+  absl::Status ConditionalError(const verible::TokenInfo& token,
+                                absl::string_view message);
+
+  // Returns true if tokens of the current conditional branch are kept.
+  bool BranchIsActive() const {
+    return conditional_blocks_.size() <= conditional_base_ ||
+           conditional_blocks_.back().active;
+  }
+
+  // Scans the tokens of an included file.
+  void ScanIncludedFile(absl::string_view referenced_path,
+                        const IncludedFile& file);
+
+  // Registers the macros of Config::defines, or returns an error if one of
+  // them is invalid.
+  absl::Status RegisterPredefinedMacros();
+
+  // Returns true if `undef removes macro definitions.  This only matters, and
+  // is only done, when macros are evaluated or come from outside the file.
+  bool HandlesUndef() const {
+    return config_.filter_branches || config_.include_file_opener ||
+           config_.shared_macros != nullptr || !config_.defines.empty();
+  }
+
+  // Runs the token-pulling loop over 'token_stream', stopping at the first
+  // error.
+  absl::Status ScanTokens(const TokenStreamView& token_stream);
+
+  // Appends a token to the preprocessed token stream, unless it belongs to an
+  // included file.
+  void EmitToken(TokenStreamView::const_iterator);
+
   // The following functions return nullptr when there is no error:
   static std::unique_ptr<VerilogPreprocessError> ConsumeMacroDefinition(
       const StreamIteratorGenerator&, TokenStreamView*);
@@ -116,6 +228,33 @@ class VerilogPreprocess {
 
   void RegisterMacroDefinition(const MacroDefinition&);
 
+  // The state of an `ifdef or `ifndef, and of its other branches so far.
+  struct ConditionalBlock {
+    // The directive that opened the block, for diagnostics.
+    verible::TokenInfo opening_directive;
+    // True if the block itself is in an active branch.
+    bool parent_active;
+    // True if one of the branches so far was taken.
+    bool taken;
+    // True if the current branch is taken.
+    bool active;
+    // True after the `else.
+    bool in_else;
+  };
+
+  const Config config_;
+
+  // Open conditional blocks, innermost last.
+  std::vector<ConditionalBlock> conditional_blocks_;
+
+  // Number of conditional blocks that belong to the files that include the
+  // one being scanned, which cannot be continued or closed by it.
+  size_t conditional_base_ = 0;
+
+  // Number of included files that are being scanned, which are nested in
+  // each other.
+  int include_depth_ = 0;
+
   // Results of preprocessing
   VerilogPreprocessData preprocess_data_;
 };
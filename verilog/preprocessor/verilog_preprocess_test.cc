@@ -14,22 +14,33 @@
 
 #include "verilog/preprocessor/verilog_preprocess.h"
 
+#include <initializer_list>
 #include <map>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
 #include "common/text/macro_definition.h"
 #include "common/text/token_info.h"
 #include "common/util/container_util.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "verilog/analysis/verilog_analyzer.h"
+#include "verilog/parser/verilog_token_enum.h"
+#include "verilog/preprocessor/verilog_include_cache.h"
+#include "verilog/preprocessor/verilog_macro_registry.h"
 
 namespace verilog {
 namespace {
 
 using testing::ElementsAre;
+using testing::IsEmpty;
 using testing::Pair;
+using testing::UnorderedElementsAre;
 using verible::container::FindOrNull;
 
 class PreprocessorTester {
@@ -206,8 +217,8 @@ TEST(VerilogPreprocessTest, TwoMacroDefinitions) {
   EXPECT_TRUE(tester.Status().ok()) << "Unexpected analyzer failure.";
   EXPECT_TRUE(tester.PreprocessorData().errors.empty());
   EXPECT_TRUE(tester.Analyzer().GetRejectedTokens().empty());
-  EXPECT_THAT(definitions, ElementsAre(Pair("BAAAAR", testing::_),
-                                       Pair("FOOOO", testing::_)));
+  EXPECT_THAT(definitions, UnorderedElementsAre(Pair("BAAAAR", testing::_),
+                                                Pair("FOOOO", testing::_)));
   {
     auto macro = FindOrNull(definitions, "BAAAAR");
     ASSERT_NE(macro, nullptr);
@@ -224,5 +235,462 @@ TEST(VerilogPreprocessTest, TwoMacroDefinitions) {
   }
 }
 
+// Opens included files from a fixed set of in-memory headers, through a
+// cache, and counts the calls.
+class FakeIncludeFiles {
+ public:
+  FakeIncludeFiles(
+      std::initializer_list<std::pair<const std::string, std::string>> headers)
+      : headers_(headers) {}
+
+  IncludeFileOpener Opener() {
+    return [this](absl::string_view path)
+               -> absl::StatusOr<std::shared_ptr<const IncludedFile>> {
+      ++open_count_;
+      const auto found = headers_.find(std::string(path));
+      if (found == headers_.end()) return absl::NotFoundError(path);
+      return cache_.Get(path, found->second);
+    };
+  }
+
+  VerilogPreprocess::Config Config() {
+    VerilogPreprocess::Config config;
+    config.include_file_opener = Opener();
+    return config;
+  }
+
+  int OpenCount() const { return open_count_; }
+
+  const VerilogIncludeCache& Cache() const { return cache_; }
+
+ private:
+  const std::map<std::string, std::string> headers_;
+  VerilogIncludeCache cache_;
+  int open_count_ = 0;
+};
+
+TEST(VerilogPreprocessIncludeTest, IncludesAreNotFollowedByDefault) {
+  PreprocessorTester tester("`include \"defs.svh\"\n");
+  EXPECT_TRUE(tester.Status().ok());
+  EXPECT_THAT(tester.PreprocessorData().included_files, IsEmpty());
+  EXPECT_THAT(tester.PreprocessorData().macro_definitions, IsEmpty());
+}
+
+TEST(VerilogPreprocessIncludeTest, RegistersIncludedDefinitions) {
+  FakeIncludeFiles headers({
+      {"defs.svh", "`define WIDTH 8\n`include \"more.svh\"\n"},
+      {"more.svh", "`define DEPTH(x) (x*2)\n"},
+  });
+  VerilogAnalyzer analyzer(
+      "`include \"defs.svh\"\n"
+      "`include \"missing.svh\"\n"
+      "`define LOCAL 1\n"
+      "module m; endmodule\n",
+      "<<inline-file>>");
+  analyzer.SetPreprocessConfig(headers.Config());
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  const auto& data = analyzer.PreprocessorData();
+  EXPECT_TRUE(data.errors.empty());
+  EXPECT_THAT(data.macro_definitions,
+              UnorderedElementsAre(Pair("DEPTH", testing::_),
+                                   Pair("LOCAL", testing::_),
+                                   Pair("WIDTH", testing::_)));
+  EXPECT_THAT(data.included_files, ElementsAre(Pair("defs.svh", testing::_),
+                                               Pair("more.svh", testing::_)));
+  // Included tokens are not spliced into the stream.
+  for (const auto& token : data.preprocessed_token_stream) {
+    EXPECT_NE(token->text(), "WIDTH");
+  }
+}
+
+TEST(VerilogPreprocessIncludeTest, SkipsGuardedIncludes) {
+  FakeIncludeFiles headers({
+      {"guarded.svh",
+       "`ifndef GUARDED_SVH\n"
+       "`define GUARDED_SVH\n"
+       "`define G 1\n"
+       "`endif\n"},
+      {"unguarded.svh", "`define U 1\n"},
+      {"uses.svh", "`include \"guarded.svh\"\n"},
+  });
+  VerilogAnalyzer analyzer(
+      "`include \"guarded.svh\"\n"
+      "`include \"uses.svh\"\n"
+      "`include \"guarded.svh\"\n"
+      "`include \"unguarded.svh\"\n"
+      "`include \"unguarded.svh\"\n",
+      "<<inline-file>>");
+  analyzer.SetPreprocessConfig(headers.Config());
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  const auto& data = analyzer.PreprocessorData();
+  EXPECT_EQ(data.skipped_includes, 2);
+  // Each file is only opened once.
+  EXPECT_EQ(headers.OpenCount(), 3);
+  EXPECT_EQ(headers.Cache().misses(), 3);
+  EXPECT_THAT(data.macro_definitions,
+              UnorderedElementsAre(Pair("G", testing::_),
+                                   Pair("GUARDED_SVH", testing::_),
+                                   Pair("U", testing::_)));
+}
+
+TEST(VerilogPreprocessIncludeTest, SharesCacheAcrossFiles) {
+  FakeIncludeFiles headers({{"defs.svh", "`define WIDTH 8\n"}});
+  for (int i = 0; i < 3; ++i) {
+    VerilogAnalyzer analyzer("`include \"defs.svh\"\n", "<<inline-file>>");
+    analyzer.SetPreprocessConfig(headers.Config());
+    EXPECT_TRUE(analyzer.Analyze().ok());
+    EXPECT_THAT(analyzer.PreprocessorData().macro_definitions,
+                ElementsAre(Pair("WIDTH", testing::_)));
+  }
+  EXPECT_EQ(headers.Cache().misses(), 1);
+  EXPECT_EQ(headers.Cache().hits(), 2);
+}
+
+TEST(VerilogPreprocessIncludeTest, RecursiveUnguardedIncludeStops) {
+  FakeIncludeFiles headers({{"self.svh", "`include \"self.svh\"\n"}});
+  VerilogAnalyzer analyzer("`include \"self.svh\"\n", "<<inline-file>>");
+  analyzer.SetPreprocessConfig(headers.Config());
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  EXPECT_EQ(headers.OpenCount(), 1);
+}
+
+TEST(VerilogPreprocessIncludeTest, IgnoresErrorsInIncludedFiles) {
+  FakeIncludeFiles headers({{"bad.svh", "`define 789\n"}});
+  VerilogAnalyzer analyzer(
+      "`include \"bad.svh\"\n"
+      "`define OK 1\n",
+      "<<inline-file>>");
+  analyzer.SetPreprocessConfig(headers.Config());
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  const auto& data = analyzer.PreprocessorData();
+  EXPECT_TRUE(data.errors.empty());
+  EXPECT_THAT(data.macro_definitions, ElementsAre(Pair("OK", testing::_)));
+}
+
+// Returns the identifiers in the preprocessed token stream.
+std::vector<absl::string_view> PreprocessedIdentifiers(
+    const VerilogPreprocessData& data) {
+  std::vector<absl::string_view> identifiers;
+  for (const auto& token : data.preprocessed_token_stream) {
+    if (token->token_enum() == SymbolIdentifier) {
+      identifiers.push_back(token->text());
+    }
+  }
+  return identifiers;
+}
+
+VerilogPreprocess::Config FilterBranchesConfig(
+    std::vector<std::string> defines = {}) {
+  VerilogPreprocess::Config config;
+  config.defines = std::move(defines);
+  config.filter_branches = true;
+  return config;
+}
+
+constexpr char kConditionalModules[] =
+    "`ifdef A\n"
+    "module a; endmodule\n"
+    "`elsif B\n"
+    "module b; endmodule\n"
+    "`ifndef C\n"
+    "module b_not_c; endmodule\n"
+    "`endif\n"
+    "`else\n"
+    "module not_a_b; endmodule\n"
+    "`endif\n";
+
+TEST(VerilogPreprocessConditionalTest, AllBranchesPassByDefault) {
+  PreprocessorTester tester(kConditionalModules);
+  EXPECT_TRUE(tester.PreprocessorData().errors.empty());
+  EXPECT_THAT(PreprocessedIdentifiers(tester.PreprocessorData()),
+              ElementsAre("a", "b", "b_not_c", "not_a_b"));
+}
+
+TEST(VerilogPreprocessConditionalTest, KeepsActiveBranches) {
+  const struct {
+    std::vector<std::string> defines;
+    std::vector<absl::string_view> expected_identifiers;
+  } test_cases[] = {
+      {{}, {"not_a_b"}},
+      {{"A"}, {"a"}},
+      {{"A", "B"}, {"a"}},
+      {{"B"}, {"b", "b_not_c"}},
+      {{"B", "C"}, {"b"}},
+      {{"C"}, {"not_a_b"}},
+  };
+  for (const auto& test : test_cases) {
+    VerilogAnalyzer analyzer(kConditionalModules, "<<inline-file>>");
+    analyzer.SetPreprocessConfig(FilterBranchesConfig(test.defines));
+    EXPECT_TRUE(analyzer.Analyze().ok());
+    const auto& data = analyzer.PreprocessorData();
+    EXPECT_TRUE(data.errors.empty());
+    EXPECT_EQ(PreprocessedIdentifiers(data), test.expected_identifiers)
+        << "defines: " << absl::StrJoin(test.defines, ",");
+    // Conditional directives are not passed through.
+    for (const auto& token : data.preprocessed_token_stream) {
+      EXPECT_NE(token->token_enum(), PP_ifdef);
+      EXPECT_NE(token->token_enum(), PP_endif);
+    }
+  }
+}
+
+TEST(VerilogPreprocessConditionalTest, ConfiguredDefinesAreRegistered) {
+  VerilogAnalyzer analyzer("", "<<inline-file>>");
+  analyzer.SetPreprocessConfig(FilterBranchesConfig({"A", "B=2", "C=x=y"}));
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  const auto& definitions = analyzer.PreprocessorData().macro_definitions;
+  EXPECT_THAT(definitions,
+              UnorderedElementsAre(Pair("A", testing::_), Pair("B", testing::_),
+                                   Pair("C", testing::_)));
+  EXPECT_EQ(FindOrNull(definitions, "A")->DefinitionText().text(), "");
+  EXPECT_EQ(FindOrNull(definitions, "B")->DefinitionText().text(), "2");
+  EXPECT_EQ(FindOrNull(definitions, "C")->DefinitionText().text(), "x=y");
+}
+
+TEST(VerilogPreprocessConditionalTest, InvalidDefinesAreReported) {
+  for (const char* define : {"", "=1", "1A", "A-B", "A(x)=x", "A=1\\",
+                             "A=1\n`define B"}) {
+    VerilogAnalyzer analyzer("module m; endmodule\n", "<<inline-file>>");
+    analyzer.SetPreprocessConfig(FilterBranchesConfig({"OK", define}));
+    EXPECT_FALSE(analyzer.Analyze().ok()) << define;
+    const auto& errors = analyzer.PreprocessorData().errors;
+    ASSERT_EQ(errors.size(), 1) << define;
+    EXPECT_THAT(errors.front().error_message,
+                testing::HasSubstr("Invalid macro definition"));
+    EXPECT_EQ(errors.front().token_info.text(), "module");
+
+    VerilogPreprocess::Config config;
+    config.defines = {"OK", define};
+    EXPECT_FALSE(VerilogPreprocess::BuildMacroRegistry({}, config).ok())
+        << define;
+  }
+}
+
+TEST(VerilogPreprocessConditionalTest, UndefIsIgnoredByDefault) {
+  const char kText[] =
+      "`define A\n"
+      "`undef A\n";
+  {
+    PreprocessorTester tester(kText);
+    EXPECT_TRUE(tester.Status().ok());
+    EXPECT_THAT(tester.PreprocessorData().macro_definitions,
+                ElementsAre(Pair("A", testing::_)));
+  }
+  {
+    VerilogAnalyzer analyzer(kText, "<<inline-file>>");
+    analyzer.SetPreprocessConfig(FilterBranchesConfig());
+    EXPECT_TRUE(analyzer.Analyze().ok());
+    EXPECT_THAT(analyzer.PreprocessorData().macro_definitions, IsEmpty());
+  }
+}
+
+TEST(VerilogPreprocessConditionalTest, DefinitionsInFileAreEvaluated) {
+  VerilogAnalyzer analyzer(
+      "`define A\n"
+      "`ifdef B\n"
+      "`define C\n"  // inactive
+      "`undef A\n"   // inactive
+      "`endif\n"
+      "`ifdef A\n"
+      "module a; endmodule\n"
+      "`endif\n"
+      "`ifdef C\n"
+      "module c; endmodule\n"
+      "`endif\n"
+      "`undef A\n"
+      "`ifndef A\n"
+      "module not_a; endmodule\n"
+      "`endif\n",
+      "<<inline-file>>");
+  analyzer.SetPreprocessConfig(FilterBranchesConfig());
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  const auto& data = analyzer.PreprocessorData();
+  EXPECT_THAT(PreprocessedIdentifiers(data), ElementsAre("a", "not_a"));
+  EXPECT_THAT(data.macro_definitions, IsEmpty());
+}
+
+TEST(VerilogPreprocessConditionalTest, ParsesOnlyActiveHeader) {
+  VerilogAnalyzer analyzer(
+      "`ifdef WIDE\n"
+      "module m(input [7:0] a);\n"
+      "`else\n"
+      "module m(input a);\n"
+      "`endif\n"
+      "endmodule\n",
+      "<<inline-file>>");
+  analyzer.SetPreprocessConfig(FilterBranchesConfig({"WIDE"}));
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  EXPECT_NE(analyzer.SyntaxTree(), nullptr);
+}
+
+TEST(VerilogPreprocessConditionalTest, InvalidConditionals) {
+  const FailTest test_cases[] = {
+      {"`else\n", 0},
+      {"`endif\n", 0},
+      {"`elsif A\n", 0},
+      {"`ifdef A\n", 0},
+      {"`ifdef A\n`ifndef B\n`endif\n", 0},
+      {"`ifdef A\n`else\n`else\n`endif\n", 15},
+      {"`ifdef A\n`else\n`elsif B\n`endif\n", 15},
+  };
+  for (const auto& test : test_cases) {
+    VerilogAnalyzer analyzer(test.input, "<<inline-file>>");
+    analyzer.SetPreprocessConfig(FilterBranchesConfig());
+    EXPECT_FALSE(analyzer.Analyze().ok()) << test.input;
+    const auto& errors = analyzer.PreprocessorData().errors;
+    ASSERT_EQ(errors.size(), 1) << test.input;
+    EXPECT_EQ(errors.front().token_info.left(analyzer.Data().Contents()),
+              test.offset)
+        << test.input;
+  }
+}
+
+TEST(VerilogPreprocessConditionalTest, IncludedFilesKeepTheirOwnBlocks) {
+  FakeIncludeFiles headers({
+      {"guarded.svh",
+       "`ifndef GUARDED_SVH\n"
+       "`define GUARDED_SVH\n"
+       "`define G\n"
+       "`endif\n"},
+      {"unterminated.svh", "`ifndef G\n`define U\n"},
+      {"unmatched.svh", "`endif\n`define V\n"},
+  });
+  VerilogPreprocess::Config config = headers.Config();
+  config.filter_branches = true;
+  VerilogAnalyzer analyzer(
+      "`ifndef X\n"
+      "`include \"guarded.svh\"\n"
+      "`include \"unterminated.svh\"\n"
+      "`include \"unmatched.svh\"\n"
+      "`include \"guarded.svh\"\n"
+      "`endif\n"
+      "`ifdef G\n"
+      "module g; endmodule\n"
+      "`endif\n",
+      "<<inline-file>>");
+  analyzer.SetPreprocessConfig(config);
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  const auto& data = analyzer.PreprocessorData();
+  EXPECT_TRUE(data.errors.empty());
+  EXPECT_EQ(data.skipped_includes, 1);
+  EXPECT_THAT(PreprocessedIdentifiers(data), ElementsAre("g"));
+  EXPECT_THAT(data.macro_definitions,
+              UnorderedElementsAre(Pair("G", testing::_),
+                                   Pair("GUARDED_SVH", testing::_)));
+}
+
+// Builds a registry from the defines header of a project.
+std::shared_ptr<const SharedMacroRegistry> SharedDefines(
+    const VerilogPreprocess::Config& config = {}) {
+  const auto header = std::make_shared<const IncludedFile>(
+      "defs.svh",
+      "`ifndef DEFS_SVH\n"
+      "`define DEFS_SVH\n"
+      "`define WIDTH 8\n"
+      "`define ADD(a, b) (a+b)\n"
+      "`endif\n");
+  return VerilogPreprocess::BuildMacroRegistry({header}, config).value();
+}
+
+TEST(VerilogPreprocessSharedMacrosTest, BuildsRegistryFromFiles) {
+  VerilogPreprocess::Config config;
+  config.defines = {"FAST"};
+  const auto registry = SharedDefines(config);
+  ASSERT_NE(registry, nullptr);
+  EXPECT_THAT(registry->Definitions(),
+              UnorderedElementsAre(Pair("ADD", testing::_),
+                                   Pair("DEFS_SVH", testing::_),
+                                   Pair("FAST", testing::_),
+                                   Pair("WIDTH", testing::_)));
+  const auto* add = registry->Find("ADD");
+  ASSERT_NE(add, nullptr);
+  EXPECT_EQ(add->Parameters().size(), 2);
+  EXPECT_EQ(registry->Find("MISSING"), nullptr);
+
+  // A registry can be extended by another one.
+  VerilogPreprocess::Config extended_config;
+  extended_config.shared_macros = registry;
+  const auto more = std::make_shared<const IncludedFile>(
+      "more.svh", "`undef FAST\n`define WIDTH 16\n");
+  const auto status_or_extended =
+      VerilogPreprocess::BuildMacroRegistry({more}, extended_config);
+  ASSERT_TRUE(status_or_extended.ok()) << status_or_extended.status();
+  const auto& extended = *status_or_extended;
+  EXPECT_THAT(extended->Definitions(),
+              UnorderedElementsAre(Pair("ADD", testing::_),
+                                   Pair("DEFS_SVH", testing::_),
+                                   Pair("WIDTH", testing::_)));
+  EXPECT_EQ(extended->Find("WIDTH")->DefinitionText().text(), "16");
+  EXPECT_EQ(registry->Find("WIDTH")->DefinitionText().text(), "8");
+}
+
+TEST(VerilogPreprocessSharedMacrosTest, FilesOnlyRecordTheirChanges) {
+  const auto registry = SharedDefines();
+  VerilogPreprocess::Config config;
+  config.shared_macros = registry;
+  VerilogAnalyzer analyzer(
+      "`define WIDTH 16\n"
+      "`undef ADD\n"
+      "`define LOCAL 1\n",
+      "<<inline-file>>");
+  analyzer.SetPreprocessConfig(config);
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  const auto& data = analyzer.PreprocessorData();
+  EXPECT_THAT(data.macro_definitions,
+              UnorderedElementsAre(Pair("LOCAL", testing::_),
+                                   Pair("WIDTH", testing::_)));
+  EXPECT_EQ(data.FindMacroDefinition("WIDTH")->DefinitionText().text(), "16");
+  EXPECT_EQ(data.FindMacroDefinition("ADD"), nullptr);
+  EXPECT_NE(data.FindMacroDefinition("DEFS_SVH"), nullptr);
+  // The shared registry is left unchanged for other files.
+  EXPECT_EQ(registry->Find("WIDTH")->DefinitionText().text(), "8");
+  EXPECT_NE(registry->Find("ADD"), nullptr);
+}
+
+TEST(VerilogPreprocessSharedMacrosTest, RedefinitionAfterUndef) {
+  VerilogPreprocess::Config config;
+  config.shared_macros = SharedDefines();
+  VerilogAnalyzer analyzer(
+      "`undef WIDTH\n"
+      "`define WIDTH 4\n",
+      "<<inline-file>>");
+  analyzer.SetPreprocessConfig(config);
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  const auto& data = analyzer.PreprocessorData();
+  EXPECT_EQ(data.FindMacroDefinition("WIDTH")->DefinitionText().text(), "4");
+}
+
+TEST(VerilogPreprocessSharedMacrosTest, SharedMacrosAreEvaluated) {
+  FakeIncludeFiles headers({
+      {"defs.svh",
+       "`ifndef DEFS_SVH\n"
+       "`define DEFS_SVH\n"
+       "`endif\n"},
+  });
+  VerilogPreprocess::Config config = headers.Config();
+  config.filter_branches = true;
+  config.shared_macros = SharedDefines();
+  VerilogAnalyzer analyzer(
+      "`include \"defs.svh\"\n"
+      "`include \"defs.svh\"\n"
+      "`ifdef WIDTH\n"
+      "module w; endmodule\n"
+      "`endif\n"
+      "`undef WIDTH\n"
+      "`ifndef WIDTH\n"
+      "module not_w; endmodule\n"
+      "`endif\n",
+      "<<inline-file>>");
+  analyzer.SetPreprocessConfig(config);
+  EXPECT_TRUE(analyzer.Analyze().ok());
+  const auto& data = analyzer.PreprocessorData();
+  EXPECT_TRUE(data.errors.empty());
+  EXPECT_THAT(PreprocessedIdentifiers(data), ElementsAre("w", "not_w"));
+  // The shared guard macro applies to the header.
+  EXPECT_EQ(data.skipped_includes, 1);
+  EXPECT_EQ(headers.OpenCount(), 1);
+  EXPECT_THAT(data.macro_definitions, IsEmpty());
+}
+
 }  // namespace
 }  // namespace verilog
@@ -0,0 +1,439 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/tools/corpus/benchmark_corpus.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/substitute.h"
+#include "common/util/enum_flags.h"
+#include "common/util/file_util.h"
+
+namespace verilog {
+namespace corpus {
+
+static constexpr absl::string_view kMacros =
+    "`define CORPUS_MAX(a, b) ((a) > (b) ? (a) : (b))\n"
+    "`define corpus_object_utils(T) typedef T this_type;\n\n";
+
+static void AppendPackage(int i, std::string* out) {
+  absl::StrAppend(out, "package pkg_", i,
+                  ";\n"
+                  "  localparam int unsigned DataWidth = 32;\n"
+                  "  typedef enum logic [1:0] {\n"
+                  "    IDLE, BUSY, DONE\n"
+                  "  } state_e;\n"
+                  "  typedef struct packed {\n"
+                  "    logic [DataWidth-1:0] data;\n"
+                  "    state_e state;\n"
+                  "    logic valid;\n"
+                  "  } packet_t;\n"
+                  "  function automatic int add(int a, int b);\n"
+                  "    return a + b;\n"
+                  "  endfunction\n"
+                  "endpackage : pkg_",
+                  i, "\n\n");
+}
+
+static void AppendInterface(int i, std::string* out) {
+  absl::StrAppend(out, "interface bus_if_", i,
+                  " (input logic clk);\n"
+                  "  logic [31:0] addr;\n"
+                  "  logic [31:0] wdata;\n"
+                  "  logic [31:0] rdata;\n"
+                  "  logic req, gnt;\n"
+                  "  modport host (input clk, gnt, rdata, "
+                  "output addr, wdata, req);\n"
+                  "  modport device (input clk, addr, wdata, req, "
+                  "output gnt, rdata);\n"
+                  "endinterface : bus_if_",
+                  i, "\n\n");
+}
+
+static void AppendClass(int i, int base, std::string* out) {
+  absl::StrAppend(out, "class cls_", i);
+  if (base >= 0) absl::StrAppend(out, " extends cls_", base);
+  absl::StrAppend(out,
+                  ";\n"
+                  "  rand int unsigned count;\n"
+                  "  rand bit [7:0] payload[];\n"
+                  "  constraint count_c {\n"
+                  "    count inside {[1:16]};\n"
+                  "    payload.size() == count;\n"
+                  "  }\n"
+                  "  function new();\n");
+  if (base >= 0) absl::StrAppend(out, "    super.new();\n");
+  absl::StrAppend(out,
+                  "    count = 0;\n"
+                  "  endfunction\n"
+                  "  virtual function int sum();\n"
+                  "    int result = 0;\n"
+                  "    foreach (payload[k]) begin\n"
+                  "      result += payload[k];\n"
+                  "    end\n"
+                  "    return result;\n"
+                  "  endfunction\n"
+                  "  task automatic run(int cycles);\n"
+                  "    repeat (cycles) begin\n"
+                  "      #1 count++;\n"
+                  "    end\n"
+                  "  endtask\n"
+                  "endclass : cls_",
+                  i, "\n\n");
+}
+
+static void AppendModule(int i, int package, int submodule, std::string* out) {
+  absl::StrAppend(out, "module mod_", i, "\n");
+  if (package >= 0) absl::StrAppend(out, "  import pkg_", package, "::*;\n");
+  absl::StrAppend(out,
+                  "#(\n"
+                  "  parameter int Width = 8,\n"
+                  "  parameter int Depth = 4\n"
+                  ") (\n"
+                  "  input  logic             clk,\n"
+                  "  input  logic             rst_n,\n"
+                  "  input  logic [Width-1:0] d,\n"
+                  "  output logic [Width-1:0] q\n"
+                  ");\n"
+                  "  logic [Width-1:0] stage[Depth];\n"
+                  "  logic [Width-1:0] next_d;\n"
+                  "  always_comb begin\n"
+                  "    next_d = `CORPUS_MAX(d, stage[0]);\n"
+                  "    case (d[1:0])\n"
+                  "      2'b00: next_d = '0;\n"
+                  "      2'b01: next_d = d + 1;\n"
+                  "      default: next_d = d;\n"
+                  "    endcase\n"
+                  "  end\n"
+                  "  always_ff @(posedge clk or negedge rst_n) begin\n"
+                  "    if (!rst_n) begin\n"
+                  "      stage[0] <= '0;\n"
+                  "    end else begin\n"
+                  "      stage[0] <= next_d;\n"
+                  "    end\n"
+                  "  end\n"
+                  "  for (genvar g = 1; g < Depth; g++) begin : gen_stage\n"
+                  "    always_ff @(posedge clk) begin\n"
+                  "      stage[g] <= stage[g-1];\n"
+                  "    end\n"
+                  "  end : gen_stage\n");
+  if (submodule >= 0) {
+    absl::StrAppend(out, "  logic [Width-1:0] sub_q;\n  mod_", submodule,
+                    " #(\n"
+                    "    .Width(Width),\n"
+                    "    .Depth(2)\n"
+                    "  ) u_sub (\n"
+                    "    .clk,\n"
+                    "    .rst_n,\n"
+                    "    .d(stage[Depth-1]),\n"
+                    "    .q(sub_q)\n"
+                    "  );\n"
+                    "  assign q = sub_q;\n");
+  } else {
+    absl::StrAppend(out, "  assign q = stage[Depth-1];\n");
+  }
+  absl::StrAppend(out, "endmodule : mod_", i, "\n\n");
+}
+
+// Appends the mixed corpus unit number 'i'.
+static void AppendMixedUnit(int i, std::string* out) {
+  // Most recent earlier unit of each kind, or -1.
+  const auto previous = [i](int kind) {
+    for (int j = i - 1; j >= 0; --j) {
+      if (j % 4 == kind) return j;
+    }
+    return -1;
+  };
+  switch (i % 4) {
+    case 0:
+      AppendPackage(i, out);
+      break;
+    case 1:
+      AppendInterface(i, out);
+      break;
+    case 2:
+      AppendClass(i, previous(2), out);
+      break;
+    default:
+      AppendModule(i, previous(0), previous(3), out);
+      break;
+  }
+}
+
+// Standard cells of the netlist corpus: name, input ports, function.
+struct NetlistCell {
+  absl::string_view name;
+  int num_inputs;
+  absl::string_view function;
+};
+
+static constexpr NetlistCell kNetlistCells[] = {
+    {"INV_X1", 1, "~A"},
+    {"NAND2_X1", 2, "~(A & B)"},
+    {"NOR2_X1", 2, "~(A | B)"},
+    {"AOI21_X1", 3, "~((A & B) | C)"},
+};
+
+static void AppendNetlistCell(const NetlistCell& cell, std::string* out) {
+  absl::StrAppend(out, "module ", cell.name, " (\n");
+  for (int i = 0; i < cell.num_inputs; ++i) {
+    absl::StrAppend(out, "  input wire ", std::string(1, 'A' + i), ",\n");
+  }
+  absl::StrAppend(out, "  output wire Y\n);\n  assign Y = ", cell.function,
+                  ";\nendmodule\n\n");
+}
+
+// Name of net 'n' of the netlist.  Like in netlists written by synthesis
+// tools, some net names are escaped hierarchical names.
+static std::string NetlistNet(int n) {
+  if (n % 8 == 0) return absl::StrCat("\\u_core/u_blk_", n / 64, "/n_", n, " ");
+  return absl::StrCat("n_", n);
+}
+
+static void AppendNetlist(int num_cells, std::string* out) {
+  constexpr int kNumInputs = 16;
+  absl::StrAppend(out,
+                  "module netlist_top (\n"
+                  "  input wire [",
+                  kNumInputs - 1,
+                  ":0] in,\n"
+                  "  output wire out\n"
+                  ");\n");
+  for (int n = 0; n < num_cells; ++n) {
+    absl::StrAppend(out, "  wire ", NetlistNet(n), ";\n");
+  }
+  // Deterministic pseudo-random connectivity.
+  uint32_t seed = 1;
+  const auto next_random = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+  };
+  for (int n = 0; n < num_cells; ++n) {
+    const NetlistCell& cell =
+        kNetlistCells[next_random() % (sizeof(kNetlistCells) /
+                                       sizeof(kNetlistCells[0]))];
+    absl::StrAppend(out, "  ", cell.name, " U", n, " (");
+    for (int i = 0; i < cell.num_inputs; ++i) {
+      const int source = next_random() % (n + kNumInputs);
+      absl::StrAppend(out, ".", std::string(1, 'A' + i), "(",
+                      source < kNumInputs ? absl::StrCat("in[", source, "]")
+                                          : NetlistNet(source - kNumInputs),
+                      "), ");
+    }
+    absl::StrAppend(out, ".Y(", NetlistNet(n), "));\n");
+  }
+  absl::StrAppend(out, "  assign out = ",
+                  num_cells > 0 ? NetlistNet(num_cells - 1) : "in[0]",
+                  ";\nendmodule : netlist_top\n\n");
+}
+
+static void AppendInstances(int num_instances, std::string* out) {
+  absl::StrAppend(out,
+                  "module instances_top (\n"
+                  "  input  logic       clk,\n"
+                  "  input  logic [7:0] d,\n"
+                  "  output logic [7:0] q\n"
+                  ");\n");
+  for (int i = 0; i < num_instances; ++i) {
+    absl::StrAppend(out, "  logic [7:0] w_", i, ";\n");
+  }
+  for (int i = 0; i < num_instances; ++i) {
+    absl::StrAppend(out, "  mod_3 #(\n    .Width(8),\n    .Depth(", i % 4 + 1,
+                    ")\n  ) u_", i,
+                    " (\n"
+                    "    .clk,\n"
+                    "    .rst_n(1'b1),\n"
+                    "    .d(",
+                    i == 0 ? "d" : absl::StrCat("w_", i - 1),
+                    "),\n"
+                    "    .q(w_",
+                    i, ")\n  );\n");
+  }
+  absl::StrAppend(out, "  assign q = ",
+                  num_instances > 0 ? absl::StrCat("w_", num_instances - 1)
+                                    : "d",
+                  ";\nendmodule : instances_top\n\n");
+}
+
+static void AppendClasses(int num_classes, std::string* out) {
+  absl::StrAppend(out,
+                  "package classes_pkg;\n"
+                  "  virtual class corpus_object;\n"
+                  "    string name;\n"
+                  "    function new(string name = \"\");\n"
+                  "      this.name = name;\n"
+                  "    endfunction\n"
+                  "    pure virtual function string convert2string();\n"
+                  "  endclass\n\n");
+  for (int i = 0; i < num_classes; ++i) {
+    const std::string base =
+        (i % 4 == 0) ? "corpus_object" : absl::StrCat("item_", i - 1);
+    absl::SubstituteAndAppend(
+        out,
+        "  class item_$0 extends $1;\n"
+        "    `corpus_object_utils(item_$0)\n"
+        "    rand bit [31:0] addr_$0;\n"
+        "    rand bit [7:0] data_$0[];\n"
+        "    constraint data_$0_c {\n"
+        "      data_$0.size() inside {[1:$2]};\n"
+        "      addr_$0[1:0] == 2'b00;\n"
+        "    }\n"
+        "    function new(string name = \"item_$0\");\n"
+        "      super.new(name);\n"
+        "    endfunction\n"
+        "    virtual function string convert2string();\n"
+        "      return $$sformatf(\"%s addr_$0=%0h\", name, addr_$0);\n"
+        "    endfunction\n"
+        "  endclass : item_$0\n\n",
+        i, base, i % 16 + 1);
+  }
+  absl::StrAppend(out, "endpackage : classes_pkg\n\n");
+}
+
+static void AppendGenerate(int depth, std::string* out) {
+  absl::StrAppend(out,
+                  "module generate_top #(\n"
+                  "  parameter int N = 2\n"
+                  ") (\n"
+                  "  input  logic       clk,\n"
+                  "  input  logic [7:0] d,\n"
+                  "  output logic [7:0] q\n"
+                  ");\n");
+  std::string indent("  ");
+  for (int level = 0; level < depth; ++level) {
+    if (level % 2 == 0) {
+      absl::StrAppend(out, indent, "for (genvar g", level, " = 0; g", level,
+                      " < N; g", level, "++) begin : gen_loop_", level, "\n");
+    } else {
+      absl::StrAppend(out, indent, "if (g", level - 1,
+                      " % 2 == 0) begin : gen_if_", level, "\n");
+    }
+    indent.append("  ");
+    absl::StrAppend(out, indent, "logic [7:0] r_", level, ";\n");
+  }
+  if (depth > 0) {
+    absl::StrAppend(out, indent, "always_ff @(posedge clk) begin\n", indent,
+                    "  r_", depth - 1, " <= d;\n", indent, "end\n");
+  }
+  for (int level = depth - 1; level >= 0; --level) {
+    indent.resize(indent.size() - 2);
+    absl::StrAppend(out, indent, "end : ",
+                    level % 2 == 0 ? "gen_loop_" : "gen_if_", level, "\n");
+  }
+  absl::StrAppend(out, "  assign q = d;\nendmodule : generate_top\n\n");
+}
+
+static const verible::EnumNameMap<CorpusShape> kCorpusShapeStringMap = {
+    {"mixed", CorpusShape::kMixed},
+    {"netlist", CorpusShape::kNetlist},
+    {"instances", CorpusShape::kInstances},
+    {"classes", CorpusShape::kClasses},
+    {"generate", CorpusShape::kGenerate},
+};
+
+std::ostream& operator<<(std::ostream& stream, CorpusShape shape) {
+  return kCorpusShapeStringMap.Unparse(shape, stream);
+}
+
+bool AbslParseFlag(absl::string_view text, CorpusShape* shape,
+                   std::string* error) {
+  return kCorpusShapeStringMap.Parse(text, shape, error, "corpus shape");
+}
+
+std::string AbslUnparseFlag(const CorpusShape& shape) {
+  std::ostringstream stream;
+  stream << shape;
+  return stream.str();
+}
+
+std::vector<std::string> GenerateUnits(const CorpusOptions& options) {
+  std::vector<std::string> units;
+  const auto new_unit = [&units]() {
+    units.emplace_back();
+    return &units.back();
+  };
+  switch (options.shape) {
+    case CorpusShape::kMixed:
+      for (int i = 0; i < options.size; ++i) AppendMixedUnit(i, new_unit());
+      break;
+    case CorpusShape::kNetlist:
+      for (const auto& cell : kNetlistCells) {
+        AppendNetlistCell(cell, new_unit());
+      }
+      AppendNetlist(options.size, new_unit());
+      break;
+    case CorpusShape::kInstances:
+      // Instantiates mod_3 of the mixed corpus, and what it depends on.
+      for (int i = 0; i < 4; ++i) AppendMixedUnit(i, new_unit());
+      AppendInstances(options.size, new_unit());
+      break;
+    case CorpusShape::kClasses:
+      AppendClasses(options.size, new_unit());
+      break;
+    case CorpusShape::kGenerate:
+      AppendGenerate(options.size, new_unit());
+      break;
+  }
+  return units;
+}
+
+std::string GenerateSource(const CorpusOptions& options) {
+  std::string source(kMacros);
+  for (const auto& unit : GenerateUnits(options)) {
+    absl::StrAppend(&source, unit);
+  }
+  return source;
+}
+
+absl::StatusOr<std::vector<std::string>> WriteCorpus(
+    absl::string_view directory, const CorpusOptions& options, int num_files) {
+  const absl::Status created = verible::file::CreateDir(directory);
+  if (!created.ok()) return created;
+  const std::vector<std::string> units(GenerateUnits(options));
+  std::vector<std::string> file_names;
+  for (int f = 0; f < num_files; ++f) {
+    std::string contents(kMacros);
+    // Distribute units evenly, in order.
+    const size_t begin = units.size() * f / num_files;
+    const size_t end = units.size() * (f + 1) / num_files;
+    for (size_t i = begin; i < end; ++i) absl::StrAppend(&contents, units[i]);
+    std::string name = absl::StrCat("unit_", f, ".sv");
+    const absl::Status status = verible::file::SetContents(
+        verible::file::JoinPath(directory, name), contents);
+    if (!status.ok()) return status;
+    file_names.push_back(std::move(name));
+  }
+  return file_names;
+}
+
+std::string BenchmarkSource(int num_units) {
+  return GenerateSource({CorpusShape::kMixed, num_units});
+}
+
+absl::StatusOr<std::vector<std::string>> WriteBenchmarkProject(
+    absl::string_view directory, int num_files, int units_per_file) {
+  return WriteCorpus(directory,
+                     {CorpusShape::kMixed, num_files * units_per_file},
+                     num_files);
+}
+
+}  // namespace corpus
+}  // namespace verilog
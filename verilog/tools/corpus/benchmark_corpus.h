@@ -0,0 +1,85 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_VERILOG_TOOLS_CORPUS_BENCHMARK_CORPUS_H_
+#define VERIBLE_VERILOG_TOOLS_CORPUS_BENCHMARK_CORPUS_H_
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace verilog {
+namespace corpus {
+
+// Kinds of generated corpora, each stressing tools differently.
+enum class CorpusShape {
+  // 'size' packages, interfaces, classes and modules, in rotation.
+  kMixed,
+  // A flattened gate-level netlist with 'size' standard cell instances,
+  // like those written by synthesis tools.
+  kNetlist,
+  // A module with 'size' instances of a parameterized module.
+  kInstances,
+  // A UVM-style package with 'size' classes.
+  kClasses,
+  // A module with generate blocks nested 'size' levels deep.
+  kGenerate,
+};
+
+std::ostream& operator<<(std::ostream&, CorpusShape);
+
+bool AbslParseFlag(absl::string_view, CorpusShape*, std::string*);
+
+std::string AbslUnparseFlag(const CorpusShape&);
+
+struct CorpusOptions {
+  CorpusShape shape = CorpusShape::kMixed;
+
+  // Meaning depends on shape.
+  int size = 100;
+};
+
+// Returns the design units of a corpus, in dependency order.
+// Units are syntactically valid SystemVerilog, and may use the macros that
+// GenerateSource() and WriteCorpus() define at the start of every file.
+// The result is deterministic, so that measurements are comparable between
+// runs and releases.
+std::vector<std::string> GenerateUnits(const CorpusOptions& options);
+
+// Returns a corpus as one source text.
+std::string GenerateSource(const CorpusOptions& options);
+
+// Distributes the units of a corpus evenly over 'num_files' files in
+// 'directory' (created if needed), and returns their base names, in
+// dependency order.
+absl::StatusOr<std::vector<std::string>> WriteCorpus(
+    absl::string_view directory, const CorpusOptions& options, int num_files);
+
+// Returns the mixed corpus of 'num_units' units.  Later units refer to
+// earlier ones (imports, base classes, module instances), so the text is also
+// meaningful to symbol resolution.
+std::string BenchmarkSource(int num_units);
+
+// Writes the units of BenchmarkSource(num_files * units_per_file) into
+// 'num_files' files in 'directory' (see WriteCorpus()).
+absl::StatusOr<std::vector<std::string>> WriteBenchmarkProject(
+    absl::string_view directory, int num_files, int units_per_file);
+
+}  // namespace corpus
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_TOOLS_CORPUS_BENCHMARK_CORPUS_H_
@@ -0,0 +1,150 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/tools/corpus/benchmark_corpus.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "common/util/file_util.h"
+#include "gtest/gtest.h"
+#include "verilog/analysis/verilog_analyzer.h"
+
+namespace verilog {
+namespace corpus {
+namespace {
+
+TEST(BenchmarkSourceTest, IsDeterministic) {
+  EXPECT_EQ(BenchmarkSource(10), BenchmarkSource(10));
+}
+
+TEST(BenchmarkSourceTest, GrowsWithUnits) {
+  const std::string small(BenchmarkSource(4));
+  const std::string large(BenchmarkSource(8));
+  EXPECT_LT(small.size(), large.size());
+  EXPECT_TRUE(absl::StartsWith(large, small));
+}
+
+TEST(BenchmarkSourceTest, UnitsReferToEarlierUnits) {
+  const std::string source(BenchmarkSource(8));
+  EXPECT_TRUE(absl::StrContains(source, "import pkg_4::*;"));
+  EXPECT_TRUE(absl::StrContains(source, "class cls_6 extends cls_2;"));
+  EXPECT_TRUE(absl::StrContains(source, "mod_3 #("));
+}
+
+TEST(BenchmarkSourceTest, Parses) {
+  for (int num_units : {0, 1, 4, 13}) {
+    const std::string source(BenchmarkSource(num_units));
+    VerilogAnalyzer analyzer(source, "corpus.sv");
+    EXPECT_TRUE(analyzer.Analyze().ok()) << "units: " << num_units;
+  }
+}
+
+TEST(WriteBenchmarkProjectTest, SplitsUnitsAcrossFiles) {
+  const std::string dir =
+      verible::file::JoinPath(::testing::TempDir(), "benchmark_project");
+  const auto file_names = WriteBenchmarkProject(dir, 3, 4);
+  ASSERT_TRUE(file_names.ok()) << file_names.status();
+  EXPECT_EQ(*file_names,
+            (std::vector<std::string>{"unit_0.sv", "unit_1.sv", "unit_2.sv"}));
+
+  std::string contents;
+  ASSERT_TRUE(verible::file::GetContents(
+                  verible::file::JoinPath(dir, "unit_1.sv"), &contents)
+                  .ok());
+  EXPECT_TRUE(absl::StrContains(contents, "package pkg_4;"));
+  EXPECT_TRUE(absl::StrContains(contents, "module mod_7"));
+  EXPECT_FALSE(absl::StrContains(contents, "module mod_3\n"));
+}
+
+constexpr CorpusShape kAllShapes[] = {
+    CorpusShape::kMixed, CorpusShape::kNetlist, CorpusShape::kInstances,
+    CorpusShape::kClasses, CorpusShape::kGenerate};
+
+TEST(CorpusShapeTest, FlagRoundTrip) {
+  for (const auto shape : kAllShapes) {
+    CorpusShape parsed = CorpusShape::kMixed;
+    std::string error;
+    EXPECT_TRUE(AbslParseFlag(AbslUnparseFlag(shape), &parsed, &error))
+        << error;
+    EXPECT_EQ(parsed, shape);
+  }
+  CorpusShape parsed;
+  std::string error;
+  EXPECT_FALSE(AbslParseFlag("nonsense", &parsed, &error));
+}
+
+TEST(GenerateSourceTest, IsDeterministic) {
+  for (const auto shape : kAllShapes) {
+    const CorpusOptions options{shape, 20};
+    EXPECT_EQ(GenerateSource(options), GenerateSource(options)) << shape;
+  }
+}
+
+TEST(GenerateSourceTest, GrowsWithSize) {
+  for (const auto shape : kAllShapes) {
+    EXPECT_LT(GenerateSource({shape, 5}).size(),
+              GenerateSource({shape, 50}).size())
+        << shape;
+  }
+}
+
+TEST(GenerateSourceTest, MixedMatchesBenchmarkSource) {
+  EXPECT_EQ(GenerateSource({CorpusShape::kMixed, 9}), BenchmarkSource(9));
+}
+
+TEST(GenerateSourceTest, NetlistHasEscapedIdentifiers) {
+  const std::string source(GenerateSource({CorpusShape::kNetlist, 64}));
+  EXPECT_TRUE(absl::StrContains(source, "module netlist_top"));
+  EXPECT_TRUE(absl::StrContains(source, "\\u_core/"));
+}
+
+TEST(GenerateSourceTest, Parses) {
+  for (const auto shape : kAllShapes) {
+    for (int size : {0, 1, 17}) {
+      const std::string source(GenerateSource({shape, size}));
+      VerilogAnalyzer analyzer(source, "corpus.sv");
+      EXPECT_TRUE(analyzer.Analyze().ok())
+          << "shape: " << shape << ", size: " << size;
+    }
+  }
+}
+
+TEST(WriteCorpusTest, DistributesUnitsEvenly) {
+  const std::string dir =
+      verible::file::JoinPath(::testing::TempDir(), "corpus_netlist");
+  const CorpusOptions options{CorpusShape::kNetlist, 10};
+  const auto file_names = WriteCorpus(dir, options, 2);
+  ASSERT_TRUE(file_names.ok()) << file_names.status();
+  ASSERT_EQ(file_names->size(), 2);
+
+  std::string all;
+  for (const auto& name : *file_names) {
+    std::string contents;
+    ASSERT_TRUE(
+        verible::file::GetContents(verible::file::JoinPath(dir, name),
+                                   &contents)
+            .ok());
+    EXPECT_FALSE(contents.empty()) << name;
+    absl::StrAppend(&all, contents);
+  }
+  EXPECT_TRUE(absl::StrContains(all, "module INV_X1"));
+  EXPECT_TRUE(absl::StrContains(all, "module netlist_top"));
+}
+
+}  // namespace
+}  // namespace corpus
+}  // namespace verilog
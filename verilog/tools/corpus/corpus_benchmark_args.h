@@ -0,0 +1,54 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_VERILOG_TOOLS_CORPUS_CORPUS_BENCHMARK_ARGS_H_
+#define VERIBLE_VERILOG_TOOLS_CORPUS_CORPUS_BENCHMARK_ARGS_H_
+
+#include "benchmark/benchmark.h"
+#include "verilog/tools/corpus/benchmark_corpus.h"
+
+namespace verilog {
+namespace corpus {
+
+// Registers (shape, size) benchmark arguments that grow every corpus shape
+// over two orders of magnitude, for plotting how a tool scales.
+// Usage:
+//   BENCHMARK(BM_Something)->Apply(CorpusScalingArgs);
+// and in BM_Something:
+//   const std::string source(GenerateSource(CorpusBenchmarkOptions(state)));
+inline void CorpusScalingArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"shape", "size"});
+  const auto add = [benchmark](CorpusShape shape, int size) {
+    benchmark->Args({static_cast<int>(shape), size});
+  };
+  for (int size : {10, 100, 1000}) add(CorpusShape::kMixed, size);
+  for (int size : {1000, 10000, 100000}) add(CorpusShape::kNetlist, size);
+  for (int size : {100, 1000, 10000}) add(CorpusShape::kInstances, size);
+  for (int size : {100, 1000, 10000}) add(CorpusShape::kClasses, size);
+  for (int size : {10, 50, 200}) add(CorpusShape::kGenerate, size);
+}
+
+// Returns the corpus options of arguments registered by CorpusScalingArgs,
+// and labels the measurement with the name of the shape.
+inline CorpusOptions CorpusBenchmarkOptions(benchmark::State& state) {
+  const CorpusOptions options{static_cast<CorpusShape>(state.range(0)),
+                              static_cast<int>(state.range(1))};
+  state.SetLabel(AbslUnparseFlag(options.shape));
+  return options;
+}
+
+}  // namespace corpus
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_TOOLS_CORPUS_CORPUS_BENCHMARK_ARGS_H_
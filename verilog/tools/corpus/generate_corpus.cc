@@ -0,0 +1,90 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// generate_corpus writes synthetic, syntactically valid SystemVerilog of
+// configurable size and shape, for scalability testing and benchmarks.
+//
+// Example usage:
+// generate_corpus --shape=netlist --size=100000 > netlist.sv
+// generate_corpus --shape=mixed --size=4000 --files=100 --output_dir=corpus
+
+#include <iostream>
+#include <string>
+
+#include "absl/flags/flag.h"
+#include "absl/strings/str_cat.h"
+#include "common/util/init_command_line.h"
+#include "verilog/tools/corpus/benchmark_corpus.h"
+
+using verilog::corpus::CorpusOptions;
+using verilog::corpus::CorpusShape;
+
+ABSL_FLAG(CorpusShape, shape, CorpusShape::kMixed,
+          R"(Kind of source to generate:
+  mixed: --size packages, interfaces, classes and modules, in rotation.
+  netlist: flattened gate-level netlist with --size cell instances.
+  instances: one module with --size module instances.
+  classes: UVM-style package with --size classes.
+  generate: generate blocks nested --size levels deep.
+)");
+
+ABSL_FLAG(int, size, 100, "Size of the generated source (see --shape).");
+
+ABSL_FLAG(std::string, output_dir, "",
+          "If provided, write the source into --files files in this directory "
+          "(created if needed), and print their names.  Otherwise, write the "
+          "source to stdout.");
+
+ABSL_FLAG(int, files, 1,
+          "Number of files to distribute design units over, with "
+          "--output_dir.");
+
+int main(int argc, char** argv) {
+  const auto usage =
+      absl::StrCat("usage: ", argv[0], " [options] > output.sv\n", R"(
+generate_corpus writes synthetic SystemVerilog of configurable size and shape.
+The output is deterministic for the same options.
+)");
+  verible::InitCommandLine(usage, &argc, &argv);
+
+  CorpusOptions options;
+  options.shape = absl::GetFlag(FLAGS_shape);
+  options.size = absl::GetFlag(FLAGS_size);
+  if (options.size < 0) {
+    std::cerr << "--size must not be negative." << std::endl;
+    return 1;
+  }
+
+  const std::string output_dir = absl::GetFlag(FLAGS_output_dir);
+  if (output_dir.empty()) {
+    std::cout << verilog::corpus::GenerateSource(options);
+    return 0;
+  }
+
+  const int num_files = absl::GetFlag(FLAGS_files);
+  if (num_files < 1) {
+    std::cerr << "--files must be positive." << std::endl;
+    return 1;
+  }
+  const auto file_names =
+      verilog::corpus::WriteCorpus(output_dir, options, num_files);
+  if (!file_names.ok()) {
+    std::cerr << file_names.status() << std::endl;
+    return 1;
+  }
+  for (const auto& name : *file_names) {
+    std::cout << name << std::endl;
+  }
+  return 0;
+}
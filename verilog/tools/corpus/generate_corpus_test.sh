@@ -0,0 +1,49 @@
+#!/bin/bash
+# Copyright 2017-2021 The Verible Authors.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Tests that generate_corpus writes syntactically valid sources.
+
+[[ "$#" == 2 ]] || {
+  echo "Expecting 2 positional arguments, generate_corpus and verible-verilog-syntax paths."
+  exit 1
+}
+generator="$(rlocation ${TEST_WORKSPACE}/${1})"
+syntax_checker="$(rlocation ${TEST_WORKSPACE}/${2})"
+
+declare -r OUTPUT_FILE="${TEST_TMPDIR}/corpus.sv"
+declare -r OUTPUT_DIR="${TEST_TMPDIR}/corpus"
+
+for shape in mixed netlist instances classes generate; do
+  "${generator}" --shape="${shape}" --size=20 > "${OUTPUT_FILE}" || exit 1
+  "${syntax_checker}" "${OUTPUT_FILE}" || exit 2
+
+  # Output is deterministic.
+  "${generator}" --shape="${shape}" --size=20 | cmp - "${OUTPUT_FILE}" || exit 3
+done
+
+# Multiple files
+"${generator}" --shape=mixed --size=20 --files=3 --output_dir="${OUTPUT_DIR}" \
+  > "${OUTPUT_FILE}" || exit 4
+[[ "$(cat "${OUTPUT_FILE}")" == "$(printf 'unit_0.sv\nunit_1.sv\nunit_2.sv')" ]] || exit 5
+for file in unit_0.sv unit_1.sv unit_2.sv; do
+  "${syntax_checker}" "${OUTPUT_DIR}/${file}" || exit 6
+done
+
+# Invalid flags
+"${generator}" --shape=nonsense && exit 7
+"${generator}" --size=-1 && exit 8
+"${generator}" --files=0 --output_dir="${OUTPUT_DIR}" && exit 9
+
+echo "PASS"
@@ -0,0 +1,72 @@
+#!/bin/bash
+# Copyright 2017-2021 The Verible Authors.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Tests the --stream_top_level_items flag of verible-verilog-format, which
+# writes each top-level item to stdout, or to the --inplace file, as soon as
+# it is formatted.
+
+declare -r MY_INPUT_FILE="${TEST_TMPDIR}/myinput.txt"
+declare -r MY_OUTPUT_FILE="${TEST_TMPDIR}/myoutput.txt"
+declare -r MY_EXPECT_FILE="${TEST_TMPDIR}/myexpect.txt"
+
+# Get tool from argument
+[[ "$#" == 1 ]] || {
+  echo "Expecting 1 positional argument, verible-verilog-format path."
+  exit 1
+}
+formatter="$(rlocation ${TEST_WORKSPACE}/$1)"
+
+cat >${MY_INPUT_FILE} <<EOF
+  module    m1   ;endmodule
+  module    m2   ;endmodule
+EOF
+
+cat >${MY_EXPECT_FILE} <<EOF
+module m1;
+endmodule
+module m2;
+endmodule
+EOF
+
+# Stream to stdout.
+${formatter} --stream_top_level_items ${MY_INPUT_FILE} >${MY_OUTPUT_FILE} ||
+  exit 1
+diff --strip-trailing-cr "${MY_OUTPUT_FILE}" "${MY_EXPECT_FILE}" || exit 2
+
+# Stream over the file itself.
+cp ${MY_INPUT_FILE} ${MY_OUTPUT_FILE}
+${formatter} --stream_top_level_items --inplace ${MY_OUTPUT_FILE} || exit 3
+diff --strip-trailing-cr "${MY_OUTPUT_FILE}" "${MY_EXPECT_FILE}" || exit 4
+
+# An already formatted file is not rewritten.
+touch -d "2000-01-01" ${MY_OUTPUT_FILE}
+${formatter} --stream_top_level_items --inplace ${MY_OUTPUT_FILE} || exit 5
+[[ "$(date -r ${MY_OUTPUT_FILE} +%Y)" == "2000" ]] || {
+  echo "Expected an already formatted file to be left untouched."
+  exit 6
+}
+diff --strip-trailing-cr "${MY_OUTPUT_FILE}" "${MY_EXPECT_FILE}" || exit 7
+
+# A file with syntax errors is left as it was.
+cat >${MY_OUTPUT_FILE} <<EOF
+  module    m1   ;endmodule
+  module    m2   ;
+EOF
+cp ${MY_OUTPUT_FILE} ${MY_INPUT_FILE}
+${formatter} --stream_top_level_items --inplace --nofailsafe_success \
+  ${MY_OUTPUT_FILE} && exit 8
+diff "${MY_OUTPUT_FILE}" "${MY_INPUT_FILE}" || exit 9
+
+echo "PASS"
@@ -25,12 +25,14 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <ostream>
 #include <sstream>  // IWYU pragma: keep  // for ostringstream
 #include <string>   // for string, allocator, etc
 #include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/usage.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
@@ -42,6 +44,8 @@
 #include "common/util/init_command_line.h"
 #include "common/util/interval_set.h"
 #include "common/util/logging.h"  // for operator<<, LOG, LogMessage, etc
+#include "common/util/phase_stats.h"
+#include "common/util/phase_stats_flags.h"
 #include "verilog/formatting/format_style.h"
 #include "verilog/formatting/formatter.h"
 
@@ -121,6 +125,11 @@ ABSL_FLAG(bool, show_equally_optimal_wrappings, false,
 ABSL_FLAG(int, max_search_states, 100000,
           "Limits the number of search states explored during "
           "line wrap optimization.");
+ABSL_FLAG(bool, stream_top_level_items, false,
+          "If true, format and output one top-level item (module, package, "
+          "...) at a time, passing each one on as soon as it is formatted "
+          "instead of buffering the whole formatted output.  Lexing, parsing "
+          "and token partitioning still cover the whole file.");
 
 // These flags exist in the short term to disable formatting of some regions.
 // Do not expect to be able to use these in the long term, once they find
@@ -182,6 +191,109 @@ static std::ostream& FileMsg(absl::string_view filename) {
   return std::cerr;
 }
 
+// Stream buffer for --stream_top_level_items, which passes formatted output on
+// as soon as it is produced, either to stdout or over the formatted file.
+// The file's original contents are still in memory, so the file is only
+// opened (and truncated) once the output starts to differ from them, which
+// leaves files that are already formatted untouched.
+class StreamingOutputBuf : public std::streambuf {
+ public:
+  // Writes to stdout.
+  explicit StreamingOutputBuf(absl::string_view original)
+      : original_(original), sink_(std::cout.rdbuf()) {}
+
+  // Writes over 'filename', whose contents are 'original'.
+  StreamingOutputBuf(absl::string_view original, absl::string_view filename)
+      : original_(original), filename_(filename) {}
+
+  // Number of characters that were output so far.
+  size_t size() const { return size_; }
+
+  // Returns true if the file was rewritten.
+  bool changed() const { return !filename_.empty() && sink_ != nullptr; }
+
+  // Completes the output, and returns an error if any of it was not written.
+  absl::Status Finish() {
+    if (filename_.empty()) {
+      if (sink_->pubsync() != 0) failed_ = true;
+    } else {
+      // Output that is shorter than the original also changes the file.
+      if (sink_ == nullptr && size_ != original_.size()) StartFile();
+      if (file_.is_open()) {
+        file_.close();
+        if (file_.fail()) failed_ = true;
+      }
+    }
+    if (failed_) return absl::DataLossError("error writing formatted output");
+    return absl::OkStatus();
+  }
+
+  // Writes back the original contents, if the file was already rewritten.
+  absl::Status Restore() {
+    if (!changed()) return absl::OkStatus();
+    if (file_.is_open()) file_.close();
+    return verible::file::SetContents(filename_, original_);
+  }
+
+ protected:
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    const absl::string_view text(s, n);
+    if (sink_ == nullptr) {
+      if (original_.substr(size_, text.length()) == text) {
+        size_ += text.length();
+        return n;
+      }
+      if (!StartFile()) return 0;
+    }
+    const std::streamsize written = sink_->sputn(s, n);
+    if (written != n) failed_ = true;
+    size_ += written;
+    return written;
+  }
+
+  int_type overflow(int_type c) override {
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+      return traits_type::not_eof(c);
+    }
+    const char ch = traits_type::to_char_type(c);
+    return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+  }
+
+  int sync() override { return sink_ == nullptr ? 0 : sink_->pubsync(); }
+
+ private:
+  // Opens the file for writing, and writes the output so far, which matched
+  // the start of the original contents.  Returns false on error.
+  bool StartFile() {
+    file_.open(filename_, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+      failed_ = true;
+      return false;
+    }
+    sink_ = file_.rdbuf();
+    if (sink_->sputn(original_.data(), size_) !=
+        static_cast<std::streamsize>(size_)) {
+      failed_ = true;
+    }
+    return !failed_;
+  }
+
+  const absl::string_view original_;
+
+  // File to write over, or empty for stdout.
+  const std::string filename_;
+
+  std::ofstream file_;
+
+  // Where output goes.  For a file, this is null until the output differs
+  // from the original contents.
+  std::streambuf* sink_ = nullptr;
+
+  size_t size_ = 0;
+
+  bool failed_ = false;
+};
+
 static bool formatOneFile(absl::string_view filename,
                           const LineNumberSet& lines_to_format) {
   const bool inplace = absl::GetFlag(FLAGS_inplace);
@@ -195,6 +307,7 @@ static bool formatOneFile(absl::string_view filename,
   }
 
   const auto diagnostic_filename = is_stdin ? stdin_name : filename;
+  const verible::ScopedStatsFile stats_file(diagnostic_filename);
 
   // Read contents into memory first.
   std::string content;
@@ -227,6 +340,8 @@ static bool formatOneFile(absl::string_view filename,
         absl::GetFlag(FLAGS_max_search_states);
     formatter_control.verify_convergence =
         absl::GetFlag(FLAGS_verify_convergence);
+    formatter_control.stream_top_level_items =
+        absl::GetFlag(FLAGS_stream_top_level_items);
 
     // formatting style flags
     format_style.try_wrap_long_lines = absl::GetFlag(FLAGS_try_wrap_long_lines);
@@ -263,15 +378,36 @@ static bool formatOneFile(absl::string_view filename,
         absl::GetFlag(FLAGS_assignment_statement_alignment);
   }
 
-  std::ostringstream stream;
+  // When streaming, the formatted output goes straight to its destination,
+  // otherwise it is buffered until it is known to be valid.
+  std::unique_ptr<StreamingOutputBuf> streaming_output;
+  if (formatter_control.stream_top_level_items) {
+    streaming_output =
+        (inplace && !is_stdin)
+            ? absl::make_unique<StreamingOutputBuf>(content, filename)
+            : absl::make_unique<StreamingOutputBuf>(content);
+  }
+  std::ostringstream buffer;
+  std::ostream streaming_stream(streaming_output.get());
+  std::ostream& stream =
+      streaming_output != nullptr ? streaming_stream : buffer;
   const auto format_status =
       FormatVerilog(content, diagnostic_filename, format_style, stream,
                     lines_to_format, formatter_control);
 
-  const std::string& formatted_output(stream.str());
+  const std::string& formatted_output(buffer.str());
   if (!format_status.ok()) {
-    if (!inplace) {
-      // Fall back to printing original content regardless of error condition.
+    if (streaming_output != nullptr) {
+      status = streaming_output->Restore();
+      if (!status.ok()) {
+        FileMsg(filename) << "error restoring original contents " << status
+                          << std::endl;
+      }
+    }
+    // Fall back to printing original content regardless of error condition,
+    // unless part of the formatted output was already printed.
+    if (!inplace &&
+        (streaming_output == nullptr || streaming_output->size() == 0)) {
       std::cout << content;
     }
     switch (format_status.code()) {
@@ -280,9 +416,12 @@ static bool formatOneFile(absl::string_view filename,
         FileMsg(filename) << format_status.message() << std::endl;
         break;
       case StatusCode::kDataLoss:
-        FileMsg(filename) << format_status.message()
-                          << "; problematic formatter output is\n"
-                          << formatted_output << "<<EOF>>" << std::endl;
+        FileMsg(filename) << format_status.message();
+        if (streaming_output == nullptr) {
+          std::cerr << "; problematic formatter output is\n"
+                    << formatted_output << "<<EOF>>";
+        }
+        std::cerr << std::endl;
         break;
       default:
         FileMsg(filename) << format_status.message() << "[other error status]"
@@ -293,6 +432,19 @@ static bool formatOneFile(absl::string_view filename,
     return absl::GetFlag(FLAGS_failsafe_success);
   }
 
+  if (streaming_output != nullptr) {
+    status = streaming_output->Finish();
+    if (!status.ok()) {
+      FileMsg(filename) << "error writing result " << status << std::endl;
+      return false;
+    }
+    if (inplace && !is_stdin && !streaming_output->changed() &&
+        absl::GetFlag(FLAGS_verbose)) {
+      FileMsg(filename) << "Already formatted, no change." << std::endl;
+    }
+    return true;
+  }
+
   // Safe to write out result, having passed above verification.
   if (inplace && !is_stdin) {
     // Don't write if the output is exactly as the input, so that we don't mess
@@ -318,6 +470,7 @@ int main(int argc, char** argv) {
                                   " [options] <file> [<file...>]\n"
                                   "To pipe from stdin, use '-' as <file>.");
   const auto file_args = verible::InitCommandLine(usage, &argc, &argv);
+  const verible::ScopedPhaseStatsReport stats_report;
 
   if (file_args.size() == 1) {
     std::cerr << absl::ProgramUsageMessage() << std::endl;
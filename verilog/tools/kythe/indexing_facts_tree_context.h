@@ -31,6 +31,11 @@ class IndexingFactsTreeContext
   // member class to handle push and pop of stack safely
   using AutoPop = base_type::AutoPop;
 
+  // For contexts that cannot be scoped with AutoPop, because they end in a
+  // later iteration of a traversal loop.
+  using base_type::Pop;
+  using base_type::Push;
+
  public:
   // returns the top IndexingFactsNode of the stack.
   IndexingFactNode& top() { return *ABSL_DIE_IF_NULL(base_type::top()); }
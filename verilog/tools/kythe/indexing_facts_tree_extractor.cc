@@ -25,6 +25,7 @@
 #include "common/text/tree_utils.h"
 #include "common/util/file_util.h"
 #include "common/util/logging.h"
+#include "common/util/phase_stats.h"
 #include "verilog/CST/class.h"
 #include "verilog/CST/declaration.h"
 #include "verilog/CST/functions.h"
@@ -314,6 +315,8 @@ IndexingFactNode BuildIndexingFactsTree(
     const VerilogSourceFile& source_file,
     VerilogExtractionState* extraction_state) {
   VLOG(1) << __FUNCTION__ << ": file: " << source_file;
+  const verible::ScopedStatsFile stats_file(source_file.ReferencedPath());
+  const verible::ScopedPhase phase("kythe-extract");
   IndexingFactsTreeExtractor visitor(file_list_facts_tree, source_file,
                                      extraction_state);
 
@@ -334,15 +337,14 @@ IndexingFactNode BuildIndexingFactsTree(
 
 IndexingFactNode ExtractFiles(absl::string_view file_list_path,
                               VerilogProject* project,
-                              const std::vector<std::string>& file_names) {
+                              const std::vector<std::string>& file_names,
+                              int jobs) {
   VLOG(1) << __FUNCTION__;
   // Open all of the translation units.
-  for (const auto& file_name : file_names) {
-    const auto status_or_file = project->OpenTranslationUnit(file_name);
-    // For now, collect all diagnostics at the end.
-    // TODO(fangism): offer a mode to exit-early if there are file-not-found
-    // or read-permission issues (fail-fast, alert-user).
-  }
+  // For now, collect all diagnostics at the end.
+  // TODO(fangism): offer a mode to exit-early if there are file-not-found
+  // or read-permission issues (fail-fast, alert-user).
+  project->OpenTranslationUnits(file_names, jobs).IgnoreError();
 
   // Create a node to hold the path and root of the ordered file list, group
   // all the files and acts as a ordered file list of these files.
@@ -360,6 +362,8 @@ IndexingFactNode ExtractFiles(absl::string_view file_list_path,
   for (const auto& file_name : file_names) {
     translation_units.push_back(project->LookupRegisteredFile(file_name));
   }
+  // Parse all files up-front (concurrently), extraction is sequential.
+  project->ParseFiles(translation_units, jobs);
 
   VerilogExtractionState project_extraction_state{project};
 
@@ -534,7 +538,9 @@ void IndexingFactsTreeExtractor::Visit(const SyntaxTreeNode& node) {
       break;
     }
     default: {
-      TreeContextVisitor::Visit(node);
+      // No facts context changes, so deeply nested expressions need not
+      // recurse.
+      VisitChildrenLater(node);
     }
   }
   VLOG(3) << "end of " << __FUNCTION__ << ", tag: " << tag;
@@ -1875,19 +1881,16 @@ void IndexingFactsTreeExtractor::ExtractTypeDeclaration(
 
 void IndexingFactsTreeExtractor::ExtractAnonymousScope(
     const SyntaxTreeNode& node) {
-  IndexingFactNode temp_scope_node(
+  // The scope is added to its parent right away, so that it can stay in
+  // context until its children have been visited, however much later that
+  // is.  This way, long chains of nested scopes, like else-if, do not recurse.
+  IndexingFactNode* scope_node = facts_tree_context_.top().NewChild(
       IndexingNodeData(IndexingFactType::kAnonymousScope,
                        // Generate unique id for this scope.
                        Anchor(absl::make_unique<std::string>(absl::StrCat(
                            "anonymous-scope-", next_anonymous_id++)))));
-
-  {
-    const IndexingFactsTreeContext::AutoPop p(&facts_tree_context_,
-                                              &temp_scope_node);
-    TreeContextVisitor::Visit(node);
-  }
-
-  facts_tree_context_.top().NewChild(std::move(temp_scope_node));
+  facts_tree_context_.Push(scope_node);
+  VisitChildrenLater(node, [this] { facts_tree_context_.Pop(); });
 }
 
 void IndexingFactsTreeExtractor::MoveAndDeleteLastExtractedNode(
@@ -29,9 +29,12 @@ namespace kythe {
 // IndexingFactsTree for the given files.
 // The returned tree will have the files as children and they will retain their
 // original ordering from the file list.
+// Up to 'jobs' files are read and parsed concurrently
+// (see VerilogProject::ParseFiles()).
 IndexingFactNode ExtractFiles(absl::string_view file_list_path,
                               VerilogProject* project,
-                              const std::vector<std::string>& file_names);
+                              const std::vector<std::string>& file_names,
+                              int jobs = 1);
 
 }  // namespace kythe
 }  // namespace verilog
@@ -0,0 +1,63 @@
+// Copyright 2017-2021 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures extraction of indexing facts from a multi-file project.
+// Files are parsed once, outside of the measurements.
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "common/util/file_util.h"
+#include "common/util/logging.h"
+#include "verilog/analysis/verilog_project.h"
+#include "verilog/tools/corpus/benchmark_corpus.h"
+#include "verilog/tools/kythe/indexing_facts_tree_extractor.h"
+
+namespace verilog {
+namespace kythe {
+namespace {
+
+constexpr int kUnitsPerFile = 20;
+
+void BM_ExtractFiles(benchmark::State& state) {
+  const std::string dir = verible::file::JoinPath(
+      std::filesystem::temp_directory_path().string(),
+      absl::StrCat("verible_kythe_extractor_benchmark_", state.range(0)));
+  const auto file_names =
+      corpus::WriteBenchmarkProject(dir, state.range(0), kUnitsPerFile);
+  CHECK(file_names.ok()) << file_names.status();
+  VerilogProject project(dir, {});
+  CHECK(project.OpenTranslationUnits(*file_names, /* jobs= */ 0).ok());
+  project.ParseAll(/* jobs= */ 0);
+
+  const std::string file_list_path = verible::file::JoinPath(dir, "file_list");
+  for (auto _ : state) {
+    const IndexingFactNode facts =
+        ExtractFiles(file_list_path, &project, *file_names);
+    benchmark::DoNotOptimize(facts.Children().size());
+  }
+}
+BENCHMARK(BM_ExtractFiles)
+    ->RangeMultiplier(4)
+    ->Range(4, 64)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace kythe
+}  // namespace verilog
+
+BENCHMARK_MAIN();
@@ -15,8 +15,10 @@
 #include "verilog/tools/kythe/indexing_facts_tree_extractor.h"
 
 #include <functional>
+#include <string>
 
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "common/analysis/syntax_tree_search_test_utils.h"
 #include "common/text/concrete_syntax_tree.h"
 #include "common/util/file_util.h"
@@ -296,6 +298,33 @@ TEST(FactsTreeExtractor, ParseErrorTest) {
   }
 }
 
+// Tests that long else-if chains, which nest anonymous scopes, are extracted
+// without exhausting the call stack.
+TEST(FactsTreeExtractor, LongElseIfChain) {
+  constexpr size_t kLength = 20000;
+  std::string code_text = "module m;\n  initial begin\n    if (a) x = 0;\n";
+  for (size_t i = 0; i < kLength; ++i) {
+    absl::StrAppend(&code_text, "    else if (a) x = 0;\n");
+  }
+  absl::StrAppend(&code_text, "  end\nendmodule\n");
+
+  SimpleTestProject project(code_text);
+  const auto facts_tree = project.Extract();
+  EXPECT_TRUE(project.GetErrorStatuses().empty());
+
+  // Every else clause is the last scope in the previous one.
+  size_t else_scopes = 0;
+  for (const T* node = &facts_tree; !node->is_leaf();
+       node = &node->Children().back()) {
+    if (node->Value().GetIndexingFactType() ==
+        IndexingFactType::kAnonymousScope) {
+      ++else_scopes;
+    }
+  }
+  // ... plus the scopes of the initial statement and of the last if clause.
+  EXPECT_EQ(else_scopes, kLength + 2);
+}
+
 TEST(FactsTreeExtractor, EmptyModuleTest) {
   constexpr int kTag = 1;  // value doesn't matter
   const verible::SyntaxTreeSearchTestCase kTestCase = {
@@ -26,6 +26,8 @@
 #include "common/util/enum_flags.h"
 #include "common/util/file_util.h"
 #include "common/util/init_command_line.h"
+#include "common/util/phase_stats.h"
+#include "common/util/phase_stats_flags.h"
 #include "verilog/analysis/verilog_analyzer.h"
 #include "verilog/analysis/verilog_project.h"
 #include "verilog/tools/kythe/indexing_facts_tree_extractor.h"
@@ -92,6 +94,10 @@ e.g --include_dir_paths directory1,directory2
 if "A.sv" exists in both "directory1" and "directory2" the one in "directory1" is the one we will use.
 )");
 
+ABSL_FLAG(int, jobs, 0,
+          "Number of files to read and parse concurrently.  "
+          "0 means one per hardware thread.");
+
 namespace verilog {
 namespace kythe {
 
@@ -107,7 +113,8 @@ static std::vector<absl::Status> ExtractTranslationUnits(
     absl::string_view file_list_path, VerilogProject* project,
     const std::vector<std::string>& file_names) {
   const verilog::kythe::IndexingFactNode file_list_facts_tree(
-      verilog::kythe::ExtractFiles(file_list_path, project, file_names));
+      verilog::kythe::ExtractFiles(file_list_path, project, file_names,
+                                   absl::GetFlag(FLAGS_jobs)));
 
   // check for printextraction flag, and print extraction if on
   if (absl::GetFlag(FLAGS_printextraction)) {
@@ -116,6 +123,7 @@ static std::vector<absl::Status> ExtractTranslationUnits(
   }
 
   // check how to output kythe facts.
+  const verible::ScopedPhase phase("kythe-emit");
   switch (absl::GetFlag(FLAGS_print_kythe_facts)) {
     case PrintMode::kJSON: {
       std::cout << KytheFactsPrinter(file_list_facts_tree, *project)
@@ -151,6 +159,7 @@ Input: A file which lists paths to the SystemVerilog top-level translation
 Output: Produces Indexing Facts for kythe (http://kythe.io).
 )");
   const auto args = verible::InitCommandLine(usage, &argc, &argv);
+  const verible::ScopedPhaseStatsReport stats_report;
 
   // List of the directories for where to look for included files.
   const std::vector<std::string> include_dir_paths =
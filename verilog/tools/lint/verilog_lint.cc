@@ -29,10 +29,13 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "common/analysis/lint_rule_profile.h"
 #include "common/util/enum_flags.h"
 #include "common/util/file_util.h"
 #include "common/util/init_command_line.h"
 #include "common/util/logging.h"  // for operator<<, LOG, LogMessage, etc
+#include "common/util/phase_stats.h"
+#include "common/util/phase_stats_flags.h"
 #include "verilog/analysis/verilog_linter.h"
 #include "verilog/analysis/verilog_linter_configuration.h"
 
@@ -91,6 +94,12 @@ ABSL_FLAG(std::string, autofix_output_file, "",
           "File to write a patch with autofixes to. If not set autofixes are "
           "applied directly to the analyzed file. Relevant only when "
           "--autofix option is enabled.");
+ABSL_FLAG(bool, profile_rules, false,
+          "If true, print the time spent in each lint rule, totalled over all "
+          "files and most expensive first, to stderr.");
+ABSL_FLAG(std::string, profile_rules_json, "",
+          "If provided, write the time spent in each lint rule, totalled over "
+          "all files and most expensive first, as JSON to this file.");
 
 // LINT.ThenChange(README.md)
 
@@ -99,10 +108,27 @@ using verilog::LinterConfiguration;
 // LintOneFile returns 0, 1, or 2
 static const int kAutofixErrorExitStatus = 3;
 
+// Prints the lint rule profile as requested by --profile_rules and
+// --profile_rules_json.
+static void ReportRuleProfile(const verible::LintRuleProfile& profile) {
+  if (absl::GetFlag(FLAGS_profile_rules)) {
+    profile.PrintTable(std::cerr);
+  }
+  const std::string json_file = absl::GetFlag(FLAGS_profile_rules_json);
+  if (!json_file.empty()) {
+    std::ofstream stream(json_file);
+    profile.PrintJson(stream);
+    if (!stream.good()) {
+      LOG(ERROR) << "Failed to write lint rule profile to " << json_file;
+    }
+  }
+}
+
 int main(int argc, char** argv) {
   const auto usage =
       absl::StrCat("usage: ", argv[0], " [options] <file> [<file>...]");
   const auto args = verible::InitCommandLine(usage, &argc, &argv);
+  const verible::ScopedPhaseStatsReport stats_report;
 
   std::string help_flag = absl::GetFlag(FLAGS_help_rules);
   if (!help_flag.empty()) {
@@ -154,9 +180,15 @@ int main(int argc, char** argv) {
       break;
   }
 
+  const bool profile_rules = absl::GetFlag(FLAGS_profile_rules) ||
+                             !absl::GetFlag(FLAGS_profile_rules_json).empty();
+  verible::LintRuleProfile rule_profile;
+  if (profile_rules) verible::SetGlobalLintRuleProfile(&rule_profile);
+
   // All positional arguments are file names.  Exclude program name.
   for (const absl::string_view filename :
        verible::make_range(args.begin() + 1, args.end())) {
+    const verible::ScopedStatsFile stats_file(filename);
     // Copy configuration, so that it can be locally modified per file.
     const LinterConfiguration config(
         verilog::LinterConfigurationFromFlags(filename));
@@ -169,5 +201,10 @@ int main(int argc, char** argv) {
     exit_status = std::max(lint_status, exit_status);
   }  // for each file
 
+  if (profile_rules) {
+    verible::SetGlobalLintRuleProfile(nullptr);
+    ReportRuleProfile(rule_profile);
+  }
+
   return exit_status;
 }
@@ -249,5 +249,66 @@ for intact_name in ${intact_names[@]}; do
   }
 done
 
+###############################################################################
+echo "Test obfuscating multiple files into --output_dir"
+
+declare -r MY_INPUT_DIR="${TEST_TMPDIR}/batch/in"
+declare -r MY_OUTPUT_DIR="${TEST_TMPDIR}/batch/out"
+mkdir -p "${MY_INPUT_DIR}/sub"
+
+cat >"${MY_INPUT_DIR}/a.sv" <<EOF
+module foo_bar;
+endmodule
+EOF
+
+cat >"${MY_INPUT_DIR}/sub/b.sv" <<EOF
+  foo_bar + foo_bar
+EOF
+
+echo "Expect error without --output_dir."
+"${obfuscator}" "${MY_INPUT_DIR}/a.sv" "${MY_INPUT_DIR}/sub/b.sv"
+status="$?"
+[[ $status == 1 ]] || {
+  echo "Expected exit code 1, but got $status"
+  exit 1
+}
+
+echo "Run obfuscator on both files.  Save substitutions."
+"${obfuscator}" --output_dir="${MY_OUTPUT_DIR}" --jobs=2 \
+  --save_map="${MY_SAVEMAP_FILE}" \
+  "${MY_INPUT_DIR}/a.sv" "${MY_INPUT_DIR}/sub/b.sv"
+status="$?"
+[[ $status == 0 ]] || {
+  echo "Expected exit code 0, but got $status"
+  exit 1
+}
+
+# Outputs mirror the input paths under --output_dir.
+for f in a.sv sub/b.sv; do
+  "${difftool}" --mode=obfuscate "${MY_INPUT_DIR}/${f}" \
+    "${MY_OUTPUT_DIR}/${MY_INPUT_DIR}/${f}" || exit 1
+done
+
+echo "Verify that both files use the same substitution."
+foo_bar_encoded=$(grep "^foo_bar " "${MY_SAVEMAP_FILE}" | cut -d' ' -f2)
+cat >"${MY_EXPECT_FILE}" <<EOF
+  ${foo_bar_encoded} + ${foo_bar_encoded}
+EOF
+diff --strip-trailing-cr -u "${MY_OUTPUT_DIR}/${MY_INPUT_DIR}/sub/b.sv" \
+  "${MY_EXPECT_FILE}" || exit 1
+
+echo "Expect error for an input path that leaves --output_dir."
+"${obfuscator}" --output_dir="${MY_OUTPUT_DIR}/nested" \
+  "${MY_INPUT_DIR}/a.sv" "../../${MY_INPUT_DIR}/sub/b.sv"
+status="$?"
+[[ $status == 1 ]] || {
+  echo "Expected exit code 1, but got $status"
+  exit 1
+}
+[[ ! -e "${MY_OUTPUT_DIR}/nested" ]] || {
+  echo "Expected no outputs to be written."
+  exit 1
+}
+
 ###############################################################################
 echo "PASS"
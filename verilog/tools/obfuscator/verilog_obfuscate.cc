@@ -14,24 +14,31 @@
 
 // verilog_obfuscate mangles verilog code by changing identifiers.
 // All whitespace and identifier lengths are preserved.
-// Output is written to stdout.
+// Output is written to stdout, or to --output_dir for multiple files.
 //
 // Example usage:
 // verilog_obfuscate [options] < file > output
 // cat files... | verilog_obfuscate [options] > output
+// verilog_obfuscate [options] --output_dir=dir files...
 
 #include <iostream>
 #include <set>
 #include <sstream>  // IWYU pragma: keep  // for ostringstream
 #include <string>   // for string, allocator, etc
 #include <utility>
+#include <vector>
 
 #include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "common/strings/obfuscator.h"
 #include "common/util/file_util.h"
 #include "common/util/init_command_line.h"
+#include "common/util/thread_pool.h"
 #include "verilog/analysis/extractors.h"
 #include "verilog/analysis/verilog_analyzer.h"
 #include "verilog/transform/obfuscate.h"
@@ -58,14 +65,140 @@ ABSL_FLAG(                            //
     "The translation map saved with --save_map will have identity mappings for "
     "these identifiers.  When used with --load_map, the mapping explicitly "
     "specified in the map file will have higher priority than this option.");
+ABSL_FLAG(                        //
+    std::string, output_dir, "",  //
+    "Directory to write the outputs to, when files are given as arguments.  "
+    "Each output is written to the path of its input, relative to this "
+    "directory.  Required with file arguments.");
+ABSL_FLAG(int, jobs, 0,
+          "Number of files to obfuscate concurrently, when files are given as "
+          "arguments.  0 means one per hardware thread.");
+
+// Writes the translation of 'subst' to 'save_map_file', unless that is empty.
+// Returns false on error.
+static bool SaveMap(absl::string_view save_map_file,
+                    const IdentifierObfuscator& subst) {
+  if (save_map_file.empty()) return true;
+  if (!verible::file::SetContents(save_map_file, subst.save()).ok()) {
+    std::cerr << "Error writing --save_map file: " << save_map_file
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Collects the interface names of 'content' to preserve.
+static absl::Status CollectPreservedNames(absl::string_view content,
+                                          std::set<std::string>* preserved) {
+  // TODO: an inner module's interface in a nested module will be preserved.
+  // but this may not be required.
+  return verilog::analysis::CollectInterfaceNames(content, preserved);
+}
+
+// Returns the path under 'output_dir' to write the output for 'file' to, which
+// mirrors the path of 'file'.  Absolute paths are taken as relative to
+// 'output_dir', and paths that would leave it (through "..") are rejected.
+static absl::StatusOr<std::string> OutputPath(absl::string_view output_dir,
+                                              absl::string_view file) {
+  // JoinPath() drops leading '/' and normalizes away "." and "dir/..".
+  const std::string relative = verible::file::JoinPath("", file);
+  if (relative.empty() || relative == "." || relative == ".." ||
+      absl::StartsWith(relative, "../")) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Output path would be outside of --output_dir: ", file));
+  }
+  return verible::file::JoinPath(output_dir, relative);
+}
+
+// Obfuscates all 'files' concurrently with the same 'subst', and writes each
+// result to --output_dir.  Returns false if any file failed.
+static bool ObfuscateFiles(const std::vector<absl::string_view>& files,
+                           IdentifierObfuscator* subst) {
+  const std::string& output_dir = absl::GetFlag(FLAGS_output_dir);
+  const bool preserve_interface = absl::GetFlag(FLAGS_preserve_interface);
+  const size_t num_threads =
+      verible::ThreadPool::ThreadsForJobs(absl::GetFlag(FLAGS_jobs));
+
+  absl::Mutex errors_mutex;
+  bool ok = true;
+  auto report_error = [&](absl::string_view file, const absl::Status& status) {
+    absl::MutexLock lock(&errors_mutex);
+    std::cerr << file << ": " << status.message() << std::endl;
+    ok = false;
+  };
+
+  // Reject files that cannot be written before obfuscating any of them.
+  std::vector<std::string> output_files;
+  output_files.reserve(files.size());
+  for (const absl::string_view file : files) {
+    absl::StatusOr<std::string> output_file = OutputPath(output_dir, file);
+    if (!output_file.ok()) {
+      report_error(file, output_file.status());
+      continue;
+    }
+    output_files.push_back(*std::move(output_file));
+  }
+  if (!ok) return false;
+
+  // Interface names must be known before any file is obfuscated, because any
+  // other file may use them first.
+  if (preserve_interface) {
+    std::vector<std::set<std::string>> preserved(files.size());
+    {
+      verible::ThreadPool pool(num_threads);
+      for (size_t i = 0; i < files.size(); ++i) {
+        pool.Schedule([&, i] {
+          std::string content;
+          absl::Status status = verible::file::GetContents(files[i], &content);
+          if (status.ok()) {
+            status = CollectPreservedNames(content, &preserved[i]);
+          }
+          if (!status.ok()) report_error(files[i], status);
+        });
+      }
+    }  // waits for all files
+    if (!ok) return false;
+    for (const auto& names : preserved) {
+      for (const auto& name : names) subst->encode(name, name);
+    }
+  }
+
+  {
+    verible::ThreadPool pool(num_threads);
+    for (size_t i = 0; i < files.size(); ++i) {
+      pool.Schedule([&, i] {
+        std::string content;
+        absl::Status status = verible::file::GetContents(files[i], &content);
+        std::ostringstream output;
+        if (status.ok()) {
+          status = verilog::ObfuscateVerilogCode(content, &output, subst);
+        }
+        const std::string& output_file = output_files[i];
+        if (status.ok()) {
+          status =
+              verible::file::CreateDirs(verible::file::Dirname(output_file));
+        }
+        if (status.ok()) {
+          status = verible::file::SetContents(output_file, output.str());
+        }
+        if (!status.ok()) report_error(files[i], status);
+      });
+    }
+  }  // waits for all files
+  return ok;
+}
 
 int main(int argc, char** argv) {
   const auto usage = absl::StrCat("usage: ", argv[0],
                                   " [options] < original > output\n"
+                                  "       ",
+                                  argv[0],
+                                  " [options] --output_dir=dir files...\n"
                                   R"(
 verilog_obfuscate mangles Verilog code by changing identifiers.
 All whitespaces and identifier lengths are preserved.
-Output is written to stdout.
+Output is written to stdout, or to --output_dir for multiple files, which are
+obfuscated concurrently with one consistent translation.
 )");
   const auto args = verible::InitCommandLine(usage, &argc, &argv);
 
@@ -97,6 +230,18 @@ Output is written to stdout.
     return 1;
   }
 
+  if (args.size() > 1) {
+    if (absl::GetFlag(FLAGS_output_dir).empty()) {
+      std::cerr << "--output_dir is required with file arguments." << std::endl;
+      return 1;
+    }
+    const std::vector<absl::string_view> files(args.begin() + 1, args.end());
+    const bool ok = ObfuscateFiles(files, &subst);
+    // Save the map even if some files failed, to be able to decode the others.
+    if (!decode && !SaveMap(save_map_file, subst)) return 1;
+    return ok ? 0 : 1;
+  }
+
   // Read from stdin.
   std::string content;
   if (!verible::file::GetContents("-", &content).ok()) {
@@ -104,13 +249,10 @@ Output is written to stdout.
   }
 
   // Preserve interface names (e.g. module name, port names).
-  // TODO: an inner module's interface in a nested module will be preserved.
-  // but this may not be required.
   const bool preserve_interface = absl::GetFlag(FLAGS_preserve_interface);
   if (preserve_interface) {
     std::set<std::string> preserved;
-    const auto status =
-        verilog::analysis::CollectInterfaceNames(content, &preserved);
+    const auto status = CollectPreservedNames(content, &preserved);
     if (!status.ok()) {
       std::cerr << status.message();
       return 1;
@@ -127,13 +269,7 @@ Output is written to stdout.
     return 1;
   }
 
-  if (!decode && !save_map_file.empty()) {
-    if (!verible::file::SetContents(save_map_file, subst.save()).ok()) {
-      std::cerr << "Error writing --save_map file: " << save_map_file
-                << std::endl;
-      return 1;
-    }
-  }
+  if (!decode && !SaveMap(save_map_file, subst)) return 1;
 
   // Print obfuscated code.
   std::cout << output.str();
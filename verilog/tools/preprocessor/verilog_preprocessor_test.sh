@@ -179,5 +179,84 @@ status="$?"
   exit 1
 }
 
+################################################################################
+echo "=== Test strip-comments: multiple files into --output_dir"
+
+MY_INPUT_DIR="${TEST_TMPDIR}/batch/in"
+readonly MY_INPUT_DIR
+MY_OUTPUT_DIR="${TEST_TMPDIR}/batch/out"
+readonly MY_OUTPUT_DIR
+mkdir -p "${MY_INPUT_DIR}/sub"
+
+cat > "${MY_INPUT_DIR}/a.sv" <<EOF
+module a; /* a */ endmodule
+EOF
+
+cat > "${MY_INPUT_DIR}/sub/b.sv" <<EOF
+// b
+module b; endmodule
+EOF
+
+# Multiple files without --output_dir are rejected.
+"$preprocessor" strip-comments "${MY_INPUT_DIR}/a.sv" \
+  "${MY_INPUT_DIR}/sub/b.sv" > /dev/null
+
+status="$?"
+[[ $status == 1 ]] || {
+  echo "Expected exit code 1, but got $status"
+  exit 1
+}
+
+"$preprocessor" --output_dir="${MY_OUTPUT_DIR}" --jobs=2 strip-comments \
+  "${MY_INPUT_DIR}/a.sv" "${MY_INPUT_DIR}/sub/b.sv" 2> "$MY_OUTPUT_FILE"
+
+status="$?"
+[[ $status == 0 ]] || {
+  echo "Expected exit code 0, but got $status"
+  exit 1
+}
+
+grep -q "from 2 files" "$MY_OUTPUT_FILE" || {
+  echo "Expected throughput report in $MY_OUTPUT_FILE but didn't find it.  Got:"
+  cat "$MY_OUTPUT_FILE"
+  exit 1
+}
+
+# Outputs mirror the input paths under --output_dir.
+cat > "$MY_EXPECT_FILE" <<EOF
+module a;         endmodule
+EOF
+
+diff --strip-trailing-cr -u "$MY_EXPECT_FILE" \
+  "${MY_OUTPUT_DIR}/${MY_INPUT_DIR}/a.sv" || {
+  exit 1
+}
+
+cat > "$MY_EXPECT_FILE" <<EOF
+    
+module b; endmodule
+EOF
+
+diff --strip-trailing-cr -u "$MY_EXPECT_FILE" \
+  "${MY_OUTPUT_DIR}/${MY_INPUT_DIR}/sub/b.sv" || {
+  exit 1
+}
+
+# A missing input fails, but the other files are still processed.
+rm -rf "${MY_OUTPUT_DIR}"
+"$preprocessor" --output_dir="${MY_OUTPUT_DIR}" strip-comments \
+  "${MY_INPUT_DIR}/does.not.exist" "${MY_INPUT_DIR}/a.sv" 2> /dev/null
+
+status="$?"
+[[ $status == 1 ]] || {
+  echo "Expected exit code 1, but got $status"
+  exit 1
+}
+
+[[ -f "${MY_OUTPUT_DIR}/${MY_INPUT_DIR}/a.sv" ]] || {
+  echo "Expected output for a.sv despite the other file failing."
+  exit 1
+}
+
 ################################################################################
 echo "PASS"
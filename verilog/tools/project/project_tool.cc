@@ -14,7 +14,10 @@
 
 #include <functional>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/usage.h"
@@ -24,10 +27,14 @@
 #include "common/util/file_util.h"
 #include "common/util/init_command_line.h"
 #include "common/util/logging.h"
+#include "common/util/phase_stats_flags.h"
 #include "common/util/subcommand.h"
+#include "common/util/thread_pool.h"
 #include "verilog/analysis/dependencies.h"
 #include "verilog/analysis/symbol_table.h"
+#include "verilog/analysis/symbol_table_index.h"
 #include "verilog/analysis/verilog_project.h"
+#include "verilog/analysis/verilog_skim.h"
 
 // Note: These flags were copied over from
 // verilog/tools/kythe/verilog_kythe_extractor.cc.
@@ -51,6 +58,25 @@ e.g --include_dir_paths directory1,directory2
 if "A.sv" exists in both "directory1" and "directory2" the one in "directory1" is the one we will use.
 )");
 
+ABSL_FLAG(int, jobs, 0,
+          "Number of files to read and parse concurrently.  "
+          "0 means one per hardware thread.");
+
+ABSL_FLAG(
+    std::string, symbol_table_index, "",
+    R"(Path to a symbol table index file (optional).
+If the file exists, translation units that have not changed since it was
+written are restored from it instead of being parsed again.
+The index is rewritten whenever any translation unit had to be (re-)built.
+)");
+
+ABSL_FLAG(bool, skim, false,
+          R"(For file-deps: find dependencies by only lexing files, without
+parsing them or building a symbol table.  This is much faster, but approximate:
+it follows all preprocessor branches, does not expand macros, and only
+recognizes instances at the start of an item.
+)");
+
 using verible::SubcommandArgsRange;
 using verible::SubcommandEntry;
 
@@ -65,6 +91,11 @@ struct VerilogProjectConfig {
   // See --file_list_root above.
   std::string file_list_root;
 
+  // See --jobs above.
+  int jobs = 0;
+  // See --symbol_table_index above.
+  std::string symbol_table_index;
+
   // Not a flag, but loaded from file_list_path.
   std::vector<std::string> files_names;
 
@@ -78,6 +109,8 @@ struct VerilogProjectConfig {
     }
 
     file_list_root = absl::GetFlag(FLAGS_file_list_root);
+    jobs = absl::GetFlag(FLAGS_jobs);
+    symbol_table_index = absl::GetFlag(FLAGS_symbol_table_index);
 
     // Load file list.
     const auto files_names_or_status(
@@ -98,6 +131,10 @@ struct ProjectSymbols {
   // This object must outlive 'symbol_table' (maintained by struct-ordering).
   std::unique_ptr<verilog::VerilogProject> project;
 
+  // Restored parts of 'symbol_table' may point into this object, so it must
+  // also outlive 'symbol_table'.
+  verilog::SymbolTableIndex index;
+
   // Unified symbol table.
   std::unique_ptr<verilog::SymbolTable> symbol_table;
 
@@ -117,9 +154,10 @@ struct ProjectSymbols {
     // Error-out early if any files failed to open.
     project = absl::make_unique<verilog::VerilogProject>(
         config.file_list_root, config.include_dir_paths);
-    for (const auto& file : config.files_names) {
-      const auto open_status = project->OpenTranslationUnit(file);
-      if (!open_status.ok()) return open_status.status();
+    {
+      const auto status =
+          project->OpenTranslationUnits(config.files_names, config.jobs);
+      if (!status.ok()) return status;
     }
 
     // Initialize symbol table (empty).
@@ -127,14 +165,58 @@ struct ProjectSymbols {
     return absl::OkStatus();
   }
 
-  // Builds symbol table.
-  void Build(std::vector<absl::Status>* build_statuses) {
+  // Builds symbol table, restoring unchanged translation units from the
+  // symbol table index (if there is one), and updates the index.
+  // Problems with reading the index are reported to 'errs', and otherwise
+  // ignored.  Returns an error if the index could not be written.
+  absl::Status Build(std::vector<absl::Status>* build_statuses,
+                     std::ostream& errs) {
     VLOG(1) << __FUNCTION__;
+    const std::string& index_path(config.symbol_table_index);
+    if (!index_path.empty() && verible::file::FileExists(index_path).ok()) {
+      std::string serialized;
+      auto status = verible::file::GetContents(index_path, &serialized);
+      if (status.ok()) status = index.Load(serialized, symbol_table.get());
+      if (!status.ok()) {
+        errs << "Ignoring symbol table index " << index_path << ": "
+             << status.message() << std::endl;
+      }
+    }
+
+    // Parse the remaining files concurrently, before building the symbol
+    // table sequentially.
+    const auto& restored_units(index.RestoredTranslationUnits());
+    std::vector<verilog::VerilogSourceFile*> files_to_parse;
+    for (const auto& file : config.files_names) {
+      if (restored_units.find(file) != restored_units.end()) continue;
+      files_to_parse.push_back(project->LookupRegisteredFile(file));
+    }
+    project->ParseFiles(files_to_parse, config.jobs);
+
     // For now, ingest files in the order they were listed.
     // Without conflicting definitions in files, this order should not matter.
+    verilog::SymbolTableIndex::DiagnosticsMap unit_statuses;
+    bool built_any = false;
     for (const auto& file : config.files_names) {
-      symbol_table->BuildSingleTranslationUnit(file, build_statuses);
+      const auto restored = restored_units.find(file);
+      auto& statuses(unit_statuses[file]);
+      if (restored != restored_units.end()) {
+        statuses = restored->second;
+      } else {
+        symbol_table->BuildSingleTranslationUnit(file, &statuses);
+        built_any = true;
+      }
+      build_statuses->insert(build_statuses->end(), statuses.begin(),
+                             statuses.end());
     }
+
+    if (index_path.empty() || !built_any) return absl::OkStatus();
+    // Save before resolving, so that the index can serve every subcommand.
+    std::ostringstream serialized;
+    const auto status = verilog::SymbolTableIndex::Save(
+        *symbol_table, unit_statuses, &serialized);
+    if (!status.ok()) return status;
+    return verible::file::SetContents(index_path, serialized.str());
   }
 
   // Resolves symbols.
@@ -174,7 +256,10 @@ static absl::Status BuildAndShowSymbolTable(const SubcommandArgsRange& args,
 
   // Build symbol table.
   std::vector<absl::Status> build_statuses;
-  project_symbols.Build(&build_statuses);
+  {
+    const auto status = project_symbols.Build(&build_statuses, errs);
+    if (!status.ok()) return status;
+  }
 
   // Print.
   outs << "Symbol Table:" << std::endl;
@@ -208,7 +293,10 @@ static absl::Status ResolveAndShowSymbolReferences(
 
   // Build symbol table.
   std::vector<absl::Status> statuses;
-  project_symbols.Build(&statuses);
+  {
+    const auto status = project_symbols.Build(&statuses, errs);
+    if (!status.ok()) return status;
+  }
 
   // Resolve symbols.
   project_symbols.Resolve(&statuses);
@@ -225,6 +313,31 @@ static absl::Status ResolveAndShowSymbolReferences(
   return absl::OkStatus();
 }
 
+// Computes approximate file dependencies by skimming the opened files of
+// 'project' concurrently.
+static verilog::FileDependencies SkimFileDependencies(
+    const verilog::VerilogProject& project,
+    const VerilogProjectConfig& config) {
+  std::vector<std::pair<const verilog::VerilogSourceFile*,
+                        verilog::SkimmedSource>>
+      skims;
+  skims.reserve(config.files_names.size());
+  for (const auto& file : config.files_names) {
+    skims.emplace_back(project.LookupRegisteredFile(file),
+                       verilog::SkimmedSource());
+  }
+  {
+    verible::ThreadPool pool(verible::ThreadPool::ThreadsForJobs(config.jobs));
+    for (auto& skim : skims) {
+      pool.Schedule([&skim] {
+        const auto* text_structure = skim.first->GetTextStructure();
+        skim.second = verilog::SkimVerilogSource(text_structure->Contents());
+      });
+    }
+  }  // waits for all files
+  return verilog::SkimmedFileDependencies(skims);
+}
+
 static absl::Status ShowFileDependencies(const SubcommandArgsRange& args,
                                          std::istream& ins, std::ostream& outs,
                                          std::ostream& errs) {
@@ -243,9 +356,17 @@ static absl::Status ShowFileDependencies(const SubcommandArgsRange& args,
     if (!status.ok()) return status;
   }
 
+  if (absl::GetFlag(FLAGS_skim)) {
+    SkimFileDependencies(*project_symbols.project, config).PrintGraph(outs);
+    return absl::OkStatus();
+  }
+
   // Build symbol table.
   std::vector<absl::Status> statuses;
-  project_symbols.Build(&statuses);
+  {
+    const auto status = project_symbols.Build(&statuses, errs);
+    if (!status.ok()) return status;
+  }
 
   // Accumulate diagnostics.
   if (!statuses.empty()) {
@@ -295,6 +416,8 @@ Prints human-readable representation of inter-file dependencies, e.g.
 
   "file1.sv" depends on "file2.sv" for symbols { X, Y, Z... }
 
+With --skim, files are only lexed, which is much faster but approximate.
+
 Input:
 Project options, including source file list.
 )"}},
@@ -321,6 +444,7 @@ int main(int argc, char* argv[]) {
 
   // Process invocation args.
   const auto args = verible::InitCommandLine(usage, &argc, &argv);
+  const verible::ScopedPhaseStatsReport stats_report;
   if (args.size() == 1) {
     std::cerr << absl::ProgramUsageMessage() << std::endl;
     return 1;
@@ -305,5 +305,99 @@ EOF
 
 diff --strip-trailing-cr -u "$MY_EXPECT_FILE" "$MY_OUTPUT_FILE" || { exit 1; }
 
+################################################################################
+echo "=== Skim dependencies between two files (modules)"
+
+# Reuse the file list and sources from the previous test.
+"$project_tool" \
+  file-deps \
+  --skim \
+  --file_list_path "$FILE_LIST_INPUT" \
+  --file_list_root "$(dirname "$MY_INPUT_FILE".A)" \
+  > "$MY_OUTPUT_FILE" 2>&1
+
+status="$?"
+[[ $status == 0 ]] || {
+  "Expected exit code 0, but got $status"
+  exit 1
+}
+
+diff --strip-trailing-cr -u "$MY_EXPECT_FILE" "$MY_OUTPUT_FILE" || { exit 1; }
+
+################################################################################
+echo "=== Reuse a symbol table index across runs"
+
+INDEX_FILE="${TEST_TMPDIR}/symbols.index"
+rm -f "$INDEX_FILE"
+
+# Reuse the file list and sources from the previous test.
+for run in 1 2; do
+  "$project_tool" \
+    file-deps \
+    --file_list_path "$FILE_LIST_INPUT" \
+    --file_list_root "$(dirname "$MY_INPUT_FILE".A)" \
+    --symbol_table_index "$INDEX_FILE" \
+    > "$MY_OUTPUT_FILE" 2>&1
+
+  status="$?"
+  [[ $status == 0 ]] || {
+    "Expected exit code 0, but got $status"
+    exit 1
+  }
+
+  [[ -f "$INDEX_FILE" ]] || {
+    echo "Expected symbol table index $INDEX_FILE to be written."
+    exit 1
+  }
+
+  diff --strip-trailing-cr -u "$MY_EXPECT_FILE" "$MY_OUTPUT_FILE" || { exit 1; }
+done
+
+# A changed file is rebuilt, the unchanged one is restored.
+cat > "$MY_INPUT_FILE".B <<EOF
+module qq;
+endmodule
+EOF
+
+"$project_tool" \
+  file-deps \
+  --file_list_path "$FILE_LIST_INPUT" \
+  --file_list_root "$(dirname "$MY_INPUT_FILE".A)" \
+  --symbol_table_index "$INDEX_FILE" \
+  > "$MY_OUTPUT_FILE" 2>&1
+
+status="$?"
+[[ $status == 0 ]] || {
+  "Expected exit code 0, but got $status"
+  exit 1
+}
+
+[[ ! -s "$MY_OUTPUT_FILE" ]] || {
+  echo "Expected no dependencies, but got:"
+  cat "$MY_OUTPUT_FILE"
+  exit 1
+}
+
+# A corrupt index is reported and ignored.
+echo "garbage" > "$INDEX_FILE"
+"$project_tool" \
+  file-deps \
+  --file_list_path "$FILE_LIST_INPUT" \
+  --file_list_root "$(dirname "$MY_INPUT_FILE".A)" \
+  --symbol_table_index "$INDEX_FILE" \
+  > "$MY_OUTPUT_FILE" 2>&1
+
+status="$?"
+[[ $status == 0 ]] || {
+  "Expected exit code 0, but got $status"
+  exit 1
+}
+
+grep -q "Ignoring symbol table index" "$MY_OUTPUT_FILE" || {
+  echo "Expected \"Ignoring symbol table index\" in $MY_OUTPUT_FILE but didn't find it.  Got:"
+  cat "$MY_OUTPUT_FILE"
+  exit 1
+}
+
 ################################################################################
 echo "PASS"
@@ -42,6 +42,8 @@
 #include "common/util/file_util.h"
 #include "common/util/init_command_line.h"
 #include "common/util/logging.h"  // for operator<<, LOG, LogMessage, etc
+#include "common/util/phase_stats.h"
+#include "common/util/phase_stats_flags.h"
 #include "json/json.h"
 #include "verilog/CST/verilog_tree_json.h"
 #include "verilog/CST/verilog_tree_print.h"
@@ -282,6 +284,7 @@ int main(int argc, char** argv) {
   const auto usage =
       absl::StrCat("usage: ", argv[0], " [options] <file> [<file>...]");
   const auto args = verible::InitCommandLine(usage, &argc, &argv);
+  const verible::ScopedPhaseStatsReport stats_report;
 
   Json::Value json;
 
@@ -289,6 +292,7 @@ int main(int argc, char** argv) {
   // All positional arguments are file names.  Exclude program name.
   for (const auto filename :
        verible::make_range(args.begin() + 1, args.end())) {
+    const verible::ScopedStatsFile stats_file(filename);
     std::string content;
     if (!verible::file::GetContents(filename, &content).ok()) {
       exit_status = 1;
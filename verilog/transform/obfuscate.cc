@@ -14,6 +14,7 @@
 
 #include "verilog/transform/obfuscate.h"
 
+#include <functional>
 #include <iostream>
 #include <sstream>
 
@@ -34,9 +35,13 @@ using verible::IdentifierObfuscator;
 // TODO(fangism): single-char identifiers don't need to be obfuscated.
 // or use a shuffle/permutation to guarantee collision-free reversibility.
 
-static void ObfuscateVerilogCodeInternal(absl::string_view content,
-                                         std::ostream* output,
-                                         IdentifierObfuscator* subst) {
+// Replaces identifiers with what 'translate' returns for them.
+using IdentifierTranslator =
+    std::function<absl::string_view(absl::string_view)>;
+
+static void ObfuscateVerilogCodeInternal(
+    absl::string_view content, std::ostream* output,
+    const IdentifierTranslator& translate) {
   VLOG(1) << __FUNCTION__;
   verilog::VerilogLexer lexer(content);
   while (true) {
@@ -45,7 +50,7 @@ static void ObfuscateVerilogCodeInternal(absl::string_view content,
     switch (token.token_enum()) {
       case verilog_tokentype::SymbolIdentifier:
       case verilog_tokentype::PP_Identifier:
-        *output << (*subst)(token.text());
+        *output << translate(token.text());
         break;
         // Preserve all $ID calls, including system task/function calls, and VPI
         // calls
@@ -57,13 +62,13 @@ static void ObfuscateVerilogCodeInternal(absl::string_view content,
       case verilog_tokentype::MacroIdentifier:
       case verilog_tokentype::MacroCallId:
         // TODO(fangism): verilog_tokentype::EscapedIdentifier
-        *output << token.text()[0] << (*subst)(token.text().substr(1));
+        *output << token.text()[0] << translate(token.text().substr(1));
         break;
       // The following tokens are un-lexed, so they need to be lexed
       // recursively.
       case verilog_tokentype::MacroArg:
       case verilog_tokentype::PP_define_body:
-        ObfuscateVerilogCodeInternal(token.text(), output, subst);
+        ObfuscateVerilogCodeInternal(token.text(), output, translate);
         break;
       default:
         // This also covers lexical error tokens.
@@ -109,7 +114,9 @@ static absl::Status VerifyDecoding(absl::string_view original,
 
   // Decode and compare.
   std::ostringstream decoded_output;
-  ObfuscateVerilogCodeInternal(encoded, &decoded_output, &reverse_subst);
+  ObfuscateVerilogCodeInternal(
+      encoded, &decoded_output,
+      [&reverse_subst](absl::string_view text) { return reverse_subst(text); });
   if (original != decoded_output.str()) {
     return ReversibilityError(original, encoded, decoded_output.str());
   }
@@ -146,7 +153,9 @@ absl::Status ObfuscateVerilogCode(absl::string_view content,
                                   IdentifierObfuscator* subst) {
   VLOG(1) << __FUNCTION__;
   std::ostringstream buffer;
-  ObfuscateVerilogCodeInternal(content, &buffer, subst);
+  ObfuscateVerilogCodeInternal(
+      content, &buffer,
+      [subst](absl::string_view text) { return (*subst)(text); });
 
   // Always verify equivalence.
   const auto eq_status = VerifyEquivalence(content, buffer.str());
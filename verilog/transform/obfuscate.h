@@ -29,6 +29,8 @@ namespace verilog {
 // not necessary syntactically valid.  Transformations apply to macro
 // arguments and macro definition bodies.
 // Returned status signals success or possible an internal error.
+// Different files can be obfuscated concurrently with the same 'subst', for
+// consistent translations across all of them.
 absl::Status ObfuscateVerilogCode(absl::string_view content,
                                   std::ostream* output,
                                   verible::IdentifierObfuscator* subst);
@@ -15,6 +15,7 @@
 #include "verilog/transform/strip_comments.h"
 
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "common/strings/comment_utils.h"
@@ -22,7 +23,6 @@
 #include "common/strings/split.h"
 #include "common/text/token_info.h"
 #include "common/util/iterator_range.h"
-#include "common/util/spacer.h"
 #include "verilog/parser/verilog_lexer.h"
 #include "verilog/parser/verilog_parser.h"
 #include "verilog/parser/verilog_token_enum.h"
@@ -30,25 +30,32 @@
 namespace verilog {
 
 using verible::make_string_view_range;
-using verible::Spacer;
 using verible::StripComment;
 using verible::TokenInfo;
 
 // Replace non-newline characters with a single char, like <space>.
 // Tabs are considered non-newline characters.
-static void ReplaceNonNewlines(absl::string_view text, std::ostream* output,
+static void ReplaceNonNewlines(absl::string_view text, std::string* output,
                                char replacement) {
   const std::vector<absl::string_view> lines(verible::SplitLines(text));
   if (lines.empty()) return;
   // no newline before first element
-  *output << Spacer(lines.front().size(), replacement);
+  output->append(lines.front().size(), replacement);
   for (const auto& line : verible::make_range(lines.begin() + 1, lines.end())) {
-    *output << '\n' << Spacer(line.size(), replacement);
+    output->push_back('\n');
+    output->append(line.size(), replacement);
   }
 }
 
 void StripVerilogComments(absl::string_view content, std::ostream* output,
                           char replacement) {
+  std::string stripped;
+  StripVerilogComments(content, &stripped, replacement);
+  *output << stripped;
+}
+
+void StripVerilogComments(absl::string_view content, std::string* output,
+                          char replacement) {
   VLOG(1) << __FUNCTION__;
   verilog::VerilogLexer lexer(content);
 
@@ -71,14 +78,15 @@ void StripVerilogComments(absl::string_view content, std::ostream* output,
             break;
           case ' ':
             // The lexer guarantees the text does not contain '\n'.
-            *output << Spacer(text.length());
+            output->append(text.length(), ' ');
             break;
           default: {
             // Retain the "//" but erase everything thereafter.
             const absl::string_view body(StripComment(text));
             const absl::string_view head(
                 make_string_view_range(text.begin(), body.begin()));
-            *output << head << Spacer(body.length(), replacement);
+            output->append(head.begin(), head.end());
+            output->append(body.length(), replacement);
             break;
           }
         }
@@ -89,7 +97,7 @@ void StripVerilogComments(absl::string_view content, std::ostream* output,
           case '\0':
             // Print one space to prevent accidental token fusion in
             // cases like: "a/**/b".
-            *output << ' ';
+            output->push_back(' ');
             break;
           case ' ':
             // Preserve newlines, but replace everything else with space.
@@ -103,9 +111,9 @@ void StripVerilogComments(absl::string_view content, std::ostream* output,
             const absl::string_view tail(
                 make_string_view_range(body.end(), text.end()));
 
-            *output << head;
+            output->append(head.begin(), head.end());
             ReplaceNonNewlines(body, output, replacement);
-            *output << tail;
+            output->append(tail.begin(), tail.end());
             break;
           }
         }
@@ -118,7 +126,7 @@ void StripVerilogComments(absl::string_view content, std::ostream* output,
         break;
       default:
         // Preserve all other text, including lexical error tokens.
-        *output << text;
+        output->append(text.begin(), text.end());
     }  // switch
   }
   VLOG(1) << "end of " << __FUNCTION__;
@@ -16,6 +16,7 @@
 #define VERIBLE_VERILOG_TRANSFORM_STRIP_COMMENTS_H_
 
 #include <iosfwd>
+#include <string>
 
 #include "absl/strings/string_view.h"
 
@@ -36,6 +37,11 @@ namespace verilog {
 void StripVerilogComments(absl::string_view content, std::ostream* output,
                           char replacement = '\0');
 
+// Same as above, but appends the result to 'output'.  This is faster than
+// streaming many small pieces, and lets callers write the result at once.
+void StripVerilogComments(absl::string_view content, std::string* output,
+                          char replacement = '\0');
+
 }  // namespace verilog
 
 #endif  // VERIBLE_VERILOG_TRANSFORM_STRIP_COMMENTS_H_
@@ -15,6 +15,7 @@
 #include "verilog/transform/strip_comments.h"
 
 #include <sstream>
+#include <string>
 
 #include "absl/strings/string_view.h"
 #include "gmock/gmock.h"
@@ -297,5 +298,15 @@ TEST(StripVerilogCommentsTest, Various) {
   }
 }
 
+TEST(StripVerilogCommentsTest, AppendsToString) {
+  std::string output("prefix\n");
+  StripVerilogComments("module m; /* c */ endmodule // c\n", &output, ' ');
+  EXPECT_EQ(output, "prefix\nmodule m;         endmodule     \n");
+  StripVerilogComments("`define D /*c*/\n", &output, '\0');
+  EXPECT_EQ(output,
+            "prefix\nmodule m;         endmodule     \n"
+            "`define D  \n");
+}
+
 }  // namespace
 }  // namespace verilog